@@ -144,6 +144,34 @@ void capacity_t::copy(capacity_t * capacity)
 	_prev_charge = capacity->_prev_charge;
 	_charge = capacity->_charge;
 }
+void capacity_t::save_state(capacity_state &state)
+{
+	state.q0 = _q0;
+	state.qmax = _qmax;
+	state.qmax_thermal = _qmax_thermal;
+	state.I = _I;
+	state.I_loss = _I_loss;
+	state.SOC = _SOC;
+	state.DOD = _DOD;
+	state.DOD_prev = _DOD_prev;
+	state.chargeChange = _chargeChange;
+	state.prev_charge = _prev_charge;
+	state.charge = _charge;
+}
+void capacity_t::restore_state(const capacity_state &state)
+{
+	_q0 = state.q0;
+	_qmax = state.qmax;
+	_qmax_thermal = state.qmax_thermal;
+	_I = state.I;
+	_I_loss = state.I_loss;
+	_SOC = state.SOC;
+	_DOD = state.DOD;
+	_DOD_prev = state.DOD_prev;
+	_chargeChange = state.chargeChange;
+	_prev_charge = state.prev_charge;
+	_charge = state.charge;
+}
 void capacity_t::check_charge_change()
 {
 	_charge = NO_CHARGE;
@@ -269,6 +297,18 @@ void capacity_kibam_t::copy(capacity_t * capacity)
 	_q20 = tmp->_q20;
 	_I20 = tmp->_I20;
 }
+void capacity_kibam_t::save_state(capacity_state &state)
+{
+	capacity_t::save_state(state);
+	state.q1_0 = _q1_0;
+	state.q2_0 = _q2_0;
+}
+void capacity_kibam_t::restore_state(const capacity_state &state)
+{
+	capacity_t::restore_state(state);
+	_q1_0 = state.q1_0;
+	_q2_0 = state.q2_0;
+}
 
 void capacity_kibam_t::replace_battery()
 {
@@ -522,6 +562,8 @@ void voltage_t::copy(voltage_t * voltage)
 	// doesn't change;
 	//_batt_voltage_matrix = voltage->_batt_voltage_matrix;
 }
+void voltage_t::save_state(voltage_state &state){ state.cell_voltage = _cell_voltage; }
+void voltage_t::restore_state(const voltage_state &state){ _cell_voltage = state.cell_voltage; }
 double voltage_t::battery_voltage(){ return _num_cells_series*_cell_voltage; }
 double voltage_t::battery_voltage_nominal(){ return _num_cells_series * _cell_voltage_nominal; }
 double voltage_t::cell_voltage(){ return _cell_voltage; }
@@ -721,6 +763,16 @@ void voltage_vanadium_redox_t::copy(voltage_t * voltage)
 	_F = tmp->_F;
 	_C0 = tmp->_C0;
 }
+void voltage_vanadium_redox_t::save_state(voltage_state &state)
+{
+	voltage_t::save_state(state);
+	state.I = _I;
+}
+void voltage_vanadium_redox_t::restore_state(const voltage_state &state)
+{
+	voltage_t::restore_state(state);
+	_I = state.I;
+}
 void voltage_vanadium_redox_t::updateVoltage(capacity_t * capacity, thermal_t * thermal, double )
 {
 
@@ -801,6 +853,22 @@ void lifetime_t::copy(lifetime_t * lifetime)
 	_replacement_scheduled = lifetime->_replacement_scheduled;
 	_q = lifetime->_q;
 }
+void lifetime_t::save_state(lifetime_state &state)
+{
+	_lifetime_cycle->save_state(state);
+	_lifetime_calendar->save_state(state);
+	state.replacements = _replacements;
+	state.replacement_scheduled = _replacement_scheduled;
+	state.q = _q;
+}
+void lifetime_t::restore_state(const lifetime_state &state)
+{
+	_lifetime_cycle->restore_state(state);
+	_lifetime_calendar->restore_state(state);
+	_replacements = state.replacements;
+	_replacement_scheduled = state.replacement_scheduled;
+	_q = state.q;
+}
 double lifetime_t::capacity_percent(){ return _q; }
 void lifetime_t::runLifetimeModels(size_t idx, capacity_t * capacity, double T_battery)
 {
@@ -866,6 +934,7 @@ lifetime_cycle_t::lifetime_cycle_t(const util::matrix_t<double> &batt_lifetime_m
 	_Ylt = 0;
 	_Range = 0;
 	_average_range = 0;
+	_Peaks.reserve(64);
 }
 
 lifetime_cycle_t::~lifetime_cycle_t(){}
@@ -891,6 +960,30 @@ void lifetime_cycle_t::copy(lifetime_cycle_t * lifetime_cycle)
 	_Range = lifetime_cycle->_Range;
 	_average_range = lifetime_cycle->_average_range;
 }
+void lifetime_cycle_t::save_state(lifetime_state &state)
+{
+	state.nCycles = _nCycles;
+	state.cycle_q = _q;
+	state.Dlt = _Dlt;
+	state.jlt = _jlt;
+	state.Xlt = _Xlt;
+	state.Ylt = _Ylt;
+	state.Peaks.assign(_Peaks.begin(), _Peaks.end());
+	state.Range = _Range;
+	state.average_range = _average_range;
+}
+void lifetime_cycle_t::restore_state(const lifetime_state &state)
+{
+	_nCycles = state.nCycles;
+	_q = state.cycle_q;
+	_Dlt = state.Dlt;
+	_jlt = state.jlt;
+	_Xlt = state.Xlt;
+	_Ylt = state.Ylt;
+	_Peaks.assign(state.Peaks.begin(), state.Peaks.end());
+	_Range = state.Range;
+	_average_range = state.average_range;
+}
 double lifetime_cycle_t::computeCycleDamageAtDOD(double DOD)
 {
 	if (DOD == 0)
@@ -907,97 +1000,47 @@ double lifetime_cycle_t::runCycleLifetime(double DOD)
 
 void lifetime_cycle_t::rainflow(double DOD)
 {
-	// initialize return code
-	int retCode = LT_GET_DATA;
-
-	// Begin algorithm
+	/*
+	Streaming rainflow count over the stack of unmatched reversals (_Peaks).
+	Each new reversal forms range X with the top of the stack, and Y is the range below it.
+	While X >= Y, Y is counted as a cycle and its two reversals are removed.
+	Ranges left on the stack are strictly decreasing, so the previous range always bounds Y
+	and the three-point test is equivalent to the four-point method once four points are available.
+	*/
 	_Peaks.push_back(DOD);
-	bool atStepTwo = true;
+	size_t n = _Peaks.size();
 
-	// Loop until break
-	while (atStepTwo)
+	while (n >= 3)
 	{
-		// Rainflow: Step 2: Form ranges X,Y
-		if (_jlt >= 2)
-			rainflow_ranges();
-		else
-		{
-			// Get more data (Step 1)
-			retCode = LT_GET_DATA;
-			break;
-		}
+		_Ylt = fabs(_Peaks[n - 2] - _Peaks[n - 3]);
+		_Xlt = fabs(_Peaks[n - 1] - _Peaks[n - 2]);
 
-		// Rainflow: Step 3: Compare ranges
-		retCode = rainflow_compareRanges();
-
-		// We break to get more data, or if we are done with step 5
-		if (retCode == LT_GET_DATA) 
+		// get more data
+		if (_Xlt < _Ylt)
 			break;
-	}
-
-	if (retCode == LT_GET_DATA)
-		_jlt++;
-}
 
-void lifetime_cycle_t::rainflow_ranges()
-{
-	_Ylt = fabs(_Peaks[_jlt - 1] - _Peaks[_jlt - 2]);
-	_Xlt = fabs(_Peaks[_jlt] - _Peaks[_jlt - 1]);
-}
-void lifetime_cycle_t::rainflow_ranges_circular(int index)
-{
-	size_t end = _Peaks.size() - 1;
-	if (index == 0)
-	{
-		_Xlt = fabs(_Peaks[0] - _Peaks[end]);
-		_Ylt = fabs(_Peaks[end] - _Peaks[end - 1]);
-	}
-	else if (index == 1)
-	{
-		_Xlt = fabs(_Peaks[1] - _Peaks[0]);
-		_Ylt = fabs(_Peaks[0] - _Peaks[end]);
+		// count range Y, discard peak & valley of Y
+		rainflow_countCycle(_Ylt);
+		_Peaks[n - 3] = _Peaks[n - 1];
+		n -= 2;
+		_Peaks.resize(n);
 	}
-	else
-		rainflow_ranges();
+	_jlt = (int)n;
 }
 
-int lifetime_cycle_t::rainflow_compareRanges()
+void lifetime_cycle_t::rainflow_countCycle(double range)
 {
-	int retCode = LT_SUCCESS;
-	bool contained = true;
-
-	// modified to disregard some of algorithm which doesn't work well
-	if (_Xlt < _Ylt)
-		retCode = LT_GET_DATA;
-	else if (_Xlt >= _Ylt)
-		contained = false;
+	_Range = range;
+	_average_range = (_average_range*_nCycles + _Range) / (_nCycles + 1);
+	_nCycles++;
 
-	// Step 5: Count range Y, discard peak & valley of Y, go to Step 2
-	if (!contained)
-	{
-		_Range = _Ylt;
-		_average_range = (_average_range*_nCycles + _Range) / (_nCycles + 1);		
-		_nCycles++;
+	// the capacity percent cannot increase
+	double q = bilinear(_average_range, _nCycles);
+	if (q <= _q)
+		_q = q;
 
-		// the capacity percent cannot increase
-		if (bilinear(_average_range, _nCycles) <= _q)
-			_q = bilinear(_average_range, _nCycles);
-
-		if (_q < 0)
-			_q = 0.;
-		
-		// discard peak & valley of Y
-		double save = _Peaks[_jlt]; 
-		_Peaks.pop_back(); 
-		_Peaks.pop_back();
-		_Peaks.pop_back();
-		_Peaks.push_back(save);
-		_jlt -= 2;
-		// stay in while loop
-		retCode = LT_RERANGE;
-	}
-
-	return retCode;
+	if (_q < 0)
+		_q = 0.;
 }
 void lifetime_cycle_t::replaceBattery()
 {
@@ -1208,6 +1251,22 @@ void lifetime_calendar_t::copy(lifetime_calendar_t * lifetime_calendar)
 	_b = lifetime_calendar->_b;
 	_c = lifetime_calendar->_c;
 }
+void lifetime_calendar_t::save_state(lifetime_state &state)
+{
+	state.day_age_of_battery = _day_age_of_battery;
+	state.calendar_last_idx = _last_idx;
+	state.calendar_q = _q;
+	state.dq_old = _dq_old;
+	state.dq_new = _dq_new;
+}
+void lifetime_calendar_t::restore_state(const lifetime_state &state)
+{
+	_day_age_of_battery = state.day_age_of_battery;
+	_last_idx = state.calendar_last_idx;
+	_q = state.calendar_q;
+	_dq_old = state.dq_old;
+	_dq_new = state.dq_new;
+}
 double lifetime_calendar_t::runLifetimeCalendarModel(size_t idx, double T, double SOC)
 {
 	if (_calendar_choice != lifetime_calendar_t::NONE)
@@ -1335,6 +1394,16 @@ void thermal_t::copy(thermal_t * thermal)
 	_capacity_percent = thermal->_capacity_percent;
 	_T_max = thermal->_T_max;
 }
+void thermal_t::save_state(thermal_state &state)
+{
+	state.T_battery = _T_battery;
+	state.capacity_percent = _capacity_percent;
+}
+void thermal_t::restore_state(const thermal_state &state)
+{
+	_T_battery = state.T_battery;
+	_capacity_percent = state.capacity_percent;
+}
 void thermal_t::replace_battery()
 { 
 	_T_battery = _T_room; 
@@ -1512,6 +1581,26 @@ void battery_t::copy(const battery_t * battery)
 	_last_idx = battery->_last_idx;
 }
 
+void battery_t::save_state(battery_state &state)
+{
+	_capacity->save_state(state.capacity);
+	_voltage->save_state(state.voltage);
+	_thermal->save_state(state.thermal);
+	_lifetime->save_state(state.lifetime);
+	state.losses_nCycle = _losses->save_state();
+	state.last_idx = _last_idx;
+}
+
+void battery_t::restore_state(const battery_state &state)
+{
+	_capacity->restore_state(state.capacity);
+	_voltage->restore_state(state.voltage);
+	_thermal->restore_state(state.thermal);
+	_lifetime->restore_state(state.lifetime);
+	_losses->restore_state(state.losses_nCycle);
+	_last_idx = state.last_idx;
+}
+
 void battery_t::delete_clone()
 {
 	if (_capacity) delete _capacity;
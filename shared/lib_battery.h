@@ -84,6 +84,57 @@ protected:
 	std::vector<int> count;
 };
 
+/*
+Time-varying state of the battery models, used to save and restore a battery while iterating on dispatch
+without copying the models.  Parameters which are fixed during the simulation are not included.
+*/
+struct capacity_state
+{
+	double q0, qmax, qmax_thermal, I, I_loss, SOC, DOD, DOD_prev;
+	bool chargeChange;
+	int prev_charge, charge;
+	double q1_0, q2_0; // KiBaM only
+};
+
+struct voltage_state
+{
+	double cell_voltage;
+	double I; // vanadium redox only
+};
+
+struct thermal_state
+{
+	double T_battery, capacity_percent;
+};
+
+struct lifetime_state
+{
+	// cycling
+	int nCycles, jlt;
+	double cycle_q, Dlt, Xlt, Ylt, Range, average_range;
+	std::vector<double> Peaks; // storage is reused when the same state object is saved to again
+
+	// calendar
+	int day_age_of_battery;
+	size_t calendar_last_idx;
+	double calendar_q, dq_old, dq_new;
+
+	// combined
+	int replacements;
+	bool replacement_scheduled;
+	double q;
+};
+
+struct battery_state
+{
+	capacity_state capacity;
+	voltage_state voltage;
+	thermal_state thermal;
+	lifetime_state lifetime;
+	int losses_nCycle;
+	size_t last_idx;
+};
+
 /*
 Base class from which capacity models derive
 Note, all capacity models are based on the capacity of one battery
@@ -102,6 +153,10 @@ public:
 	// shallow copy from capacity to this
 	virtual void copy(capacity_t *);
 
+	// save and restore the time-varying state
+	virtual void save_state(capacity_state &state);
+	virtual void restore_state(const capacity_state &state);
+
 	// virtual destructor
 	virtual ~capacity_t(){};
 	
@@ -170,6 +225,9 @@ public:
 	// copy from capacity to this
 	void copy(capacity_t *);
 
+	void save_state(capacity_state &state);
+	void restore_state(const capacity_state &state);
+
 	void updateCapacity(double &I, double dt);
 	void updateCapacityForThermal(double capacity_percent);
 	void updateCapacityForLifetime(double capacity_percent);
@@ -254,6 +312,9 @@ public:
 	// copy from voltage to this
 	virtual void copy(voltage_t *);
 
+	// save and restore the time-varying state
+	virtual void save_state(voltage_state &state);
+	virtual void restore_state(const voltage_state &state);
 
 	virtual ~voltage_t(){};
 
@@ -364,6 +425,9 @@ public:
 	// copy from voltage to this
 	void copy(voltage_t *);
 
+	void save_state(voltage_state &state);
+	void restore_state(const voltage_state &state);
+
 	void updateVoltage(capacity_t * capacity, thermal_t * thermal, double dt);
 
 protected:
@@ -398,6 +462,10 @@ public:
 	// copy from lifetime_cycle to this
 	void copy(lifetime_cycle_t *);
 
+	// save and restore the time-varying state
+	void save_state(lifetime_state &state);
+	void restore_state(const lifetime_state &state);
+
 	// return q, the effective capacity percent
 	double runCycleLifetime(double DOD);
 
@@ -411,9 +479,7 @@ public:
 
 protected:
 	
-	void rainflow_ranges();
-	void rainflow_ranges_circular(int index);
-	int rainflow_compareRanges();
+	void rainflow_countCycle(double range);
 	double bilinear(double DOD, int cycle_number);
 
 	util::matrix_t<double> _cycles_vs_DOD;
@@ -426,19 +492,12 @@ protected:
 	int _nCycles;
 	double _q;				// relative capacity %
 	double _Dlt;			// % damage according to rainflow
-	int _jlt;			    // last index in Peaks, i.e, if Peaks = [0,1], then _jlt = 1
+	int _jlt;			    // number of unmatched reversals in Peaks
 	double _Xlt;
 	double _Ylt;
-	std::vector<double> _Peaks;
+	std::vector<double> _Peaks;	// stack of unmatched reversals (rainflow residue)
 	double _Range;
 	double _average_range;
-
-	enum RETURN_CODES
-	{
-		LT_SUCCESS,
-		LT_GET_DATA,
-		LT_RERANGE
-	};
 };
 /*
 Lifetime calendar model
@@ -456,6 +515,10 @@ public:
 	// copy from lifetime_calendar to this
 	void copy(lifetime_calendar_t *);
 
+	// save and restore the time-varying state
+	void save_state(lifetime_state &state);
+	void restore_state(const lifetime_state &state);
+
 	/// Given the index of the simulation, the tempertature and SOC, return the effective capacity percent
 	double runLifetimeCalendarModel(size_t idx, double T, double SOC);
 
@@ -512,6 +575,10 @@ public:
 	// copy lifetime to this
 	void copy(lifetime_t *);
 
+	// save and restore the time-varying state, including the cycle and calendar models
+	void save_state(lifetime_state &state);
+	void restore_state(const lifetime_state &state);
+
 	void runLifetimeModels(size_t idx, capacity_t *, double T_battery);
 
 	double capacity_percent();
@@ -558,6 +625,10 @@ public:
 	// copy thermal to this
 	void copy(thermal_t *);
 
+	// save and restore the time-varying state
+	void save_state(thermal_state &state);
+	void restore_state(const thermal_state &state);
+
 	void updateTemperature(double I, double R, double dt);
 	void replace_battery();
 
@@ -605,6 +676,10 @@ public:
 	// copy losses to this
 	void copy(losses_t *);
 
+	// save and restore the time-varying state
+	int save_state(){ return _nCycle; }
+	void restore_state(int nCycle){ _nCycle = nCycle; }
+
 	// main APIs
 	void run_losses(double dt_hour, size_t index);
 	void replace_battery();
@@ -642,6 +717,12 @@ public:
 	// copy members from battery to this
 	void copy(const battery_t * battery);
 
+	// save the time-varying state of all models, much cheaper than copy for rolling back a timestep
+	void save_state(battery_state &state);
+
+	// restore the state of all models from a previous save_state
+	void restore_state(const battery_state &state);
+
 	// virtual destructor, does nothing as no memory allocated in constructor
 	virtual ~battery_t();
 
@@ -50,6 +50,8 @@
 #include <algorithm>
 #include <numeric>
 
+#include "../lpsolve/lp_lib.h"
+
 /*
 Dispatch base class
 */
@@ -68,9 +70,9 @@ dispatch_t::dispatch_t(battery_t * Battery, double dt_hour, double SOC_min, doub
 	m_batteryPower->powerBatteryDischargeMax = Pd_max;
 	m_batteryPower->meterPosition = battMeterPosition;
 
-	// initalize Battery and a copy of the Battery for iteration
+	// initalize Battery and its saved state for iteration
 	_Battery = Battery;
-	_Battery_initial = new battery_t(*_Battery);
+	_Battery->save_state(_Battery_state);
 
 	// Call the dispatch init method
 	init(_Battery, dt_hour, current_choice, t_min, mode);
@@ -114,7 +116,7 @@ dispatch_t::dispatch_t(const dispatch_t& dispatch)
 	m_batteryPower = m_batteryPowerFlow->getBatteryPower();
 
 	_Battery = new battery_t(*dispatch._Battery);
-	_Battery_initial = new battery_t(*dispatch._Battery_initial);
+	_Battery_state = dispatch._Battery_state;
 	init(_Battery, dispatch._dt_hour, dispatch._current_choice, dispatch._t_min, dispatch._mode);
 }
 
@@ -122,7 +124,7 @@ dispatch_t::dispatch_t(const dispatch_t& dispatch)
 void dispatch_t::copy(const dispatch_t * dispatch)
 {
 	_Battery->copy(dispatch->_Battery);
-	_Battery_initial->copy(dispatch->_Battery_initial);
+	_Battery_state = dispatch->_Battery_state;
 	init(_Battery, dispatch->_dt_hour,  dispatch->_current_choice, dispatch->_t_min, dispatch->_mode);
 
 	// can't create shallow copy of unique ptr
@@ -132,15 +134,12 @@ void dispatch_t::copy(const dispatch_t * dispatch)
 }
 void dispatch_t::delete_clone()
 {
-	// need to delete both, since allocated memory for both in deep copy 
+	// allocated memory in deep copy 
 	if (_Battery) delete _Battery;
-	if (_Battery_initial) delete _Battery_initial;
 }
 dispatch_t::~dispatch_t()
 {
 	// original _Battery doesn't need deleted, since was a pointer passed in
-	_Battery_initial->delete_clone();
-	delete _Battery_initial;
 }
 bool dispatch_t::check_constraints(double &I, size_t count)
 {
@@ -198,7 +197,7 @@ bool dispatch_t::check_constraints(double &I, size_t count)
 	// reset
 	if (iterate)
 	{
-		_Battery->copy(_Battery_initial);
+		_Battery->restore_state(_Battery_state);
 		m_batteryPower->powerBattery = 0;
 		m_batteryPower->powerGridToBattery = 0;
 		m_batteryPower->powerBatteryToGrid = 0;
@@ -329,7 +328,7 @@ void dispatch_t::runDispatch(size_t year, size_t hour_of_year, size_t step)
 	double I = current_controller(_Battery->battery_voltage_nominal());
 
 	// Setup battery iteration
-	_Battery_initial->copy(_Battery);
+	_Battery->save_state(_Battery_state);
 	bool iterate = true;
 	size_t count = 0;
 	size_t idx = util::index_year_hour_step(year, hour_of_year, step, static_cast<size_t>(1 / _dt_hour));
@@ -527,7 +526,7 @@ bool dispatch_manual_t::check_constraints(double &I, size_t count)
 		// reset
 		if (iterate)
 		{
-			_Battery->copy(_Battery_initial);
+			_Battery->restore_state(_Battery_state);
 			m_batteryPower->powerBattery = 0;
 			m_batteryPower->powerGridToBattery = 0;
 			m_batteryPower->powerBatteryToGrid = 0;
@@ -760,7 +759,7 @@ bool dispatch_automatic_t::check_constraints(double &I, size_t count)
 		// reset
 		if (iterate)
 		{
-			_Battery->copy(_Battery_initial);
+			_Battery->restore_state(_Battery_state);
 			m_batteryPower->powerBattery = 0;
 			m_batteryPower->powerGridToBattery = 0;
 			m_batteryPower->powerBatteryToGrid = 0;
@@ -1007,96 +1006,73 @@ void dispatch_automatic_behind_the_meter_t::target_power(FILE*p, bool debug, dou
 	// otherwise, compute one target for the next 24 hours.
 	else
 	{
-		// First compute target power which will allow battery to charge up to E_useful over 24 hour period
-		if (debug)
-			fprintf(p, "Index\tRecharge_target\t charge_energy\n");
-
-		double P_target = sorted_grid[0].Grid();
-		double P_target_min = 1e16;
-		double E_charge = 0.;
-		int index = (int)_num_steps - 1;
-		std::vector<double> E_charge_vec;
-		for (int jj = (int)_num_steps - 1; jj >= 0; jj--)
-		{
-			E_charge = 0.;
-			P_target_min = sorted_grid[index].Grid();
-
-			for (int ii = (int)_num_steps - 1; ii >= 0; ii--)
-			{
-				if (sorted_grid[ii].Grid() > P_target_min)
-					break;
-
-				E_charge += (P_target_min - sorted_grid[ii].Grid())*_dt_hour;
-			}
-			E_charge_vec.push_back(E_charge);
-			if (debug)
-				fprintf(p, "%u: index\t%.3f\t %.3f\n", index, P_target_min, E_charge);
-			index--;
+		/*
+		The energy shaved above a target grows as the target drops down the sorted profile,
+		while the energy available to recharge below it shrinks, so the first step at which
+		the shaved energy exceeds either the recharge energy or E_useful is found by bisection.
+		*/
+		size_t n = _num_steps;
 
-			if (index < 0)
-				break;
+		// cumulative energy shaved by lowering the target to each sorted power [kWh]
+		double sum = 0;
+		_E_shave.resize(n - 1);
+		for (size_t ii = 0; ii != n - 1; ii++)
+		{
+			double diff = sorted_grid[ii].Grid() - sorted_grid[ii + 1].Grid();
+			if (diff != 0)
+				sum += diff * (ii + 1)*_dt_hour;
+			_E_shave[ii] = sum;
 		}
-		std::reverse(E_charge_vec.begin(), E_charge_vec.end());
-
-		// Calculate target power 
-		std::vector<double> sorted_grid_diff;
-		sorted_grid_diff.reserve(_num_steps - 1);
-
-		for (size_t ii = 0; ii != _num_steps - 1; ii++)
-			sorted_grid_diff.push_back(sorted_grid[ii].Grid() - sorted_grid[ii + 1].Grid());
-
-		P_target = sorted_grid[0].Grid(); // target power to shave to [kW]
-		double sum = 0;			   // energy [kWh];
-		if (debug)
-			fprintf(p, "Step\tTarget_Power\tEnergy_Sum\tEnergy_charged\n");
 
-		for (size_t ii = 0; ii != _num_steps - 1; ii++)
+		// don't look at negative grid power
+		size_t ii_end = n - 1;
+		for (size_t lo = 0, hi = n - 1; lo < hi;)
 		{
-			// don't look at negative grid power
-			if (sorted_grid[ii + 1].Grid() < 0)
-				break;
-			// Update power target
+			size_t mid = (lo + hi) / 2;
+			if (sorted_grid[mid + 1].Grid() < 0)
+				ii_end = hi = mid;
 			else
-				P_target = sorted_grid[ii + 1].Grid();
-
-			if (debug)
-				fprintf(p, "%lu\t %.3f\t", ii, P_target);
+				lo = mid + 1;
+		}
 
-			// implies a repeated power
-			if (sorted_grid_diff[ii] == 0)
-			{
-				if (debug)
-					fprintf(p, "\n");
-				continue;
-			}
-			// add to energy we are trimming
+		// first step where we have limited power or would exceed one cycle per day
+		size_t lo = 0, hi = ii_end;
+		while (lo < hi)
+		{
+			size_t mid = (lo + hi) / 2;
+			if (_E_shave[mid] > compute_charge_energy(mid + 1) || _E_shave[mid] > E_useful)
+				hi = mid;
 			else
-				sum += sorted_grid_diff[ii] * (ii + 1)*_dt_hour;
+				lo = mid + 1;
+		}
 
-			if (debug)
-				fprintf(p, "%.3f\t%.3f\n", sum, E_charge_vec[ii + 1]);
+		// repeated powers don't add energy, so the target is set at the next distinct power
+		while (lo < ii_end && sorted_grid[lo].Grid() == sorted_grid[lo + 1].Grid())
+			lo++;
+
+		double P_target = sorted_grid[lo < ii_end ? lo + 1 : ii_end].Grid(); // target power to shave to [kW]
+		if (lo < ii_end)
+		{
+			sum = _E_shave[lo];
+			double E_charge = compute_charge_energy(lo + 1);
 
-			if (sum < E_charge_vec[ii + 1] && sum < E_useful)
-				continue;
 			// we have limited power, we'll shave what more we can
-			else if (sum > E_charge_vec[ii + 1])
+			if (sum > E_charge)
 			{
-				P_target += (sum - E_charge_vec[ii]) / ((ii + 1)*_dt_hour);
-				sum = E_charge_vec[ii];
-				if (debug)
-					fprintf(p, "%lu\t %.3f\t%.3f\t%.3f\n", ii, P_target, sum, E_charge_vec[ii]);
-				break;
+				E_charge = compute_charge_energy(lo);
+				P_target += (sum - E_charge) / ((lo + 1)*_dt_hour);
+				sum = E_charge;
 			}
 			// only allow one cycle per day
-			else if (sum > E_useful)
+			else
 			{
-				P_target += (sum - E_useful) / ((ii + 1)*_dt_hour);
+				P_target += (sum - E_useful) / ((lo + 1)*_dt_hour);
 				sum = E_useful;
-				if (debug)
-					fprintf(p, "%lu\t %.3f\t%.3f\t%.3f\n", ii, P_target, sum, E_charge_vec[ii]);
-				break;
 			}
 		}
+		if (debug)
+			fprintf(p, "Step\tTarget_Power\tEnergy_Sum\n%zu\t %.3f\t%.3f\n", lo, P_target, sum);
+
 		// set safety factor in case voltage differences make it impossible to achieve target without violated minimum SOC
 		P_target *= (1 + _safety_factor);
 
@@ -1116,6 +1092,21 @@ void dispatch_automatic_behind_the_meter_t::target_power(FILE*p, bool debug, dou
 	}
 }
 
+double dispatch_automatic_behind_the_meter_t::compute_charge_energy(size_t index)
+{
+	// energy available to recharge below the sorted grid power at index [kWh]
+	double P_target_min = sorted_grid[index].Grid();
+	double E_charge = 0.;
+	for (int ii = (int)_num_steps - 1; ii >= 0; ii--)
+	{
+		if (sorted_grid[ii].Grid() > P_target_min)
+			break;
+
+		E_charge += (P_target_min - sorted_grid[ii].Grid())*_dt_hour;
+	}
+	return E_charge;
+}
+
 void dispatch_automatic_behind_the_meter_t::set_battery_power(FILE *p, bool debug)
 {
 	for (size_t i = 0; i != _P_target_use.size(); i++)
@@ -1128,6 +1119,107 @@ void dispatch_automatic_behind_the_meter_t::set_battery_power(FILE *p, bool debu
 	}
 }
 
+dispatch_lp_t::dispatch_lp_t(size_t nsteps, double dt_hour, double P_charge_max, double P_discharge_max,
+	double eta_pv_charge, double eta_grid_charge, double eta_discharge)
+{
+	m_nsteps = nsteps;
+	m_dt_hour = dt_hour;
+	m_P_charge_max = P_charge_max;
+	m_P_discharge_max = P_discharge_max;
+	m_eta_pv_charge = eta_pv_charge;
+	m_eta_grid_charge = eta_grid_charge;
+	m_eta_discharge = eta_discharge;
+
+	int ncols = (int)(m_nsteps * NCOLUMNS);
+	m_objective.assign(ncols + 1, 0.);
+	m_solution.assign(ncols, 0.);
+
+	m_lp = make_lp(0, ncols);
+	set_verbose(m_lp, NEUTRAL);
+	set_add_rowmode(m_lp, TRUE);
+
+	int cols[6];
+	double row[6];
+	for (size_t t = 0; t != m_nsteps; t++)
+	{
+		// energy balance, the stored energy before the horizon is on the right-hand side of the first row
+		int n = 0;
+		cols[n] = column(t, ENERGY); row[n++] = 1.;
+		if (t > 0) {
+			cols[n] = column(t - 1, ENERGY); row[n++] = -1.;
+		}
+		cols[n] = column(t, CLIP_CHARGE); row[n++] = -m_dt_hour * m_eta_pv_charge;
+		cols[n] = column(t, PV_CHARGE); row[n++] = -m_dt_hour * m_eta_pv_charge;
+		cols[n] = column(t, GRID_CHARGE); row[n++] = -m_dt_hour * m_eta_grid_charge;
+		cols[n] = column(t, DISCHARGE); row[n++] = m_dt_hour;
+		add_constraintex(m_lp, n, row, cols, EQ, 0.);
+
+		// charge power limit
+		n = 0;
+		cols[n] = column(t, CLIP_CHARGE); row[n++] = 1.;
+		cols[n] = column(t, PV_CHARGE); row[n++] = 1.;
+		cols[n] = column(t, GRID_CHARGE); row[n++] = 1.;
+		add_constraintex(m_lp, n, row, cols, LE, m_P_charge_max);
+
+		// discharge limited by inverter capacity not used by PV, which PV charging frees up
+		n = 0;
+		cols[n] = column(t, DISCHARGE); row[n++] = 1.;
+		cols[n] = column(t, PV_CHARGE); row[n++] = -1.;
+		add_constraintex(m_lp, n, row, cols, LE, 0.);
+	}
+
+	// don't end the horizon with less energy than at the start
+	cols[0] = column(m_nsteps - 1, ENERGY); row[0] = 1.;
+	add_constraintex(m_lp, 1, row, cols, GE, 0.);
+
+	set_add_rowmode(m_lp, FALSE);
+	set_minim(m_lp);
+
+	for (size_t t = 0; t != m_nsteps; t++)
+		set_upbo(m_lp, column(t, DISCHARGE), m_P_discharge_max);
+}
+
+dispatch_lp_t::~dispatch_lp_t()
+{
+	if (m_lp)
+		delete_lp(m_lp);
+}
+
+bool dispatch_lp_t::solve(const double * P_pv, const double * P_clipped, const double * P_headroom,
+	const double * price_sell, const double * price_buy, double cycle_cost,
+	bool can_pv_charge, bool can_clip_charge, bool can_grid_charge,
+	double E_max, double E_initial, double * P_battery)
+{
+	for (size_t t = 0; t != m_nsteps; t++)
+	{
+		set_upbo(m_lp, column(t, CLIP_CHARGE), can_clip_charge ? std::fmax(0., P_clipped[t]) : 0.);
+		set_upbo(m_lp, column(t, PV_CHARGE), can_pv_charge ? std::fmax(0., P_pv[t]) : 0.);
+		set_upbo(m_lp, column(t, GRID_CHARGE), can_grid_charge ? m_P_charge_max : 0.);
+		set_upbo(m_lp, column(t, ENERGY), E_max);
+		set_rh(m_lp, (int)(3 * t + 3), std::fmax(0., P_headroom[t]));
+
+		// minimize the cost of charging (purchases and PV sales given up) less the revenue from discharging
+		m_objective[column(t, PV_CHARGE)] = m_dt_hour * price_sell[t];
+		m_objective[column(t, GRID_CHARGE)] = m_dt_hour * price_buy[t];
+		m_objective[column(t, DISCHARGE)] = -m_dt_hour * (price_sell[t] * m_eta_discharge - cycle_cost);
+	}
+	set_rh(m_lp, 1, E_initial);
+	set_rh(m_lp, (int)(3 * m_nsteps + 1), E_initial);
+	set_obj_fn(m_lp, &m_objective[0]);
+
+	int ret = ::solve(m_lp);
+	if (ret != OPTIMAL && ret != SUBOPTIMAL)
+		return false;
+
+	get_variables(m_lp, &m_solution[0]);
+	for (size_t t = 0; t != m_nsteps; t++)
+	{
+		double P_charge = m_solution[column(t, CLIP_CHARGE) - 1] + m_solution[column(t, PV_CHARGE) - 1] + m_solution[column(t, GRID_CHARGE) - 1];
+		P_battery[t] = m_solution[column(t, DISCHARGE) - 1] - P_charge;
+	}
+	return true;
+}
+
 dispatch_automatic_front_of_meter_t::dispatch_automatic_front_of_meter_t(
 	battery_t * Battery,
 	double dt_hour,
@@ -1197,6 +1289,7 @@ void dispatch_automatic_front_of_meter_t::init_with_pointer(const dispatch_autom
 	m_etaPVCharge = tmp->m_etaPVCharge;
 	m_etaGridCharge = tmp->m_etaGridCharge;
 	m_etaDischarge = tmp->m_etaDischarge;
+	m_dispatchLP = tmp->m_dispatchLP;
 }
 
 void dispatch_automatic_front_of_meter_t::setup_cost_vector(util::matrix_t<size_t> ppa_weekday_schedule, util::matrix_t<size_t> ppa_weekend_schedule)
@@ -1263,7 +1356,11 @@ void dispatch_automatic_front_of_meter_t::update_dispatch(size_t hour_of_year, s
 	m_batteryPower->powerBattery = 0;
 	m_batteryPower->powerBatteryTarget = 0;
 
-	if (_mode != dispatch_t::FOM_CUSTOM_DISPATCH)
+	if (_mode == dispatch_t::FOM_OPTIMAL)
+	{
+		update_dispatch_optimal(idx);
+	}
+	else if (_mode != dispatch_t::FOM_CUSTOM_DISPATCH)
 	{
 
 		// Power to charge (<0) or discharge (>0)
@@ -1372,6 +1469,62 @@ void dispatch_automatic_front_of_meter_t::update_dispatch(size_t hour_of_year, s
 	m_batteryPower->powerBattery = m_batteryPower->powerBatteryTarget;
 }
 
+void dispatch_automatic_front_of_meter_t::update_dispatch_optimal(size_t idx)
+{
+	size_t nsteps = _look_ahead_hours * _steps_per_hour;
+	if (!m_dispatchLP || m_dispatchLP->nsteps() != nsteps)
+	{
+		std::shared_ptr<dispatch_lp_t> tmp(new dispatch_lp_t(nsteps, _dt_hour,
+			m_batteryPower->powerBatteryChargeMax, m_batteryPower->powerBatteryDischargeMax,
+			m_etaPVCharge, m_etaGridCharge, m_etaDischarge));
+		m_dispatchLP = tmp;
+	}
+
+	if (idx == _index_last_updated + _d_index_update || idx == 0)
+	{
+		if (idx > 0) {
+			_index_last_updated += _d_index_update;
+		}
+
+		/*! Cost to cycle the battery at all, using maximum DOD or user input */
+		costToCycle();
+
+		// forecast and prices over the horizon
+		std::vector<double> P_pv(nsteps), P_clipped(nsteps), P_headroom(nsteps), price_sell(nsteps), price_buy(nsteps);
+		for (size_t t = 0; t != nsteps; t++)
+		{
+			size_t i = idx + t;
+			size_t hour_of_year = (i / _steps_per_hour) % 8760;
+
+			P_clipped[t] = i < _P_cliploss_dc.size() ? _P_cliploss_dc[i] : 0.;
+			P_pv[t] = i < _P_pv_dc.size() ? std::fmax(0., _P_pv_dc[i] - P_clipped[t]) : 0.;
+			P_headroom[t] = std::fmax(0., _inverter_paco - P_pv[t]);
+
+			price_sell[t] = _ppa_cost_vector[hour_of_year];
+			price_buy[t] = price_sell[t];
+			if (m_utilityRateCalculator) {
+				price_buy[t] = m_utilityRateCalculator->getEnergyRate(hour_of_year);
+			}
+		}
+
+		// usable energy between the SOC limits [kWh]
+		double E_max = _Battery->battery_voltage() * _Battery->battery_charge_maximum() * (m_batteryPower->stateOfChargeMax - m_batteryPower->stateOfChargeMin) * 0.01 * util::watt_to_kilowatt;
+		double E_initial = std::fmin(E_max, std::fmax(0., E_max - _Battery->battery_energy_to_fill(m_batteryPower->stateOfChargeMax)));
+
+		_P_battery_use.resize(nsteps);
+		if (!m_dispatchLP->solve(&P_pv[0], &P_clipped[0], &P_headroom[0], &price_sell[0], &price_buy[0], m_cycleCost,
+			m_batteryPower->canPVCharge, m_batteryPower->canClipCharge, m_batteryPower->canGridCharge,
+			E_max, E_initial, &_P_battery_use[0]))
+		{
+			std::fill(_P_battery_use.begin(), _P_battery_use.end(), 0.);
+		}
+	}
+
+	size_t step = idx - _index_last_updated;
+	if (step < _P_battery_use.size())
+		m_batteryPower->powerBatteryTarget = _P_battery_use[step];
+}
+
 void dispatch_automatic_front_of_meter_t::update_cliploss_data(double_vec P_cliploss)
 {
 	_P_cliploss_dc = P_cliploss;
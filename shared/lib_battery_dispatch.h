@@ -68,7 +68,7 @@ class dispatch_t
 {
 public:
 
-	enum FOM_MODES { FOM_LOOK_AHEAD, FOM_LOOK_BEHIND, FOM_FORECAST, FOM_CUSTOM_DISPATCH, FOM_MANUAL };
+	enum FOM_MODES { FOM_LOOK_AHEAD, FOM_LOOK_BEHIND, FOM_FORECAST, FOM_CUSTOM_DISPATCH, FOM_MANUAL, FOM_OPTIMAL };
 	enum BTM_MODES { LOOK_AHEAD, LOOK_BEHIND, MAINTAIN_TARGET, CUSTOM_DISPATCH, MANUAL };
 	enum METERING { BEHIND, FRONT };
 	enum PV_PRIORITY { MEET_LOAD, CHARGE_BATTERY };
@@ -169,14 +169,14 @@ protected:
 	bool restrict_power(double &I);
 
 	battery_t * _Battery;
-	battery_t * _Battery_initial;
+	battery_state _Battery_state;  // battery state at the start of the step, restored while iterating on constraints
 
 	double _dt_hour;
 
 	/** 
 	The dispatch mode. 
 	For behind-the-meter dispatch: 0 = LOOK_AHEAD, 1 = LOOK_BEHIND, 2 = MAINTAIN_TARGET, 3 = MANUAL
-	For front-of-meter dispatch: 0 = LOOK_AHEAD, 1 = LOOK_BEHIND, 2 = INPUT FORECAST, 3 = MANUAL
+	For front-of-meter dispatch: 0 = LOOK_AHEAD, 1 = LOOK_BEHIND, 2 = INPUT FORECAST, 3 = CUSTOM, 4 = MANUAL, 5 = OPTIMAL
 	*/
 	int _mode; 
 
@@ -499,6 +499,7 @@ protected:
 	void sort_grid(FILE *p, bool debug, size_t idx);
 	void compute_energy(FILE *p, bool debug, double & E_max);
 	void target_power(FILE*p, bool debug, double E_max, size_t idx);
+	double compute_charge_energy(size_t index);
 	void set_battery_power(FILE *p, bool debug);
 	void check_new_month(size_t hour_of_year, size_t step);
 
@@ -522,6 +523,60 @@ protected:
 
 	/* Vector of length (24 hours * steps_per_hour) containing sorted grid calculation [P_grid, hour, step] */
 	grid_vec sorted_grid;
+
+	/* Cumulative energy shaved as the target is lowered through sorted_grid [kWh] */
+	double_vec _E_shave;
+};
+
+typedef struct _lprec lprec;
+
+/*! Linear program for front-of-meter battery dispatch over a fixed look-ahead horizon */
+class dispatch_lp_t
+{
+	/**
+	The lp_solve model is built once for the horizon length. Each solve only updates the column bounds,
+	constraint right-hand sides and objective, so lp_solve starts from the basis of the previous horizon.
+
+	Columns per step: charge from clipped PV, charge from PV, charge from grid, discharge [kW], stored energy above minimum SOC [kWh]
+	Rows per step: energy balance, charge power limit, inverter headroom for discharge
+	The stored energy at the end of the horizon may not be less than at the start.
+	*/
+public:
+	dispatch_lp_t(size_t nsteps, double dt_hour, double P_charge_max, double P_discharge_max,
+		double eta_pv_charge, double eta_grid_charge, double eta_discharge);
+
+	~dispatch_lp_t();
+
+	/*! Solve the horizon, return false if lp_solve did not find a solution.
+		P_pv: PV power that can be sold [kW], P_clipped: PV power lost to clipping [kW], P_headroom: inverter capacity not used by PV [kW]
+		price_sell, price_buy: [$/kWh], cycle_cost: [$/kWh discharged], E_max, E_initial: usable and stored energy [kWh]
+		P_battery: battery power for each step, > 0 discharging [kW] */
+	bool solve(const double * P_pv, const double * P_clipped, const double * P_headroom,
+		const double * price_sell, const double * price_buy, double cycle_cost,
+		bool can_pv_charge, bool can_clip_charge, bool can_grid_charge,
+		double E_max, double E_initial, double * P_battery);
+
+	/*! Number of steps in the horizon */
+	size_t nsteps() { return m_nsteps; }
+
+protected:
+
+	enum COLUMNS { CLIP_CHARGE, PV_CHARGE, GRID_CHARGE, DISCHARGE, ENERGY, NCOLUMNS };
+
+	/*! lp_solve column (1-based) for variable at step t */
+	int column(size_t t, int var) { return (int)(t * NCOLUMNS + var + 1); }
+
+	lprec * m_lp;
+	size_t m_nsteps;
+	double m_dt_hour;
+	double m_P_charge_max;
+	double m_P_discharge_max;
+	double m_eta_pv_charge;
+	double m_eta_grid_charge;
+	double m_eta_discharge;
+
+	std::vector<double> m_objective;
+	std::vector<double> m_solution;
 };
 
 /*! Automated Front of Meter DC-connected battery dispatch */
@@ -535,6 +590,7 @@ public:
 	 2. Charging from the grid during times of low electricity buy-rates (if grid charging allowed)
 	 3. Charging from the PV array during times of low PPA sell rates
 	 4. Charging from the PV array during times where the PV power would be clipped due to inverter limits (if DC-connected)
+	 In the OPTIMAL mode, the same revenue is maximized over each look-ahead horizon with a linear program (dispatch_lp_t)
 	*/
 	dispatch_automatic_front_of_meter_t(
 		battery_t * Battery,
@@ -594,6 +650,9 @@ public:
 	/*! Calculate the cost to cycle */
 	void costToCycle();
 
+	/*! Solve the linear program for the battery power over the look-ahead horizon starting at idx */
+	void update_dispatch_optimal(size_t idx);
+
 	/*! Return the calculated cost to cycle ($/cycle)*/
 	double cost_to_cycle() { return m_cycleCost; }
 
@@ -626,6 +685,9 @@ protected:
 	double m_etaPVCharge;
 	double m_etaGridCharge;
 	double m_etaDischarge;
+
+	/*! Optimal dispatch model, shared by copies since only the solver workspace is kept */
+	std::shared_ptr<dispatch_lp_t> m_dispatchLP;
 };
 
 /*! Battery metrics class */
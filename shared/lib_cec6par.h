@@ -114,6 +114,7 @@ public:
 	double TbackInteg;  // back surface temperature for integrated modules ('C)
 	
 	virtual bool operator() ( pvinput_t &input, pvmodule_t &module, double opvoltage, double &Tcell );
+	virtual bool depends_on_voltage() { return true; }
 };
 
 #endif
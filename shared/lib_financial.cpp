@@ -48,6 +48,8 @@
 *******************************************************************************************************/
 
 #include <math.h>
+#include <float.h>
+#include <cmath>
 #include <limits>
 #include "lib_financial.h"
 
@@ -61,32 +63,75 @@ static bool is_valid_iter_bound(double estimatedReturnRate)
 	return estimatedReturnRate != -1 && (estimatedReturnRate < std::numeric_limits<int>::max()) && (estimatedReturnRate > std::numeric_limits<int>::min());
 }
 
-static double irr_poly_sum(double estimatedReturnRate, const std::vector<double> &CashFlows, int Count)
+/* one Horner pass in v = 1/(1+r) over years 0..count gives the present value and its
+   derivative with respect to r together, without a pow per year */
+static bool irr_npv_and_derivative(const double *line, int count, double rate, double &npv, double &dnpv)
 {
-    double sumOfPolynomial = 0;
-    if (is_valid_iter_bound(estimatedReturnRate))
+	if (!(rate > -1.0) || !is_valid_iter_bound(rate))
+		return false;
+
+	double v = 1.0/(1.0+rate);
+	double p = line[count];
+	double dp = 0;
+	for (int i = count-1; i >= 0; i--)
 	{
-		for (int j = 0; j < Count && j<(int)CashFlows.size(); j++)
-        {
-			double val = (pow((1 + estimatedReturnRate), j));
-			if (val != 0.0)
-				sumOfPolynomial += CashFlows[j]/val;
-			else
-				break;
-        }
+		dp = dp*v + p;
+		p = p*v + line[i];
 	}
-    return sumOfPolynomial;
+	npv = p;
+	dnpv = -dp*v*v;
+	return std::isfinite(npv) && std::isfinite(dnpv);
 }
 
-static double irr_derivative_sum(double estimatedReturnRate, const std::vector<double> &CashFlows, int Count)
+/* Newton from guess, safeguarded by bisection once rates with positive and negative npv are
+   known (bracket holds such a pair when the caller already has one).  rate is the last iterate;
+   a root where npv rises with the rate is not an irr and is reported as not converged */
+static int irr_solve(const double *line, int count, double guess, double tolerance, int max_iterations, double scale_factor, const double *bracket, double &rate)
 {
-    double sumOfDerivative = 0;
-    if (is_valid_iter_bound(estimatedReturnRate))
-		for (int i = 1; i < Count && i < (int)CashFlows.size(); i++)
-        {
-            sumOfDerivative += CashFlows[i]*(i)/pow((1 + estimatedReturnRate), i);
-        }
-    return sumOfDerivative*-1;
+	double pos = 0, neg = 0;
+	bool have_pos = false, have_neg = false;
+	if (bracket)
+	{
+		pos = bracket[0];
+		neg = bracket[1];
+		have_pos = have_neg = true;
+	}
+
+	double r = guess;
+	rate = guess;
+	for (int iteration = 0; iteration < max_iterations; iteration++)
+	{
+		double f, df;
+		if (!irr_npv_and_derivative(line, count, r, f, df))
+		{
+			if (!(have_pos && have_neg))
+				return libfin::IRR_NOT_CONVERGED;
+			r = 0.5*(pos+neg);
+			continue;
+		}
+
+		rate = r;
+		if (fabs(f/scale_factor) <= tolerance)
+			return (df < 0) ? libfin::IRR_SOLVED : libfin::IRR_NOT_CONVERGED;
+
+		if (f > 0) { pos = r; have_pos = true; }
+		else { neg = r; have_neg = true; }
+
+		double next = (df != 0) ? r - f/df : std::numeric_limits<double>::quiet_NaN();
+		if (have_pos && have_neg)
+		{
+			double lo = (pos < neg) ? pos : neg;
+			double hi = (pos < neg) ? neg : pos;
+			if (!(next > lo && next < hi))
+				next = 0.5*(lo+hi);
+		}
+		else if (!std::isfinite(next))
+			return libfin::IRR_NOT_CONVERGED;
+		else if (next <= -1.0)
+			next = 0.5*(r-1.0);
+		r = next;
+	}
+	return libfin::IRR_NOT_CONVERGED;
 }
 
 double libfin::irr(double tolerance, int maxIterations, const std::vector<double> &CashFlows, int Count)
@@ -97,33 +142,18 @@ double libfin::irr(double tolerance, int maxIterations, const std::vector<double
 		Messages.Add( "Cash flow for the first period  must be negative and there should");
     }
 */
-	int numberOfIterations=0;
 	double calculatedIRR=0;
 	double initialGuess = 0.1; // 10% is default used in Excel IRR function
 
 	if (CashFlows.size() < 3) 
 		return initialGuess;
 
+	if (Count > (int)CashFlows.size())
+		Count = (int)CashFlows.size();
+
     if ( (Count > 1) && (CashFlows[0] <= 0))
-    {
-		double deriv_sum = irr_derivative_sum(initialGuess,CashFlows,Count);
-		if (deriv_sum != 0)
-			calculatedIRR = initialGuess - irr_poly_sum(initialGuess,CashFlows,Count)/deriv_sum;
-		else
-			return initialGuess;
-
-		numberOfIterations++;
-		while (!(fabs(irr_poly_sum(calculatedIRR,CashFlows,Count)) <= tolerance) && (numberOfIterations < maxIterations))
-		{
-			deriv_sum = irr_derivative_sum(initialGuess,CashFlows,Count);
-			if (deriv_sum != 0.0)
-				calculatedIRR = calculatedIRR - irr_poly_sum(calculatedIRR,CashFlows,Count)/deriv_sum;
-			else
-				break;
+		irr_solve(&CashFlows[0], Count-1, initialGuess, tolerance, maxIterations, 1.0, 0, calculatedIRR);
 
-			numberOfIterations++;
-		}
-	}
     return calculatedIRR;
 }
 
@@ -154,6 +184,118 @@ double libfin::npv(double Rate, const std::vector<double> &CashFlows, int Count)
 	return result*rr; // assumes end of period payments!!
 }
 
+double libfin::cashflow_npv(const double *line, int nyears, double rate)
+{
+	double rr = 1.0;
+	if (rate != -1.0) rr = 1.0/(1.0+rate);
+	double result = 0;
+	for (int i=nyears;i>0;i--)
+		result = rr * result + line[i];
+
+	return result*rr;
+}
+
+static double cashflow_irr_scale_factor(const double *line, int count)
+{
+	// scale to max value for better irr convergence
+	if (count<1) return 1.0;
+	double max=fabs(line[0]);
+	for (int i=0;i<=count;i++) 
+		if (fabs(line[i])> max) max =fabs(line[i]);
+	return (max>0 ? max:1);
+}
+
+/* rates checked, in order, for npv falling from positive to negative when Newton does not converge from the guesses */
+static const double irr_scan_rates[] = { -0.99, -0.9, -0.75, -0.5, -0.3, -0.2, -0.1, -0.05, 0, 0.05, 0.1, 0.15, 0.2, 0.3, 0.5, 0.75, 1, 1.5, 2, 3, 5, 10, 100 };
+
+static int cashflow_irr_scan(const double *line, int count, double tolerance, int max_iterations, double scale_factor, double &rate)
+{
+	const int nscan = sizeof(irr_scan_rates)/sizeof(irr_scan_rates[0]);
+	int result = libfin::IRR_NO_SOLUTION;
+	double f_prev = 0, df;
+	bool have_prev = false;
+	for (int k = 0; k < nscan; k++)
+	{
+		double f;
+		if (!irr_npv_and_derivative(line, count, irr_scan_rates[k], f, df))
+		{
+			have_prev = false;
+			continue;
+		}
+		if (have_prev && f_prev > 0 && f <= 0)
+		{
+			double bracket[2] = { irr_scan_rates[k-1], irr_scan_rates[k] };
+			result = irr_solve(line, count, 0.5*(bracket[0]+bracket[1]), tolerance, max_iterations, scale_factor, bracket, rate);
+			if (result == libfin::IRR_SOLVED)
+				break;
+		}
+		f_prev = f;
+		have_prev = true;
+	}
+	return result;
+}
+
+double libfin::cashflow_irr(const double *line, int count, double initial_guess, double tolerance, int max_iterations, int *status)
+{
+	int result = IRR_NO_INVESTMENT;
+	double calculated_irr = std::numeric_limits<double>::quiet_NaN();
+
+	// leading zero years only scale the npv by a power of 1/(1+r), skip them so the npv
+	// does not approach zero at large rates
+	int first = 0;
+	while (first < count && line[first] == 0) first++;
+	line += first;
+	count -= first;
+
+	// only possible for first value negative
+	if ( (count >= 1) && (line[0] < 0))
+	{
+		// initial guess from http://zainco.blogspot.com/2008/08/internal-rate-of-return-using-newton.html
+		if ((initial_guess < -1) && (count > 1))// second order
+		{
+			if (line[0] !=0) 
+			{
+				double b = 2.0+ line[1]/line[0];
+				double c = 1.0+line[1]/line[0]+line[2]/line[0];
+				initial_guess = -0.5*b - 0.5*sqrt(b*b-4.0*c);
+				if ((initial_guess <= 0) || (initial_guess >= 1)) initial_guess = -0.5*b + 0.5*sqrt(b*b-4.0*c);
+			}
+		}
+		else if (initial_guess < 0) // first order
+		{
+			if (line[0] !=0) initial_guess = -(1.0 + line[1]/line[0]);
+		}
+
+		double scale_factor = cashflow_irr_scale_factor(line,count);
+
+		// Newton from the estimate, retried from 0.1, -0.1 and 0, then from a bracket
+		const double guess[4] = { initial_guess, 0.1, -0.1, 0 };
+		for (int k = 0; k < 4 && result != IRR_SOLVED; k++)
+			result = irr_solve(line,count,guess[k],tolerance,max_iterations,scale_factor,0,calculated_irr);
+		if (result != IRR_SOLVED)
+			result = cashflow_irr_scan(line,count,tolerance,max_iterations,scale_factor,calculated_irr);
+
+		if (result != IRR_SOLVED)
+			calculated_irr = std::numeric_limits<double>::quiet_NaN();
+	}
+	if (status) *status = result;
+	return calculated_irr;
+}
+
+double libfin::cashflow_min_value(const double *line, int nyears)
+{
+	// check for NaN
+	bool is_nan = true;
+	for (int i = 1; i <= nyears; i++)
+		is_nan &= std::isnan(line[i]);
+	if (is_nan) return std::numeric_limits<double>::quiet_NaN();
+
+	double min_value = DBL_MAX;
+	for (int i = 1; i <= nyears; i++)
+		if ((line[i]<min_value) && (line[i] != 0)) min_value = line[i];
+	return min_value;
+}
+
 double libfin::payback(const std::vector<double> &CumulativePayback, const std::vector<double> &Payback, int Count)
 {
 /*
@@ -58,6 +58,15 @@ double irr(double tolerance, int maxIterations, const std::vector<double> &CashF
 double npv(double Rate, const std::vector<double> &CashFlows, int Count);
 double payback(const std::vector<double> &CumulativePayback, const std::vector<double> &Payback, int Count);
 
+/* cashflow_irr status - irr is NaN unless solved */
+enum { IRR_SOLVED, IRR_NO_INVESTMENT, IRR_NO_SOLUTION, IRR_NOT_CONVERGED };
+
+/* cashflow line kernels shared by the financial compute modules - a line is the
+   contiguous years 0..nyears of one row of a cashflow matrix, year 0 undiscounted */
+double cashflow_npv(const double *line, int nyears, double rate);
+double cashflow_irr(const double *line, int count, double initial_guess=-2, double tolerance=1e-6, int max_iterations=100, int *status=0);
+double cashflow_min_value(const double *line, int nyears);
+
 double pow1pm1 (double x, double y);
 double pow1p (double x, double y); 
 double fvifa (double rate, double nper); 
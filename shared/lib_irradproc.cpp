@@ -1127,6 +1127,31 @@ int irrad::calc()
 	int code = check();
 	if ( code < 0 )
 		return -100+code;
+
+	calc_sunpos_internal();
+	return calc_surface_internal();
+}
+
+void irrad::calc_sunpos( irrad_sunpos &sunpos )
+{
+	calc_sunpos_internal();
+	for (int i = 0; i < 9; i++) sunpos.sun[i] = sun[i];
+	for (int i = 0; i < 3; i++) sunpos.tms[i] = tms[i];
+}
+
+int irrad::calc( const irrad_sunpos &sunpos )
+{
+	int code = check();
+	if ( code < 0 )
+		return -100+code;
+
+	for (int i = 0; i < 9; i++) sun[i] = sunpos.sun[i];
+	for (int i = 0; i < 3; i++) tms[i] = sunpos.tms[i];
+	return calc_surface_internal();
+}
+
+void irrad::calc_sunpos_internal()
+{
 /*
 	calculates effective sun position at current timestep, with delt specified in hours
 
@@ -1199,8 +1224,10 @@ int irrad::calc()
 		tms[1] = 0;
 		tms[2] = 0;
 	}
+}
 
-			
+int irrad::calc_surface_internal()
+{
 	poa[0]=poa[1]=poa[2] = 0;
 	diffc[0]=diffc[1]=diffc[2] = 0;
 	angle[0]=angle[1]=angle[2]=angle[3]=angle[4] = 0;
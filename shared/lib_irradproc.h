@@ -50,6 +50,8 @@
 #ifndef __irradproc_h
 #define __irradproc_h
 
+#include <vector>
+
 /* aug2011 - apd
 	solar position and radiation processing split out from pvwatts.
 	added isotropic sky model and hdkr model for diffuse on a tilted surface
@@ -89,6 +91,13 @@ double ModifiedDISC(const double g[3], const double z[3], double td, double alt,
 void ModifiedDISC(const double kt[3], const double kt1[3], const double g[3], const double z[3], double td, double alt, int doy, double &dn);
 
 
+// sun position results for one time step, see irrad::calc_sunpos
+struct irrad_sunpos
+{
+	double sun[9];
+	int tms[3];
+};
+
 class irrad
 {
 private:
@@ -111,6 +120,9 @@ private:
 
 	poaDecompReq* poaAll;
 
+	void calc_sunpos_internal();
+	int calc_surface_internal();
+
 public:
 
 	irrad();
@@ -133,6 +145,12 @@ public:
 	void set_sun_component(size_t index, double value);
 
 	int calc();
+
+	/// Calculate only the sun position for the current time and location, for sharing across several surfaces
+	void calc_sunpos( irrad_sunpos &sunpos );
+	/// Same as calc(), but uses a sun position from calc_sunpos() for the same time, location and time step instead of recalculating it
+	int calc( const irrad_sunpos &sunpos );
+
 	int calc_rear_side(double transmissionFactor, double bifaciality, double groundClearanceHeight, double slopeLength);
 	
 	void get_sun( double *solazi,
@@ -11,10 +11,6 @@ PVIOManager::PVIOManager(compute_module*  cm, std::string cmName)
 	std::unique_ptr<Simulation_IO> ptr2(new Simulation_IO(cm, *m_IrradianceIO));
 	m_SimulationIO = std::move(ptr2);
 
-	std::unique_ptr<ShadeDB8_mpp> shadeDatabase(new ShadeDB8_mpp());
-	m_shadeDatabase = std::move(shadeDatabase);
-	m_shadeDatabase->init();
-
 	std::unique_ptr<Inverter_IO> ptrInv(new Inverter_IO(cm, cmName));
 	m_InverterIO = std::move(ptrInv);
 
@@ -33,6 +29,20 @@ PVIOManager::PVIOManager(compute_module*  cm, std::string cmName)
 		}
 	}
 
+	// Shading database tables are shared across the process, only attach them if a subarray uses the database
+	std::unique_ptr<ShadeDB8_mpp> shadeDatabase(new ShadeDB8_mpp());
+	m_shadeDatabase = std::move(shadeDatabase);
+	for (size_t subarray = 0; subarray < m_SubarraysIO.size(); subarray++)
+	{
+		if (m_SubarraysIO[subarray]->enable && m_SubarraysIO[subarray]->shadeCalculator.use_shade_db())
+		{
+			m_shadeDatabase->init();
+			if (!m_shadeDatabase->get_error().empty())
+				throw compute_module::exec_error(cmName, "failed to load shading database: " + m_shadeDatabase->get_error());
+			break;
+		}
+	}
+
 	// Aggregate Subarray outputs in different structure
 	std::unique_ptr<PVSystem_IO> pvSystem(new PVSystem_IO(cm, cmName, m_SimulationIO.get(), m_IrradianceIO.get(), getSubarrays(), m_InverterIO.get()));
 	m_PVSystemIO = std::move(pvSystem);
@@ -191,6 +201,7 @@ Subarray_IO::Subarray_IO(compute_module* cm, std::string cmName, size_t subarray
 		monthlyTiltDegrees = cm->as_vector_double(prefix + "monthly_tilt");
 		backtrackingEnabled = cm->as_boolean(prefix + "backtrack");
 		moduleAspectRatio = cm->as_double("module_aspect_ratio");
+		selfShadingTiltStep = cm->as_double("selfshading_tilt_step");
 		usePOAFromWeatherFile = false;
 		dcLoss = (1 - cm->as_double(prefix + "mismatch_loss") / 100) *
 			(1 - cm->as_double(prefix + "diodeconn_loss") / 100) *
@@ -342,6 +342,8 @@ public:
 	int nStringsBottom;					/// Number of strings along bottom from self-shading
 	ssinputs selfShadingInputs;			/// Inputs and calculation methods for self-shading of the subarray
 	ssoutputs selfShadingOutputs;		/// Outputs for the self-shading of the subarray
+	sscache selfShadingCache;			/// Geometry terms of the self-shading calculation, cached over surface tilt
+	double selfShadingTiltStep;			/// Tilt resolution of the self-shading cache for trackers [deg], 0 = exact
 	shading_factor_calculator shadeCalculator; /// The shading calculator model for self-shading
 	pvsnowmodel snowModel;				/// The underlying snow model for this subarray
 
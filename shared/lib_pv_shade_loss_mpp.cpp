@@ -52,6 +52,15 @@
 #include <algorithm>    // std::sort
 #include <math.h> // logarithm function
 #include <cstring> // memcpy
+#include <cstdio>
+#include <mutex>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "lib_miniz.h" // decompression
 #include "DB8_vmpp_impp_uint8_bin.h" // char* of binary compressed file
@@ -67,7 +76,7 @@ typedef unsigned int uint;
 
 short ShadeDB8_mpp::get_vmpp(size_t i)
 {
-	if (i < 6045840) // uint16 check
+	if (p_vmpp && i < 6045840) // uint16 check
 		return (short)((p_vmpp[2 * i + 1] << 8) | p_vmpp[2 * i]); 
 	else 
 		return -1;
@@ -75,7 +84,7 @@ short ShadeDB8_mpp::get_vmpp(size_t i)
 
 short ShadeDB8_mpp::get_impp(size_t i)
 { 
-	if (i < 6045840) // uint16 check
+	if (p_impp && i < 6045840) // uint16 check
 		return (short)((p_impp[2 * i + 1] << 8) | p_impp[2 * i]); 
 	else 
 		return -1; 
@@ -184,54 +193,147 @@ std::vector<double> ShadeDB8_mpp::get_vector(const size_t &N, const size_t &d, c
 	return ret_vec;
 }
 
-void ShadeDB8_mpp::init()
+ShadeDB8_tables::ShadeDB8_tables()
 {
-	p_error_msg = "";
-	p_warning_msg = "";
-	p_vmpp_uint8_size = 12091680; // uint8 size from matlab
-	p_impp_uint8_size = 12091680; // uint8 size from matlab
-	p_vmpp = (unsigned char *)malloc(p_vmpp_uint8_size);//malloc(12091680); uint8 size
-	p_impp = (unsigned char *)malloc(p_impp_uint8_size);//malloc(12091680); uint8 size
-	p_compressed_size = 3133517; // from modified example5.c in miniz project
-	decompress_file_to_uint8();
+	p_data = NULL;
+	p_mapped = false;
 }
 
-ShadeDB8_mpp::~ShadeDB8_mpp()
+ShadeDB8_tables::~ShadeDB8_tables()
 {
-	if (p_vmpp)
-		free(p_vmpp);
-	if (p_impp)
-		free(p_impp);
+	if (!p_data)
+		return;
+#if !defined(_WIN32)
+	if (p_mapped)
+	{
+		munmap(p_data, vmpp_uint8_size + impp_uint8_size);
+		return;
+	}
+#endif
+	free(p_data);
 }
 
-
-
-bool ShadeDB8_mpp::decompress_file_to_uint8()
+std::shared_ptr<const ShadeDB8_tables> ShadeDB8_tables::instance(std::string *error)
 {
-	size_t status;
-	uint8 *pTmp_data;
-
-	size_t mem_size = p_vmpp_uint8_size + p_impp_uint8_size;
+	static std::mutex build_mutex;
+	static std::shared_ptr<const ShadeDB8_tables> tables;
 
-	pTmp_data = (uint8 *)malloc(mem_size);
+	std::lock_guard<std::mutex> lock(build_mutex);
+	if (tables)
+		return tables;
 
-	status = tinfl_decompress_mem_to_mem((void *)pTmp_data, mem_size, pCmp_data, p_compressed_size, TINFL_FLAG_PARSE_ZLIB_HEADER);
+	std::shared_ptr<ShadeDB8_tables> built(new ShadeDB8_tables());
+	std::string cache_path;
+	if (const char *env = getenv("SSC_SHADE_DB_CACHE"))
+		cache_path = env;
 
-	memcpy(p_vmpp, pTmp_data, p_vmpp_uint8_size);
-	memcpy(p_impp, pTmp_data + p_vmpp_uint8_size, p_impp_uint8_size);
+	if (cache_path.empty() || !built->map_cache_file(cache_path))
+	{
+		std::string msg;
+		if (!built->decompress(msg))
+		{
+			if (error) *error = msg;
+			return std::shared_ptr<const ShadeDB8_tables>();
+		}
+		if (!cache_path.empty())
+			built->write_cache_file(cache_path);
+	}
+	tables = built;
+	return tables;
+}
 
-	free(pTmp_data);
+bool ShadeDB8_tables::decompress(std::string &error)
+{
+	size_t mem_size = vmpp_uint8_size + impp_uint8_size;
+	p_data = (unsigned char *)malloc(mem_size);
+	p_mapped = false;
+	if (!p_data)
+	{
+		error = "unable to allocate memory for shading database";
+		return false;
+	}
 
+	// vmpp and impp are stored back to back in the compressed blob, inflate them in place
+	size_t status = tinfl_decompress_mem_to_mem((void *)p_data, mem_size, pCmp_data, compressed_size, TINFL_FLAG_PARSE_ZLIB_HEADER);
 	if (status == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED)
 	{
 		std::stringstream outm;
 		outm << "tinfl_decompress_mem_to_mem() failed with status " << (int)status;
-		p_error_msg = outm.str();
-		return EXIT_FAILURE;
+		error = outm.str();
+		free(p_data);
+		p_data = NULL;
+		return false;
 	}
+	return true;
+}
 
+bool ShadeDB8_tables::map_cache_file(const std::string &path)
+{
+	size_t mem_size = vmpp_uint8_size + impp_uint8_size;
+#if defined(_WIN32)
+	FILE *fp = fopen(path.c_str(), "rb");
+	if (!fp)
+		return false;
+	p_data = (unsigned char *)malloc(mem_size);
+	bool ok = p_data && fread(p_data, 1, mem_size, fp) == mem_size && fgetc(fp) == EOF;
+	fclose(fp);
+	if (!ok && p_data)
+	{
+		free(p_data);
+		p_data = NULL;
+	}
+	p_mapped = false;
+	return ok;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size != mem_size)
+	{
+		close(fd);
+		return false;
+	}
+	void *p = mmap(NULL, mem_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED)
+		return false;
+	p_data = (unsigned char *)p;
+	p_mapped = true;
 	return true;
-};
+#endif
+}
+
+void ShadeDB8_tables::write_cache_file(const std::string &path)
+{
+	// write to a temporary file first so that a concurrent reader never maps a partial file
+	std::string tmp_path = path + ".tmp";
+	FILE *fp = fopen(tmp_path.c_str(), "wb");
+	if (!fp)
+		return;
+	size_t mem_size = vmpp_uint8_size + impp_uint8_size;
+	bool ok = (fwrite(p_data, 1, mem_size, fp) == mem_size);
+	ok = (fclose(fp) == 0) && ok;
+	if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0)
+		remove(tmp_path.c_str());
+}
+
+void ShadeDB8_mpp::init()
+{
+	p_error_msg = "";
+	p_warning_msg = "";
+	p_tables = ShadeDB8_tables::instance(&p_error_msg);
+	if (p_tables)
+	{
+		p_vmpp = p_tables->vmpp();
+		p_impp = p_tables->impp();
+	}
+}
+
+ShadeDB8_mpp::~ShadeDB8_mpp()
+{
+	// tables are owned by the shared ShadeDB8_tables instance
+}
 
 double ShadeDB8_mpp::get_shade_loss(double &gpoa, double &dpoa, std::vector<double> &shade_frac, bool use_pv_cell_temp, double pv_cell_temp, int mods_per_str, double str_vmp_stc, double mppt_lo, double mppt_hi)
 {
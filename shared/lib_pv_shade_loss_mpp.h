@@ -56,8 +56,42 @@
 #include <vector>
 #include <stdlib.h>
 #include <string>
+#include <memory>
 
 extern const unsigned char pCmp_data[3133517];
+
+/**
+* Decompressed vmpp and impp tables of the shading database.
+* The tables are read-only once built, so a single instance is shared by every ShadeDB8_mpp in the process
+* and may be used concurrently from multiple threads.  The first call to instance() inflates the embedded
+* compressed data; later calls return the same tables.  If the environment variable SSC_SHADE_DB_CACHE names
+* a file, the raw tables are written there on first use and memory-mapped from it in later processes.
+*/
+class ShadeDB8_tables
+{
+public:
+	~ShadeDB8_tables();
+
+	/// Return the process-wide tables, building them on first use.  Returns null and sets error on failure.
+	static std::shared_ptr<const ShadeDB8_tables> instance(std::string *error = 0);
+
+	const unsigned char *vmpp() const { return p_data; }
+	const unsigned char *impp() const { return p_data + vmpp_uint8_size; }
+
+	static const size_t vmpp_uint8_size = 12091680; // uint8 size from matlab
+	static const size_t impp_uint8_size = 12091680; // uint8 size from matlab
+	static const size_t compressed_size = 3133517; // from modified example5.c in miniz project
+
+private:
+	ShadeDB8_tables();
+	bool decompress(std::string &error);
+	bool map_cache_file(const std::string &path);
+	void write_cache_file(const std::string &path);
+
+	unsigned char *p_data;
+	bool p_mapped;
+};
+
 // shading database with up to 8 strings
 class ShadeDB8_mpp
 {
@@ -85,14 +119,11 @@ public:
 
 
 private:
-	unsigned char *p_vmpp;
-	unsigned char *p_impp;
+	std::shared_ptr<const ShadeDB8_tables> p_tables;
+	const unsigned char *p_vmpp;
+	const unsigned char *p_impp;
 	short get_vmpp(size_t i);
 	short get_impp(size_t i);
-	bool decompress_file_to_uint8();
-	size_t p_vmpp_uint8_size;
-	size_t p_impp_uint8_size;
-	size_t p_compressed_size;
 	std::string p_warning_msg;
 	std::string p_error_msg;
 };
@@ -394,4 +394,106 @@ double maxpower_5par( double Voc_ubound, double a, double Il, double Io, double
 	if ( __Vmp ) *__Vmp = V;
 	if ( __Imp ) *__Imp = I;
 	return P;
-}
\ No newline at end of file
+}
+
+pvmismatch_t::pvmismatch_t()
+{
+	m_count = 0;
+}
+
+void pvmismatch_t::clear()
+{
+	m_count = 0;
+}
+
+void pvmismatch_t::add( pvinput_t &input, pvmodule_t &module, pvcelltemp_t &celltemp, double tdry )
+{
+	if ( m_count >= m_members.size() )
+		m_members.resize( m_count+1 );
+
+	member &m = m_members[m_count++];
+	m.input = input;
+	m.module = &module;
+	m.celltemp = &celltemp;
+	m.tdry = tdry;
+	m.tcell = tdry;
+	if ( !celltemp.depends_on_voltage() )
+		celltemp( m.input, module, -1, m.tcell );
+}
+
+double pvmismatch_t::current( double V )
+{
+	double I = 0;
+	for ( size_t i = 0; i < m_count; i++ )
+	{
+		member &m = m_members[i];
+		double tcell = m.tcell;
+		if ( m.celltemp->depends_on_voltage() )
+		{
+			tcell = m.tdry;
+			(*m.celltemp)( m.input, *m.module, V, tcell );
+		}
+		pvoutput_t out( 0, 0, 0, 0, 0, 0, 0, 0 );
+		(*m.module)( m.input, tcell, V, out );
+		I += out.Current;
+	}
+	return I;
+}
+
+double pvmismatch_t::find_mpp( double vmin, double vmax, double *vmp, int ncoarse, double tol )
+{
+	if ( vmp ) *vmp = -1;
+	if ( m_count == 0 || vmax <= vmin || ncoarse < 3 )
+		return 0;
+
+	// coarse scan to bracket the largest local maximum of the combined power curve
+	double dV = (vmax-vmin)/(ncoarse-1);
+	int ibest = -1;
+	double Pbest = 0;
+	for ( int i = 0; i < ncoarse; i++ )
+	{
+		double V = vmin + dV*i;
+		double P = V*current( V );
+		if ( P > Pbest )
+		{
+			Pbest = P;
+			ibest = i;
+		}
+	}
+
+	if ( ibest < 0 )
+		return 0;
+
+	// golden section search within the neighboring scan points
+	const double R = 0.61803399;
+	double a = vmin + dV*(ibest > 0 ? ibest-1 : 0);
+	double b = vmin + dV*(ibest < ncoarse-1 ? ibest+1 : ncoarse-1);
+	double x1 = b - R*(b-a);
+	double x2 = a + R*(b-a);
+	double f1 = x1*current( x1 );
+	double f2 = x2*current( x2 );
+	while ( b-a > tol*vmax )
+	{
+		if ( f1 < f2 )
+		{
+			a = x1;
+			x1 = x2; f1 = f2;
+			x2 = a + R*(b-a);
+			f2 = x2*current( x2 );
+		}
+		else
+		{
+			b = x2;
+			x2 = x1; f2 = f1;
+			x1 = b - R*(b-a);
+			f1 = x1*current( x1 );
+		}
+	}
+
+	double Vbest = vmin + dV*ibest;
+	if ( f1 > Pbest ) { Pbest = f1; Vbest = x1; }
+	if ( f2 > Pbest ) { Pbest = f2; Vbest = x2; }
+
+	if ( vmp ) *vmp = Vbest;
+	return Pbest;
+}
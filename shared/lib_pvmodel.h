@@ -51,6 +51,7 @@
 #define __pvmodulemodel_h
 
 #include <string>
+#include <vector>
 
 class pvcelltemp_t;
 class pvpower_t;
@@ -112,6 +113,8 @@ protected:
 public:
 	
 	virtual bool operator() ( pvinput_t &input, pvmodule_t &module, double opvoltage, double &Tcell ) = 0;
+	// true if the cell temperature depends on the operating voltage passed in, false if it only depends on the inputs
+	virtual bool depends_on_voltage() { return false; }
 	std::string error();
 };
 
@@ -164,6 +167,44 @@ double openvoltage_5par( double Voc0, double a, double IL, double IO, double Rsh
 double maxpower_5par( double Voc_ubound, double a, double Il, double Io, double Rs, double Rsh, double *Vmp=0, double *Imp=0 );
 double air_mass_modifier( double Zenith_deg, double Elev_m, double a[5] );
 
+/**
+* Maximum power point of several modules operating at a common voltage, for example one module from each
+* subarray when the subarrays are connected to the same inverter input.  The combined current is the sum of
+* the module currents at the voltage.  Cell temperatures are calculated once per module unless the cell
+* temperature model depends on the operating voltage.  The combined power curve is scanned coarsely to
+* bracket the maximum, then refined with a golden section search.
+*/
+class pvmismatch_t
+{
+public:
+	pvmismatch_t();
+
+	// remove all modules, keeping allocated storage for the next time step
+	void clear();
+
+	// add a module at the given operating conditions, tdry is the initial guess for cell temperature
+	void add( pvinput_t &input, pvmodule_t &module, pvcelltemp_t &celltemp, double tdry );
+
+	// sum of module currents at the voltage (A)
+	double current( double V );
+
+	// find the voltage between vmin and vmax with the largest combined power.  returns the combined power (W),
+	// or zero with vmp = -1 if no module produces power
+	double find_mpp( double vmin, double vmax, double *vmp, int ncoarse = 20, double tol = 1e-4 );
+
+private:
+	struct member
+	{
+		pvinput_t input;
+		pvmodule_t *module;
+		pvcelltemp_t *celltemp;
+		double tdry;
+		double tcell;
+	};
+	std::vector<member> m_members;
+	size_t m_count;
+};
+
 
 
 #endif
@@ -183,22 +183,37 @@ double qromb(double (*func)(double,double,double,double), double a, double b, do
 
 // SUPPORTING FUNCTION DEFINITIONS
 
-void diffuse_reduce(
-	// inputs (angles in degrees)
+static ssgeometry ss_geometry_for_mask(double tilt, double mask_angle, double gcr)
+{
+	ssgeometry geom;
+	geom.tilt = tilt;
+	geom.mask_angle = mask_angle;
+	geom.gcr = gcr;
+
+	// view factor terms assume isotropic sky, see diffuse_reduce_geometry
+	geom.sky_loss = (1 - pow(cosd(mask_angle / 2), 2));
+	geom.diffuse_tilt_factor = (1 + cosd(tilt));
+	geom.gnd_view_front = pow(sind(tilt / 2.0), 2);
+
+	double B = 1.0;
+	double R = B / gcr;
+	geom.gnd_view_rows = (1.0 + R / B - sqrt(pow(R, 2) / pow(B, 2) - 2 * R / B * cosd(180 - tilt) + 1.0));
+	return geom;
+}
+
+static void diffuse_reduce_geometry(
+	const ssgeometry &geom,
 	double solzen,
 	double stilt,
 	double Gb_nor,
 	double Gd_poa,
-	double gcr,
-	double phi0, // mask angle
 	double alb,
 	double nrows,
 
-	// outputs
 	double &reduced_skydiff,
-	double &Fskydiff,  // derate factor on sky diffuse
+	double &Fskydiff,
 	double &reduced_gnddiff,
-	double &Fgnddiff) // derate factor on ground diffuse
+	double &Fgnddiff)
 {
 	if (Gd_poa < 0.1)
 	{
@@ -208,24 +223,24 @@ void diffuse_reduce(
 
 	// view factor calculations assume isotropic sky
 	double Gd = Gd_poa; // total plane-of-array diffuse
-	double Gdh = Gd * 2 / (1 + cosd(stilt)); // total
+	double Gdh = Gd * 2 / geom.diffuse_tilt_factor; // total
 	double Gbh = Gb_nor * cosd(solzen); // beam irradiance on horizontal surface
 
 	// sky diffuse reduction
-	reduced_skydiff = Gd - Gdh*(1 - pow(cosd(phi0 / 2), 2))*(nrows - 1.0) / nrows;
+	reduced_skydiff = Gd - Gdh*geom.sky_loss*(nrows - 1.0) / nrows;
 	Fskydiff = reduced_skydiff / Gd;
 
 	double B = 1.0;
-	double R = B / gcr;
+	double R = B / geom.gcr;
 
 	double solalt = 90 - solzen;
 
 	// ground reflected reduction 
-	double F1 = alb * pow(sind(stilt / 2.0), 2);
+	double F1 = alb * geom.gnd_view_front;
 	double Y1 = R - B * sind(180.0 - solalt - stilt) / sind(solalt);
 	Y1 = fmax(0.00001, Y1); // constraint per Chris 4/23/12
 	double F2 = 0.5 * alb * (1.0 + Y1 / B - sqrt(pow(Y1, 2) / pow(B, 2) - 2 * Y1 / B * cosd(180 - stilt) + 1.0));
-	double F3 = 0.5 * alb * (1.0 + R / B - sqrt(pow(R, 2) / pow(B, 2) - 2 * R / B * cosd(180 - stilt) + 1.0));
+	double F3 = 0.5 * alb * geom.gnd_view_rows;
 
 	double Gr1 = F1 * (Gbh + Gdh);
 	reduced_gnddiff = ((F1 + (nrows - 1)*F2) / nrows) * Gbh
@@ -236,6 +251,27 @@ void diffuse_reduce(
 		Fgnddiff = reduced_gnddiff / Gr1;
 }
 
+void diffuse_reduce(
+	// inputs (angles in degrees)
+	double solzen,
+	double stilt,
+	double Gb_nor,
+	double Gd_poa,
+	double gcr,
+	double phi0, // mask angle
+	double alb,
+	double nrows,
+
+	// outputs
+	double &reduced_skydiff,
+	double &Fskydiff,  // derate factor on sky diffuse
+	double &reduced_gnddiff,
+	double &Fgnddiff) // derate factor on ground diffuse
+{
+	ssgeometry geom = ss_geometry_for_mask(stilt, phi0, gcr);
+	diffuse_reduce_geometry(geom, solzen, stilt, Gb_nor, Gd_poa, alb, nrows, reduced_skydiff, Fskydiff, reduced_gnddiff, Fgnddiff);
+}
+
 double selfshade_dc_derate(double X, double S, double FF0, double dbh_ratio, double m_d, double Vmp)
 {
 	double Xtemp = fmin(X, 0.65);  // X is limited to 0.65 for c2 calculation
@@ -303,6 +339,94 @@ void selfshade_xs_horstr(bool landscape,
 	}
 }
 
+// mask angle of the row in front (deg)
+static double ss_mask_angle(const ssinputs &inputs, double tilt)
+{
+	double m_m = inputs.nmody;
+	double m_W = inputs.width;
+	double m_L = inputs.length;
+	double m_R = inputs.row_space;
+	if (m_R < M_EPS) m_R = M_EPS;
+
+	// NOTE THAT B HERE IS PER CHRIS DELINE'S PAPER: B IS THE LENGTH OF THE SIDE OF A ROW
+	double m_B;
+	if (inputs.mod_orient == 0) m_B = m_L * m_m;	// Portrait Mode
+	else m_B = m_W * m_m;	// Landscape Mode
+
+	double a = 0.0, b = m_B;
+	
+	double mask_angle;
+	if (inputs.mask_angle_calc_method == 1)
+	{
+	// average over entire array
+		mask_angle = qromb( mask_angle_func, a, b, m_R, m_B, tilt) / m_B;
+	}
+	else
+	{
+	// worst case (default)
+	// updated to phi(0) per email from Chris Deline 5/2/12
+		mask_angle = atan2( ( m_B * sind( tilt ) ), ( m_R - m_B * cosd( tilt ) ) );
+	}
+	return mask_angle * 180.0/M_PI; // change to degrees to pass into functions later
+}
+
+static double ss_gcr(const ssinputs &inputs)
+{
+	double m_R = inputs.row_space;
+	if (m_R < M_EPS) m_R = M_EPS;
+	double m_B = (inputs.mod_orient == 0) ? inputs.length * inputs.nmody : inputs.width * inputs.nmody;
+	return m_B / m_R;
+}
+
+ssgeometry ss_geometry(const ssinputs &inputs, double tilt)
+{
+	return ss_geometry_for_mask(tilt, ss_mask_angle(inputs, tilt), ss_gcr(inputs));
+}
+
+sscache::sscache()
+	: m_tilt_step(0.0), m_valid(false)
+{
+}
+
+void sscache::setup(const ssinputs &inputs, double tilt_step)
+{
+	m_valid = false;
+	m_tilt_step = tilt_step;
+	m_mask_angle.clear();
+	if (m_tilt_step <= 0)
+		return;
+
+	// tabulate the mask angle over the range of surface tilts, including 90 degrees as the last point
+	size_t n = (size_t)ceil(90.0 / m_tilt_step) + 1;
+	m_mask_angle.reserve(n);
+	for (size_t i = 0; i < n; i++)
+		m_mask_angle.push_back(ss_mask_angle(inputs, fmin(i * m_tilt_step, 90.0)));
+}
+
+const ssgeometry &sscache::geometry(const ssinputs &inputs, double tilt)
+{
+	if (m_valid && tilt == m_last.tilt)
+		return m_last;
+
+	if (m_mask_angle.size() > 1 && tilt >= 0 && tilt <= 90.0)
+	{
+		double x = tilt / m_tilt_step;
+		size_t i = (size_t)x;
+		if (i >= m_mask_angle.size() - 1)
+			i = m_mask_angle.size() - 2;
+		double x0 = i * m_tilt_step;
+		double x1 = fmin((i + 1) * m_tilt_step, 90.0);
+		double f = (x1 > x0) ? (tilt - x0) / (x1 - x0) : 0.0;
+		double mask_angle = m_mask_angle[i] + f * (m_mask_angle[i + 1] - m_mask_angle[i]);
+		m_last = ss_geometry_for_mask(tilt, mask_angle, ss_gcr(inputs));
+	}
+	else
+		m_last = ss_geometry(inputs, tilt);
+
+	m_valid = true;
+	return m_last;
+}
+
 // self-shading calculation function
 /*
 
@@ -330,9 +454,10 @@ R: inter-row spacing
 phi_bar: average masking angle
 
 */
-bool ss_exec(
+static bool ss_exec_geometry(
 	
 	const ssinputs &inputs,
+	const ssgeometry &geom,	// geometry terms for this tilt, see ss_geometry
 
 	double tilt,		// module tilt (constant for fixed tilt, varies for one-axis)
 	double azimuth,		// module azimuth (constant for fixed tilt, varies for one-axis)
@@ -376,21 +501,7 @@ bool ss_exec(
 	if (inputs.mod_orient == 0) m_row_length = m_n * m_W; //Portrait Mode
 	else m_row_length = m_n * m_L; //Landscape Mode
 
-	double a = 0.0, b = m_B;
-	
-	double mask_angle;
-	if (inputs.mask_angle_calc_method == 1)
-	{
-	// average over entire array
-		mask_angle = qromb( mask_angle_func, a, b, m_R, m_B, tilt) / m_B;
-	}
-	else
-	{
-	// worst case (default)
-	// updated to phi(0) per email from Chris Deline 5/2/12
-		mask_angle = atan2( ( m_B * sind( tilt ) ), ( m_R - m_B * cosd( tilt ) ) );
-	}
-	mask_angle *= 180.0/M_PI; // change to degrees to pass into functions later
+	// the mask angle is part of the cached geometry, see ss_geometry
 
 	// ***********************************
 	// SHADOW DIMENSION CALCULATIONS
@@ -518,7 +629,7 @@ bool ss_exec(
 	//Chris Deline's self-shading algorithm
 
 	// 1. determine reduction of diffuse incident on shaded sections due to self-shading (beam is not derated because that shading is taken into account in dc derate)
-	diffuse_reduce( solzen, tilt, Gb_nor, Gd_poa, m_B/m_R, mask_angle, albedo, m_r,
+	diffuse_reduce_geometry( geom, solzen, tilt, Gb_nor, Gd_poa, albedo, m_r,
 		// outputs
 		outputs.m_reduced_diffuse, outputs.m_diffuse_derate, outputs.m_reduced_reflected, outputs.m_reflected_derate );
 
@@ -534,3 +645,45 @@ bool ss_exec(
 
 	return true;
 }
+
+bool ss_exec(
+	const ssinputs &inputs,
+	double tilt,
+	double azimuth,
+	double solzen,
+	double solazi,
+	double Gb_nor,
+	double Gb_poa,
+	double Gd_poa,
+	double albedo,
+	bool trackmode,
+	bool linear,
+	double shade_frac_1x,
+	ssoutputs &outputs)
+{
+	ssgeometry geom;
+	if (!linear)
+		geom = ss_geometry(inputs, tilt);
+	return ss_exec_geometry(inputs, geom, tilt, azimuth, solzen, solazi, Gb_nor, Gb_poa, Gd_poa, albedo, trackmode, linear, shade_frac_1x, outputs);
+}
+
+bool ss_exec(
+	const ssinputs &inputs,
+	sscache &cache,
+	double tilt,
+	double azimuth,
+	double solzen,
+	double solazi,
+	double Gb_nor,
+	double Gb_poa,
+	double Gd_poa,
+	double albedo,
+	bool trackmode,
+	bool linear,
+	double shade_frac_1x,
+	ssoutputs &outputs)
+{
+	if (linear)
+		return ss_exec_geometry(inputs, ssgeometry(), tilt, azimuth, solzen, solazi, Gb_nor, Gb_poa, Gd_poa, albedo, trackmode, linear, shade_frac_1x, outputs);
+	return ss_exec_geometry(inputs, cache.geometry(inputs, tilt), tilt, azimuth, solzen, solazi, Gb_nor, Gb_poa, Gd_poa, albedo, trackmode, linear, shade_frac_1x, outputs);
+}
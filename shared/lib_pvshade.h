@@ -51,6 +51,7 @@
 #define __pvshade_h
 
 #include <string>
+#include <vector>
 
 #include "lib_util.h"
 
@@ -147,6 +148,48 @@ struct ssoutputs	// self-shading outputs
 	double m_shade_frac_fixed;
 };
 
+// geometry-only terms of the self-shading calculation.  these depend on the row geometry and surface tilt
+// but not on the sun position or irradiance, so they can be computed once for a fixed tilt array
+struct ssgeometry
+{
+	double tilt;		// surface tilt these terms were computed for (deg)
+	double mask_angle;	// mask angle of the row in front (deg)
+	double gcr;			// ratio of row side length to row spacing, used by diffuse_reduce
+	double sky_loss;	// 1 - cos^2(mask_angle/2), fraction of horizontal diffuse blocked by the row in front
+	double diffuse_tilt_factor;	// 1 + cos(tilt), POA diffuse * 2 / diffuse_tilt_factor is horizontal diffuse
+	double gnd_view_front;	// ground view factor of the front row without albedo, sin^2(tilt/2)
+	double gnd_view_rows;	// ground view factor between rows without albedo and beam
+
+	ssgeometry() : tilt(0), mask_angle(0), gcr(0), sky_loss(0), diffuse_tilt_factor(2), gnd_view_front(0), gnd_view_rows(0) {}
+};
+
+// compute the geometry-only self-shading terms for the given surface tilt
+ssgeometry ss_geometry(const ssinputs &inputs, double tilt);
+
+/**
+* Cached self-shading geometry for one subarray.
+* Fixed tilt arrays compute the geometry once.  For trackers the surface tilt changes each timestep, so the
+* mask angle (the integral over the row for the averaged mask angle method) can be tabulated over tilt at
+* a configurable resolution and interpolated; a resolution of zero recomputes it exactly for each new tilt.
+*/
+class sscache
+{
+public:
+	sscache();
+
+	/// build the cache for the row geometry, tilt_step in degrees (0 = exact)
+	void setup(const ssinputs &inputs, double tilt_step = 0.0);
+
+	/// geometry terms for the given surface tilt
+	const ssgeometry &geometry(const ssinputs &inputs, double tilt);
+
+private:
+	double m_tilt_step;
+	std::vector<double> m_mask_angle;
+	ssgeometry m_last;
+	bool m_valid;
+};
+
 //performs shading calculation and returns outputs
 bool ss_exec(
 	const ssinputs &inputs,
@@ -165,4 +208,23 @@ bool ss_exec(
 	
 	ssoutputs &outputs);
 
+//performs shading calculation using cached geometry for the surface tilt
+bool ss_exec(
+	const ssinputs &inputs,
+	sscache &cache,
+
+	double tilt,
+	double azimuth,
+	double solzen,
+	double solazi,
+	double Gb_nor,
+	double Gb_poa,
+	double Gd_poa,
+	double albedo,
+	bool trackmode,
+	bool linear,
+	double shade_frac_1x,
+
+	ssoutputs &outputs);
+
 #endif
\ No newline at end of file
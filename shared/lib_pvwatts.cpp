@@ -100,6 +100,8 @@
 #include <stdlib.h>
 
 #include "lib_pvwatts.h"
+#include "lib_pvshade.h"
+#include "lib_pv_incidence_modifier.h"
 
 #ifndef M_PI
 #define M_PI 3.1415926535
@@ -387,3 +389,220 @@ double dctoac(double pcrate,double efffp,double dc)
 
 	return(ac);
 }
+
+// module temperature coefficient and cover type for the pvwatts module types
+void pvwattsv5_module_type( int module_type, double &gamma, bool &use_ar_glass )
+{
+	gamma = 0;
+	use_ar_glass = false;
+	switch( module_type )
+	{
+	case 0: // standard module
+		gamma = -0.0047; use_ar_glass = false; break;
+	case 1: // premium module
+		gamma = -0.0035; use_ar_glass = true; break;
+	case 2: // thin film module
+		gamma = -0.0020; use_ar_glass = false; break;
+	}
+}
+
+// tracking mode, installed nominal operating cell temperature and backtracking for the pvwatts array types
+void pvwattsv5_array_type( int array_type, int &track_mode, double &inoct, int &shade_mode_1x )
+{
+	track_mode =  0;
+	inoct = 45;
+	shade_mode_1x = 0; // self shaded
+	switch( array_type )
+	{
+	case 0: // fixed open rack
+		track_mode = 0; inoct = 45; shade_mode_1x = 0; break;
+	case 1: // fixed roof mount
+		track_mode = 0; inoct = 49; shade_mode_1x = 0; break;
+	case 2: // 1 axis self-shaded
+		track_mode = 1; inoct = 45; shade_mode_1x = 0; break;
+	case 3: // 1 axis backtracked
+		track_mode = 1; inoct = 45; shade_mode_1x = 1; break;
+	case 4: // 2 axis
+		track_mode = 2; inoct = 45; shade_mode_1x = 0; break;
+	case 5: // azimuth axis
+		track_mode = 3; inoct = 45; shade_mode_1x = 0; break;
+	}
+}
+
+// sky and ground diffuse derate factors for self-shaded one axis trackers
+void pvwattsv5_diffuse_selfshade_1x( double solzen, double stilt, double dni, double iskydiff, double ignddiff,
+	double gcr, double alb, double &Fskydiff, double &Fgnddiff )
+{
+	double reduced_skydiff = iskydiff;
+	Fskydiff = 1.0;
+	double reduced_gnddiff = ignddiff;
+	Fgnddiff = 1.0;
+						
+	// worst-case mask angle using calculated surface tilt
+	double phi0 = 180/3.1415926*atan2( sind( stilt ), 1/gcr - cosd( stilt ) );
+
+	// calculate sky and gnd diffuse derate factors
+	// based on view factor reductions from self-shading
+	diffuse_reduce( solzen, stilt,
+		dni, iskydiff+ignddiff,
+		gcr, phi0, alb, 1000,
+
+		// outputs (pass by reference)
+		reduced_skydiff, Fskydiff,
+		reduced_gnddiff, Fgnddiff );
+}
+
+// transmitted plane of array irradiance through the module cover
+double pvwattsv5_tpoa( double poa, double dni, double aoi, bool use_ar_glass )
+{
+	double tpoa = poa;
+	if ( aoi > AOI_MIN && aoi < AOI_MAX )
+	{
+		double mod = iam( aoi, use_ar_glass );
+		tpoa = poa - ( 1.0 - mod )*dni*cosd(aoi);
+		if( tpoa < 0.0 ) tpoa = 0.0;
+		if( tpoa > poa ) tpoa = poa;
+	}
+	return tpoa;
+}
+
+// pvwatts part load inverter efficiency with clipping at the ac nameplate
+double pvwattsv5_inverter( double dc, double ac_nameplate, double inv_eff_percent )
+{
+	double etanom = inv_eff_percent/100.0;
+	double etaref = 0.9637;
+	double A =  -0.0162;
+	double B = -0.0059;
+	double C =  0.9858;
+	double pdc0 = ac_nameplate/etanom;
+	double plr = dc / pdc0;
+	double ac = 0;
+				
+	if ( plr > 0 )
+	{ // normal operation
+		double eta = (A*plr + B/plr + C)*etanom/etaref;
+		ac = dc*eta;
+	}
+
+	if ( ac > ac_nameplate ) // clipping
+		ac = ac_nameplate;
+
+	// make sure no negative AC values (no parasitic nighttime losses calculated)
+	if ( ac < 0 ) ac = 0;
+
+	return ac;
+}
+
+pvwattsv5_system::pvwattsv5_system()
+{
+	dc_nameplate = ac_nameplate = inv_eff_percent = 0;
+	loss_percent = tilt = azimuth = gamma = 0;
+	gcr = 0.4;
+	inoct = 45;
+	use_ar_glass = false;
+	track_mode = shade_mode_1x = 0;
+}
+
+bool pvwattsv5_system::setup( double system_capacity_kw, int module_type, double dc_ac_ratio, double inv_eff, double losses,
+	int array_type, double tilt_deg, double azimuth_deg, double gcr_in, std::string *error )
+{
+	std::string msg;
+	if ( system_capacity_kw <= 0 || dc_ac_ratio <= 0 )
+		msg = "system capacity and dc to ac ratio must be positive";
+	else if ( inv_eff < 90 || inv_eff > 99.5 )
+		msg = "inverter efficiency must be between 90 and 99.5 percent";
+	else if ( losses < -5 || losses > 99 )
+		msg = "losses must be between -5 and 99 percent";
+	else if ( module_type < 0 || module_type > 2 )
+		msg = "module type must be 0, 1 or 2";
+	else if ( array_type < 0 || array_type > 4 )
+		msg = "array type must be between 0 and 4";
+	else if ( tilt_deg < 0 || tilt_deg > 90 || azimuth_deg < 0 || azimuth_deg > 360 )
+		msg = "tilt must be between 0 and 90 degrees and azimuth between 0 and 360 degrees";
+	else if ( gcr_in < 0 || gcr_in > 3 )
+		msg = "ground coverage ratio must be between 0 and 3";
+
+	if ( !msg.empty() )
+	{
+		if ( error ) *error = msg;
+		return false;
+	}
+
+	dc_nameplate = system_capacity_kw*1000;
+	ac_nameplate = dc_nameplate / dc_ac_ratio;
+	inv_eff_percent = inv_eff;
+	loss_percent = losses;
+	tilt = tilt_deg;
+	azimuth = azimuth_deg;
+	pvwattsv5_module_type( module_type, gamma, use_ar_glass );
+	pvwattsv5_array_type( array_type, track_mode, inoct, shade_mode_1x );
+	gcr = ( track_mode == 1 ) ? gcr_in : 0.4;
+	return true;
+}
+
+pvwattsv5_site::pvwattsv5_site( const pvwattsv5_system &sys, double lat, double lon, double tz, double ts_hour )
+	: m_sys( sys ), m_tccalc( sys.inoct+273.15, PVWATTS_HEIGHT, ts_hour )
+{
+	m_tcell = m_poa = 0;
+	m_irr.set_location( lat, lon, tz );
+	m_irr.set_surface( m_sys.track_mode, m_sys.tilt, m_sys.azimuth, 45.0,
+		m_sys.shade_mode_1x == 1, // backtracking mode
+		m_sys.gcr );
+}
+
+void pvwattsv5_site::set_last_values( double tcell, double poa )
+{
+	m_tccalc.set_last_values( tcell, poa );
+	m_tcell = tcell;
+	m_poa = poa;
+}
+
+int pvwattsv5_site::calc( int year, int month, int day, int hour, double minute, double delt_hr,
+	double dn, double df, double tdry, double wspd, double alb,
+	double &dc, double &ac, const irrad_sunpos *sunpos )
+{
+	dc = ac = 0;
+	m_poa = 0;
+	m_tcell = tdry;
+
+	m_irr.set_time( year, month, day, hour, minute, delt_hr );
+	m_irr.set_sky_model( 2, alb );
+	m_irr.set_beam_diffuse( dn, df );
+
+	int code = sunpos ? m_irr.calc( *sunpos ) : m_irr.calc();
+	if ( code != 0 && code != -1 )
+		return code;
+
+	double solazi, solzen, solalt, aoi, stilt, sazi, rot, btd;
+	double ibeam, iskydiff, ignddiff;
+	int sunup;
+	m_irr.get_sun( &solazi, &solzen, &solalt, 0, 0, 0, &sunup, 0, 0, 0 );
+	m_irr.get_angles( &aoi, &stilt, &sazi, &rot, &btd );
+	m_irr.get_poa( &ibeam, &iskydiff, &ignddiff, 0, 0, 0 );
+
+	if ( sunup <= 0 )
+		return code;
+
+	if ( m_sys.track_mode == 1 && m_sys.shade_mode_1x == 0 ) // selfshaded mode
+	{
+		ibeam *= 1 - shade_fraction_1x( solazi, solzen, m_sys.tilt, m_sys.azimuth, m_sys.gcr, rot );
+
+		if ( iskydiff > 0 )
+		{
+			double Fskydiff = 1.0;
+			double Fgnddiff = 1.0;
+			pvwattsv5_diffuse_selfshade_1x( solzen, stilt, dn, iskydiff, ignddiff, m_sys.gcr, alb, Fskydiff, Fgnddiff );
+			if ( Fskydiff >= 0 && Fskydiff <= 1 ) iskydiff *= Fskydiff;
+			if ( Fgnddiff >= 0 && Fgnddiff <= 1 ) ignddiff *= Fgnddiff;
+		}
+	}
+
+	m_poa = ibeam + iskydiff + ignddiff;
+	double tpoa = pvwattsv5_tpoa( m_poa, dn, aoi, m_sys.use_ar_glass );
+	m_tcell = m_tccalc( m_poa, wspd < 0 ? 0 : wspd, tdry );
+
+	dc = m_sys.dc_nameplate*(1.0+m_sys.gamma*(m_tcell-25.0))*tpoa/1000.0;
+	dc = dc*(1-m_sys.loss_percent/100);
+	ac = pvwattsv5_inverter( dc, m_sys.ac_nameplate, m_sys.inv_eff_percent );
+	return code;
+}
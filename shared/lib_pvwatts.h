@@ -50,6 +50,10 @@
 #ifndef __lib_pvwatts_h
 #define __lib_pvwatts_h
 
+#include <string>
+
+#include "lib_irradproc.h"
+
 #define PVWATTS_INOCT (45.0+273.15)
 #define PVWATTS_HEIGHT 5.0
 #define PVWATTS_REFTEM 25.0
@@ -135,4 +139,66 @@ public:
 	void set_last_values( double Tc, double poa );
 };
 
+/* PVWatts V5 system model, shared by the pvwattsv5 compute modules and the streaming PVWatts api */
+
+// module temperature coefficient and cover type for the pvwatts module types
+void pvwattsv5_module_type( int module_type, double &gamma, bool &use_ar_glass );
+
+// tracking mode, installed nominal operating cell temperature and backtracking for the pvwatts array types
+void pvwattsv5_array_type( int array_type, int &track_mode, double &inoct, int &shade_mode_1x );
+
+// sky and ground diffuse derate factors for self-shaded one axis trackers
+void pvwattsv5_diffuse_selfshade_1x( double solzen, double stilt, double dni, double iskydiff, double ignddiff,
+	double gcr, double alb, double &Fskydiff, double &Fgnddiff );
+
+// transmitted plane of array irradiance through the module cover
+double pvwattsv5_tpoa( double poa, double dni, double aoi, bool use_ar_glass );
+
+// pvwatts part load inverter efficiency with clipping at the ac nameplate
+double pvwattsv5_inverter( double dc, double ac_nameplate, double inv_eff_percent );
+
+// system parameters for one pvwattsv5 system
+struct pvwattsv5_system
+{
+	double dc_nameplate, ac_nameplate, inv_eff_percent;
+	double loss_percent, tilt, azimuth, gamma, gcr, inoct;
+	bool use_ar_glass;
+	int track_mode, shade_mode_1x;
+
+	pvwattsv5_system();
+
+	// same inputs and ranges as the pvwattsv5 compute module, returns false and sets error if out of range
+	bool setup( double system_capacity_kw, int module_type, double dc_ac_ratio, double inv_eff, double losses,
+		int array_type, double tilt, double azimuth, double gcr, std::string *error = 0 );
+};
+
+/**
+* One pvwattsv5 system at a fixed location, stepped forward in time.
+* The surface geometry is set once and the cell temperature model keeps its state between calls,
+* so repeated calls allocate nothing.  Shading and adjustment factors are not applied.
+*/
+class pvwattsv5_site
+{
+	pvwattsv5_system m_sys;
+	irrad m_irr;
+	pvwatts_celltemp m_tccalc;
+	double m_tcell, m_poa;
+
+public:
+	pvwattsv5_site( const pvwattsv5_system &sys, double lat, double lon, double tz, double ts_hour );
+
+	// calculate dc and ac power (W) for one time step.  delt_hr is passed to irrad::set_time, and sunpos
+	// may give a sun position already calculated for this time and location.  returns the irrad::calc code,
+	// where -1 (beam above extraterrestrial) still produces a result
+	int calc( int year, int month, int day, int hour, double minute, double delt_hr,
+		double dn, double df, double tdry, double wspd, double alb,
+		double &dc, double &ac, const irrad_sunpos *sunpos = 0 );
+
+	// restore the cell temperature model from a previous time step
+	void set_last_values( double tcell, double poa );
+
+	double tcell() const { return m_tcell; }
+	double poa() const { return m_poa; }
+};
+
 #endif
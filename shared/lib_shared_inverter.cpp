@@ -120,6 +120,34 @@ void SharedInverter::calculateACPower(const double powerDC_Watts, const double D
 	efficiencyAC *= 100;
 }
 
+void SharedInverter::calculateACPower(const double* powerDC_Watts, const double* DCStringVoltage, const double* T, size_t n,
+	double* powerAC, double* powerClipLoss)
+{
+	double Pac, P_par, P_lr, eff, P_clip, P_cons, P_night;
+	double scale = m_numInverters * util::watt_to_kilowatt;
+	bool sandia = (m_inverterType == SANDIA_INVERTER || m_inverterType == DATASHEET_INVERTER || m_inverterType == COEFFICIENT_GENERATOR);
+	bool partload = (m_inverterType == PARTLOAD_INVERTER);
+	bool derate = (m_tempEnabled && T != NULL);
+
+	for (size_t i = 0; i < n; i++)
+	{
+		Pac = P_clip = eff = 0;
+		double Pdc = powerDC_Watts[i] / m_numInverters;
+		if (sandia)
+			m_sandiaInverter->acpower(Pdc, DCStringVoltage[i], &Pac, &P_par, &P_lr, &eff, &P_clip, &P_cons, &P_night);
+		else if (partload)
+			m_partloadInverter->acpower(Pdc, &Pac, &P_lr, &P_par, &eff, &P_clip, &P_night);
+
+		if (derate){
+			double tempLoss = 0.0;
+			calculateTempDerate(DCStringVoltage[i], T[i], Pac, eff, tempLoss);
+		}
+
+		if (powerAC) powerAC[i] = Pac * scale;
+		if (powerClipLoss) powerClipLoss[i] = P_clip * scale;
+	}
+}
+
 double SharedInverter::getInverterDCNominalVoltage()
 {
 	if (m_inverterType == SANDIA_INVERTER)
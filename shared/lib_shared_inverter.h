@@ -31,6 +31,12 @@ public:
 	/// Given the combined PV plus battery DC power (W), voltage and ambient T, compute the AC power (kW)
 	void calculateACPower(const double powerDC, const double DCStringVoltage, double ambientT);
 
+	/// Compute the AC power and clipping loss (kW) for n timesteps of DC power (W), voltage and ambient T (NULL for no temperature derate).
+	/// The per-timestep values below are not modified. pvsamv1 uses it for the DC-connected battery clipping forecast; its
+	/// AC loop steps the scalar overload, which also reports efficiency and the other losses and runs between battery steps.
+	void calculateACPower(const double* powerDC, const double* DCStringVoltage, const double* ambientT, size_t n,
+		double* powerAC_kW, double* powerClipLoss_kW);
+
 	/// Return the nominal DC voltage input
 	double getInverterDCNominalVoltage();
 
@@ -51,6 +51,7 @@
 #include "lib_util.h"
 #include <cmath>
 #include <iostream>
+#include <limits>
 
 
 #ifndef M_PI
@@ -199,3 +200,55 @@ bool pvsnowmodel::getLoss(float poa, float tilt, float , float tdry, float snowD
 	if (isGood) return true;
 	else return false;
 }
+
+bool pvsnowmodel::getLoss(const float *poa, const float *tilt_in, const float *tdry, const float *snowDepth_in, const int *sunup,
+	float dt, size_t n, float *returnLoss, float *returnCoverage){
+
+	bool isGood = true;
+	float deltaDepth = deltaThreshold*dt;
+
+	// the sliding term only changes with the tilt, which is constant for fixed systems and at night
+	float lastTilt = std::numeric_limits<float>::quiet_NaN();
+	double slideRate = 0;
+
+	for (size_t i = 0; i < n; i++){
+		float snowDepth = snowDepth_in[i];
+		if (snowDepth < 0 || snowDepth > 610 || std::isnan(snowDepth)){
+			isGood = false;
+			snowDepth = 0;
+			badValues++;
+			if (badValues == maxBadValues){
+				good = false;
+				msg = util::format("The weather file contains no snow depth data or the data is not valid. Found (%d) bad snow depth values.", maxBadValues);
+				return false;
+			}
+		}
+
+		// Steps 1 and 4 as in the single timestep version
+		if ((snowDepth - previousDepth) >= deltaDepth && snowDepth >= depthThreshold)
+			coverage = 1;
+		else
+			coverage = pCvg;
+
+		if (snowDepth < depthThreshold) coverage = 0;
+
+		float tilt = (sunup[i] == 0) ? baseTilt : tilt_in[i];
+		if (tilt != lastTilt){
+			slideRate = 0.1 * sSlope * sin(tilt * M_PI / 180);
+			lastTilt = tilt;
+		}
+
+		if (tdry[i] - poa[i] / mSlope > 0)
+			coverage -= (float)(slideRate * dt);
+
+		if (coverage < 0) coverage = 0;
+
+		returnLoss[i] = ((float)ceil(coverage*nmody))/nmody;
+		if (returnCoverage) returnCoverage[i] = coverage;
+
+		previousDepth = snowDepth;
+		pCvg = coverage;
+	}
+
+	return isGood;
+}
@@ -60,6 +60,12 @@ public:
 
 	bool getLoss(float poa, float tilt, float wspd, float tdry, float snowDepth, int sunup, float dt, float *returnLoss);
 
+	// Same as getLoss for n consecutive timesteps, continuing from the current state.  Wind speed is not
+	// used by the model and is not an input.  returnCoverage may be NULL.  Returns false if any snow depth
+	// value was bad; if good is also false the remaining timesteps were not processed.
+	bool getLoss(const float *poa, const float *tilt, const float *tdry, const float *snowDepth, const int *sunup,
+		float dt, size_t n, float *returnLoss, float *returnCoverage = 0);
+
 	float	tilt,		// Surface tilt, degrees
 		baseTilt,		// The default tilt for 1-axis tracking systems
 		mSlope,			// This is a value given by fig. 4 in [1]
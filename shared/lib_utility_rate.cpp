@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include "lib_utility_rate.h"
+#include "core.h"
 
 
 UtilityRate::UtilityRate(util::matrix_t<size_t> ecWeekday, util::matrix_t<size_t> ecWeekend, util::matrix_t<double> ecRatesMatrix)
@@ -9,6 +12,18 @@ UtilityRate::UtilityRate(util::matrix_t<size_t> ecWeekday, util::matrix_t<size_t
 	m_ecRatesMatrix = ecRatesMatrix;
 }
 
+UtilityRate::UtilityRate(util::matrix_t<size_t> ecWeekday, util::matrix_t<size_t> ecWeekend, util::matrix_t<double> ecRatesMatrix,
+	util::matrix_t<size_t> dcWeekday, util::matrix_t<size_t> dcWeekend, util::matrix_t<double> dcRatesMatrix, util::matrix_t<double> dcFlatMatrix)
+{
+	m_ecWeekday = ecWeekday;
+	m_ecWeekend = ecWeekend;
+	m_ecRatesMatrix = ecRatesMatrix;
+	m_dcWeekday = dcWeekday;
+	m_dcWeekend = dcWeekend;
+	m_dcRatesMatrix = dcRatesMatrix;
+	m_dcFlatMatrix = dcFlatMatrix;
+}
+
 UtilityRateCalculator::UtilityRateCalculator(UtilityRate * rate, size_t stepsPerHour) :
 	UtilityRate(*rate)
 {
@@ -78,3 +93,231 @@ size_t UtilityRateCalculator::getEnergyPeriod(size_t hourOfYear)
 	return period;
 
 }
+
+UtilityRateIncremental::UtilityRateIncremental(UtilityRate * rate, size_t stepsPerHour) :
+	UtilityRate(*rate)
+{
+	m_stepsPerHour = stepsPerHour;
+	size_t nsteps = 8760 * m_stepsPerHour;
+	size_t none = std::numeric_limits<size_t>::max();
+
+	// tier tables, rows are assumed to be in increasing tier order within each period
+	std::map<size_t, size_t> energyIndex;
+	for (size_t r = 0; r != m_ecRatesMatrix.nrows(); r++)
+	{
+		size_t period = static_cast<size_t>(m_ecRatesMatrix(r, 0));
+		if (energyIndex.find(period) == energyIndex.end())
+		{
+			energyIndex[period] = m_energyUpperBounds.size();
+			m_energyUpperBounds.push_back(std::vector<double>());
+			m_energyBuyRates.push_back(std::vector<double>());
+			m_energySellRates.push_back(m_ecRatesMatrix.ncols() > 5 ? m_ecRatesMatrix(r, 5) : 0.);
+		}
+		size_t idx = energyIndex[period];
+		m_energyUpperBounds[idx].push_back(m_ecRatesMatrix(r, 2));
+		m_energyBuyRates[idx].push_back(m_ecRatesMatrix(r, 4));
+	}
+
+	std::map<size_t, size_t> demandIndex;
+	for (size_t r = 0; r != m_dcRatesMatrix.nrows(); r++)
+	{
+		size_t period = static_cast<size_t>(m_dcRatesMatrix(r, 0));
+		if (demandIndex.find(period) == demandIndex.end())
+		{
+			demandIndex[period] = m_demandUpperBounds.size();
+			m_demandUpperBounds.push_back(std::vector<double>());
+			m_demandCharges.push_back(std::vector<double>());
+		}
+		size_t idx = demandIndex[period];
+		m_demandUpperBounds[idx].push_back(m_dcRatesMatrix(r, 2));
+		m_demandCharges[idx].push_back(m_dcRatesMatrix(r, 3));
+	}
+
+	m_flatUpperBounds.resize(12);
+	m_flatCharges.resize(12);
+	for (size_t r = 0; r != m_dcFlatMatrix.nrows(); r++)
+	{
+		size_t month = static_cast<size_t>(m_dcFlatMatrix(r, 0));
+		if (month < 12)
+		{
+			m_flatUpperBounds[month].push_back(m_dcFlatMatrix(r, 2));
+			m_flatCharges[month].push_back(m_dcFlatMatrix(r, 3));
+		}
+	}
+
+	// resolve the month and periods of every step once
+	bool demand = (m_dcWeekday.nrows() > 0 && m_dcWeekend.nrows() > 0);
+	m_power.assign(nsteps, 0.);
+	m_stepMonth.resize(nsteps);
+	m_stepEnergyPeriod.assign(nsteps, none);
+	m_stepDemandPeriod.assign(nsteps, none);
+	for (size_t step = 0; step != nsteps; step++)
+	{
+		size_t hourOfYear = step / m_stepsPerHour;
+		size_t month, hour;
+		util::month_hour(hourOfYear, month, hour);
+		bool weekday = util::weekday(hourOfYear);
+		m_stepMonth[step] = month - 1;
+
+		size_t period = weekday ? m_ecWeekday.at(month - 1, hour - 1) : m_ecWeekend.at(month - 1, hour - 1);
+		std::map<size_t, size_t>::iterator it = energyIndex.find(period);
+		if (it == energyIndex.end())
+			throw compute_module::general_error(util::format("Energy rate period %d not found for month %d hour %d.", (int)period, (int)month, (int)hour));
+		m_stepEnergyPeriod[step] = it->second;
+
+		if (demand)
+		{
+			period = weekday ? m_dcWeekday.at(month - 1, hour - 1) : m_dcWeekend.at(month - 1, hour - 1);
+			it = demandIndex.find(period);
+			if (it == demandIndex.end())
+				throw compute_module::general_error(util::format("Demand rate period %d not found for month %d hour %d.", (int)period, (int)month, (int)hour));
+			m_stepDemandPeriod[step] = it->second;
+		}
+	}
+
+	m_energy.assign(12 * m_energyUpperBounds.size(), 0.);
+	m_demandPeaks.resize(12 * m_demandUpperBounds.size());
+	m_flatPeaks.resize(12);
+	for (size_t step = 0; step != nsteps; step++)
+	{
+		size_t month = m_stepMonth[step];
+		if (m_stepDemandPeriod[step] != none)
+			m_demandPeaks[month * m_demandUpperBounds.size() + m_stepDemandPeriod[step]].insert(0.);
+		m_flatPeaks[month].insert(0.);
+	}
+
+	m_monthEnergyCharge.assign(12, 0.);
+	m_monthDemandCharge.assign(12, 0.);
+	for (size_t month = 0; month != 12; month++)
+		updateMonth(month);
+}
+
+double UtilityRateIncremental::tieredCharge(double quantity, const std::vector<double> &upperBounds, const std::vector<double> &rates)
+{
+	double charge = 0;
+	double lower = 0;
+	for (size_t tier = 0; tier != upperBounds.size(); tier++)
+	{
+		if (quantity < upperBounds[tier])
+			return charge + (quantity - lower) * rates[tier];
+		charge += (upperBounds[tier] - lower) * rates[tier];
+		lower = upperBounds[tier];
+	}
+	return charge;
+}
+
+void UtilityRateIncremental::updateMonth(size_t month)
+{
+	// as in utilityrate5, tiers apply to the month's total purchases and each period pays its share
+	size_t nperiods = m_energyUpperBounds.size();
+	double purchases = 0;
+	for (size_t p = 0; p != nperiods; p++)
+		purchases += std::max(m_energy[month * nperiods + p], 0.);
+
+	double charge = 0;
+	for (size_t p = 0; p != nperiods; p++)
+	{
+		double energy = m_energy[month * nperiods + p];
+		if (energy > 0)
+			charge += energy / purchases * tieredCharge(purchases, m_energyUpperBounds[p], m_energyBuyRates[p]);
+		else
+			charge += energy * m_energySellRates[p];
+	}
+	m_monthEnergyCharge[month] = charge;
+
+	nperiods = m_demandUpperBounds.size();
+	charge = 0;
+	for (size_t p = 0; p != nperiods; p++)
+	{
+		const std::multiset<double> &peaks = m_demandPeaks[month * nperiods + p];
+		if (!peaks.empty() && *peaks.rbegin() > 0)
+			charge += tieredCharge(*peaks.rbegin(), m_demandUpperBounds[p], m_demandCharges[p]);
+	}
+	double flatPeak = *m_flatPeaks[month].rbegin();
+	if (flatPeak > 0)
+		charge += tieredCharge(flatPeak, m_flatUpperBounds[month], m_flatCharges[month]);
+	m_monthDemandCharge[month] = charge;
+}
+
+void UtilityRateIncremental::setPower(size_t step, double power)
+{
+	size_t month = m_stepMonth[step];
+	double old = m_power[step];
+	if (m_stepEnergyPeriod[step] != std::numeric_limits<size_t>::max())
+		m_energy[month * m_energyUpperBounds.size() + m_stepEnergyPeriod[step]] += (power - old) / m_stepsPerHour;
+	if (m_stepDemandPeriod[step] != std::numeric_limits<size_t>::max())
+	{
+		std::multiset<double> &peaks = m_demandPeaks[month * m_demandUpperBounds.size() + m_stepDemandPeriod[step]];
+		peaks.erase(peaks.find(old));
+		peaks.insert(power);
+	}
+	m_flatPeaks[month].erase(m_flatPeaks[month].find(old));
+	m_flatPeaks[month].insert(power);
+	m_power[step] = power;
+	updateMonth(month);
+}
+
+double UtilityRateIncremental::getPower(size_t step) const
+{
+	return m_power[step];
+}
+
+double UtilityRateIncremental::getBill() const
+{
+	double bill = 0;
+	for (size_t month = 0; month != 12; month++)
+		bill += m_monthEnergyCharge[month] + m_monthDemandCharge[month];
+	return bill;
+}
+
+double UtilityRateIncremental::getEnergyCharge(size_t month) const
+{
+	return m_monthEnergyCharge[month];
+}
+
+double UtilityRateIncremental::getDemandCharge(size_t month) const
+{
+	return m_monthDemandCharge[month];
+}
+
+double UtilityRateIncremental::changeCost(size_t stepA, double powerA, size_t stepB, double powerB)
+{
+	// apply the change, read the months it touched and put the previous state back exactly
+	size_t monthA = m_stepMonth[stepA];
+	size_t monthB = m_stepMonth[stepB];
+	double before = m_monthEnergyCharge[monthA] + m_monthDemandCharge[monthA];
+	if (monthB != monthA)
+		before += m_monthEnergyCharge[monthB] + m_monthDemandCharge[monthB];
+
+	std::vector<double> energy(m_energy);
+	double oldA = m_power[stepA];
+	double oldB = m_power[stepB];
+	setPower(stepA, powerA);
+	setPower(stepB, powerB);
+
+	double after = m_monthEnergyCharge[monthA] + m_monthDemandCharge[monthA];
+	if (monthB != monthA)
+		after += m_monthEnergyCharge[monthB] + m_monthDemandCharge[monthB];
+
+	setPower(stepB, oldB);
+	setPower(stepA, oldA);
+	m_energy.swap(energy);
+	updateMonth(monthA);
+	if (monthB != monthA)
+		updateMonth(monthB);
+	return after - before;
+}
+
+double UtilityRateIncremental::marginalCost(size_t step, double deltaPower)
+{
+	double power = m_power[step] + deltaPower;
+	return changeCost(step, power, step, power);
+}
+
+double UtilityRateIncremental::shiftCost(size_t from, size_t to, double energy)
+{
+	if (from == to)
+		return 0;
+	double deltaPower = energy * m_stepsPerHour;
+	return changeCost(from, m_power[from] - deltaPower, to, m_power[to] + deltaPower);
+}
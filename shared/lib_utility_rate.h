@@ -3,6 +3,7 @@
 
 #include "lib_util.h"
 #include <map>
+#include <set>
 
 class UtilityRate
 {
@@ -12,6 +13,10 @@ public:
 
 	UtilityRate(util::matrix_t<size_t> ecWeekday, util::matrix_t<size_t> ecWeekend, util::matrix_t<double> ecRatesMatrix);
 
+	/// Constructor for a rate that also has TOU (period, tier, max kW, charge) and monthly (month, tier, max kW, charge) demand charges
+	UtilityRate(util::matrix_t<size_t> ecWeekday, util::matrix_t<size_t> ecWeekend, util::matrix_t<double> ecRatesMatrix,
+		util::matrix_t<size_t> dcWeekday, util::matrix_t<size_t> dcWeekend, util::matrix_t<double> dcRatesMatrix, util::matrix_t<double> dcFlatMatrix);
+
 	virtual ~UtilityRate() {/* nothing to do */ };
 
 protected:
@@ -26,6 +31,18 @@ protected:
 
 	/// Energy Tiers per period
 	std::map<size_t, size_t> m_energyTiersPerPeriod;
+
+	/// Demand charge schedule for weekdays
+	util::matrix_t<size_t> m_dcWeekday;
+
+	/// Demand charge schedule for weekends
+	util::matrix_t<size_t> m_dcWeekend;
+
+	/// Demand charge periods, tiers, maxes, charges
+	util::matrix_t<double> m_dcRatesMatrix;
+
+	/// Demand charge months, tiers, maxes, charges
+	util::matrix_t<double> m_dcFlatMatrix;
 };
 
 class UtilityRateCalculator : protected UtilityRate
@@ -69,6 +86,88 @@ protected:
 	std::vector<double> m_energyUsagePerPeriod;
 };
 
+/**
+* Bill engine that keeps the monthly energy per period and the demand peaks up to date as the
+* grid power at any step of the year is changed, so the cost of a candidate change can be found
+* without recomputing the year.  As in utilityrate5, energy tiers apply to the month's total net
+* purchases (max usage taken as kWh) and each period pays its share of that energy at its own
+* tier rates, while net exports in a period are credited at its first tier sell rate.  Schedules
+* that name a period missing from the rate tables throw a general_error.
+*/
+class UtilityRateIncremental : protected UtilityRate
+{
+public:
+	/// Constructor for an engine with zero grid power at every step
+	UtilityRateIncremental(UtilityRate * Rate, size_t stepsPerHour);
+
+	/// Set the grid power at a step of the year (kW, positive from grid)
+	void setPower(size_t step, double power);
+
+	/// Get the grid power at a step of the year (kW)
+	double getPower(size_t step) const;
+
+	/// Energy plus demand charges for the year ($)
+	double getBill() const;
+
+	/// Energy charge for a month ($)
+	double getEnergyCharge(size_t month) const;
+
+	/// Demand charge for a month, TOU plus flat ($)
+	double getDemandCharge(size_t month) const;
+
+	/// Change in the bill if the grid power at a step changes by deltaPower ($)
+	double marginalCost(size_t step, double deltaPower);
+
+	/// Change in the bill if energy (kWh) drawn at step from is drawn at step to instead ($)
+	double shiftCost(size_t from, size_t to, double energy);
+
+	virtual ~UtilityRateIncremental() {/* nothing to do*/ };
+
+protected:
+
+	/// Tiered charge for a quantity given tier upper bounds and rates, as in utilityrate5
+	static double tieredCharge(double quantity, const std::vector<double> &upperBounds, const std::vector<double> &rates);
+
+	/// Recompute the cached charges of a month from its energies and peaks
+	void updateMonth(size_t month);
+
+	/// Bill change from setting the power at two steps (which may be the same), leaving the state unchanged
+	double changeCost(size_t stepA, double powerA, size_t stepB, double powerB);
+
+	/// The number of time steps per hour
+	size_t m_stepsPerHour;
+
+	/// Grid power at each step of the year (kW)
+	std::vector<double> m_power;
+
+	/// Month, energy period index and demand period index of each step
+	std::vector<size_t> m_stepMonth;
+	std::vector<size_t> m_stepEnergyPeriod;
+	std::vector<size_t> m_stepDemandPeriod;
+
+	/// Tier upper bounds, buy rates and first tier sell rate for each energy period index
+	std::vector<std::vector<double>> m_energyUpperBounds;
+	std::vector<std::vector<double>> m_energyBuyRates;
+	std::vector<double> m_energySellRates;
+
+	/// Tier upper bounds and charges for each demand period index and for each month
+	std::vector<std::vector<double>> m_demandUpperBounds;
+	std::vector<std::vector<double>> m_demandCharges;
+	std::vector<std::vector<double>> m_flatUpperBounds;
+	std::vector<std::vector<double>> m_flatCharges;
+
+	/// Net energy for each month and energy period index (kWh), month major
+	std::vector<double> m_energy;
+
+	/// Grid power of every step for each month and demand period index, and for each month (kW)
+	std::vector<std::multiset<double>> m_demandPeaks;
+	std::vector<std::multiset<double>> m_flatPeaks;
+
+	/// Cached charges for each month ($)
+	std::vector<double> m_monthEnergyCharge;
+	std::vector<double> m_monthDemandCharge;
+};
+
 
 
 
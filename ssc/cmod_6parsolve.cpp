@@ -51,6 +51,7 @@
 
 #include <limits>
 #include <cmath>
+#include <algorithm>
 
 #include "6par_jacobian.h"
 #include "6par_lu.h"
@@ -135,3 +136,134 @@ public:
 };
 
 DEFINE_MODULE_ENTRY( 6parsolve, "Solver for CEC/6 parameter PV module coefficients", 1 )
+
+
+/* *****************************************************************************
+			BATCH VERSION
+	coefficients for a whole module library in one call.  modules are sorted so
+	that similar modules are adjacent, and each module's solve starts from the
+	solution of its neighbor, falling back to the usual heuristics if that fails.
+	groups of neighboring modules are divided among worker threads.
+ ***************************************************************************** */
+
+static var_info _cm_vtab_6parsolve_batch[] = {
+/*   VARTYPE           DATATYPE         NAME                           LABEL                                UNITS     META                      GROUP                      REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,         SSC_ARRAY,       "tech",                   "Cell technology type",           "0..5",    "monoSi,multiSi/polySi,cdte,cis,cigs,amorphous","6 Parameter Solver","*",        "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "Vmp",                    "Maximum power point voltage",    "V",       "one value per module",  "6 Parameter Solver",      "*",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "Imp",                    "Maximum power point current",    "A",       "",                      "6 Parameter Solver",      "*",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "Voc",                    "Open circuit voltage",           "V",       "",                      "6 Parameter Solver",      "*",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "Isc",                    "Short circuit current",          "A",       "",                      "6 Parameter Solver",      "*",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "alpha_isc",              "Temp coeff of current at SC",    "A/'C",    "",                      "6 Parameter Solver",      "*",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "beta_voc",               "Temp coeff of voltage at OC",    "V/'C",    "",                      "6 Parameter Solver",      "*",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "gamma_pmp",              "Temp coeff of power at MP",      "%/'C",    "",                      "6 Parameter Solver",      "*",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "Nser",                   "Number of cells in series",      "",        "",                      "6 Parameter Solver",      "*",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "Tref",                   "Reference cell temperature",     "'C",      "",                      "6 Parameter Solver",      "?=25",                    "",      "" },
+	{ SSC_INPUT,         SSC_NUMBER,      "batch_threads",          "Number of worker threads",       "",        "0=one per processor",   "6 Parameter Solver",      "?=0",                     "INTEGER,MIN=0",      "" },
+	
+// outputs
+	{ SSC_OUTPUT,        SSC_MATRIX,      "coefficients",           "Module coefficients",            "",        "[a,Il,Io,Rs,Rsh,Adj], one row per module, NaN if not solved","6 Parameter Solver","*",          "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "status",                 "Solution status",                "",        "0=solved,<0=failed sanity check", "6 Parameter Solver", "*",                "",                      "" },
+	
+var_info_invalid };
+
+class cm_6parsolve_batch : public compute_module
+{
+public:
+
+	cm_6parsolve_batch()
+	{
+		add_var_info( _cm_vtab_6parsolve_batch );
+	}
+
+	// start from the solution of a similar module, scaling the parameters that depend on the datasheet values
+	static void warm_guess( module6par &m, const module6par &prev )
+	{
+		m.guess();
+		m.a = prev.a * m.Nser / prev.Nser;
+		m.Il = m.Isc;
+		m.Io = prev.Io;
+		m.Rs = prev.Rs * ((m.Voc - m.Vmp)/m.Imp) / ((prev.Voc - prev.Vmp)/prev.Imp);
+		m.Rsh = prev.Rsh * (m.Voc/(m.Isc - m.Imp)) / (prev.Voc/(prev.Isc - prev.Imp));
+		m.Adj = prev.Adj;
+	}
+
+	void exec( ) throw( general_error )
+	{
+		size_t nmod = as_vector_double("Vmp").size();
+		std::vector<double> tech = as_vector_expanded( "tech", nmod, "module" );
+		std::vector<double> Vmp = as_vector_expanded( "Vmp", nmod, "module" );
+		std::vector<double> Imp = as_vector_expanded( "Imp", nmod, "module" );
+		std::vector<double> Voc = as_vector_expanded( "Voc", nmod, "module" );
+		std::vector<double> Isc = as_vector_expanded( "Isc", nmod, "module" );
+		std::vector<double> aIsc = as_vector_expanded( "alpha_isc", nmod, "module" );
+		std::vector<double> bVoc = as_vector_expanded( "beta_voc", nmod, "module" );
+		std::vector<double> gPmp = as_vector_expanded( "gamma_pmp", nmod, "module" );
+		std::vector<double> nser = as_vector_expanded( "Nser", nmod, "module" );
+		std::vector<double> Tref = as_vector_expanded( "Tref", nmod, "module" );
+
+		std::vector<module6par> modules( nmod );
+		for( size_t i=0;i<nmod;i++ )
+		{
+			int type = (int)tech[i];
+			if ( type < module6par::monoSi || type > module6par::Amorphous )
+				throw exec_error( "6parsolve_batch", util::format("module %d: invalid cell technology type %d", (int)i, type) );
+			if ( nser[i] < 1 )
+				throw exec_error( "6parsolve_batch", util::format("module %d: number of cells in series must be positive", (int)i) );
+			modules[i] = module6par( type, Vmp[i], Imp[i], Voc[i], Isc[i], bVoc[i], aIsc[i], gPmp[i], (int)nser[i], Tref[i]+273.15 );
+		}
+
+		// similar modules next to each other: same technology, then cell count and open circuit voltage
+		std::vector<size_t> order( nmod );
+		for( size_t i=0;i<nmod;i++ ) order[i] = i;
+		std::sort( order.begin(), order.end(), [&]( size_t i, size_t j ) {
+			if ( modules[i].Type != modules[j].Type ) return modules[i].Type < modules[j].Type;
+			if ( modules[i].Nser != modules[j].Nser ) return modules[i].Nser < modules[j].Nser;
+			if ( modules[i].Voc != modules[j].Voc ) return modules[i].Voc < modules[j].Voc;
+			return i < j;
+		} );
+
+		std::vector<int> status( nmod, 0 );
+
+		// groups are a fixed size so that the results do not depend on the number of threads
+		const size_t group_size = 16;
+		size_t ngroups = (nmod + group_size - 1) / group_size;
+
+		parallel_for( ngroups, (size_t)as_integer( "batch_threads" ), [&]( size_t g, size_t )
+		{
+			const module6par *prev = 0;
+			for( size_t k=g*group_size;k<nmod && k<(g+1)*group_size;k++ )
+			{
+				module6par &m = modules[order[k]];
+				int err = -1;
+				if ( prev != 0 && prev->Type == m.Type )
+				{
+					warm_guess( m, *prev );
+					err = m.solve<double>( 300, 1e-7 );
+				}
+				if ( err < 0 )
+					err = m.solve_with_sanity_and_heuristics<double>( 300, 1e-7 );
+
+				status[order[k]] = err;
+				prev = ( err == 0 ) ? &m : 0;
+			}
+		} );
+
+		ssc_number_t *coefs = allocate( "coefficients", nmod, 6 );
+		ssc_number_t *p_status = allocate( "status", nmod );
+		for( size_t i=0;i<nmod;i++ )
+		{
+			const module6par &m = modules[i];
+			bool ok = ( status[i] == 0 );
+			ssc_number_t nan = std::numeric_limits<ssc_number_t>::quiet_NaN();
+			coefs[i*6+0] = ok ? (ssc_number_t)m.a : nan;
+			coefs[i*6+1] = ok ? (ssc_number_t)m.Il : nan;
+			coefs[i*6+2] = ok ? (ssc_number_t)m.Io : nan;
+			coefs[i*6+3] = ok ? (ssc_number_t)m.Rs : nan;
+			coefs[i*6+4] = ok ? (ssc_number_t)m.Rsh : nan;
+			coefs[i*6+5] = ok ? (ssc_number_t)m.Adj : nan;
+			p_status[i] = (ssc_number_t)status[i];
+		}
+	}
+};
+
+DEFINE_MODULE_ENTRY( 6parsolve_batch, "Solver for CEC/6 parameter PV module coefficients for many modules", 1 )
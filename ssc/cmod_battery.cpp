@@ -48,6 +48,8 @@
 *******************************************************************************************************/
 
 #include <math.h>
+#include <map>
+#include <set>
 
 #include "common.h"
 #include "core.h"
@@ -159,7 +161,7 @@ var_info vtab_battery_inputs[] = {
 	{ SSC_INPUT,        SSC_ARRAY,      "batt_target_power_monthly",                   "Grid target power on monthly basis",                     "kW",       "",                     "Battery",       "?=0",                        "",                             "" },
 	{ SSC_INPUT,        SSC_NUMBER,     "batt_target_choice",                          "Target power input option",                              "0/1",      "",                     "Battery",       "?=0",                        "",                             "" },
 	{ SSC_INPUT,        SSC_ARRAY,      "batt_custom_dispatch",                        "Custom battery power for every time step",               "kW",       "",                     "Battery",       "?=0",                        "",                             "" },
-	{ SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_choice",                        "Battery dispatch algorithm",                             "0/1/2/3/4", "",                    "Battery",       "?=0",                        "",                             "" },
+	{ SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_choice",                        "Battery dispatch algorithm",                             "0/1/2/3/4/5", "",                    "Battery",       "?=0",                        "",                             "" },
 	{ SSC_INPUT,        SSC_NUMBER,     "batt_pv_choice",                              "Prioritize PV usage for load or battery",                "0/1",      "",                     "Battery",       "?=0",                        "",                             "" },
 	{ SSC_INPUT,        SSC_ARRAY,      "batt_pv_clipping_forecast",                   "PV clipping forecast",                                   "kW",       "",                     "Battery",       "en_batt=1&batt_meter_position=1&batt_dispatch_choice=2",  "",          "" },
 	{ SSC_INPUT,        SSC_ARRAY,      "batt_pv_dc_forecast",                         "PV dc power forecast",                                   "kW",       "",                     "Battery",       "en_batt=1&batt_meter_position=1&batt_dispatch_choice=2",  "",          "" },
@@ -374,7 +376,8 @@ battstor::battstor(compute_module &cm, bool setup_model, size_t nrec, double dt_
 
 				if (batt_vars->batt_dispatch == dispatch_t::FOM_LOOK_AHEAD || 
 					batt_vars->batt_dispatch == dispatch_t::FOM_FORECAST || 
-					batt_vars->batt_dispatch == dispatch_t::FOM_LOOK_BEHIND)
+					batt_vars->batt_dispatch == dispatch_t::FOM_LOOK_BEHIND ||
+					batt_vars->batt_dispatch == dispatch_t::FOM_OPTIMAL)
 				{
 					batt_vars->batt_look_ahead_hours = cm.as_unsigned_long("batt_look_ahead_hours");
 					batt_vars->batt_dispatch_update_frequency_hours = cm.as_double("batt_dispatch_update_frequency_hours");
@@ -840,6 +843,9 @@ battstor::battstor(compute_module &cm, bool setup_model, size_t nrec, double dt_
 	{
 		double efficiencyCombined = batt_vars->batt_dc_dc_bms_efficiency * 0.01 * batt_vars->inverter_efficiency;
 
+		if (batt_vars->batt_dispatch == dispatch_t::FOM_OPTIMAL && batt_vars->batt_look_ahead_hours == 0)
+			throw compute_module::exec_error("battery", "optimal dispatch requires a look ahead of at least one hour");
+
 		// Create UtilityRate object only if utility rate is defined
 		utilityRate = NULL;
 		if (batt_vars->ec_rate_defined) {
@@ -928,7 +934,7 @@ void battstor::parse_configuration()
 		}
 		else if (batt_meter_position == dispatch_t::FRONT)
 		{
-			if (batt_dispatch == dispatch_t::FOM_LOOK_AHEAD) {
+			if (batt_dispatch == dispatch_t::FOM_LOOK_AHEAD || batt_dispatch == dispatch_t::FOM_OPTIMAL) {
 				look_ahead = true;
 			}
 			else if (batt_dispatch == dispatch_t::FOM_LOOK_BEHIND) {
@@ -1366,7 +1372,7 @@ public:
 	
 						batt.initialize_time(year, hour, jj);
 						batt.check_replacement_schedule();
-						batt.advance(*this, power_input[year_idx], power_load[year_idx]);
+						batt.advance(*this, power_input[year_idx], 0, power_load[year_idx]);
 						p_gen[lifetime_idx] = batt.outGenPower[lifetime_idx];
 						annual_energy += p_gen[lifetime_idx] * batt._dt_hour;
 						lifetime_idx++;
@@ -1386,3 +1392,373 @@ public:
 };
 
 DEFINE_MODULE_ENTRY(battery, "Battery storage standalone model .", 10)
+
+///////////////////////////////////////////////////
+static var_info _cm_vtab_battery_sweep[] = {
+	/*   VARTYPE           DATATYPE         NAME                                            LABEL                                                   UNITS      META                           GROUP                  REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,        SSC_NUMBER,      "en_batt",                                    "Enable battery storage model",                            "0/1",        "",                     "Battery",                      "?=1",                    "",                               "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "gen",                                        "System power generated",                                  "kW",         "year one, repeated for each year of a lifetime simulation", "", "*",                      "",                               "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "load",                                       "Electricity load (year 1)",                               "kW",         "behind the meter only, repeated for each year of a lifetime simulation", "", "",                       "",                               "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "batt_replacement_option",                    "Enable battery replacement?",                              "0=none,1=capacity based,2=user schedule", "", "Battery",             "?=0",                    "INTEGER,MIN=0,MAX=2",           "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "sweep_batt_kwh",                             "Battery bank capacity for each point",                    "kWh",        "",                     "Battery Sweep",                "*",                      "",                               "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "sweep_batt_kw",                              "Battery discharge power for each point",                  "kW",         "one value or one per point", "Battery Sweep",        "*",                      "",                               "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "sweep_batt_dispatch_choice",                 "Battery dispatch algorithm for each point",               "",           "one value or one per point, defaults to batt_dispatch_choice", "Battery Sweep", "", "",                            "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "sweep_batt_replacement_capacity",            "Capacity degradation at which to replace battery for each point", "%", "one value or one per point, defaults to batt_replacement_capacity", "Battery Sweep", "", "",                  "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "sweep_threads",                              "Number of worker threads",                                "",           "0=one per processor",  "Battery Sweep",                "?=0",                    "INTEGER,MIN=0",                  "" },
+
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_bank_capacity",                        "Simulated battery bank capacity",                         "kWh",        "whole strings nearest sweep_batt_kwh", "Battery Sweep", "*",                  "",                               "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_bank_power",                           "Simulated battery discharge power",                       "kW",         "",                     "Battery Sweep",                "*",                      "",                               "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_cycles",                               "Battery cycles at end of simulation",                     "",           "",                     "Battery Sweep",                "*",                      "",                               "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_capacity_percent",                     "Battery capacity at end of simulation",                   "%",          "",                     "Battery Sweep",                "*",                      "",                               "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_roundtrip_efficiency",                 "Average battery roundtrip efficiency",                    "%",          "",                     "Battery Sweep",                "*",                      "",                               "" },
+	{ SSC_OUTPUT,       SSC_MATRIX,      "sweep_annual_discharge_energy",              "Annual battery discharge energy",                         "kWh",        "one row per point, one column per year", "Battery Sweep", "*",                "",                               "" },
+	{ SSC_OUTPUT,       SSC_MATRIX,      "sweep_bank_replacement",                     "Battery bank replacements per year",                      "number",     "one row per point, one column per year", "Battery Sweep", "*",                "",                               "" },
+	{ SSC_OUTPUT,       SSC_MATRIX,      "sweep_annual_savings",                       "Annual energy value of the battery",                      "$",          "one row per point, one column per year, energy charges only", "Battery Sweep", "*", "",                      "" },
+
+	var_info_invalid };
+
+// Runs the battery for one point of a sweep.  Each worker thread owns one of these so that
+// the time series battstor allocates land in a private var_table, which is thrown away once
+// the compact metrics are collected.  Also used to parse the battery inputs from a copy of
+// the sweep inputs.
+class battery_sweep_point : public compute_module
+{
+public:
+	struct result
+	{
+		double bank_capacity;
+		double cycles;
+		double capacity_percent;
+		double roundtrip_efficiency;
+		std::vector<double> annual_discharge;
+		std::vector<double> replacements;
+		std::vector<double> savings;
+		std::vector<std::string> warnings;
+	};
+
+	battery_sweep_point() : m_vars(0), m_parsed(0), m_result(0), m_gen(0), m_load(0), m_buy(0), m_sell(0), m_value_base(0)
+	{
+		add_var_info(vtab_battery_outputs);
+	}
+
+	// parse the battery inputs from a var_table holding a copy of the sweep inputs, returns an empty string on success
+	std::string parse(var_table *inputs, batt_variables &vars)
+	{
+		m_vars = 0;
+		m_parsed = &vars;
+		silent_handler h(this);
+		return compute(&h, inputs) ? std::string() : h.last_error();
+	}
+
+	// run one point, gen and load cover every simulated year and are read but never modified,
+	// returns an empty string on success
+	std::string run(batt_variables *vars, const std::vector<ssc_number_t> &gen, const std::vector<ssc_number_t> &load,
+		const std::vector<double> &buy, const std::vector<double> &sell, double value_base, result &r)
+	{
+		m_vars = vars;
+		m_gen = &gen;
+		m_load = &load;
+		m_buy = &buy;
+		m_sell = &sell;
+		m_value_base = value_base;
+		m_result = &r;
+
+		clear_log();
+		var_table outputs;
+		silent_handler h(this);
+		if (!compute(&h, &outputs))
+			return h.last_error();
+		for (int i = 0; log_item *li = log(i); i++)
+			if (li->type == SSC_WARNING)
+				r.warnings.push_back(li->text);
+		return std::string();
+	}
+
+	void exec() throw(general_error)
+	{
+		if (!m_vars)
+		{
+			battstor parsed(*this, false, 8760, 1.);
+			*m_parsed = *parsed.batt_vars;
+			return;
+		}
+
+		const std::vector<ssc_number_t> &gen = *m_gen;
+		const std::vector<ssc_number_t> &load = *m_load;
+		size_t nrec = m_buy->size();
+		battstor batt(*this, true, nrec, static_cast<double>(8760. / nrec), m_vars);
+
+		// as in the battery module, front of meter dispatch is not given a generation and load forecast
+		if (m_vars->batt_meter_position == dispatch_t::BEHIND)
+			batt.initialize_automated_dispatch(gen, load);
+
+		result &r = *m_result;
+		r.bank_capacity = m_vars->batt_kwh;
+		r.annual_discharge.assign(batt.nyears, 0.);
+		r.replacements.assign(batt.nyears, 0.);
+		r.savings.assign(batt.nyears, 0.);
+
+		size_t lifetime_idx = 0;
+		for (size_t year = 0; year != batt.nyears; year++)
+		{
+			double value = 0;
+			size_t year_idx = 0;
+			for (size_t hour = 0; hour < 8760; hour++)
+			{
+				for (size_t jj = 0; jj < batt.step_per_hour; jj++)
+				{
+					batt.initialize_time(year, hour, jj);
+					batt.check_replacement_schedule();
+					batt.advance(*this, gen[lifetime_idx], 0, load[lifetime_idx]);
+
+					double P_grid = batt.outGridPower[lifetime_idx];
+					value += P_grid * (P_grid > 0 ? (*m_sell)[year_idx] : (*m_buy)[year_idx]);
+					lifetime_idx++;
+					year_idx++;
+				}
+			}
+			size_t annual_index = batt.nyears > 1 ? year + 1 : 0;
+			r.annual_discharge[year] = batt.outAnnualDischargeEnergy[annual_index];
+			r.replacements[year] = batt.outBatteryBankReplacement[annual_index];
+			r.savings[year] = value * batt._dt_hour - m_value_base;
+		}
+
+		r.cycles = batt.outCycles[lifetime_idx - 1];
+		r.capacity_percent = batt.outCapacityPercent[lifetime_idx - 1];
+		r.roundtrip_efficiency = batt.outAverageRoundtripEfficiency;
+	}
+
+private:
+	batt_variables *m_vars;
+	batt_variables *m_parsed;
+	result *m_result;
+	const std::vector<ssc_number_t> *m_gen;
+	const std::vector<ssc_number_t> *m_load;
+	const std::vector<double> *m_buy;
+	const std::vector<double> *m_sell;
+	double m_value_base;
+};
+
+class cm_battery_sweep : public compute_module
+{
+public:
+
+	cm_battery_sweep()
+	{
+		add_var_info(_cm_vtab_battery_sweep);
+		add_var_info(vtab_battery_inputs);
+	}
+
+	// scale the bank to the requested size, keeping the cells in series (and so the voltage) fixed
+	static void size_bank(batt_variables &vars, const batt_variables &base, double kwh, double kw)
+	{
+		int strings = (int)floor(base.batt_computed_strings * kwh / base.batt_kwh + 0.5);
+		if (strings < 1) strings = 1;
+		double s = (double)strings / base.batt_computed_strings;
+		vars.batt_computed_strings = strings;
+		vars.batt_kwh = base.batt_kwh * s;
+		vars.batt_Qfull_flow = base.batt_Qfull_flow * s;
+		vars.LeadAcid_q10_computed = base.LeadAcid_q10_computed * s;
+		vars.LeadAcid_q20_computed = base.LeadAcid_q20_computed * s;
+		vars.LeadAcid_qn_computed = base.LeadAcid_qn_computed * s;
+		vars.batt_mass = base.batt_mass * s;
+		vars.batt_length = base.batt_length * pow(s, 1. / 3.);
+		vars.batt_width = base.batt_width * pow(s, 1. / 3.);
+		vars.batt_height = base.batt_height * pow(s, 1. / 3.);
+
+		double p = kw / base.batt_power_discharge_max;
+		vars.batt_kw = kw;
+		vars.batt_power_discharge_max = kw;
+		vars.batt_power_charge_max = base.batt_power_charge_max * p;
+		vars.batt_current_discharge_max = base.batt_current_discharge_max * p;
+		vars.batt_current_charge_max = base.batt_current_charge_max * p;
+	}
+
+	// time series of energy buy and sell rates ($/kWh) used to value the grid power
+	void energy_rates(const batt_variables &vars, size_t nrec, std::vector<double> &buy, std::vector<double> &sell)
+	{
+		size_t step_per_hour = nrec / 8760;
+		buy.assign(nrec, 0.);
+		sell.assign(nrec, 0.);
+
+		if (is_assigned("ur_ec_tou_mat") && is_assigned("ur_ec_sched_weekday") && is_assigned("ur_ec_sched_weekend"))
+		{
+			util::matrix_t<double> ec_tou = as_matrix("ur_ec_tou_mat");
+			UtilityRate rate(as_matrix_unsigned_long("ur_ec_sched_weekday"), as_matrix_unsigned_long("ur_ec_sched_weekend"), ec_tou);
+			UtilityRateCalculator calculator(&rate, step_per_hour);
+
+			// first tier of each period, as the battery dispatch assumes
+			std::map<size_t, size_t> period_row;
+			for (size_t r = 0; r < ec_tou.nrows(); r++)
+				if (ec_tou(r, 1) == 1)
+					period_row[(size_t)ec_tou(r, 0)] = r;
+
+			for (size_t hour = 0; hour < 8760; hour++)
+			{
+				size_t period = calculator.getEnergyPeriod(hour);
+				if (period_row.find(period) == period_row.end())
+					throw exec_error("battery_sweep", util::format("energy rate period %d is not in ur_ec_tou_mat", (int)period));
+				size_t r = period_row[period];
+				for (size_t jj = 0; jj < step_per_hour; jj++)
+				{
+					buy[hour * step_per_hour + jj] = ec_tou(r, 4);
+					sell[hour * step_per_hour + jj] = ec_tou.ncols() > 5 ? ec_tou(r, 5) : 0.;
+				}
+			}
+		}
+
+		// front of meter systems sell at the PPA price and time of delivery factors
+		if (vars.batt_meter_position == dispatch_t::FRONT)
+		{
+			bool buy_at_ppa = !is_assigned("ur_ec_tou_mat");
+			for (size_t hour = 0; hour < 8760; hour++)
+			{
+				size_t month, hour_of_day;
+				util::month_hour(hour, month, hour_of_day);
+				size_t period = util::weekday(hour) ? vars.ppa_weekday_schedule.at(month - 1, hour_of_day - 1) : vars.ppa_weekend_schedule.at(month - 1, hour_of_day - 1);
+				double price = period >= 1 && period <= vars.ppa_factors.size() ? vars.ppa_factors[period - 1] : 0.;
+				for (size_t jj = 0; jj < step_per_hour; jj++)
+				{
+					sell[hour * step_per_hour + jj] = price;
+					if (buy_at_ppa)
+						buy[hour * step_per_hour + jj] = price;
+				}
+			}
+		}
+	}
+
+	void exec() throw(general_error)
+	{
+		std::vector<ssc_number_t> gen = as_vector_ssc_number_t("gen");
+		size_t nrec = gen.size();
+		size_t step_per_hour = nrec / 8760;
+		if (step_per_hour < 1 || step_per_hour > 60 || step_per_hour * 8760 != nrec)
+			throw exec_error("battery_sweep", util::format("invalid number of data records (%u): must be an integer multiple of 8760", nrec));
+
+		size_t npoints = as_vector_double("sweep_batt_kwh").size();
+		std::vector<double> kwh = as_vector_expanded("sweep_batt_kwh", npoints, "point");
+		std::vector<double> kw = as_vector_expanded("sweep_batt_kw", npoints, "point");
+		std::vector<double> dispatch = is_assigned("sweep_batt_dispatch_choice") ?
+			as_vector_expanded("sweep_batt_dispatch_choice", npoints, "point") : std::vector<double>(npoints, as_double("batt_dispatch_choice"));
+		std::vector<double> replacement_capacity;
+		if (is_assigned("sweep_batt_replacement_capacity"))
+			replacement_capacity = as_vector_expanded("sweep_batt_replacement_capacity", npoints, "point");
+
+		for (size_t i = 0; i < npoints; i++)
+			if (kwh[i] <= 0 || kw[i] <= 0)
+				throw exec_error("battery_sweep", util::format("point %d: battery capacity and power must be positive", (int)i));
+
+		// parse the battery inputs once for each dispatch choice in the sweep
+		var_table inputs;
+		for (var_info *vi = vtab_battery_inputs; vi->name != 0; vi++)
+			if (is_assigned(vi->name))
+				inputs.assign(vi->name, *lookup(vi->name));
+		inputs.assign("en_batt", var_data((ssc_number_t)1));
+
+		std::map<int, batt_variables> base_vars;
+		for (size_t i = 0; i < npoints; i++)
+		{
+			int choice = (int)dispatch[i];
+			if (base_vars.find(choice) != base_vars.end())
+				continue;
+
+			inputs.assign("batt_dispatch_choice", var_data((ssc_number_t)choice));
+			battery_sweep_point parser;
+			std::string error = parser.parse(&inputs, base_vars[choice]);
+			if (!error.empty())
+				throw exec_error("battery_sweep", util::format("dispatch choice %d: ", choice) + error);
+		}
+
+		const batt_variables &vars0 = base_vars.begin()->second;
+		if (vars0.batt_topology == ChargeController::DC_CONNECTED)
+			throw exec_error("battery_sweep", "Generic System must be AC connected to battery");
+		if (vars0.batt_kwh <= 0 || vars0.batt_computed_strings < 1 || vars0.batt_power_discharge_max <= 0)
+			throw exec_error("battery_sweep", "batt_computed_bank_capacity, batt_computed_strings and batt_power_discharge_max must be positive");
+
+		// load, rates and the value of the system without a battery are shared by all points
+		std::vector<ssc_number_t> load(nrec, 0.);
+		if (vars0.batt_meter_position == dispatch_t::BEHIND)
+		{
+			load = as_vector_ssc_number_t("load");
+			if (load.size() != nrec)
+				throw exec_error("battery_sweep", "Load and PV power do not match weatherfile length");
+		}
+
+		std::vector<double> buy, sell;
+		energy_rates(vars0, nrec, buy, sell);
+
+		double value_base = 0;
+		for (size_t i = 0; i < nrec; i++)
+		{
+			double P_grid = gen[i] - load[i];
+			value_base += P_grid * (P_grid > 0 ? sell[i] : buy[i]);
+		}
+		value_base *= 1. / step_per_hour;
+
+		// the automated dispatch forecasts over the whole simulation, so repeat year one for each year
+		size_t nyears = vars0.system_use_lifetime_output ? (size_t)vars0.analysis_period : 1;
+		gen.reserve(nrec * nyears);
+		load.reserve(nrec * nyears);
+		for (size_t i = nrec; i < nrec * nyears; i++)
+		{
+			gen.push_back(gen[i - nrec]);
+			load.push_back(load[i - nrec]);
+		}
+
+		std::vector<batt_variables> point_vars(npoints);
+		for (size_t i = 0; i < npoints; i++)
+		{
+			const batt_variables &base = base_vars[(int)dispatch[i]];
+			point_vars[i] = base;
+			size_bank(point_vars[i], base, kwh[i], kw[i]);
+			if (!replacement_capacity.empty())
+				point_vars[i].batt_replacement_capacity = replacement_capacity[i];
+		}
+
+		// one point model per thread, reused for each point the thread runs
+		size_t nthreads = (size_t)as_integer("sweep_threads");
+		std::vector<battery_sweep_point> points(parallel_threads(npoints, nthreads));
+		std::vector<battery_sweep_point::result> results(npoints);
+		std::vector<std::string> errors(npoints);
+		parallel_for(npoints, nthreads, [&](size_t i, size_t t)
+		{
+			errors[i] = points[t].run(&point_vars[i], gen, load, buy, sell, value_base, results[i]);
+		});
+
+		std::set<std::string> warnings;
+		for (size_t i = 0; i < npoints; i++)
+		{
+			if (!errors[i].empty())
+				throw exec_error("battery_sweep", util::format("point %d: ", (int)i) + errors[i]);
+			for (size_t k = 0; k < results[i].warnings.size(); k++)
+				if (warnings.insert(results[i].warnings[k]).second)
+					log(results[i].warnings[k], SSC_WARNING);
+		}
+
+		ssc_number_t *p_capacity = allocate("sweep_bank_capacity", npoints);
+		ssc_number_t *p_power = allocate("sweep_bank_power", npoints);
+		ssc_number_t *p_cycles = allocate("sweep_cycles", npoints);
+		ssc_number_t *p_capacity_percent = allocate("sweep_capacity_percent", npoints);
+		ssc_number_t *p_efficiency = allocate("sweep_roundtrip_efficiency", npoints);
+		ssc_number_t *p_discharge = allocate("sweep_annual_discharge_energy", npoints, nyears);
+		ssc_number_t *p_replacement = allocate("sweep_bank_replacement", npoints, nyears);
+		ssc_number_t *p_savings = allocate("sweep_annual_savings", npoints, nyears);
+		for (size_t i = 0; i < npoints; i++)
+		{
+			const battery_sweep_point::result &r = results[i];
+			p_capacity[i] = (ssc_number_t)r.bank_capacity;
+			p_power[i] = (ssc_number_t)point_vars[i].batt_kw;
+			p_cycles[i] = (ssc_number_t)r.cycles;
+			p_capacity_percent[i] = (ssc_number_t)r.capacity_percent;
+			p_efficiency[i] = (ssc_number_t)r.roundtrip_efficiency;
+			for (size_t y = 0; y < nyears; y++)
+			{
+				p_discharge[i * nyears + y] = (ssc_number_t)r.annual_discharge[y];
+				p_replacement[i * nyears + y] = (ssc_number_t)r.replacements[y];
+				p_savings[i * nyears + y] = (ssc_number_t)r.savings[y];
+			}
+		}
+	}
+};
+
+DEFINE_MODULE_ENTRY(battery_sweep, "Battery storage sizing and dispatch sweep sharing one generation and load profile.", 1)
@@ -1887,15 +1887,9 @@ public:
 		int its=0;
 		double irr_weighting_factor = DBL_MAX;
 		bool irr_is_minimally_met = false;
-		bool irr_greater_than_target = false;
-		double w0=1.0;
-		double w1=1.0;
 		double x0=ppa_min;
 		double x1=ppa_max;
-		double ppa_coarse_interval=10; // 10 cents/kWh
-		bool ppa_interval_found=false;
-		bool ppa_too_large=false;
-		bool ppa_interval_reset=true;
+		ppa_solver ppa_search(ppa_min, ppa_max, 10); // 10 cents/kWh coarse step until a secant is available
 		// 12/14/12 - address issue from Eric Lantz - ppa solution when target mode and ppa < 0
 		double ppa_old=ppa;
 
@@ -2088,7 +2082,6 @@ public:
 		cash_for_debt_service=0;
 		pv_cafds=0;
 		if (constant_dscr_mode)	size_of_debt=0;
-		if (ppa_interval_found)	ppa = (w0*x1+w1*x0)/(w0 + w1);
 
 		// debt pre calculation
 		for (i=1; i<=nyears; i++)
@@ -2641,67 +2634,11 @@ public:
 //				double itnpv_target = npv(CF_project_return_aftertax,flip_target_year,flip_frac) +  cf.at(CF_project_return_aftertax,0) ;
 				irr_weighting_factor = fabs(itnpv_target);
 				irr_is_minimally_met = ((irr_weighting_factor < ppa_soln_tolerance));
-				irr_greater_than_target = (( itnpv_target >= 0.0) || irr_is_minimally_met );
-				if (ppa_interval_found)
-				{// reset interval
-				
-					if (irr_greater_than_target) // too large
-					{
-			// set endpoint of weighted interval x0<x1
-						x1 = ppa;
-						w1 = irr_weighting_factor;
-					}
-					else // too small
-					{
-			// set endpoint of weighted interval x0<x1
-						x0 = ppa;
-						w0 = irr_weighting_factor;
-					}
-
-				}
-				else
-				{ // find solution interval [x0,x1]
-					if (ppa_interval_reset) 
-					{
-							if (irr_greater_than_target) ppa_too_large=true;
-							ppa_interval_reset=false;
-					}
-					if (ppa_too_large) // too large
-					{
-						if (irr_greater_than_target)
-						{
-							x0 = ppa;
-							w0 = irr_weighting_factor;
-							ppa = x0-ppa_coarse_interval;
-						}
-						else
-						{
-						  x1 = x0;
-						  w1 = w0;
-						  x0 = ppa;
-						  w0 = irr_weighting_factor;
-						  ppa_interval_found=true;
-						}
-					}
-					else
-					{
-						if (!irr_greater_than_target)
-						{
-							x1 = ppa;
-							w1 = irr_weighting_factor;
-							ppa = x1+ppa_coarse_interval;
-						}
-						else
-						{
-						  x0 = x1;
-						  w0 = w1;
-						  x1 = ppa;
-						  w1 = irr_weighting_factor;
-						  ppa_interval_found=true;
-						}
-					}
-					// for initial guess of zero
-					if (fabs(x0-x1)<ppa_soln_tolerance) x0 = x1-2*ppa_soln_tolerance;
+				if (!irr_is_minimally_met)
+				{
+					ppa = ppa_search.next(ppa, itnpv_target);
+					x0 = ppa_search.lower();
+					x1 = ppa_search.upper();
 				}
 					//std::stringstream outm;
 					//outm << "iteration=" << its  << ", irr=" << cf.at(CF_project_return_aftertax_irr, flip_target_year)  << ", npvtarget=" << itnpv_target  << ", npvtarget_delta=" << itnpv_target_delta  
@@ -3992,177 +3929,14 @@ public:
 
 	double npv( int cf_line, int nyears, double rate ) throw ( general_error )
 	{		
-		//if (rate == -1.0) throw general_error("cannot calculate NPV with discount rate equal to -1.0");
-		double rr = 1.0;
-		if (rate != -1.0) rr = 1.0/(1.0+rate);
-		double result = 0;
-		for (int i=nyears;i>0;i--)
-			result = rr * result + cf.at(cf_line,i);
-
-		return result*rr;
-	}
-
-/* ported from http://code.google.com/p/irr-newtonraphson-calculator/ */
-	bool is_valid_iter_bound(double estimated_return_rate)
-	{
-		return estimated_return_rate != -1 && (estimated_return_rate < std::numeric_limits<int>::max()) && (estimated_return_rate > std::numeric_limits<int>::min());
-	}
-
-	double irr_poly_sum(double estimated_return_rate, int cf_line, int count)
-	{
-		double sum_of_polynomial = 0;
-		if (is_valid_iter_bound(estimated_return_rate))
-		{
-			for (int j = 0; j <= count ; j++)
-			{
-				double val = (pow((1 + estimated_return_rate), j));
-				if (val != 0.0)
-					sum_of_polynomial += cf.at(cf_line,j)/val;
-				else
-					break;
-			}
-		}
-		return sum_of_polynomial;
-	}
-
-	double irr_derivative_sum(double estimated_return_rate,int cf_line, int count)
-	{
-		double sum_of_derivative = 0;
-		if (is_valid_iter_bound(estimated_return_rate))
-			for (int i = 1; i <= count ; i++)
-			{
-				sum_of_derivative += cf.at(cf_line,i)*(i)/pow((1 + estimated_return_rate), i+1);
-			}
-		return sum_of_derivative*-1;
-	}
-
-	double irr_scale_factor( int cf_unscaled, int count)
-	{
-		// scale to max value for better irr convergence
-		if (count<1) return 1.0;
-		int i=0;
-		double max=fabs(cf.at(cf_unscaled,0));
-		for (i=0;i<=count;i++) 
-			if (fabs(cf.at(cf_unscaled,i))> max) max =fabs(cf.at(cf_unscaled,i));
-		return (max>0 ? max:1);
-	}
-
-	bool is_valid_irr( int cf_line, int count, double residual, double tolerance, int number_of_iterations, int max_iterations, double calculated_irr, double scale_factor )
-	{
-		double npv_of_irr = npv(cf_line,count,calculated_irr)+cf.at(cf_line,0);
-		double npv_of_irr_plus_delta = npv(cf_line,count,calculated_irr+0.001)+cf.at(cf_line,0);
-		bool is_valid = ( (number_of_iterations<max_iterations) && (fabs(residual)<tolerance) && (npv_of_irr>npv_of_irr_plus_delta) && (fabs(npv_of_irr/scale_factor)<tolerance) );
-				//if (!is_valid)
-				//{
-				//std::stringstream outm;
-				//outm <<  "cf_line=" << cf_line << "count=" << count << "residual=" << residual << "number_of_iterations=" << number_of_iterations << "calculated_irr=" << calculated_irr
-				//	<< "npv of irr=" << npv_of_irr << "npv of irr plus delta=" << npv_of_irr_plus_delta;
-				//log( outm.str() );
-				//}
-		return is_valid;
+		return libfin::cashflow_npv(&cf.at(cf_line, 0), nyears, rate);
 	}
 
 	double irr( int cf_line, int count, double initial_guess=-2, double tolerance=1e-6, int max_iterations=100 )
 	{
-		int number_of_iterations=0;
-//		double calculated_irr = 0;
-		double calculated_irr = std::numeric_limits<double>::quiet_NaN();
-//		double calculated_irr = -999;
-
-
-		if (count < 1) 
-			return calculated_irr;
-
-		// only possible for first value negative
-		if ( (cf.at(cf_line,0) <= 0))
-		{
-			// initial guess from http://zainco.blogspot.com/2008/08/internal-rate-of-return-using-newton.html
-			if ((initial_guess < -1) && (count > 1))// second order
-			{
-				if (cf.at(cf_line,0) !=0) 
-				{
-					double b = 2.0+ cf.at(cf_line,1)/cf.at(cf_line,0);
-					double c = 1.0+cf.at(cf_line,1)/cf.at(cf_line,0)+cf.at(cf_line,2)/cf.at(cf_line,0);
-					initial_guess = -0.5*b - 0.5*sqrt(b*b-4.0*c);
-					if ((initial_guess <= 0) || (initial_guess >= 1)) initial_guess = -0.5*b + 0.5*sqrt(b*b-4.0*c);
-				}
-			}
-			else if (initial_guess < 0) // first order
-			{
-				if (cf.at(cf_line,0) !=0) initial_guess = -(1.0 + cf.at(cf_line,1)/cf.at(cf_line,0));
-			}
-
-			double scale_factor = irr_scale_factor(cf_line,count);
-			double residual=DBL_MAX;
-
-			calculated_irr = irr_calc(cf_line,count,initial_guess,tolerance,max_iterations,scale_factor,number_of_iterations,residual);
-
-			if (!is_valid_irr(cf_line,count,residual,tolerance,number_of_iterations,max_iterations,calculated_irr,scale_factor)) // try 0.1 as initial guess
-			{
-				initial_guess=0.1;
-				number_of_iterations=0;
-				residual=0;
-				calculated_irr = irr_calc(cf_line,count,initial_guess,tolerance,max_iterations,scale_factor,number_of_iterations,residual);
-			}
-
-			if (!is_valid_irr(cf_line,count,residual,tolerance,number_of_iterations,max_iterations,calculated_irr,scale_factor)) // try -0.1 as initial guess
-			{
-				initial_guess=-0.1;
-				number_of_iterations=0;
-				residual=0;
-				calculated_irr = irr_calc(cf_line,count,initial_guess,tolerance,max_iterations,scale_factor,number_of_iterations,residual);
-			}
-			if (!is_valid_irr(cf_line,count,residual,tolerance,number_of_iterations,max_iterations,calculated_irr,scale_factor)) // try 0 as initial guess
-			{
-				initial_guess=0;
-				number_of_iterations=0;
-				residual=0;
-				calculated_irr = irr_calc(cf_line,count,initial_guess,tolerance,max_iterations,scale_factor,number_of_iterations,residual);
-			}
-
-			if (!is_valid_irr(cf_line,count,residual,tolerance,number_of_iterations,max_iterations,calculated_irr,scale_factor)) // try 0.1 as initial guess
-			{
-//				calculated_irr = 0.0; // did not converge
-				calculated_irr = std::numeric_limits<double>::quiet_NaN(); // did not converge
-//				double calculated_irr = -999;
-			}
-
-		}
-		return calculated_irr;
+		return libfin::cashflow_irr(&cf.at(cf_line, 0), count, initial_guess, tolerance, max_iterations);
 	}
 
-
-	double irr_calc( int cf_line, int count, double initial_guess, double tolerance, int max_iterations, double scale_factor, int &number_of_iterations, double &residual )
-	{
-//		double calculated_irr = 0;
-		double calculated_irr = std::numeric_limits<double>::quiet_NaN();
-//		double calculated_irr = -999;
-		double deriv_sum = irr_derivative_sum(initial_guess, cf_line, count);
-		if (deriv_sum != 0.0)
-			calculated_irr = initial_guess - irr_poly_sum(initial_guess,cf_line,count)/deriv_sum;
-		else
-			return initial_guess;
-
-		number_of_iterations++;
-
-
-		residual = irr_poly_sum(calculated_irr,cf_line,count) / scale_factor;
-
-		while (!(fabs(residual) <= tolerance) && (number_of_iterations < max_iterations))
-		{
-			deriv_sum = irr_derivative_sum(initial_guess,cf_line,count);
-			if (deriv_sum != 0.0)
-				calculated_irr = calculated_irr - irr_poly_sum(calculated_irr,cf_line,count)/deriv_sum;
-			else
-				break;
-
-			number_of_iterations++;
-			residual = irr_poly_sum(calculated_irr,cf_line,count) / scale_factor;
-		}
-		return calculated_irr;
-	}
-
-
 	double min(double a, double b)
 	{ // handle NaN
 		if ((a != a) || (b != b))
@@ -4181,19 +3955,9 @@ public:
 
 	double min_cashflow_value(int cf_line, int nyears)
 	{
-		// check for NaN
-		bool is_nan = true;
-		for (int i = 1; i <= nyears; i++)
-			is_nan &= std::isnan(cf.at(cf_line, i));
-		if (is_nan) return std::numeric_limits<double>::quiet_NaN();
-
-		double min_value = DBL_MAX;
-		for (int i = 1; i <= nyears; i++)
-			if ((cf.at(cf_line, i)<min_value) && (cf.at(cf_line, i) != 0)) min_value = cf.at(cf_line, i);
-		return min_value;
+		return libfin::cashflow_min_value(&cf.at(cf_line, 0), nyears);
 	}
 
-
 };
 
 
@@ -220,6 +220,7 @@ static var_info _cm_vtab_pvsamv1[] = {
 	{ SSC_INPUT,        SSC_NUMBER,      "subarray4_backtrack",                         "Sub-array 4 Backtracking enabled",                        "",       "0=no backtracking,1=backtrack", "pvsamv1",              "subarray4_track_mode=1",   "BOOLEAN",                       "" },
 
 	{ SSC_INPUT,        SSC_NUMBER,      "module_model",                                "Photovoltaic module model specifier",                     "",       "0=spe,1=cec,2=6par_user,3=snl,4=sd11-iec61853", "pvsamv1",              "*",                        "INTEGER,MIN=0,MAX=4",           "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "selfshading_tilt_step",                       "Self-shading tracker tilt interpolation step",            "deg",    "0=exact",                       "pvsamv1",              "?=0",                      "MIN=0,MAX=10",                  "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "module_aspect_ratio",                         "Module aspect ratio",                                     "",       "",                              "pvsamv1",              "?=1.7",                    "",                              "POSITIVE" },
 	{ SSC_INPUT,        SSC_NUMBER,      "spe_area",                                    "Module area",                                             "m2",     "",                              "pvsamv1",              "module_model=0",           "",                              "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "spe_rad0",                                    "Irradiance level 0",                                      "W/m2",   "",                              "pvsamv1",              "module_model=0",           "",                              "" },
@@ -871,6 +872,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 	double ref_area_m2 = Subarrays[0]->Module->referenceArea;
 	double module_watts_stc = Subarrays[0]->Module->moduleWattsSTC;
 	bool enable_mismatch_vmax_calc = Subarrays[0]->Module->enableMismatchVoltageCalc;
+	pvmismatch_t mismatch;
 	int modules_per_string = PVSystem->modulesPerString;
 	int strings_in_parallel = PVSystem->stringsInParallel;
 	SharedInverter * sharedInverter = PVSystem->m_sharedInverter.get();
@@ -892,6 +894,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 		else
 			b = Subarrays[nn]->selfShadingInputs.nmody * Subarrays[nn]->selfShadingInputs.width;
 		Subarrays[nn]->selfShadingInputs.row_space = b / Subarrays[nn]->groundCoverageRatio;
+		Subarrays[nn]->selfShadingCache.setup(Subarrays[nn]->selfShadingInputs, Subarrays[nn]->selfShadingTiltStep);
 	}
 
 	double nameplate_kw = modules_per_string * strings_in_parallel * module_watts_stc * util::watt_to_kilowatt;
@@ -1078,10 +1081,39 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 			wdprov->rewind();
 		}
 	}
+
+	// Lifetime fast path: with a single-year weather file the irradiance, shading and module chain produce
+	// the same DC power every year, only degradation and lifetime losses differ.  Cache year-one DC power
+	// ahead of those factors and reuse it for the remaining years.  Snow coverage carries state across years,
+	// so its inputs are cached as well and the snow model itself is re-simulated.
+	bool reuse_year_one_dc = (system_use_lifetime_output && nyears > 1);
+	size_t nyears_dc_full = reuse_year_one_dc ? 1 : nyears;
+	size_t nsteps_year = 8760 * step_per_hour;
+	std::vector<double> p_dcpwr_year_one;
+	std::vector<int> p_sunup_year_one;
+	std::vector<std::vector<double>> p_snow_dcpwr_year_one, p_snow_shade_year_one;
+	std::vector<std::vector<float>> p_snow_poa_year_one, p_snow_tilt_year_one, p_snow_loss_year;
+	std::vector<float> p_snow_tdry_year_one, p_snow_depth_year_one;
+	if (reuse_year_one_dc)
+	{
+		p_dcpwr_year_one.resize(nsteps_year, 0.0);
+		if (Subarrays[0]->enableShowModel)
+		{
+			p_sunup_year_one.resize(nsteps_year, 0);
+			p_snow_dcpwr_year_one.resize(num_subarrays, std::vector<double>(nsteps_year, 0.0));
+			p_snow_shade_year_one.resize(num_subarrays, std::vector<double>(nsteps_year, 0.0));
+			p_snow_poa_year_one.resize(num_subarrays, std::vector<float>(nsteps_year, 0.0f));
+			p_snow_tilt_year_one.resize(num_subarrays, std::vector<float>(nsteps_year, 0.0f));
+			p_snow_loss_year.resize(num_subarrays, std::vector<float>(nsteps_year, 0.0f));
+			p_snow_tdry_year_one.resize(nsteps_year, 0.0f);
+			p_snow_depth_year_one.resize(nsteps_year, 0.0f);
+		}
+	}
+
 	/* *********************************************************************************************
 	PV DC calculation
 	*********************************************************************************************** */
-	for (size_t iyear = 0; iyear < nyears; iyear++)
+	for (size_t iyear = 0; iyear < nyears_dc_full; iyear++)
 	{
 		for (hour = 0; hour < 8760; hour++)
 		{
@@ -1399,8 +1431,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 						double shadedb_mppt_hi = PVSystem->voltageMpptHi1Module * modules_per_string;;
 
 						/// shading database if necessary
-						smart_ptr<ShadeDB8_mpp>::ptr  p_shade_db;
-						if (!Subarrays[nn]->shadeCalculator.fbeam_shade_db(p_shade_db, hour, solalt, solazi, jj, step_per_hour, shadedb_gpoa, shadedb_dpoa, tcell, modules_per_string, shadedb_str_vmp_stc, shadedb_mppt_lo, shadedb_mppt_hi))
+						if (!Subarrays[nn]->shadeCalculator.fbeam_shade_db(IOManager->m_shadeDatabase, hour, solalt, solazi, jj, step_per_hour, shadedb_gpoa, shadedb_dpoa, tcell, modules_per_string, shadedb_str_vmp_stc, shadedb_mppt_lo, shadedb_mppt_hi))
 						{
 							throw exec_error("pvsamv1", util::format("Error calculating shading factor for subarray %d", nn));
 						}
@@ -1414,7 +1445,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 							p_shadedb_str_vmp_stc[nn][idx] = (ssc_number_t)shadedb_str_vmp_stc;
 							p_shadedb_mppt_lo[nn][idx] = (ssc_number_t)shadedb_mppt_lo;
 							p_shadedb_mppt_hi[nn][idx] = (ssc_number_t)shadedb_mppt_hi;
-							log("shade db hour " + util::to_string((int)hour) +"\n" + p_shade_db->get_warning());
+							log("shade db hour " + util::to_string((int)hour) +"\n" + IOManager->m_shadeDatabase->get_warning());
 #endif
 							// fraction shaded for comparison
 							PVSystem->p_shadeDBShadeFraction[nn][idx] = (ssc_number_t)(Subarrays[nn]->shadeCalculator.dc_shade_factor());
@@ -1501,7 +1532,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 							}
 						}
 
-						else if (ss_exec(Subarrays[nn]->selfShadingInputs, stilt, sazi, solzen, solazi, beam_to_use, ibeam, (iskydiff + ignddiff), alb, trackbool, linear, shad1xf, Subarrays[nn]->selfShadingOutputs))
+						else if (ss_exec(Subarrays[nn]->selfShadingInputs, Subarrays[nn]->selfShadingCache, stilt, sazi, solzen, solazi, beam_to_use, ibeam, (iskydiff + ignddiff), alb, trackbool, linear, shad1xf, Subarrays[nn]->selfShadingOutputs))
 						{
 							if (linear) //fixed tilt linear
 							{
@@ -1617,43 +1648,22 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 						throw exec_error("pvsamv1", "Subarray voltage mismatch calculation requires more than one subarray. Please check your inputs.");
 					double vmax = Subarrays[0]->Module->moduleModel->VocRef()*1.3; // maximum voltage
 					double vmin = 0.4 * vmax; // minimum voltage
-					const int NP = 100;
-					double V[NP], I[NP], P[NP];
-					double Pmax = 0;
-					// sweep voltage, calculating current for each subarray module, and adding
-					for (int i = 0; i < NP; i++)
+					// one module from each subarray at a common voltage: bracket the combined maximum power point
+					// with a coarse scan, then refine it with a golden section search
+					mismatch.clear();
+					for (size_t nn = 0; nn < num_subarrays; nn++)
 					{
-						V[i] = vmin + (vmax - vmin)*i / ((double)NP);
-						I[i] = 0;
-						for (int nn = 0; nn < 4; nn++)
-						{
-							if (!Subarrays[nn]->enable || Subarrays[nn]->nStrings < 1) continue; // skip disabled subarrays
-
-							pvinput_t in(Subarrays[nn]->poa.poaBeamFront, Subarrays[nn]->poa.poaDiffuseFront, Subarrays[nn]->poa.poaGroundFront, Subarrays[nn]->poa.poaRear, Subarrays[nn]->poa.poaTotal,
-								wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
-								solzen, Subarrays[nn]->poa.angleOfIncidenceDegrees, hdr.elev,
-								Subarrays[nn]->poa.surfaceTiltDegrees, Subarrays[nn]->poa.surfaceAzimuthDegrees,
-								((double)wf.hour) + wf.minute / 60.0,
-								radmode, Subarrays[nn]->poa.usePOAFromWF);
-							pvoutput_t out(0, 0, 0, 0, 0, 0, 0, 0);
-							if (Subarrays[nn]->poa.sunUp)
-							{
-								double tcell = wf.tdry;
-								// calculate cell temperature using selected temperature model
-								(*Subarrays[nn]->Module->cellTempModel)(in, *Subarrays[nn]->Module->moduleModel, V[i], tcell);
-								// calculate module power output using conversion model previously specified
-								(*Subarrays[nn]->Module->moduleModel)(in, tcell, V[i], out);
-							}
-							I[i] += out.Current;
-						}
-
-						P[i] = V[i] * I[i];
-						if (P[i] > Pmax)
-						{
-							Pmax = P[i];
-							module_voltage = V[i];
-						}
+						if (!Subarrays[nn]->enable || Subarrays[nn]->nStrings < 1 || !Subarrays[nn]->poa.sunUp) continue; // skip disabled and dark subarrays
+
+						pvinput_t in(Subarrays[nn]->poa.poaBeamFront, Subarrays[nn]->poa.poaDiffuseFront, Subarrays[nn]->poa.poaGroundFront, Subarrays[nn]->poa.poaRear, Subarrays[nn]->poa.poaTotal,
+							wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
+							solzen, Subarrays[nn]->poa.angleOfIncidenceDegrees, hdr.elev,
+							Subarrays[nn]->poa.surfaceTiltDegrees, Subarrays[nn]->poa.surfaceAzimuthDegrees,
+							((double)wf.hour) + wf.minute / 60.0,
+							radmode, Subarrays[nn]->poa.usePOAFromWF);
+						mismatch.add(in, *Subarrays[nn]->Module->moduleModel, *Subarrays[nn]->Module->cellTempModel, wf.tdry);
 					}
+					mismatch.find_mpp(vmin, vmax, &module_voltage);
 
 					if (PVSystem->clipMpptWindow)
 					{
@@ -1771,9 +1781,22 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 					if (Subarrays[0]->enableShowModel)
 					{
 						float smLoss = 0.0f;
+						float snow_poa = (float)(Subarrays[nn]->poa.poaBeamFront + Subarrays[nn]->poa.poaDiffuseFront + Subarrays[nn]->poa.poaGroundFront);
+						float snow_tilt = (float)Subarrays[nn]->poa.surfaceTiltDegrees;
 
-						if (Subarrays[nn]->snowModel.getLoss((float)(Subarrays[nn]->poa.poaBeamFront + Subarrays[nn]->poa.poaDiffuseFront + Subarrays[nn]->poa.poaGroundFront),
-							(float)Subarrays[nn]->poa.surfaceTiltDegrees, (float)wf.wspd, (float)wf.tdry, (float)wf.snow, sunup, 1.0f / step_per_hour, &smLoss))
+						if (reuse_year_one_dc)
+						{
+							size_t istep = hour * step_per_hour + jj;
+							p_sunup_year_one[istep] = sunup;
+							p_snow_tdry_year_one[istep] = (float)wf.tdry;
+							p_snow_depth_year_one[istep] = (float)wf.snow;
+							p_snow_dcpwr_year_one[nn][istep] = Subarrays[nn]->module.dcPowerW;
+							p_snow_shade_year_one[nn][istep] = Subarrays[nn]->shadeCalculator.dc_shade_factor();
+							p_snow_poa_year_one[nn][istep] = snow_poa;
+							p_snow_tilt_year_one[nn][istep] = snow_tilt;
+						}
+
+						if (Subarrays[nn]->snowModel.getLoss(snow_poa, snow_tilt, (float)wf.wspd, (float)wf.tdry, (float)wf.snow, sunup, 1.0f / step_per_hour, &smLoss))
 						{
 							if (!Subarrays[nn]->snowModel.good)
 								throw exec_error("pvsamv1", Subarrays[nn]->snowModel.msg);
@@ -1818,6 +1841,9 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 				// bug fix jmf 12/13/16- losses that apply to ALL subarrays need to be applied OUTSIDE of the subarray summing loop
 				// if they're applied WITHIN the loop, as they had been, then the power from subarrays 1-3 get the SAME derate/degradation applied nn-1 times, instead of just once!!
 
+				if (reuse_year_one_dc)
+					p_dcpwr_year_one[hour * step_per_hour + jj] = dcpwr_net;
+
 				//module degradation and lifetime DC losses apply to all subarrays
 				if (system_use_lifetime_output == 1)
 					dcpwr_net *= PVSystem->p_dcDegradationFactor[iyear + 1];
@@ -1874,14 +1900,10 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 				}
 				p_pv_dc_use.push_back(static_cast<ssc_number_t>(dcpwr));
 
- 				sharedInverter->calculateACPower(dcpwr * util::kilowatt_to_watt, dc_string_voltage, 0.0);
-
 				if (p_pv_clipping_forecast.size() > 1 && p_pv_clipping_forecast.size() > idx % (8760 * step_per_hour)) {
 					cliploss = p_pv_clipping_forecast[idx % (8760 * step_per_hour)] * util::kilowatt_to_watt;
 				}
 
-				p_invcliploss_full.push_back(static_cast<ssc_number_t>(sharedInverter->powerClipLoss_kW));
-
 				idx++;
 			}
 		}
@@ -1889,9 +1911,117 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 		wdprov->rewind();
 	}
 
+	/* *********************************************************************************************
+	PV DC calculation - lifetime years reusing year-one DC power
+	*********************************************************************************************** */
+	for (size_t iyear = nyears_dc_full; iyear < nyears; iyear++)
+	{
+		// snow coverage depends on the previous timestep, so re-run the snow model on the cached inputs,
+		// one whole year per subarray at a time
+		if (Subarrays[0]->enableShowModel)
+		{
+			for (size_t nn = 0; nn < num_subarrays; nn++)
+			{
+				if (!Subarrays[nn]->enable
+					|| Subarrays[nn]->nStrings < 1)
+					continue; // skip disabled subarrays
+
+				if (!Subarrays[nn]->snowModel.getLoss(&p_snow_poa_year_one[nn][0], &p_snow_tilt_year_one[nn][0], &p_snow_tdry_year_one[0],
+					&p_snow_depth_year_one[0], &p_sunup_year_one[0], 1.0f / step_per_hour, nsteps_year, &p_snow_loss_year[nn][0]))
+				{
+					if (!Subarrays[nn]->snowModel.good)
+						throw exec_error("pvsamv1", Subarrays[nn]->snowModel.msg);
+				}
+			}
+		}
+
+		for (hour = 0; hour < 8760; hour++)
+		{
+			// report progress updates to the caller
+			ireport++;
+			if (ireport - ireplast > irepfreq)
+			{
+				percent_complete = percent_baseline + 100.0f *(float)(hour + iyear * 8760) / (float)(insteps);
+				if (!update("", percent_complete))
+					throw exec_error("pvsamv1", "simulation canceled at hour " + util::to_string(hour + 1.0) + " in year " + util::to_string((int)iyear + 1) + "in dc loop");
+				ireplast = ireport;
+			}
+
+			if (nload == 8760)
+				cur_load = p_load_in[hour];
+
+			for (size_t jj = 0; jj < step_per_hour; jj++)
+			{
+				size_t istep = hour * step_per_hour + jj;
+
+				if (nload == nrec)
+					cur_load = p_load_in[istep];
+				p_load_full.push_back((ssc_number_t)cur_load);
+
+				double dcpwr_net = p_dcpwr_year_one[istep];
+
+				if (Subarrays[0]->enableShowModel)
+				{
+					dcpwr_net = 0.0;
+					for (size_t nn = 0; nn < num_subarrays; nn++)
+					{
+						if (!Subarrays[nn]->enable
+							|| Subarrays[nn]->nStrings < 1)
+							continue; // skip disabled subarrays
+
+						double dcpwr_subarray = p_snow_dcpwr_year_one[nn][istep];
+						dcpwr_subarray *= (1 - p_snow_loss_year[nn][istep]);
+						dcpwr_subarray *= p_snow_shade_year_one[nn][istep];
+						dcpwr_net += dcpwr_subarray * Subarrays[nn]->dcLoss;
+					}
+				}
+
+				//module degradation and lifetime DC losses apply to all subarrays
+				dcpwr_net *= PVSystem->p_dcDegradationFactor[iyear + 1];
+
+				//dc adjustment factors apply to all subarrays
+				dcpwr_net *= dc_haf(hour);
+
+				//lifetime daily DC losses apply to all subarrays and should be applied last. Only applied if they are enabled.
+				if (PVSystem->enableDCLifetimeLosses)
+				{
+					int dc_loss_index = (int)iyear * 365 + (int)floor(hour / 24); //in units of days
+					dcpwr_net *= (100 - PVSystem->p_dcLifetimeLosses[dc_loss_index]) / 100;
+				}
+
+				// string voltage does not degrade, so it is taken directly from year one
+				double dc_string_voltage = PVSystem->p_inverterDCVoltage[istep];
+				PVSystem->p_inverterDCVoltage[idx] = (ssc_number_t)dc_string_voltage;
+				PVSystem->p_systemDCPower[idx] = (ssc_number_t)(dcpwr_net * util::watt_to_kilowatt);
+
+				// Predict clipping for DC battery controller
+				double dcpwr = PVSystem->p_systemDCPower[idx];
+				if (p_pv_dc_forecast.size() > 1 && p_pv_dc_forecast.size() > idx % (8760 * step_per_hour)) {
+					dcpwr = p_pv_dc_forecast[idx % (8760 * step_per_hour)];
+				}
+				p_pv_dc_use.push_back(static_cast<ssc_number_t>(dcpwr));
+
+				idx++;
+			}
+		}
+	}
+
 	// Initialize DC battery predictive controller
 	if (en_batt && (batt_topology == ChargeController::DC_CONNECTED))
+	{
+		// predicted inverter clipping of the PV-only DC power, computed for the whole analysis period at once
+		std::vector<double> inv_dc_power(p_pv_dc_use.size()), inv_dc_voltage(p_pv_dc_use.size()), inv_cliploss(p_pv_dc_use.size());
+		for (size_t i = 0; i < p_pv_dc_use.size(); i++)
+		{
+			inv_dc_power[i] = p_pv_dc_use[i] * util::kilowatt_to_watt;
+			inv_dc_voltage[i] = PVSystem->p_inverterDCVoltage[i];
+		}
+		if (inv_dc_power.size() > 0)
+			sharedInverter->calculateACPower(&inv_dc_power[0], &inv_dc_voltage[0], NULL, inv_dc_power.size(), NULL, &inv_cliploss[0]);
+		p_invcliploss_full.assign(inv_cliploss.begin(), inv_cliploss.end());
+
 		batt.initialize_automated_dispatch(util::array_to_vector<ssc_number_t>(PVSystem->p_systemDCPower, nlifetime), p_load_full, p_invcliploss_full);
+	}
 
 	/* *********************************************************************************************
 	PV AC calculation
@@ -2123,7 +2253,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 
 	double annual_inv_psoloss = accumulate_annual_for_year("inv_psoloss", "annual_inv_psoloss", ts_hour, step_per_hour );
 	double annual_inv_pntloss = accumulate_annual_for_year("inv_pntloss", "annual_inv_pntloss", ts_hour, step_per_hour);
-	double annual_inv_tdcloss = accumulate_annual_for_year("inv_tdcloss", "annual_inv_tdcloss", ts_hour, step_per_hour);
+	double annual_inv_tdcloss = accumulate_annual_for_year("inv_tdcloss", "annual_inv_tdcloss", ts_hour, step_per_hour);
 
 	double nom_rad = Subarrays[0]->Module->isConcentratingPV ? annual_poa_beam_nom : annual_poa_nom;
 	double inp_rad = Subarrays[0]->Module->isConcentratingPV ? annual_poa_beam_eff : annual_poa_eff;
@@ -188,40 +188,11 @@ public:
 		tilt = as_double("tilt");
 		azimuth = as_double("azimuth");
 
-		gamma = 0;
-		use_ar_glass = false;
-
 		module_type = as_integer("module_type");
-		switch( module_type )
-		{
-		case 0: // standard module
-			gamma = -0.0047; use_ar_glass = false; break;
-		case 1: // premium module
-			gamma = -0.0035; use_ar_glass = true; break;
-		case 2: // thin film module
-			gamma = -0.0020; use_ar_glass = false; break;
-		}
-
-		track_mode =  0;
-		inoct = 45;
-		shade_mode_1x = 0; // self shaded
+		pvwattsv5_module_type( module_type, gamma, use_ar_glass );
 		
 		array_type = as_integer("array_type"); // 0, 1, 2, 3, 4		
-		switch( array_type )
-		{
-		case 0: // fixed open rack
-			track_mode = 0; inoct = 45; shade_mode_1x = 0; break;
-		case 1: // fixed roof mount
-			track_mode = 0; inoct = 49; shade_mode_1x = 0; break;
-		case 2: // 1 axis self-shaded
-			track_mode = 1; inoct = 45; shade_mode_1x = 0; break;
-		case 3: // 1 axis backtracked
-			track_mode = 1; inoct = 45; shade_mode_1x = 1; break;
-		case 4: // 2 axis
-			track_mode = 2; inoct = 45; shade_mode_1x = 0; break;
-		case 5: // azimuth axis
-			track_mode = 3; inoct = 45; shade_mode_1x = 0; break;
-		}
+		pvwattsv5_array_type( array_type, track_mode, inoct, shade_mode_1x );
 
 		
 		gcr = 0.4;
@@ -271,23 +242,9 @@ public:
 
 				if ( shade_mode_1x == 0 && iskydiff > 0 )
 				{
-					double reduced_skydiff = iskydiff;
 					double Fskydiff = 1.0;
-					double reduced_gnddiff = ignddiff;
 					double Fgnddiff = 1.0;
-						
-					// worst-case mask angle using calculated surface tilt
-					double phi0 = 180/3.1415926*atan2( sind( stilt ), 1/gcr - cosd( stilt ) );
-
-					// calculate sky and gnd diffuse derate factors
-					// based on view factor reductions from self-shading
-					diffuse_reduce( solzen, stilt,
-						dni, iskydiff+ignddiff,
-						gcr, phi0, alb, 1000,
-
-						// outputs (pass by reference)
-						reduced_skydiff, Fskydiff,
-						reduced_gnddiff, Fgnddiff );
+					pvwattsv5_diffuse_selfshade_1x( solzen, stilt, dni, iskydiff, ignddiff, gcr, alb, Fskydiff, Fgnddiff );
 
 					if ( Fskydiff >= 0 && Fskydiff <= 1 ) iskydiff *= Fskydiff;
 					else log( util::format("sky diffuse reduction factor invalid at time %lg: fskydiff=%lg, stilt=%lg", time, Fskydiff, stilt), SSC_NOTICE, (float)time );
@@ -309,14 +266,7 @@ public:
 			double wspd_corr = wspd < 0 ? 0 : wspd;					
 
 			// module cover			
-			tpoa = poa;
-			if ( aoi > AOI_MIN && aoi < AOI_MAX )
-			{
-				double mod = iam( aoi, use_ar_glass );
-				tpoa = poa - ( 1.0 - mod )*dni*cosd(aoi);
-				if( tpoa < 0.0 ) tpoa = 0.0;
-				if( tpoa > poa ) tpoa = poa;
-			}
+			tpoa = pvwattsv5_tpoa( poa, dni, aoi, use_ar_glass );
 						
 			// cell temperature
 			pvt = (*tccalc)( poa, wspd_corr, tdry );
@@ -328,26 +278,7 @@ public:
 			dc = dc*(1-loss_percent/100);
 
 			// inverter efficiency
-			double etanom = inv_eff_percent/100.0;
-			double etaref = 0.9637;
-			double A =  -0.0162;
-			double B = -0.0059;
-			double C =  0.9858;
-			double pdc0 = ac_nameplate/etanom;
-			double plr = dc / pdc0;
-			ac = 0;
-				
-			if ( plr > 0 )
-			{ // normal operation
-				double eta = (A*plr + B/plr + C)*etanom/etaref;
-				ac = dc*eta;
-			}
-
-			if ( ac > ac_nameplate ) // clipping
-				ac = ac_nameplate;
-
-			// make sure no negative AC values (no parasitic nighttime losses calculated)
-			if ( ac < 0 ) ac = 0;
+			ac = pvwattsv5_inverter( dc, ac_nameplate, inv_eff_percent );
 		}
 		else
 		{
@@ -676,3 +607,184 @@ public:
 };
 
 DEFINE_MODULE_ENTRY( pvwattsv5_1ts, "pvwattsv5_1ts- single timestep calculation of PV system performance.", 1 )
+
+
+
+/* *****************************************************************************
+			FLEET VERSION
+	many systems simulated against one weather file.  the weather file is read
+	and the sun position is calculated once, then the systems are divided among
+	worker threads.  shading and adjustment factor inputs are not available.
+ ***************************************************************************** */
+
+static var_info _cm_vtab_pvwattsv5_fleet[] = {
+/*   VARTYPE           DATATYPE          NAME                         LABEL                                               UNITS        META                      GROUP          REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,        SSC_ARRAY,       "system_capacity",                "System size (DC nameplate)",                  "kW",        "one value per system",       "PVWatts",      "*",                       "",                      "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "module_type",                    "Module type",                                 "0/1/2",     "Standard,Premium,Thin film", "PVWatts",      "?=0",                     "",                      "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "dc_ac_ratio",                    "DC to AC ratio",                              "ratio",     "",                           "PVWatts",      "?=1.1",                   "",                      "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "inv_eff",                        "Inverter efficiency at rated power",          "%",         "",                           "PVWatts",      "?=96",                    "",                      "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "losses",                         "System losses",                               "%",         "Total system losses",        "PVWatts",      "*",                       "",                      "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "array_type",                     "Array type",                                  "0/1/2/3/4", "Fixed OR,Fixed Roof,1Axis,Backtracked,2Axis",  "PVWatts",      "*",       "",                      "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "tilt",                           "Tilt angle",                                  "deg",       "H=0,V=90",                   "PVWatts",      "*",                       "",                      "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "azimuth",                        "Azimuth angle",                               "deg",       "E=90,S=180,W=270",           "PVWatts",      "*",                       "",                      "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "gcr",                            "Ground coverage ratio",                       "0..1",      "",                           "PVWatts",      "?=0.4",                   "",                      "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "fleet_threads",                  "Number of worker threads",                    "",          "0=one per processor",        "PVWatts",      "?=0",                     "INTEGER,MIN=0",         "" },
+
+	{ SSC_OUTPUT,       SSC_MATRIX,      "fleet_gen",                      "System power generated",                      "kW",        "one row per system",         "Time Series",  "*",                       "",                      "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "fleet_annual_energy",            "Annual energy",                               "kWh",       "",                           "Annual",       "*",                       "",                      "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "fleet_kwh_per_kw",               "First year kWh/kW",                           "",          "",                           "Annual",       "*",                       "",                      "" },
+	{ SSC_OUTPUT,       SSC_NUMBER,      "ts_shift_hours",                 "Time offset for interpreting time series outputs",  "hours", "",                  "Miscellaneous", "*",                      "",                      "" },
+
+	var_info_invalid };
+
+class cm_pvwattsv5_fleet : public compute_module
+{
+public:
+
+	cm_pvwattsv5_fleet()
+	{
+		add_var_info( _cm_vtab_pvwattsv5_part1 );
+		add_var_info( _cm_vtab_pvwattsv5_fleet );
+	}
+
+	// simulate one system over the whole weather file, returns an empty string on success
+	static std::string run_system( const pvwattsv5_system &sys,
+		const std::vector<weather_record> &weather, const std::vector<irrad_sunpos> &sunpos,
+		const weather_header &hdr, bool instantaneous, double ts_hour,
+		ssc_number_t *gen, double &annual_kwh )
+	{
+		pvwattsv5_site site( sys, hdr.lat, hdr.lon, hdr.tz, ts_hour );
+
+		annual_kwh = 0;
+		for( size_t idx=0;idx<weather.size();idx++ )
+		{
+			const weather_record &wf = weather[idx];
+
+			double alb = 0.2; // do not increase albedo if snow exists in TMY2			
+			if ( std::isfinite( wf.alb ) && wf.alb > 0 && wf.alb < 1 )
+				alb = wf.alb;
+
+			double dc, ac;
+			int code = site.calc( wf.year, wf.month, wf.day, wf.hour, wf.minute,
+				instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour,
+				wf.dn, wf.df, wf.tdry, wf.wspd, alb, dc, ac, &sunpos[idx] );
+			if ( code != 0 && code != -1 )
+				return util::format("failed to process irradiation on surface (code: %d) [y:%d m:%d d:%d h:%d]", 
+					code, wf.year, wf.month, wf.day, wf.hour);
+
+			gen[idx] = (ssc_number_t)(ac * 0.001f); // W to kW
+			annual_kwh += gen[idx];
+		}
+
+		annual_kwh *= ts_hour;
+		return std::string();
+	}
+
+	void exec( ) throw( general_error )
+	{
+		std::unique_ptr<weather_data_provider> wdprov;
+
+		if ( is_assigned( "solar_resource_file" ) )
+		{
+			const char *file = as_string("solar_resource_file");
+			wdprov = std::unique_ptr<weather_data_provider>( new weatherfile( file ) );
+
+			weatherfile *wfile = dynamic_cast<weatherfile*>(wdprov.get());
+			if (!wfile->ok()) throw exec_error("pvwattsv5_fleet", wfile->message());
+			if( wfile->has_message() ) log( wfile->message(), SSC_WARNING);
+		}
+		else if ( is_assigned( "solar_resource_data" ) )
+		{
+			wdprov = std::unique_ptr<weather_data_provider>( new weatherdata( lookup("solar_resource_data") ) );
+		}
+		else
+			throw exec_error("pvwattsv5_fleet", "no weather data supplied");
+
+		// system parameters
+		size_t nsys = as_vector_double("system_capacity").size();
+		std::vector<double> capacity = as_vector_expanded( "system_capacity", nsys, "system" );
+		std::vector<double> module_type = as_vector_expanded( "module_type", nsys, "system" );
+		std::vector<double> dc_ac_ratio = as_vector_expanded( "dc_ac_ratio", nsys, "system" );
+		std::vector<double> inv_eff = as_vector_expanded( "inv_eff", nsys, "system" );
+		std::vector<double> losses = as_vector_expanded( "losses", nsys, "system" );
+		std::vector<double> array_type = as_vector_expanded( "array_type", nsys, "system" );
+		std::vector<double> tilt = as_vector_expanded( "tilt", nsys, "system" );
+		std::vector<double> azimuth = as_vector_expanded( "azimuth", nsys, "system" );
+		std::vector<double> gcr = as_vector_expanded( "gcr", nsys, "system" );
+
+		std::vector<pvwattsv5_system> systems( nsys );
+		for( size_t i=0;i<nsys;i++ )
+		{
+			std::string error;
+			if ( !systems[i].setup( capacity[i], (int)module_type[i], dc_ac_ratio[i], inv_eff[i], losses[i],
+					(int)array_type[i], tilt[i], azimuth[i], is_assigned("gcr") ? gcr[i] : 0.4, &error ) )
+				throw exec_error( "pvwattsv5_fleet", util::format("system %d: ", (int)i) + error );
+		}
+
+		weather_header hdr;
+		wdprov->header( &hdr );
+
+		// same time convention as pvwattsv5
+		double ts_shift_hours = 0.0;
+		bool instantaneous = true;
+		if ( wdprov->has_data_column( weather_data_provider::MINUTE ) )
+		{
+			weather_record rec;
+			if ( wdprov->read( &rec ) )
+				ts_shift_hours = rec.minute/60.0;
+
+			wdprov->rewind();
+		}
+		else if ( wdprov->nrecords() == 8760 )
+		{
+			instantaneous = false;
+			ts_shift_hours = 0.5;
+		}
+		else
+			throw exec_error("pvwattsv5_fleet", "subhourly weather files must specify the minute for each record" );
+
+		assign( "ts_shift_hours", var_data( (ssc_number_t)ts_shift_hours ) );
+
+		size_t nrec = wdprov->nrecords();
+		size_t step_per_hour = nrec/8760;
+		if ( step_per_hour < 1 || step_per_hour > 60 || step_per_hour*8760 != nrec )
+			throw exec_error( "pvwattsv5_fleet", util::format("invalid number of data records (%d): must be an integer multiple of 8760", (int)nrec ) );
+
+		double ts_hour = 1.0/step_per_hour;
+
+		// read the weather and calculate the sun position once for all systems
+		std::vector<weather_record> weather( nrec );
+		std::vector<irrad_sunpos> sunpos( nrec );
+		for( size_t idx=0;idx<nrec;idx++ )
+		{
+			if (!wdprov->read( &weather[idx] ))
+				throw exec_error("pvwattsv5_fleet", util::format("could not read data line %d of %d in weather file", (int)(idx+1), (int)nrec ));
+
+			const weather_record &wf = weather[idx];
+			irrad irr;
+			irr.set_time( wf.year, wf.month, wf.day, wf.hour, wf.minute,
+				instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour );
+			irr.set_location( hdr.lat, hdr.lon, hdr.tz );
+			irr.calc_sunpos( sunpos[idx] );
+		}
+
+		ssc_number_t *p_gen = allocate( "fleet_gen", nsys, nrec );
+		ssc_number_t *p_annual = allocate( "fleet_annual_energy", nsys );
+		ssc_number_t *p_kwh_per_kw = allocate( "fleet_kwh_per_kw", nsys );
+
+		std::vector<std::string> errors( nsys );
+		parallel_for( nsys, (size_t)as_integer( "fleet_threads" ), [&]( size_t i, size_t )
+		{
+			double annual_kwh = 0;
+			errors[i] = run_system( systems[i], weather, sunpos, hdr, instantaneous, ts_hour, p_gen + i*nrec, annual_kwh );
+			p_annual[i] = (ssc_number_t)annual_kwh;
+			p_kwh_per_kw[i] = (ssc_number_t)(annual_kwh / capacity[i]);
+		} );
+
+		for( size_t i=0;i<nsys;i++ )
+			if ( !errors[i].empty() )
+				throw exec_error( "pvwattsv5_fleet", util::format("system %d: ", (int)i) + errors[i] );
+	}
+};
+
+DEFINE_MODULE_ENTRY( pvwattsv5_fleet, "pvwattsv5_fleet- PVWatts V5 for many systems sharing one weather file.", 1 )
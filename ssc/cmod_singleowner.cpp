@@ -51,6 +51,9 @@
 #include "lib_financial.h"
 using namespace libfin;
 #include <sstream>
+#include <limits>
+#include <memory>
+#include <string.h>
 
 #ifndef WIN32
 #include <float.h>
@@ -1048,19 +1051,42 @@ private:
 	dispatch_calculations m_disp_calcs;
 	hourly_energy_calculation hourly_energy_calcs;
 
+protected:
+	// energy and dispatch setup depends only on gen, degradation and the dispatch schedules,
+	// so singleowner_sweep computes it once and hands it to every point
+	struct energy_setup
+	{
+		std::vector<double> degradation;	// CF_degradation, years 0..nyears
+		std::vector<double> energy_net;		// CF_energy_net, years 0..nyears
+		std::vector<ssc_number_t> ppa_multipliers;
+		dispatch_calculations disp_calcs;
+	};
+	energy_setup *m_energy_setup;			// when set, exec also saves its setup here
+	const energy_setup *m_shared_energy;	// when set, exec uses this instead of gen
+
+	// for sweep points, which may register a copy of _cm_vtab_singleowner without the generation inputs
+	cm_singleowner(var_info *singleowner_vtab) : m_energy_setup(0), m_shared_energy(0)
+	{
+		add_tables(singleowner_vtab);
+	}
 
-public:
-	cm_singleowner()
+	void add_tables(var_info *singleowner_vtab)
 	{
 		add_var_info( vtab_standard_financial );
 		add_var_info( vtab_oandm );
 		add_var_info( vtab_tax_credits );
 		add_var_info( vtab_payment_incentives );
 //		add_var_info(vtab_advanced_financing_cost);
-		add_var_info( _cm_vtab_singleowner );
+		add_var_info( singleowner_vtab );
 		add_var_info(vtab_battery_replacement_cost);
 	}
 
+public:
+	cm_singleowner() : m_energy_setup(0), m_shared_energy(0)
+	{
+		add_tables(_cm_vtab_singleowner);
+	}
+
 	void exec( ) throw( general_error )
 	{
 		int i = 0;
@@ -1204,52 +1230,63 @@ public:
 		double first_year_energy = 0.0;
 
 
-		// degradation
-		// degradation starts in year 2 for single value degradation - no degradation in year 1 - degradation =1.0
-		// lifetime degradation applied in technology compute modules
-		if (as_integer("system_use_lifetime_output") == 1)
+		if (m_shared_energy)
 		{
-			for (i = 1; i <= nyears; i++) cf.at(CF_degradation, i) = 1.0;
+			for (i = 0; i <= nyears; i++)
+			{
+				cf.at(CF_degradation, i) = m_shared_energy->degradation[i];
+				cf.at(CF_energy_net, i) = m_shared_energy->energy_net[i];
+			}
 		}
 		else
 		{
-			size_t count_degrad = 0;
-			ssc_number_t *degrad = 0;
-			degrad = as_array("degradation", &count_degrad);
-
-			if (count_degrad == 1)
+			// degradation
+			// degradation starts in year 2 for single value degradation - no degradation in year 1 - degradation =1.0
+			// lifetime degradation applied in technology compute modules
+			if (as_integer("system_use_lifetime_output") == 1)
 			{
-				for (i = 1; i <= nyears; i++) cf.at(CF_degradation, i) = pow((1.0 - degrad[0] / 100.0), i - 1);
+				for (i = 1; i <= nyears; i++) cf.at(CF_degradation, i) = 1.0;
 			}
-			else if (count_degrad > 0)
+			else
 			{
-				for (i = 0; i < nyears && i < (int)count_degrad; i++) cf.at(CF_degradation, i + 1) = (1.0 - degrad[i] / 100.0);
+				size_t count_degrad = 0;
+				ssc_number_t *degrad = 0;
+				degrad = as_array("degradation", &count_degrad);
+
+				if (count_degrad == 1)
+				{
+					for (i = 1; i <= nyears; i++) cf.at(CF_degradation, i) = pow((1.0 - degrad[0] / 100.0), i - 1);
+				}
+				else if (count_degrad > 0)
+				{
+					for (i = 0; i < nyears && i < (int)count_degrad; i++) cf.at(CF_degradation, i + 1) = (1.0 - degrad[i] / 100.0);
+				}
 			}
-		}
 
 
 
-		hourly_energy_calcs.calculate(this);
+			hourly_energy_calcs.calculate(this);
 
 
-		// dispatch
-		if (as_integer("system_use_lifetime_output") == 1)
-		{
-			// hourly_enet includes all curtailment, availability
-			for (size_t y = 1; y <= (size_t)nyears; y++)
+			// dispatch
+			if (as_integer("system_use_lifetime_output") == 1)
 			{
-				for (size_t h = 0; h<8760; h++)
+				// hourly_enet includes all curtailment, availability
+				for (size_t y = 1; y <= (size_t)nyears; y++)
 				{
-					cf.at(CF_energy_net, y) += hourly_energy_calcs.hourly_energy()[(y - 1) * 8760 + h] * cf.at(CF_degradation, y);
+					for (size_t h = 0; h<8760; h++)
+					{
+						cf.at(CF_energy_net, y) += hourly_energy_calcs.hourly_energy()[(y - 1) * 8760 + h] * cf.at(CF_degradation, y);
+					}
 				}
 			}
-		}
-		else
-		{
-			for (i = 0; i<8760; i++) first_year_energy += hourly_energy_calcs.hourly_energy()[i]; // sum up hourly kWh to get total annual kWh first year production includes first year curtailment, availability 
-			cf.at(CF_energy_net, 1) = first_year_energy;
-			for (i = 1; i <= nyears; i++)
-				cf.at(CF_energy_net, i) = first_year_energy * cf.at(CF_degradation, i);
+			else
+			{
+				for (i = 0; i<8760; i++) first_year_energy += hourly_energy_calcs.hourly_energy()[i]; // sum up hourly kWh to get total annual kWh first year production includes first year curtailment, availability 
+				cf.at(CF_energy_net, 1) = first_year_energy;
+				for (i = 1; i <= nyears; i++)
+					cf.at(CF_energy_net, i) = first_year_energy * cf.at(CF_degradation, i);
+			}
 		}
 
 		first_year_energy = cf.at(CF_energy_net, 1);
@@ -1261,9 +1298,29 @@ public:
 		{
 			degrade_cf.push_back(cf.at(CF_degradation, i));
 		}
-		m_disp_calcs.init(this, degrade_cf, hourly_energy_calcs.hourly_energy());
+		if (m_shared_energy)
+		{
+			m_disp_calcs.init(this, m_shared_energy->disp_calcs);
+			ssc_number_t *ppa_multipliers = allocate("ppa_multipliers", m_shared_energy->ppa_multipliers.size());
+			for (size_t h = 0; h < m_shared_energy->ppa_multipliers.size(); h++)
+				ppa_multipliers[h] = m_shared_energy->ppa_multipliers[h];
+		}
+		else
+			m_disp_calcs.init(this, degrade_cf, hourly_energy_calcs.hourly_energy());
 		// end of energy and dispatch initialization
 
+		if (m_energy_setup)
+		{
+			m_energy_setup->degradation = degrade_cf;
+			m_energy_setup->energy_net.clear();
+			for (i = 0; i <= nyears; i++)
+				m_energy_setup->energy_net.push_back(cf.at(CF_energy_net, i));
+			m_energy_setup->disp_calcs = m_disp_calcs;
+			size_t count_multipliers = 0;
+			ssc_number_t *ppa_multipliers = as_array("ppa_multipliers", &count_multipliers);
+			m_energy_setup->ppa_multipliers.assign(ppa_multipliers, ppa_multipliers + count_multipliers);
+		}
+
 
 
 		for (i=1;i<=nyears;i++)
@@ -1895,15 +1952,9 @@ public:
 		int its=0;
 		double irr_weighting_factor = DBL_MAX;
 		bool irr_is_minimally_met = false;
-		bool irr_greater_than_target = false;
-		double w0=1.0;
-		double w1=1.0;
 		double x0=ppa_min;
 		double x1=ppa_max;
-		double ppa_coarse_interval=10; // 10 cents/kWh
-		bool ppa_interval_found=false;
-		bool ppa_too_large=false;
-		bool ppa_interval_reset=true;
+		ppa_solver ppa_search(ppa_min, ppa_max, 10); // 10 cents/kWh coarse step until a secant is available
 		// 12/14/12 - address issue from Eric Lantz - ppa solution when target mode and ppa < 0
 		double ppa_old=ppa;
 
@@ -2096,7 +2147,6 @@ public:
 		cash_for_debt_service=0;
 		pv_cafds=0;
 		if (constant_dscr_mode)	size_of_debt=0;
-		if (ppa_interval_found)	ppa = (w0*x1+w1*x0)/(w0 + w1);
 
 		// debt pre calculation
 		for (i=1; i<=nyears; i++)
@@ -2649,67 +2699,11 @@ public:
 //				double itnpv_target = npv(CF_project_return_aftertax,flip_target_year,flip_frac) +  cf.at(CF_project_return_aftertax,0) ;
 				irr_weighting_factor = fabs(itnpv_target);
 				irr_is_minimally_met = ((irr_weighting_factor < ppa_soln_tolerance));
-				irr_greater_than_target = (( itnpv_target >= 0.0) || irr_is_minimally_met );
-				if (ppa_interval_found)
-				{// reset interval
-				
-					if (irr_greater_than_target) // too large
-					{
-			// set endpoint of weighted interval x0<x1
-						x1 = ppa;
-						w1 = irr_weighting_factor;
-					}
-					else // too small
-					{
-			// set endpoint of weighted interval x0<x1
-						x0 = ppa;
-						w0 = irr_weighting_factor;
-					}
-
-				}
-				else
-				{ // find solution interval [x0,x1]
-					if (ppa_interval_reset) 
-					{
-							if (irr_greater_than_target) ppa_too_large=true;
-							ppa_interval_reset=false;
-					}
-					if (ppa_too_large) // too large
-					{
-						if (irr_greater_than_target)
-						{
-							x0 = ppa;
-							w0 = irr_weighting_factor;
-							ppa = x0-ppa_coarse_interval;
-						}
-						else
-						{
-						  x1 = x0;
-						  w1 = w0;
-						  x0 = ppa;
-						  w0 = irr_weighting_factor;
-						  ppa_interval_found=true;
-						}
-					}
-					else
-					{
-						if (!irr_greater_than_target)
-						{
-							x1 = ppa;
-							w1 = irr_weighting_factor;
-							ppa = x1+ppa_coarse_interval;
-						}
-						else
-						{
-						  x0 = x1;
-						  w0 = w1;
-						  x1 = ppa;
-						  w1 = irr_weighting_factor;
-						  ppa_interval_found=true;
-						}
-					}
-					// for initial guess of zero
-					if (fabs(x0-x1)<ppa_soln_tolerance) x0 = x1-2*ppa_soln_tolerance;
+				if (!irr_is_minimally_met)
+				{
+					ppa = ppa_search.next(ppa, itnpv_target);
+					x0 = ppa_search.lower();
+					x1 = ppa_search.upper();
 				}
 					//std::stringstream outm;
 					//outm << "iteration=" << its  << ", irr=" << cf.at(CF_project_return_aftertax_irr, flip_target_year)  << ", npvtarget=" << itnpv_target  << ", npvtarget_delta=" << itnpv_target_delta  
@@ -2986,7 +2980,11 @@ public:
 		assign("issuance_of_equity", var_data((ssc_number_t) issuance_of_equity));
 		
 
-		assign("project_return_aftertax_irr", var_data((ssc_number_t)  (irr(CF_project_return_aftertax,nyears)*100.0)));
+		int irr_status = libfin::IRR_SOLVED;
+		double project_irr = irr(CF_project_return_aftertax, nyears, -2, 1e-6, 100, &irr_status);
+		if (irr_status == libfin::IRR_NOT_CONVERGED)
+			log("After-tax project IRR did not converge and is reported as NaN.", SSC_WARNING);
+		assign("project_return_aftertax_irr", var_data((ssc_number_t)  (project_irr*100.0)));
 		assign("project_return_aftertax_npv", var_data((ssc_number_t)  (npv(CF_project_return_aftertax,nyears,nom_discount_rate) +  cf.at(CF_project_return_aftertax,0)) ));
 
 
@@ -3890,213 +3888,211 @@ public:
 
 	double npv( int cf_line, int nyears, double rate ) throw ( general_error )
 	{		
-		//if (rate == -1.0) throw general_error("cannot calculate NPV with discount rate equal to -1.0");
-		double rr = 1.0;
-		if (rate != -1.0) rr = 1.0/(1.0+rate);
-		double result = 0;
-		for (int i=nyears;i>0;i--)
-			result = rr * result + cf.at(cf_line,i);
-
-		return result*rr;
+		return libfin::cashflow_npv(&cf.at(cf_line, 0), nyears, rate);
 	}
 
-/* ported from http://code.google.com/p/irr-newtonraphson-calculator/ */
-	bool is_valid_iter_bound(double estimated_return_rate)
+	double irr( int cf_line, int count, double initial_guess=-2, double tolerance=1e-6, int max_iterations=100, int *status=0 )
 	{
-		return estimated_return_rate != -1 && (estimated_return_rate < std::numeric_limits<int>::max()) && (estimated_return_rate > std::numeric_limits<int>::min());
-	}
-
-	double irr_poly_sum(double estimated_return_rate, int cf_line, int count)
-	{
-		double sum_of_polynomial = 0;
-		if (is_valid_iter_bound(estimated_return_rate))
-		{
-			for (int j = 0; j <= count ; j++)
-			{
-				double val = (pow((1 + estimated_return_rate), j));
-				if (val != 0.0)
-					sum_of_polynomial += cf.at(cf_line,j)/val;
-				else
-					break;
-			}
-		}
-		return sum_of_polynomial;
+		return libfin::cashflow_irr(&cf.at(cf_line, 0), count, initial_guess, tolerance, max_iterations, status);
 	}
 
-	double irr_derivative_sum(double estimated_return_rate,int cf_line, int count)
-	{
-		double sum_of_derivative = 0;
-		if (is_valid_iter_bound(estimated_return_rate))
-			for (int i = 1; i <= count ; i++)
-			{
-				sum_of_derivative += cf.at(cf_line,i)*(i)/pow((1 + estimated_return_rate), i+1);
-			}
-		return sum_of_derivative*-1;
+	double min(double a, double b)
+	{ // handle NaN
+		if ((a != a) || (b != b))
+			return 0;
+		else
+			return (a < b) ? a : b;
 	}
 
-	double irr_scale_factor( int cf_unscaled, int count)
-	{
-		// scale to max value for better irr convergence
-		if (count<1) return 1.0;
-		int i=0;
-		double max=fabs(cf.at(cf_unscaled,0));
-		for (i=0;i<=count;i++) 
-			if (fabs(cf.at(cf_unscaled,i))> max) max =fabs(cf.at(cf_unscaled,i));
-		return (max>0 ? max:1);
+	double max(double a, double b)
+	{ // handle NaN
+		if ((a != a) || (b != b))
+			return 0;
+		else
+			return (a > b) ? a : b;
 	}
 
-	bool is_valid_irr( int cf_line, int count, double residual, double tolerance, int number_of_iterations, int max_iterations, double calculated_irr, double scale_factor )
+	double min_cashflow_value(int cf_line, int nyears)
 	{
-		double npv_of_irr = npv(cf_line,count,calculated_irr)+cf.at(cf_line,0);
-		double npv_of_irr_plus_delta = npv(cf_line,count,calculated_irr+0.001)+cf.at(cf_line,0);
-		bool is_valid = ( (number_of_iterations<max_iterations) && (fabs(residual)<tolerance) && (npv_of_irr>npv_of_irr_plus_delta) && (fabs(npv_of_irr/scale_factor)<tolerance) );
-				//if (!is_valid)
-				//{
-				//std::stringstream outm;
-				//outm <<  "cf_line=" << cf_line << "count=" << count << "residual=" << residual << "number_of_iterations=" << number_of_iterations << "calculated_irr=" << calculated_irr
-				//	<< "npv of irr=" << npv_of_irr << "npv of irr plus delta=" << npv_of_irr_plus_delta;
-				//log( outm.str() );
-				//}
-		return is_valid;
+		return libfin::cashflow_min_value(&cf.at(cf_line, 0), nyears);
 	}
 
-	double irr( int cf_line, int count, double initial_guess=-2, double tolerance=1e-6, int max_iterations=100 )
-	{
-		int number_of_iterations=0;
-//		double calculated_irr = 0;
-		double calculated_irr = std::numeric_limits<double>::quiet_NaN();
-//		double calculated_irr = -999;
-
+};
 
-		if (count < 1) 
-			return calculated_irr;
 
-		// only possible for first value negative
-		if ( (cf.at(cf_line,0) <= 0))
-		{
-			// initial guess from http://zainco.blogspot.com/2008/08/internal-rate-of-return-using-newton.html
-			if ((initial_guess < -1) && (count > 1))// second order
-			{
-				if (cf.at(cf_line,0) !=0) 
-				{
-					double b = 2.0+ cf.at(cf_line,1)/cf.at(cf_line,0);
-					double c = 1.0+cf.at(cf_line,1)/cf.at(cf_line,0)+cf.at(cf_line,2)/cf.at(cf_line,0);
-					initial_guess = -0.5*b - 0.5*sqrt(b*b-4.0*c);
-					if ((initial_guess <= 0) || (initial_guess >= 1)) initial_guess = -0.5*b + 0.5*sqrt(b*b-4.0*c);
-				}
-			}
-			else if (initial_guess < 0) // first order
-			{
-				if (cf.at(cf_line,0) !=0) initial_guess = -(1.0 + cf.at(cf_line,1)/cf.at(cf_line,0));
-			}
 
-			double scale_factor = irr_scale_factor(cf_line,count);
-			double residual=DBL_MAX;
 
-			calculated_irr = irr_calc(cf_line,count,initial_guess,tolerance,max_iterations,scale_factor,number_of_iterations,residual);
+DEFINE_MODULE_ENTRY( singleowner, "DHF Single Owner Financial Model_", 1 );
 
-			if (!is_valid_irr(cf_line,count,residual,tolerance,number_of_iterations,max_iterations,calculated_irr,scale_factor)) // try 0.1 as initial guess
-			{
-				initial_guess=0.1;
-				number_of_iterations=0;
-				residual=0;
-				calculated_irr = irr_calc(cf_line,count,initial_guess,tolerance,max_iterations,scale_factor,number_of_iterations,residual);
-			}
+///////////////////////////////////////////////////
+static var_info _cm_vtab_singleowner_sweep[] = {
+/*   VARTYPE           DATATYPE         NAME                                      LABEL                                                            UNITS              META                      GROUP                       REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,        SSC_ARRAY,       "sweep_total_installed_cost",            "Installed cost for each point",                                 "$",               "one value or one per point, defaults to total_installed_cost", "Financial Sweep", "", "", "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "sweep_debt_percent",                    "Debt percent for each point",                                   "%",               "one value or one per point, defaults to debt_percent", "Financial Sweep", "", "", "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "sweep_itc_fed_percent",                 "Federal percentage-based ITC percent for each point",           "%",               "one value or one per point, defaults to itc_fed_percent", "Financial Sweep", "", "", "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "sweep_ppa_escalation",                  "PPA escalation rate for each point",                            "%/year",          "one value or one per point, defaults to ppa_escalation", "Financial Sweep", "", "", "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "sweep_threads",                         "Number of worker threads",                                      "",                "0=one per processor",    "Financial Sweep",          "?=0",                      "INTEGER,MIN=0",                 "" },
+
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_ppa",                             "PPA price (Year 1)",                                            "cents/kWh",       "",                       "Financial Sweep",          "*",                        "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_lppa_nom",                        "Levelized PPA price (nominal)",                                 "cents/kWh",       "",                       "Financial Sweep",          "*",                        "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_lcoe_nom",                        "Levelized cost (nominal)",                                      "cents/kWh",       "",                       "Financial Sweep",          "*",                        "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_lcoe_real",                       "Levelized cost (real)",                                         "cents/kWh",       "",                       "Financial Sweep",          "*",                        "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_project_return_aftertax_npv",     "Net present value (after-tax)",                                 "$",               "",                       "Financial Sweep",          "*",                        "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_project_return_aftertax_irr",     "Internal rate of return (after-tax)",                           "%",               "",                       "Financial Sweep",          "*",                        "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_flip_actual_irr",                 "IRR in target year",                                            "%",               "",                       "Financial Sweep",          "*",                        "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "sweep_size_of_debt",                    "Size of debt",                                                  "$",               "",                       "Financial Sweep",          "*",                        "",                              "" },
 
-			if (!is_valid_irr(cf_line,count,residual,tolerance,number_of_iterations,max_iterations,calculated_irr,scale_factor)) // try -0.1 as initial guess
-			{
-				initial_guess=-0.1;
-				number_of_iterations=0;
-				residual=0;
-				calculated_irr = irr_calc(cf_line,count,initial_guess,tolerance,max_iterations,scale_factor,number_of_iterations,residual);
-			}
-			if (!is_valid_irr(cf_line,count,residual,tolerance,number_of_iterations,max_iterations,calculated_irr,scale_factor)) // try 0 as initial guess
-			{
-				initial_guess=0;
-				number_of_iterations=0;
-				residual=0;
-				calculated_irr = irr_calc(cf_line,count,initial_guess,tolerance,max_iterations,scale_factor,number_of_iterations,residual);
-			}
+var_info_invalid };
 
-			if (!is_valid_irr(cf_line,count,residual,tolerance,number_of_iterations,max_iterations,calculated_irr,scale_factor)) // try 0.1 as initial guess
-			{
-//				calculated_irr = 0.0; // did not converge
-				calculated_irr = std::numeric_limits<double>::quiet_NaN(); // did not converge
-//				double calculated_irr = -999;
-			}
+// singleowner inputs, copied to each point of a sweep
+static std::vector<var_info> singleowner_input_vtab()
+{
+	var_info *tables[] = { _cm_vtab_singleowner, vtab_standard_financial, vtab_oandm, vtab_tax_credits,
+		vtab_payment_incentives, vtab_battery_replacement_cost, 0 };
+	std::vector<var_info> vtab;
+	for (size_t t = 0; tables[t] != 0; t++)
+		for (var_info *vi = tables[t]; vi->name != 0; vi++)
+			if (vi->var_type == SSC_INPUT || vi->var_type == SSC_INOUT)
+				vtab.push_back(*vi);
+	vtab.push_back(var_info_invalid);
+	return vtab;
+}
+static std::vector<var_info> _cm_vtab_singleowner_inputs = singleowner_input_vtab();
+
+// _cm_vtab_singleowner without gen and grid_to_batt, for the points that reuse the energy setup of the first
+static std::vector<var_info> singleowner_shared_energy_vtab()
+{
+	std::vector<var_info> vtab;
+	for (var_info *vi = _cm_vtab_singleowner; vi->name != 0; vi++)
+		if (strcmp(vi->name, "gen") != 0 && strcmp(vi->name, "grid_to_batt") != 0)
+			vtab.push_back(*vi);
+	vtab.push_back(var_info_invalid);
+	return vtab;
+}
+static std::vector<var_info> _cm_vtab_singleowner_shared_energy = singleowner_shared_energy_vtab();
+
+// Runs singleowner for one point of a sweep on a private copy of the inputs.  The first point
+// saves its energy and dispatch setup, later points reuse it instead of reading gen.
+class singleowner_sweep_point : public cm_singleowner
+{
+public:
+	typedef energy_setup setup;
 
-		}
-		return calculated_irr;
+	singleowner_sweep_point(bool shared_energy)
+		: cm_singleowner(shared_energy ? &_cm_vtab_singleowner_shared_energy[0] : _cm_vtab_singleowner)
+	{
 	}
 
-
-	double irr_calc( int cf_line, int count, double initial_guess, double tolerance, int max_iterations, double scale_factor, int &number_of_iterations, double &residual )
+	// returns an empty string on success
+	std::string run(var_table *inputs, setup *save, const setup *shared)
 	{
-//		double calculated_irr = 0;
-		double calculated_irr = std::numeric_limits<double>::quiet_NaN();
-//		double calculated_irr = -999;
-		double deriv_sum = irr_derivative_sum(initial_guess, cf_line, count);
-		if (deriv_sum != 0.0)
-			calculated_irr = initial_guess - irr_poly_sum(initial_guess,cf_line,count)/deriv_sum;
-		else
-			return initial_guess;
+		m_energy_setup = save;
+		m_shared_energy = shared;
+		clear_log();
+		silent_handler h(this);
+		return compute(&h, inputs) ? std::string() : h.last_error();
+	}
+};
 
-		number_of_iterations++;
+class cm_singleowner_sweep : public compute_module
+{
+public:
+	cm_singleowner_sweep()
+	{
+		add_var_info(_cm_vtab_singleowner_sweep);
+		add_var_info(&_cm_vtab_singleowner_inputs[0]);
+	}
 
+	static double output(var_table &vt, const char *name)
+	{
+		var_data *v = vt.lookup(name);
+		return (v && v->type == SSC_NUMBER) ? (double)v->num : std::numeric_limits<double>::quiet_NaN();
+	}
 
-		residual = irr_poly_sum(calculated_irr,cf_line,count) / scale_factor;
+	void exec() throw(general_error)
+	{
+		static const char *swept[] = { "total_installed_cost", "debt_percent", "itc_fed_percent", "ppa_escalation" };
+		const size_t nswept = sizeof(swept) / sizeof(swept[0]);
 
-		while (!(fabs(residual) <= tolerance) && (number_of_iterations < max_iterations))
+		size_t npoints = 0;
+		for (size_t k = 0; k < nswept; k++)
 		{
-			deriv_sum = irr_derivative_sum(initial_guess,cf_line,count);
-			if (deriv_sum != 0.0)
-				calculated_irr = calculated_irr - irr_poly_sum(calculated_irr,cf_line,count)/deriv_sum;
-			else
-				break;
+			std::string name = std::string("sweep_") + swept[k];
+			if (is_assigned(name) && as_vector_double(name).size() > npoints)
+				npoints = as_vector_double(name).size();
+		}
+		if (npoints == 0)
+			throw exec_error("singleowner_sweep", "at least one sweep_ input must be assigned");
 
-			number_of_iterations++;
-			residual = irr_poly_sum(calculated_irr,cf_line,count) / scale_factor;
+		std::vector< std::vector<double> > values(nswept);
+		for (size_t k = 0; k < nswept; k++)
+		{
+			std::string name = std::string("sweep_") + swept[k];
+			if (is_assigned(name))
+				values[k] = as_vector_expanded(name, npoints, "point");
 		}
-		return calculated_irr;
-	}
 
+		// singleowner inputs shared by every point, gen and grid_to_batt are only needed by the first
+		var_table inputs;
+		for (var_info *vi = &_cm_vtab_singleowner_inputs[0]; vi->name != 0; vi++)
+			if (is_assigned(vi->name) && strcmp(vi->name, "gen") != 0 && strcmp(vi->name, "grid_to_batt") != 0)
+				inputs.assign(vi->name, *lookup(vi->name));
 
-	double min(double a, double b)
-	{ // handle NaN
-		if ((a != a) || (b != b))
-			return 0;
-		else
-			return (a < b) ? a : b;
-	}
+		static const char *metrics[] = { "ppa", "lppa_nom", "lcoe_nom", "lcoe_real", "project_return_aftertax_npv",
+			"project_return_aftertax_irr", "flip_actual_irr", "size_of_debt" };
+		const size_t nmetrics = sizeof(metrics) / sizeof(metrics[0]);
+		std::vector<double> results(npoints * nmetrics);
+		std::vector<std::string> errors(npoints);
 
-	double max(double a, double b)
-	{ // handle NaN
-		if ((a != a) || (b != b))
-			return 0;
-		else
-			return (a > b) ? a : b;
-	}
-
-	double min_cashflow_value(int cf_line, int nyears)
-	{
-		// check for NaN
-		bool is_nan = true;
-		for (int i = 1; i <= nyears; i++)
-			is_nan &= std::isnan(cf.at(cf_line, i));
-		if (is_nan) return std::numeric_limits<double>::quiet_NaN();
-
-		double min_value = DBL_MAX;
-		for (int i = 1; i <= nyears; i++)
-			if ((cf.at(cf_line, i)<min_value) && (cf.at(cf_line, i) != 0)) min_value = cf.at(cf_line, i);
-		return min_value;
-	}
+		// each point runs on its own copy of the inputs, which is released once its metrics are saved
+		auto run_point = [&](singleowner_sweep_point &point, size_t i, singleowner_sweep_point::setup *save, const singleowner_sweep_point::setup *shared)
+		{
+			var_table point_inputs;
+			point_inputs = inputs;
+			if (i == 0)
+			{
+				point_inputs.assign("gen", *lookup("gen"));
+				if (is_assigned("grid_to_batt"))
+					point_inputs.assign("grid_to_batt", *lookup("grid_to_batt"));
+			}
+			for (size_t k = 0; k < nswept; k++)
+				if (!values[k].empty())
+					point_inputs.assign(swept[k], var_data((ssc_number_t)values[k][i]));
+			errors[i] = point.run(&point_inputs, save, shared);
+			for (size_t m = 0; m < nmetrics; m++)
+				results[i * nmetrics + m] = output(point_inputs, metrics[m]);
+		};
+
+		// the first point sets up energy and dispatch from gen, so it runs on its own
+		singleowner_sweep_point::setup energy;
+		singleowner_sweep_point first(false);
+		run_point(first, 0, &energy, 0);
+		if (!errors[0].empty())
+			throw exec_error("singleowner_sweep", "point 0: " + errors[0]);
+
+		// later points reuse that setup and do not read gen or grid_to_batt
+		size_t nthreads = (size_t)as_integer("sweep_threads");
+		std::vector< std::unique_ptr<singleowner_sweep_point> > points(parallel_threads(npoints - 1, nthreads));
+		for (size_t t = 0; t < points.size(); t++)
+			points[t].reset(new singleowner_sweep_point(true));
+		parallel_for(npoints - 1, nthreads, [&](size_t j, size_t t)
+		{
+			run_point(*points[t], j + 1, 0, &energy);
+		});
 
+		for (size_t i = 0; i < npoints; i++)
+			if (!errors[i].empty())
+				throw exec_error("singleowner_sweep", util::format("point %d: ", (int)i) + errors[i]);
 
+		for (size_t m = 0; m < nmetrics; m++)
+		{
+			ssc_number_t *p = allocate(std::string("sweep_") + metrics[m], npoints);
+			for (size_t i = 0; i < npoints; i++)
+				p[i] = (ssc_number_t)results[i * nmetrics + m];
+		}
+	}
 };
 
-
-
-
-DEFINE_MODULE_ENTRY( singleowner, "DHF Single Owner Financial Model_", 1 );
+DEFINE_MODULE_ENTRY( singleowner_sweep, "Single Owner financial sweep over cost and incentive parameters sharing one generation profile", 1 );
 
 
@@ -53,6 +53,7 @@
 #include <iostream>
 #include <cmath>
 #include <string>
+#include <vector>
 
 /**********************************************************************************
 ************************************************************************************
@@ -119,7 +120,6 @@ public:
 		// Define Input Arrays and variables
 		//ssc_number_t *poa  = as_array( "subarray1_poa_eff_beam", &num_steps );	// Plane of array Irradiance
 		ssc_number_t *poa  = as_array( "subarray1_poa_shaded", &num_steps );	// Plane of array Irradiance
-		ssc_number_t *wSpd = as_array( "wspd", &num_steps );					// Wind Speed
 		ssc_number_t *hrEn = as_array( "hourly_gen", &num_steps );			// Hourly Energy
 		ssc_number_t *tAmb = as_array( "tdry", &num_steps );					// Ambient Temperature
 		ssc_number_t *tilt = as_array( "subarray1_surf_tilt", &num_steps );		// Surface Tilt
@@ -142,20 +142,22 @@ public:
 			}	
 		}
 
-		float loss; 
+		std::vector<int> isUp(8760);
+		std::vector<float> loss(8760);
+		for (int i = 0; i < 8760; i++)
+			isUp[i] = (int)sunup[i];
 
-		for (int i = 0; i < 8760; i++){
-			if (!snowModule.getLoss(poa[i], tilt[i], wSpd[i], tAmb[i], sDep[i], (int)sunup[i], 1.0, &loss)){
-				if (snowModule.good) log(snowModule.msg, SSC_WARNING);
-				else{
-					log(snowModule.msg, SSC_ERROR);
-					return;
-				}
+		if (!snowModule.getLoss(poa, tilt, tAmb, sDep, &isUp[0], 1.0, 8760, &loss[0])){
+			if (snowModule.good) log(snowModule.msg, SSC_WARNING);
+			else{
+				log(snowModule.msg, SSC_ERROR);
+				return;
 			}
+		}
 
+		for (int i = 0; i < 8760; i++){
 			hrEn_b4Snow[i] = hrEn[i]; 
-			hrEn[i] = hrEn[i] * (1 - loss);
-
+			hrEn[i] = hrEn[i] * (1 - loss[i]);
 		}
 
 		// accumulate monthly and annual values
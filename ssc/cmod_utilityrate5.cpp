@@ -49,34 +49,16 @@
 
 #include "core.h"
 #include <algorithm>
+#include <memory>
 #include <sstream>
 
 
   
-static var_info vtab_utility_rate5[] = {
-
-/*   VARTYPE           DATATYPE         NAME                         LABEL                                           UNITS     META                      GROUP          REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
-	{ SSC_INPUT,        SSC_NUMBER,     "analysis_period",           "Number of years in analysis",                   "years",  "",                      "",             "*",                         "INTEGER,POSITIVE",              "" },
-
-	{ SSC_INPUT, SSC_NUMBER, "system_use_lifetime_output", "Lifetime hourly system outputs", "0/1", "0=hourly first year,1=hourly lifetime", "", "*", "INTEGER,MIN=0,MAX=1", "" },
+// tariff inputs, shared with the batch bill calculator
+static var_info vtab_utility_rate5_tariff[] = {
 
 	{ SSC_INPUT, SSC_NUMBER, "TOU_demand_single_peak", "Use single monthly peak for TOU demand charge", "0/1", "0=use TOU peak,1=use flat peak", "", "?=0", "INTEGER,MIN=0,MAX=1", "" },
-	
-	// First year or lifetime hourly or subhourly
-	// load and gen expected to be > 0
-	// grid positive if system generation > load, negative otherwise
-	{ SSC_INPUT, SSC_ARRAY, "gen", "System power generated", "kW", "", "Time Series", "*", "", "" },
-	 
-	// input from user as kW and output as kW
-	{ SSC_INOUT, SSC_ARRAY, "load", "Electricity load (year 1)", "kW", "", "Time Series", "", "", "" },
-	//  output as kWh - same as load (kW) for hourly simulations
-	{ SSC_OUTPUT, SSC_ARRAY, "bill_load", "Bill load (year 1)", "kWh", "", "Time Series", "*", "", "" },
 
-	{ SSC_INPUT, SSC_NUMBER, "inflation_rate", "Inflation rate", "%", "", "Financials", "*", "MIN=-99", "" },
-
-	{ SSC_INPUT, SSC_ARRAY, "degradation", "Annual energy degradation", "%", "", "AnnualOutput", "*", "", "" },
-	{ SSC_INPUT, SSC_ARRAY, "load_escalation", "Annual load escalation", "%/year", "", "", "?=0", "", "" },
-	{ SSC_INPUT,        SSC_ARRAY,      "rate_escalation",          "Annual electricity rate escalation",  "%/year", "",                      "",             "?=0",                       "",                              "" },
 	{ SSC_INPUT, SSC_NUMBER, "ur_metering_option", "Metering options", "0=Single meter with monthly rollover credits in kWh,1=Single meter with monthly rollover credits in $,2=Single meter with no monthly rollover credits (Net Billing),3=Single meter with monthly rollover credits in $ (Net Billing $),4=Two meters with all generation sold and all load purchased", "Net metering monthly excess", "", "?=0", "INTEGER,MIN=0,MAX=4", "" },
 
 	
@@ -124,6 +106,31 @@ static var_info vtab_utility_rate5[] = {
 	// ur_dc_tou_flat has 4 columns month, tier, peak demand (kW), demand charge
 	// replaces 12(P)*6(T)*(peak+charge) = 144 single inputs
 	{ SSC_INPUT, SSC_MATRIX, "ur_dc_flat_mat", "Demand rates (flat) table", "", "", "", "ur_dc_enable=1", "", "" },
+
+	var_info_invalid };
+
+static var_info vtab_utility_rate5[] = {
+
+/*   VARTYPE           DATATYPE         NAME                         LABEL                                           UNITS     META                      GROUP          REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,        SSC_NUMBER,     "analysis_period",           "Number of years in analysis",                   "years",  "",                      "",             "*",                         "INTEGER,POSITIVE",              "" },
+
+	{ SSC_INPUT, SSC_NUMBER, "system_use_lifetime_output", "Lifetime hourly system outputs", "0/1", "0=hourly first year,1=hourly lifetime", "", "*", "INTEGER,MIN=0,MAX=1", "" },
+
+	// First year or lifetime hourly or subhourly
+	// load and gen expected to be > 0
+	// grid positive if system generation > load, negative otherwise
+	{ SSC_INPUT, SSC_ARRAY, "gen", "System power generated", "kW", "", "Time Series", "*", "", "" },
+	 
+	// input from user as kW and output as kW
+	{ SSC_INOUT, SSC_ARRAY, "load", "Electricity load (year 1)", "kW", "", "Time Series", "", "", "" },
+	//  output as kWh - same as load (kW) for hourly simulations
+	{ SSC_OUTPUT, SSC_ARRAY, "bill_load", "Bill load (year 1)", "kWh", "", "Time Series", "*", "", "" },
+
+	{ SSC_INPUT, SSC_NUMBER, "inflation_rate", "Inflation rate", "%", "", "Financials", "*", "MIN=-99", "" },
+
+	{ SSC_INPUT, SSC_ARRAY, "degradation", "Annual energy degradation", "%", "", "AnnualOutput", "*", "", "" },
+	{ SSC_INPUT, SSC_ARRAY, "load_escalation", "Annual load escalation", "%/year", "", "", "?=0", "", "" },
+	{ SSC_INPUT,        SSC_ARRAY,      "rate_escalation",          "Annual electricity rate escalation",  "%/year", "",                      "",             "?=0",                       "",                              "" },
 	
 
 	// outputs
@@ -401,12 +408,27 @@ public:
 
 };
 
+// rate independent results of ur_calc, so a later year with identical energy and
+// demand inputs only repeats the pricing at its own escalation
+struct ur_aggregates
+{
+	ur_aggregates() : valid(false) {}
+	bool valid;
+	std::vector<ur_month> month;
+	ssc_number_t cumulative_excess_energy[12];
+	ssc_number_t excess_kwhs_earned[12];
+	ssc_number_t excess_kwhs_applied[12];
+};
+
 class cm_utilityrate5 : public compute_module
 {
-private:
+protected:
 	// schedule outputs
 	std::vector<int> m_ec_tou_sched;
 	std::vector<int> m_dc_tou_sched;
+	// row of each time step's TOU period in its month's ec_periods/dc_periods (-1 if missing)
+	std::vector<int> m_ec_tou_row;
+	std::vector<int> m_dc_tou_row;
 	std::vector<ur_month> m_month;
 	std::vector<int> m_ec_periods; // period number
 	// time step sell rate
@@ -419,9 +441,34 @@ private:
 	std::vector<std::vector<int> >  m_dc_flat_tiers; // tier numbers for each month of flat demand charge
 	size_t m_num_rec_yearly;
 
+	// for modules that run the bill calculation with their own inputs and outputs
+	cm_utilityrate5(var_info *vtab)
+	{
+		add_var_info( vtab_utility_rate5_tariff );
+		if (vtab) add_var_info( vtab );
+	}
+
+	// take the tariff parsed by setup() on another instance
+	void copy_tariff(const cm_utilityrate5 &src)
+	{
+		m_ec_tou_sched = src.m_ec_tou_sched;
+		m_dc_tou_sched = src.m_dc_tou_sched;
+		m_ec_tou_row = src.m_ec_tou_row;
+		m_dc_tou_row = src.m_dc_tou_row;
+		m_month = src.m_month;
+		m_ec_periods = src.m_ec_periods;
+		m_ec_ts_sell_rate = src.m_ec_ts_sell_rate;
+		m_ec_periods_tiers_init = src.m_ec_periods_tiers_init;
+		m_dc_tou_periods = src.m_dc_tou_periods;
+		m_dc_tou_periods_tiers = src.m_dc_tou_periods_tiers;
+		m_dc_flat_tiers = src.m_dc_flat_tiers;
+		m_num_rec_yearly = src.m_num_rec_yearly;
+	}
+
 public:
 	cm_utilityrate5()
 	{
+		add_var_info( vtab_utility_rate5_tariff );
 		add_var_info( vtab_utility_rate5 );
 	}
 
@@ -753,6 +800,9 @@ public:
 		bool timestep_reconciliation = (metering_option == 2 || metering_option == 3 || metering_option == 4);
 
 
+		bool lifetime_output = (as_integer("system_use_lifetime_output") == 1);
+		ur_aggregates agg_wo_sys, agg_w_sys;
+
 		idx = 0;
 		for (i=0;i<nyears;i++)
 		{
@@ -785,7 +835,7 @@ public:
 
 
 				// update e_sys per year if lifetime output
-				if ((as_integer("system_use_lifetime_output") == 1) && ( idx < nrec_gen ))
+				if (lifetime_output && ( idx < nrec_gen ))
 				{
 //					e_sys[j] = p_sys[j] = 0.0;
 //					ts_power = (idx < nrec_gen) ? pgen[idx] : 0;
@@ -813,6 +863,10 @@ public:
 			}
 
 
+			// years with the same load and system output as year one reuse its aggregates
+			bool same_load = (load_scale[i] == load_scale[0]);
+			bool same_sys = !lifetime_output && (sys_scale[i] == sys_scale[0]);
+
 			// now calculate revenue without solar system (using load only)
 			if (timestep_reconciliation)
 			{
@@ -840,7 +894,8 @@ public:
 					&monthly_excess_dollars_applied[0],
 					&monthly_excess_kwhs_earned[0],
 					&monthly_excess_kwhs_applied[0],
-					&dc_hourly_peak[0], &monthly_cumulative_excess_energy[0], &monthly_cumulative_excess_dollars[0], &monthly_bill[0], rate_scale[i], i + 1);
+					&dc_hourly_peak[0], &monthly_cumulative_excess_energy[0], &monthly_cumulative_excess_dollars[0], &monthly_bill[0], rate_scale[i], i + 1,
+					true, true, false, same_load ? &agg_wo_sys : 0);
 			}
 	
 			for (j = 0; j < 12; j++)
@@ -1009,7 +1064,8 @@ public:
 						&monthly_excess_dollars_applied[0],
 						&monthly_excess_kwhs_earned[0],
 						&monthly_excess_kwhs_applied[0],
-						&dc_hourly_peak[0], &monthly_cumulative_excess_energy[0], &monthly_cumulative_excess_dollars[0], &monthly_bill[0], rate_scale[i], i + 1, false, false, true);
+						&dc_hourly_peak[0], &monthly_cumulative_excess_energy[0], &monthly_cumulative_excess_dollars[0], &monthly_bill[0], rate_scale[i], i + 1, false, false, true,
+						same_sys ? &agg_w_sys : 0);
 				}
 				else
 				{
@@ -1025,7 +1081,8 @@ public:
 						&monthly_excess_dollars_applied[0],
 						&monthly_excess_kwhs_earned[0],
 						&monthly_excess_kwhs_applied[0],
-						&dc_hourly_peak[0], &monthly_cumulative_excess_energy[0], &monthly_cumulative_excess_dollars[0], &monthly_bill[0], rate_scale[i], i + 1);
+						&dc_hourly_peak[0], &monthly_cumulative_excess_energy[0], &monthly_cumulative_excess_dollars[0], &monthly_bill[0], rate_scale[i], i + 1,
+						true, true, false, (same_load && same_sys) ? &agg_w_sys : 0);
 				}
 			}
 			if (two_meter)
@@ -1864,6 +1921,25 @@ public:
 
 		}
 
+		// resolve each time step's TOU period to its row in the month once here
+		// so ur_calc and ur_calc_timestep do not search the period lists every step
+		m_ec_tou_row.assign(m_num_rec_yearly, -1);
+		m_dc_tou_row.assign(m_num_rec_yearly, -1);
+		c = 0;
+		for (m = 0; m < m_month.size(); m++)
+		{
+			size_t steps_per_month = util::nday[m] * 24 * steps_per_hour;
+			for (i = 0; i < steps_per_month && c < m_num_rec_yearly; i++, c++)
+			{
+				std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), m_ec_tou_sched[c]);
+				if (per_num != m_month[m].ec_periods.end())
+					m_ec_tou_row[c] = (int)(per_num - m_month[m].ec_periods.begin());
+				per_num = std::find(m_month[m].dc_periods.begin(), m_month[m].dc_periods.end(), m_dc_tou_sched[c]);
+				if (per_num != m_month[m].dc_periods.end())
+					m_dc_tou_row[c] = (int)(per_num - m_month[m].dc_periods.begin());
+			}
+		}
+
 	}
 
 
@@ -1882,7 +1958,8 @@ public:
 		ssc_number_t excess_kwhs_applied[12],
 		ssc_number_t *dc_hourly_peak, ssc_number_t monthly_cumulative_excess_energy[12], 
 		ssc_number_t monthly_cumulative_excess_dollars[12], ssc_number_t monthly_bill[12], 
-		ssc_number_t rate_esc, size_t year, bool include_fixed=true, bool include_min=true, bool gen_only=false) 
+		ssc_number_t rate_esc, size_t year, bool include_fixed=true, bool include_min=true, bool gen_only=false,
+		ur_aggregates *agg=0)
 		throw(general_error)
 	{
 		int i;
@@ -1926,712 +2003,754 @@ public:
 
 
 		size_t steps_per_hour = m_num_rec_yearly / 8760;
-		// calculate the monthly net energy and monthly hours
 		int m, d, h, s, period, tier;
 		int c = 0;
-		for (m = 0; m < (int)m_month.size(); m++)
-		{
-			m_month[m].energy_net = 0;
-			m_month[m].hours_per_month = 0;
-			m_month[m].dc_flat_peak = 0;
-			m_month[m].dc_flat_peak_hour = 0;
-			for (d = 0; d < util::nday[m]; d++)
-			{
-				for (h = 0; h < 24; h++)
-				{
-					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
-					{
-						// net energy use per month
-						m_month[m].energy_net += e_in[c]; // -load and +gen
-						// hours per period per month
-						m_month[m].hours_per_month++;
-						// peak
-						if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_flat_peak)
-						{
-							m_month[m].dc_flat_peak = -p_in[c];
-							m_month[m].dc_flat_peak_hour = c;
-						}
-						c++;
-					}
-				}
-			}
-		}
 
-		// monthly cumulative excess energy (positive = excess energy, negative = excess load)
-		if (enable_nm && !excess_monthly_dollars)
+		if (agg && agg->valid)
 		{
-			ssc_number_t prev_value = 0;
+			// same energy and demand inputs as the cached call, only the pricing below changes
+			m_month = agg->month;
 			for (m = 0; m < 12; m++)
 			{
-				prev_value = (m > 0) ? monthly_cumulative_excess_energy[m - 1] : 0;
-				monthly_cumulative_excess_energy[m] = ((prev_value + m_month[m].energy_net) > 0) ? (prev_value + m_month[m].energy_net) : 0;
+				monthly_cumulative_excess_energy[m] = agg->cumulative_excess_energy[m];
+				excess_kwhs_earned[m] = agg->excess_kwhs_earned[m];
+				excess_kwhs_applied[m] = agg->excess_kwhs_applied[m];
 			}
 		}
-
-		// excess earned
-		for (m = 0; m < 12; m++)
-		{
-			if (m_month[m].energy_net > 0)
-				excess_kwhs_earned[m] = m_month[m].energy_net;
-		}
-
-	
-		// adjust net energy if net metering with monthly rollover
-		if (enable_nm && !excess_monthly_dollars)
+		else
 		{
-			for (m = 1; m < (int)m_month.size(); m++)
+			ur_calc_aggregate(e_in, p_in, excess_kwhs_earned, excess_kwhs_applied, monthly_cumulative_excess_energy, year, gen_only);
+			if (agg)
 			{
-				if (m_month[m].energy_net < 0)
+				agg->month = m_month;
+				for (m = 0; m < 12; m++)
 				{
-					m_month[m].energy_net += monthly_cumulative_excess_energy[m - 1];
-					excess_kwhs_applied[m] = monthly_cumulative_excess_energy[m - 1];
+					agg->cumulative_excess_energy[m] = monthly_cumulative_excess_energy[m];
+					agg->excess_kwhs_earned[m] = excess_kwhs_earned[m];
+					agg->excess_kwhs_applied[m] = excess_kwhs_applied[m];
 				}
+				agg->valid = true;
 			}
 		}
 
 
-		if (ec_enabled)
+		
+		
+// main loop
+		c = 0;
+		// process one month at a time
+		for (m = 0; m < (int)m_month.size(); m++)
 		{
-			// calculate the monthly net energy per tier and period based on units
-			c = 0;
-			for (m = 0; m < (int)m_month.size(); m++)
+			if (m_month[m].hours_per_month <= 0) break;
+			for (d = 0; d<util::nday[m]; d++)
 			{
-				int start_tier = 0;
-				int end_tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
-				int num_periods = (int)m_month[m].ec_tou_ub_init.nrows();
-				int num_tiers = end_tier - start_tier + 1;
-
-				if (!gen_only) // added for two meter no load scenarios to use load tier sizing
+				for (h = 0; h<24; h++)
 				{
-					//start_tier = 0;
-					end_tier = (int)m_month[m].ec_tou_ub_init.ncols() - 1;
-					//int num_periods = (int)m_month[m].ec_tou_ub_init.nrows();
-					num_tiers = end_tier - start_tier + 1;
-
-					// kWh/kW (kWh/kW daily handled in Setup)
-					// 1. find kWh/kW tier
-					// 2. set min tier and max tier based on next item in ec_tou matrix
-					// 3. resize use and chart based on number of tiers in kWh/kW section
-					// 4. assumption is that all periods in same month have same tier breakdown
-					// 5. assumption is that tier numbering is correct for the kWh/kW breakdown
-					// That is, first tier must be kWh/kW
-					if ((m_month[m].ec_tou_units.ncols()>0 && m_month[m].ec_tou_units.nrows() > 0)
-						&& ((m_month[m].ec_tou_units.at(0, 0) == 1) || (m_month[m].ec_tou_units.at(0, 0) == 3)))
+					// energy charge
+					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
 					{
-						// monthly total energy / monthly peak to determine which kWh/kW tier
-						double mon_kWhperkW = -m_month[m].energy_net; // load negative
-						if (m_month[m].dc_flat_peak != 0)
-							mon_kWhperkW /= m_month[m].dc_flat_peak;
-						// find correct start and end tier based on kWhperkW band
-						start_tier = 1;
-						bool found = false;
-						for (size_t i_tier = 0; i_tier < m_month[m].ec_tou_units.ncols(); i_tier++)
+						if (d == util::nday[m] - 1 && h == 23 && s == (int)(steps_per_hour-1) )
 						{
-							int units = (int)m_month[m].ec_tou_units.at(0, i_tier);
-							if ((units == 1) || (units == 3))
+							if (ec_enabled)
 							{
-								if (found)
-								{
-									end_tier = (int)i_tier - 1;
-									break;
-								}
-								else if (mon_kWhperkW < m_month[m].ec_tou_ub_init.at(0, i_tier))
+								// energy use and surplus distributed correctly above.
+								// so calculate for all and not based on monthly net
+								// addresses issue if net > 0 but one period net < 0
+								ssc_number_t credit_amt = 0;
+								for (period = 0; period < (int)m_month[m].ec_tou_sr.nrows(); period++)
 								{
-									start_tier = (int)i_tier + 1;
-									found = true;
-								}
-							}
-						}
-						// last tier since no max specified in rate
-						if (!found) start_tier = end_tier;
-						if (start_tier >= (int)m_month[m].ec_tou_ub_init.ncols())
-							start_tier = (int)m_month[m].ec_tou_ub_init.ncols() - 1;
-						if (end_tier < start_tier)
-							end_tier = start_tier;
-						num_tiers = end_tier - start_tier + 1;
-						// resize everytime to handle load and energy changes
-						// resize sr, br and ub for use in energy charge calculations below
-						util::matrix_t<float> br(num_periods, num_tiers);
-						util::matrix_t<float> sr(num_periods, num_tiers);
-						util::matrix_t<float> ub(num_periods, num_tiers);
-						// assign appropriate values.
-						for (period = 0; period < num_periods; period++)
-						{
-							for (tier = 0; tier < num_tiers; tier++)
-							{
-								br.at(period, tier) = m_month[m].ec_tou_br_init.at(period, start_tier + tier);
-								sr.at(period, tier) = m_month[m].ec_tou_sr_init.at(period, start_tier + tier);
-								ub.at(period, tier) = m_month[m].ec_tou_ub_init.at(period, start_tier + tier);
-								// update for correct tier number column headings
-								m_month[m].ec_periods_tiers[period][tier] = start_tier + m_ec_periods_tiers_init[period][tier];
-							}
-						}
-
-						m_month[m].ec_tou_br = br;
-						m_month[m].ec_tou_sr = sr;
-						m_month[m].ec_tou_ub = ub;
-					}
-
-					// reset now resized - if necessary
-				}
-				start_tier = 0;
-				end_tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
+									for (tier = 0; tier < (int)m_month[m].ec_tou_sr.ncols(); tier++)
+									{
+										ssc_number_t cr = m_month[m].ec_energy_surplus.at(period, tier) * m_month[m].ec_tou_sr.at(period, tier) * rate_esc;
 
-				m_month[m].ec_energy_use.resize_fill(num_periods, num_tiers, 0);
-				m_month[m].ec_energy_surplus.resize_fill(num_periods, num_tiers, 0);
-				m_month[m].ec_charge.resize_fill(num_periods, num_tiers, 0);
+//										excess_kwhs_earned[m] += m_month[m].ec_energy_surplus.at(period, tier);
 
+										if (!enable_nm)
+										{
+											credit_amt += cr;
+											m_month[m].ec_charge.at(period, tier) = -cr;
+										}
+										else if (excess_monthly_dollars)
+											monthly_cumulative_excess_dollars[m] += cr;
 
+										/*
+										if (!enable_nm || excess_monthly_kwhs)
+										{
+										credit_amt += cr;
+										if (!excess_monthly_kwhs)
+										m_month[m].ec_charge.at(period, tier) = -cr;
+										}
+										*/
+									}
+								}
+								monthly_ec_charges[m] -= credit_amt;
 
-				// accumulate energy per period - place all in tier 0 initially and then
-				// break up according to tier boundaries and number of periods
+								ssc_number_t charge_amt = 0;
+								for (period = 0; period < (int)m_month[m].ec_tou_br.nrows(); period++)
+								{
+									for (tier = 0; tier < (int)m_month[m].ec_tou_br.ncols(); tier++)
+									{
+										ssc_number_t ch = m_month[m].ec_energy_use.at(period, tier) * m_month[m].ec_tou_br.at(period, tier) * rate_esc;
+										m_month[m].ec_charge.at(period, tier) = ch;
+										charge_amt += ch;
+									}
+								}
+								monthly_ec_charges[m] += charge_amt;
 
-				/*  hour by hour accumulation - changed to monthly per meeting with Paul 2/29/16 */
-				// monthly accumulation of energy
-				ssc_number_t mon_e_net = 0;
-				if (m>0 && enable_nm && !excess_monthly_dollars)
-				{
-					mon_e_net = monthly_cumulative_excess_energy[m - 1]; // rollover
-				}
 
-				for (d = 0; d < util::nday[m]; d++)
-				{
-					for (h = 0; h < 24; h++)
-					{
-						for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
-						{
-							mon_e_net += e_in[c];
-							int toup = m_ec_tou_sched[c];
-							std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), toup);
-							if (per_num == m_month[m].ec_periods.end())
+								// monthly rollover with year end sell at reduced rate
+								if (enable_nm)
+								{
+									payment[c] += monthly_ec_charges[m];
+									/*
+									if (monthly_ec_charges[m] < 0)
+									{
+									monthly_cumulative_excess_kwhs[m] = -monthly_ec_charges[m];
+									payment[c] += monthly_ec_charges[m];
+									}
+									*/
+								}
+								else // non-net metering - no rollover 
+								{
+									if (m_month[m].energy_net < 0) // must buy from grid
+										payment[c] += monthly_ec_charges[m];
+									else // surplus - sell to grid
+										income[c] -= monthly_ec_charges[m]; // charge is negative for income!
+								}
+
+								energy_charge[c] += monthly_ec_charges[m];
+
+								// end of energy charge
+
+							}
+
+
+							if (dc_enabled)
 							{
-								std::ostringstream ss;
-								ss << "Energy rate TOU Period " << toup << " not found for Month " << util::schedule_int_to_month(m) << ".";
-								throw exec_error("utilityrate5", ss.str());
+								// fixed demand charge
+								// compute charge based on tier structure for the month
+								ssc_number_t charge = 0;
+								ssc_number_t d_lower = 0;
+								ssc_number_t demand = m_month[m].dc_flat_peak;
+								bool found = false;
+								for (tier = 0; tier < (int)m_month[m].dc_flat_ub.size() && !found; tier++)
+								{
+									if (demand < m_month[m].dc_flat_ub[tier])
+									{
+										found = true;
+										charge += (demand - d_lower) *
+											m_month[m].dc_flat_ch[tier] * rate_esc;
+										m_month[m].dc_flat_charge = charge;
+									}
+									else
+									{
+										charge += (m_month[m].dc_flat_ub[tier] - d_lower) *
+											m_month[m].dc_flat_ch[tier] * rate_esc;
+										d_lower = m_month[m].dc_flat_ub[tier];
+									}
+								}
+
+								monthly_dc_fixed[m] = charge; // redundant...
+								payment[c] += monthly_dc_fixed[m];
+								demand_charge[c] = charge;
+								dc_hourly_peak[m_month[m].dc_flat_peak_hour] = demand;
+
+
+								// end of fixed demand charge
+
+
+								// TOU demand charge for each period find correct tier
+								demand = 0;
+								d_lower = 0;
+								int peak_hour = 0;
+								m_month[m].dc_tou_charge.clear();
+								for (period = 0; period < (int)m_month[m].dc_tou_ub.nrows(); period++)
+								{
+									charge = 0;
+									d_lower = 0;
+									if (tou_demand_single_peak)
+									{
+										demand = m_month[m].dc_flat_peak;
+										if (m_month[m].dc_flat_peak_hour != m_month[m].dc_tou_peak_hour[period]) continue; // only one peak per month.
+									}
+									else
+										demand = m_month[m].dc_tou_peak[period];
+									// find tier corresponding to peak demand
+									found = false;
+									for (tier = 0; tier < (int)m_month[m].dc_tou_ub.ncols() && !found; tier++)
+									{
+										if (demand < m_month[m].dc_tou_ub.at(period, tier))
+										{
+											found = true;
+											charge += (demand - d_lower) *
+												m_month[m].dc_tou_ch.at(period, tier)* rate_esc;
+											m_month[m].dc_tou_charge.push_back(charge);
+										}
+										else
+										{
+											charge += (m_month[m].dc_tou_ub.at(period, tier) - d_lower) * m_month[m].dc_tou_ch.at(period, tier)* rate_esc;
+											d_lower = m_month[m].dc_tou_ub.at(period, tier);
+										}
+									}
+
+									dc_hourly_peak[peak_hour] = demand;
+									// add to payments
+									monthly_dc_tou[m] += charge;
+									payment[c] += charge; // apply to last hour of the month
+									demand_charge[c] += charge; // add TOU charge to hourly demand charge
+								}
+								// end of TOU demand charge
 							}
-							int row = (int)(per_num - m_month[m].ec_periods.begin());
-							// place all in tier 0 initially and then update appropriately
-							// net energy per period per month
-							m_month[m].ec_energy_use(row, 0) += e_in[c];
-							c++;
-						}
+
+						} // end of if end of month
+						c++;
+					} // end of steps per hour loop
+				}  // h loop
+			} // d loop
+
+			// Calculate monthly bill (before minimums and fixed charges) and excess kwhs and rollover
+//			monthly_bill[m] = payment[c - 1] - income[c - 1];
+			monthly_bill[m] = monthly_ec_charges[m] + monthly_dc_fixed[m] + monthly_dc_tou[m];
+
+			monthly_ec_charges_gross[m] = monthly_ec_charges[m];
+			excess_dollars_earned[m] = monthly_cumulative_excess_dollars[m];
+			ssc_number_t dollars_applied = 0;
+			if (enable_nm)
+			{
+				// apply previous month rollover kwhs
+				if (m > 0)
+				{
+//					monthly_bill[m] -= monthly_cumulative_excess_dollars[m - 1];
+					payment[c - 1] -= monthly_cumulative_excess_dollars[m-1];
+					monthly_ec_charges[m] -= monthly_cumulative_excess_dollars[m - 1];
+					dollars_applied += monthly_cumulative_excess_dollars[m - 1];
+				}
+//				if (monthly_bill[m] < 0)
+				if (monthly_ec_charges[m] < 0)
+				{
+					if (excess_monthly_dollars)
+					{
+						monthly_cumulative_excess_dollars[m] -= monthly_ec_charges[m];
+						//						monthly_cumulative_excess_dollars[m] -= monthly_bill[m];
 					}
+					//					monthly_bill[m] = 0;
+					payment[c - 1] -= monthly_ec_charges[m];; // keep demand charges
+					monthly_ec_charges[m] = 0;
 				}
-
-				/*
-				// rollover energy from correct period - based on matching period number
-				if (m > 0 && enable_nm && !excess_monthly_kwhs)
+				else // apply current month rollover and adjust
 				{
-					// check for surplus in previous month for same period
-					for (size_t ir = 0; ir < m_month[m - 1].ec_energy_surplus.nrows(); ir++)
+//					monthly_bill[m] -= monthly_cumulative_excess_dollars[m];
+					monthly_ec_charges[m] -= monthly_cumulative_excess_dollars[m];
+					//					if (monthly_bill[m] < 0)
+					if (monthly_ec_charges[m] < 0)
 					{
-						if (m_month[m - 1].ec_energy_surplus.at(ir, 0) > 0) // surplus - check period
+						payment[c - 1] -= monthly_cumulative_excess_dollars[m] + monthly_ec_charges[m];
+						if (excess_monthly_dollars)
 						{
-							int toup = m_month[m - 1].ec_periods[ir]; // number of rows of previous month
-							std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), toup);
-							if (per_num == m_month[m].ec_periods.end())
-							{
-								std::ostringstream ss;
-								ss << "utilityrate5: energy charge rollover for period " << toup << " not found for month " << m;
-								log(ss.str(), SSC_NOTICE);
-							}
-							else
-							{
-								ssc_number_t extra = 0;
-								int row = (int)(per_num - m_month[m].ec_periods.begin());
-								for (size_t ic = 0; ic < m_month[m - 1].ec_energy_surplus.ncols(); ic++)
-									extra += m_month[m - 1].ec_energy_surplus.at(ir, ic);
-
-								m_month[m].ec_energy_use(row, 0) += extra;
-							}
+//							monthly_cumulative_excess_dollars[m] = -monthly_bill[m];
+							dollars_applied += monthly_cumulative_excess_dollars[m] + monthly_ec_charges[m];
+							monthly_cumulative_excess_dollars[m] = -monthly_ec_charges[m];
 						}
+						//						monthly_bill[m] = 0;
+						monthly_ec_charges[m] = 0;
+					}
+					else
+					{
+						dollars_applied += monthly_cumulative_excess_dollars[m];
+						payment[c - 1] -= monthly_cumulative_excess_dollars[m];
+						monthly_cumulative_excess_dollars[m] = 0;
 					}
 				}
-				*/
+			}
+			if (monthly_ec_charges_gross[m] < dollars_applied) dollars_applied = monthly_ec_charges_gross[m];
+			excess_dollars_applied[m] = dollars_applied;
+			monthly_bill[m] = monthly_ec_charges[m] + monthly_dc_fixed[m] + monthly_dc_tou[m];
 
-				// rollover energy from correct period - matching time of day - currently four values considered 12a, 6a, 12p, 6p set in loop above.
-				if (m > 0 && enable_nm && !excess_monthly_dollars)
+		} // end of month m (m loop)
+
+		// TODO: check two meter excess
+
+
+		// Assumption that fixed and minimum charges independent of rollovers kWh or $
+		// process monthly fixed charges
+		// compute revenue ( = income - payment ) and monthly bill ( = payment - income) and apply fixed and minimum charges
+		c = 0;
+		ssc_number_t mon_bill = 0, ann_bill = 0;
+		ssc_number_t ann_min_charge = as_number("ur_annual_min_charge")*rate_esc;
+		ssc_number_t mon_min_charge = as_number("ur_monthly_min_charge")*rate_esc;
+		ssc_number_t mon_fixed = as_number("ur_monthly_fixed_charge")*rate_esc;
+
+		// process one month at a time
+		for (m = 0; m < 12; m++)
+		{
+			for (d = 0; d < util::nday[m]; d++)
+			{
+				for (h = 0; h < 24; h++)
 				{
-					// check for surplus in previous month for same period
-					for (size_t ir = 0; ir < m_month[m - 1].ec_energy_surplus.nrows(); ir++)
+					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
 					{
-						if (m_month[m - 1].ec_energy_surplus.at(ir, 0) > 0) // surplus - check period
+						if (d == util::nday[m] - 1 && h == 23 && s == (int)(steps_per_hour - 1))
 						{
-							int toup_source = m_month[m - 1].ec_periods[ir]; // number of rows of previous month - and period with surplus
-							// find source period in rollover map for previous month
-							std::vector<int>::iterator source_per_num = std::find(m_month[m-1].ec_rollover_periods.begin(), m_month[m-1].ec_rollover_periods.end(), toup_source);
-							if (source_per_num == m_month[m-1].ec_rollover_periods.end())
+							// apply fixed first
+							if (include_fixed)
 							{
-								std::ostringstream ss;
-								ss << "year:" << year << " utilityrate5: Unable to determine period for energy charge rollover: Period " << toup_source << " does not exist for 12 am, 6 am, 12 pm or 6 pm in the previous month, which is Month " << util::schedule_int_to_month(m-1) << ".";
-								log(ss.str(), SSC_NOTICE);
+								payment[c] += mon_fixed;
+								monthly_fixed_charges[m] += mon_fixed;
 							}
-							else
+							mon_bill = payment[c] - income[c];
+							if (mon_bill < 0) mon_bill = 0; // for calculating min charge when monthly surplus.
+							// apply monthly minimum
+							if (include_min)
 							{
-								// find corresponding target period for same time of day
-								ssc_number_t extra = 0;
-								int rollover_index = (int)(source_per_num - m_month[m-1].ec_rollover_periods.begin());
-								if (rollover_index < (int)m_month[m].ec_rollover_periods.size())
+								if (mon_bill < mon_min_charge)
 								{
-									int toup_target = m_month[m].ec_rollover_periods[rollover_index];
-									std::vector<int>::iterator target_per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), toup_target);
-									if (target_per_num == m_month[m].ec_periods.end())
+									monthly_minimum_charges[m] += mon_min_charge - mon_bill;
+									payment[c] += mon_min_charge - mon_bill;
+								}
+							}
+							ann_bill += mon_bill;
+							if (m == 11)
+							{
+								// apply annual minimum
+								if (include_min)
+								{
+									if (ann_bill < ann_min_charge)
 									{
-										std::ostringstream ss;
-										ss << "year:" << year << "utilityrate5: Unable to determine period for energy charge rollover: Period " << toup_target << " does not exist for 12 am, 6 am, 12 pm or 6 pm in the current month, which is " << util::schedule_int_to_month(m) << ".";
-										log(ss.str(), SSC_NOTICE);
+										monthly_minimum_charges[m] += ann_min_charge - ann_bill;
+										payment[c] += ann_min_charge - ann_bill;
+									}
+								}
+								// apply annual rollovers AFTER minimum calculations
+								if (enable_nm)
+								{
+									// monthly rollover with year end sell at reduced rate
+									if (!excess_monthly_dollars && (monthly_cumulative_excess_energy[11] > 0))
+									{
+										ssc_number_t year_end_dollars = monthly_cumulative_excess_energy[11] * as_number("ur_nm_yearend_sell_rate")*rate_esc;
+										income[8759] += year_end_dollars;
+										monthly_cumulative_excess_dollars[11] = year_end_dollars;
+										excess_dollars_earned[11] += year_end_dollars;
+										excess_dollars_applied[11] += year_end_dollars;
+									}
+									else if (excess_monthly_dollars && (monthly_cumulative_excess_dollars[11] > 0))
+									{
+										income[8759] += monthly_cumulative_excess_dollars[11];
+										// ? net metering energy?
 									}
-									int target_row = (int)(target_per_num - m_month[m].ec_periods.begin());
-									for (size_t ic = 0; ic < m_month[m - 1].ec_energy_surplus.ncols(); ic++)
-										extra += m_month[m - 1].ec_energy_surplus.at(ir, ic);
-
-									m_month[m].ec_energy_use(target_row, 0) += extra;
 								}
 							}
+							revenue[c] = income[c] - payment[c];
+							monthly_bill[m] = -revenue[c];
 						}
+						c++;
 					}
 				}
+			}
+		}
 
-				// set surplus or use
-				for (size_t ir = 0; ir < m_month[m].ec_energy_use.nrows(); ir++)
+	}
+
+	// rate independent part of ur_calc: monthly net energy, energy by period and tier, and demand peaks
+	void ur_calc_aggregate(ssc_number_t *e_in, ssc_number_t *p_in,
+		ssc_number_t excess_kwhs_earned[12], ssc_number_t excess_kwhs_applied[12],
+		ssc_number_t monthly_cumulative_excess_energy[12], size_t year, bool gen_only)
+		throw(general_error)
+	{
+		int metering_option = as_integer("ur_metering_option");
+		bool enable_nm = (metering_option == 0 || metering_option == 1);
+
+		bool ec_enabled = true; // per 2/25/16 meeting
+		bool dc_enabled = as_boolean("ur_dc_enable");
+
+		bool excess_monthly_dollars = (as_integer("ur_metering_option") == 1);
+
+		size_t steps_per_hour = m_num_rec_yearly / 8760;
+		// calculate the monthly net energy and monthly hours
+		int i, m, d, h, s, period, tier;
+		int c = 0;
+		for (m = 0; m < (int)m_month.size(); m++)
+		{
+			m_month[m].energy_net = 0;
+			m_month[m].hours_per_month = 0;
+			m_month[m].dc_flat_peak = 0;
+			m_month[m].dc_flat_peak_hour = 0;
+			for (d = 0; d < util::nday[m]; d++)
+			{
+				for (h = 0; h < 24; h++)
 				{
-					if (m_month[m].ec_energy_use.at(ir, 0) > 0)
+					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
 					{
-						m_month[m].ec_energy_surplus.at(ir, 0) = m_month[m].ec_energy_use.at(ir, 0);
-						m_month[m].ec_energy_use.at(ir, 0) = 0;
+						// net energy use per month
+						m_month[m].energy_net += e_in[c]; // -load and +gen
+						// hours per period per month
+						m_month[m].hours_per_month++;
+						// peak
+						if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_flat_peak)
+						{
+							m_month[m].dc_flat_peak = -p_in[c];
+							m_month[m].dc_flat_peak_hour = c;
+						}
+						c++;
 					}
-					else
-						m_month[m].ec_energy_use.at(ir, 0) = -m_month[m].ec_energy_use.at(ir, 0);
 				}
+			}
+		}
 
-				// now ditribute across tier boundaries - upper bounds equally across periods
-				// 3/5/16 prorate based on total net per period / total net
-				// look at total net distributed among tiers
+		// monthly cumulative excess energy (positive = excess energy, negative = excess load)
+		if (enable_nm && !excess_monthly_dollars)
+		{
+			ssc_number_t prev_value = 0;
+			for (m = 0; m < 12; m++)
+			{
+				prev_value = (m > 0) ? monthly_cumulative_excess_energy[m - 1] : 0;
+				monthly_cumulative_excess_energy[m] = ((prev_value + m_month[m].energy_net) > 0) ? (prev_value + m_month[m].energy_net) : 0;
+			}
+		}
 
-				ssc_number_t num_per = (ssc_number_t)m_month[m].ec_energy_use.nrows();
-				ssc_number_t tot_energy = 0;
-				for (size_t ir = 0; ir < num_per; ir++)
-					tot_energy += m_month[m].ec_energy_use.at(ir, 0);
-				if (tot_energy > 0)
+		// excess earned
+		for (m = 0; m < 12; m++)
+		{
+			if (m_month[m].energy_net > 0)
+				excess_kwhs_earned[m] = m_month[m].energy_net;
+		}
+
+	
+		// adjust net energy if net metering with monthly rollover
+		if (enable_nm && !excess_monthly_dollars)
+		{
+			for (m = 1; m < (int)m_month.size(); m++)
+			{
+				if (m_month[m].energy_net < 0)
 				{
-					for (size_t ir = 0; ir < num_per; ir++)
+					m_month[m].energy_net += monthly_cumulative_excess_energy[m - 1];
+					excess_kwhs_applied[m] = monthly_cumulative_excess_energy[m - 1];
+				}
+			}
+		}
+
+
+		if (ec_enabled)
+		{
+			// calculate the monthly net energy per tier and period based on units
+			c = 0;
+			for (m = 0; m < (int)m_month.size(); m++)
+			{
+				int start_tier = 0;
+				int end_tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
+				int num_periods = (int)m_month[m].ec_tou_ub_init.nrows();
+				int num_tiers = end_tier - start_tier + 1;
+
+				if (!gen_only) // added for two meter no load scenarios to use load tier sizing
+				{
+					//start_tier = 0;
+					end_tier = (int)m_month[m].ec_tou_ub_init.ncols() - 1;
+					//int num_periods = (int)m_month[m].ec_tou_ub_init.nrows();
+					num_tiers = end_tier - start_tier + 1;
+
+					// kWh/kW (kWh/kW daily handled in Setup)
+					// 1. find kWh/kW tier
+					// 2. set min tier and max tier based on next item in ec_tou matrix
+					// 3. resize use and chart based on number of tiers in kWh/kW section
+					// 4. assumption is that all periods in same month have same tier breakdown
+					// 5. assumption is that tier numbering is correct for the kWh/kW breakdown
+					// That is, first tier must be kWh/kW
+					if ((m_month[m].ec_tou_units.ncols()>0 && m_month[m].ec_tou_units.nrows() > 0)
+						&& ((m_month[m].ec_tou_units.at(0, 0) == 1) || (m_month[m].ec_tou_units.at(0, 0) == 3)))
 					{
-						bool done = false;
-						ssc_number_t per_energy = m_month[m].ec_energy_use.at(ir, 0);
-						for (size_t ic = 0; ic < m_month[m].ec_tou_ub.ncols() && !done; ic++)
+						// monthly total energy / monthly peak to determine which kWh/kW tier
+						double mon_kWhperkW = -m_month[m].energy_net; // load negative
+						if (m_month[m].dc_flat_peak != 0)
+							mon_kWhperkW /= m_month[m].dc_flat_peak;
+						// find correct start and end tier based on kWhperkW band
+						start_tier = 1;
+						bool found = false;
+						for (size_t i_tier = 0; i_tier < m_month[m].ec_tou_units.ncols(); i_tier++)
 						{
-							ssc_number_t ub_tier = m_month[m].ec_tou_ub.at(ir, ic);
-							if (per_energy > 0)
+							int units = (int)m_month[m].ec_tou_units.at(0, i_tier);
+							if ((units == 1) || (units == 3))
 							{
-								if (tot_energy > ub_tier)
+								if (found)
 								{
-									m_month[m].ec_energy_use.at(ir, ic) = (per_energy/tot_energy) * ub_tier;
-									if (ic > 0)
-										m_month[m].ec_energy_use.at(ir, ic) -= (per_energy / tot_energy) * m_month[m].ec_tou_ub.at(ir, ic - 1);
+									end_tier = (int)i_tier - 1;
+									break;
 								}
-								else
+								else if (mon_kWhperkW < m_month[m].ec_tou_ub_init.at(0, i_tier))
 								{
-									m_month[m].ec_energy_use.at(ir, ic) = (per_energy / tot_energy) * tot_energy;
-									if (ic > 0)
-										m_month[m].ec_energy_use.at(ir, ic) -= (per_energy / tot_energy)* m_month[m].ec_tou_ub.at(ir, ic - 1);
-									done=true;
+									start_tier = (int)i_tier + 1;
+									found = true;
 								}
 							}
 						}
-					}
-				}
-
-				// repeat for surplus
-				tot_energy = 0;
-				for (size_t ir = 0; ir < num_per; ir++)
-					tot_energy += m_month[m].ec_energy_surplus.at(ir, 0);
-				if (tot_energy > 0)
-				{
-					for (size_t ir = 0; ir < num_per; ir++)
-					{
-						bool done = false;
-						ssc_number_t per_energy = m_month[m].ec_energy_surplus.at(ir, 0);
-						for (size_t ic = 0; ic < m_month[m].ec_tou_ub.ncols() && !done; ic++)
+						// last tier since no max specified in rate
+						if (!found) start_tier = end_tier;
+						if (start_tier >= (int)m_month[m].ec_tou_ub_init.ncols())
+							start_tier = (int)m_month[m].ec_tou_ub_init.ncols() - 1;
+						if (end_tier < start_tier)
+							end_tier = start_tier;
+						num_tiers = end_tier - start_tier + 1;
+						// resize everytime to handle load and energy changes
+						// resize sr, br and ub for use in energy charge calculations below
+						util::matrix_t<float> br(num_periods, num_tiers);
+						util::matrix_t<float> sr(num_periods, num_tiers);
+						util::matrix_t<float> ub(num_periods, num_tiers);
+						// assign appropriate values.
+						for (period = 0; period < num_periods; period++)
 						{
-							ssc_number_t ub_tier = m_month[m].ec_tou_ub.at(0, ic);
-							if (per_energy > 0)
+							for (tier = 0; tier < num_tiers; tier++)
 							{
-								if (tot_energy > ub_tier)
-								{
-									m_month[m].ec_energy_surplus.at(ir, ic) = (per_energy / tot_energy) * ub_tier;
-									if (ic > 0)
-										m_month[m].ec_energy_surplus.at(ir, ic) -= (per_energy / tot_energy) * m_month[m].ec_tou_ub.at(ir, ic - 1);
-								}
-								else
-								{
-									m_month[m].ec_energy_surplus.at(ir, ic) = (per_energy / tot_energy) * tot_energy;
-									if (ic > 0)
-										m_month[m].ec_energy_surplus.at(ir, ic) -= (per_energy / tot_energy)* m_month[m].ec_tou_ub.at(ir, ic - 1);
-									done = true;
-								}
+								br.at(period, tier) = m_month[m].ec_tou_br_init.at(period, start_tier + tier);
+								sr.at(period, tier) = m_month[m].ec_tou_sr_init.at(period, start_tier + tier);
+								ub.at(period, tier) = m_month[m].ec_tou_ub_init.at(period, start_tier + tier);
+								// update for correct tier number column headings
+								m_month[m].ec_periods_tiers[period][tier] = start_tier + m_ec_periods_tiers_init[period][tier];
 							}
 						}
+
+						m_month[m].ec_tou_br = br;
+						m_month[m].ec_tou_sr = sr;
+						m_month[m].ec_tou_ub = ub;
 					}
+
+					// reset now resized - if necessary
 				}
+				start_tier = 0;
+				end_tier = (int)m_month[m].ec_tou_ub.ncols() - 1;
 
-			} // end month
-		}
+				m_month[m].ec_energy_use.resize_fill(num_periods, num_tiers, 0);
+				m_month[m].ec_energy_surplus.resize_fill(num_periods, num_tiers, 0);
+				m_month[m].ec_charge.resize_fill(num_periods, num_tiers, 0);
 
-		// set peak per period - no tier accumulation
-		if (dc_enabled)
-		{
-			c = 0;
-			for (m = 0; m < (int)m_month.size(); m++)
-			{
-				m_month[m].dc_tou_peak.clear();
-				m_month[m].dc_tou_peak_hour.clear();
-				for (i = 0; i < (int)m_month[m].dc_periods.size(); i++)
+
+
+				// accumulate energy per period - place all in tier 0 initially and then
+				// break up according to tier boundaries and number of periods
+
+				/*  hour by hour accumulation - changed to monthly per meeting with Paul 2/29/16 */
+				// monthly accumulation of energy
+				ssc_number_t mon_e_net = 0;
+				if (m>0 && enable_nm && !excess_monthly_dollars)
 				{
-					m_month[m].dc_tou_peak.push_back(0);
-					m_month[m].dc_tou_peak_hour.push_back(0);
+					mon_e_net = monthly_cumulative_excess_energy[m - 1]; // rollover
 				}
+
 				for (d = 0; d < util::nday[m]; d++)
 				{
 					for (h = 0; h < 24; h++)
 					{
 						for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
 						{
-							int todp = m_dc_tou_sched[c];
-							std::vector<int>::iterator per_num = std::find(m_month[m].dc_periods.begin(), m_month[m].dc_periods.end(), todp);
-							if (per_num == m_month[m].dc_periods.end())
+							mon_e_net += e_in[c];
+							int row = m_ec_tou_row[c];
+							if (row < 0)
 							{
 								std::ostringstream ss;
-								ss << "Demand rate Period " << todp << " not found for Month " << m << ".";
+								ss << "Energy rate TOU Period " << m_ec_tou_sched[c] << " not found for Month " << util::schedule_int_to_month(m) << ".";
 								throw exec_error("utilityrate5", ss.str());
 							}
-							int row = (int)(per_num - m_month[m].dc_periods.begin());
-							if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_tou_peak[row])
-							{
-								m_month[m].dc_tou_peak[row] = -p_in[c];
-								m_month[m].dc_tou_peak_hour[row] = c;
-							}
+							// place all in tier 0 initially and then update appropriately
+							// net energy per period per month
+							m_month[m].ec_energy_use(row, 0) += e_in[c];
 							c++;
 						}
 					}
 				}
-			}
-		}
 
-
-		
-		
-// main loop
-		c = 0;
-		// process one month at a time
-		for (m = 0; m < (int)m_month.size(); m++)
-		{
-			if (m_month[m].hours_per_month <= 0) break;
-			for (d = 0; d<util::nday[m]; d++)
-			{
-				for (h = 0; h<24; h++)
+				/*
+				// rollover energy from correct period - based on matching period number
+				if (m > 0 && enable_nm && !excess_monthly_kwhs)
 				{
-					// energy charge
-					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
+					// check for surplus in previous month for same period
+					for (size_t ir = 0; ir < m_month[m - 1].ec_energy_surplus.nrows(); ir++)
 					{
-						if (d == util::nday[m] - 1 && h == 23 && s == (int)(steps_per_hour-1) )
+						if (m_month[m - 1].ec_energy_surplus.at(ir, 0) > 0) // surplus - check period
 						{
-							if (ec_enabled)
+							int toup = m_month[m - 1].ec_periods[ir]; // number of rows of previous month
+							std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), toup);
+							if (per_num == m_month[m].ec_periods.end())
 							{
-								// energy use and surplus distributed correctly above.
-								// so calculate for all and not based on monthly net
-								// addresses issue if net > 0 but one period net < 0
-								ssc_number_t credit_amt = 0;
-								for (period = 0; period < (int)m_month[m].ec_tou_sr.nrows(); period++)
-								{
-									for (tier = 0; tier < (int)m_month[m].ec_tou_sr.ncols(); tier++)
-									{
-										ssc_number_t cr = m_month[m].ec_energy_surplus.at(period, tier) * m_month[m].ec_tou_sr.at(period, tier) * rate_esc;
-
-//										excess_kwhs_earned[m] += m_month[m].ec_energy_surplus.at(period, tier);
-
-										if (!enable_nm)
-										{
-											credit_amt += cr;
-											m_month[m].ec_charge.at(period, tier) = -cr;
-										}
-										else if (excess_monthly_dollars)
-											monthly_cumulative_excess_dollars[m] += cr;
-
-										/*
-										if (!enable_nm || excess_monthly_kwhs)
-										{
-										credit_amt += cr;
-										if (!excess_monthly_kwhs)
-										m_month[m].ec_charge.at(period, tier) = -cr;
-										}
-										*/
-									}
-								}
-								monthly_ec_charges[m] -= credit_amt;
-
-								ssc_number_t charge_amt = 0;
-								for (period = 0; period < (int)m_month[m].ec_tou_br.nrows(); period++)
-								{
-									for (tier = 0; tier < (int)m_month[m].ec_tou_br.ncols(); tier++)
-									{
-										ssc_number_t ch = m_month[m].ec_energy_use.at(period, tier) * m_month[m].ec_tou_br.at(period, tier) * rate_esc;
-										m_month[m].ec_charge.at(period, tier) = ch;
-										charge_amt += ch;
-									}
-								}
-								monthly_ec_charges[m] += charge_amt;
-
-
-								// monthly rollover with year end sell at reduced rate
-								if (enable_nm)
-								{
-									payment[c] += monthly_ec_charges[m];
-									/*
-									if (monthly_ec_charges[m] < 0)
-									{
-									monthly_cumulative_excess_kwhs[m] = -monthly_ec_charges[m];
-									payment[c] += monthly_ec_charges[m];
-									}
-									*/
-								}
-								else // non-net metering - no rollover 
-								{
-									if (m_month[m].energy_net < 0) // must buy from grid
-										payment[c] += monthly_ec_charges[m];
-									else // surplus - sell to grid
-										income[c] -= monthly_ec_charges[m]; // charge is negative for income!
-								}
-
-								energy_charge[c] += monthly_ec_charges[m];
-
-								// end of energy charge
-
+								std::ostringstream ss;
+								ss << "utilityrate5: energy charge rollover for period " << toup << " not found for month " << m;
+								log(ss.str(), SSC_NOTICE);
 							}
-
-
-							if (dc_enabled)
+							else
 							{
-								// fixed demand charge
-								// compute charge based on tier structure for the month
-								ssc_number_t charge = 0;
-								ssc_number_t d_lower = 0;
-								ssc_number_t demand = m_month[m].dc_flat_peak;
-								bool found = false;
-								for (tier = 0; tier < (int)m_month[m].dc_flat_ub.size() && !found; tier++)
-								{
-									if (demand < m_month[m].dc_flat_ub[tier])
-									{
-										found = true;
-										charge += (demand - d_lower) *
-											m_month[m].dc_flat_ch[tier] * rate_esc;
-										m_month[m].dc_flat_charge = charge;
-									}
-									else
-									{
-										charge += (m_month[m].dc_flat_ub[tier] - d_lower) *
-											m_month[m].dc_flat_ch[tier] * rate_esc;
-										d_lower = m_month[m].dc_flat_ub[tier];
-									}
-								}
-
-								monthly_dc_fixed[m] = charge; // redundant...
-								payment[c] += monthly_dc_fixed[m];
-								demand_charge[c] = charge;
-								dc_hourly_peak[m_month[m].dc_flat_peak_hour] = demand;
-
-
-								// end of fixed demand charge
+								ssc_number_t extra = 0;
+								int row = (int)(per_num - m_month[m].ec_periods.begin());
+								for (size_t ic = 0; ic < m_month[m - 1].ec_energy_surplus.ncols(); ic++)
+									extra += m_month[m - 1].ec_energy_surplus.at(ir, ic);
 
+								m_month[m].ec_energy_use(row, 0) += extra;
+							}
+						}
+					}
+				}
+				*/
 
-								// TOU demand charge for each period find correct tier
-								demand = 0;
-								d_lower = 0;
-								int peak_hour = 0;
-								m_month[m].dc_tou_charge.clear();
-								for (period = 0; period < (int)m_month[m].dc_tou_ub.nrows(); period++)
+				// rollover energy from correct period - matching time of day - currently four values considered 12a, 6a, 12p, 6p set in loop above.
+				if (m > 0 && enable_nm && !excess_monthly_dollars)
+				{
+					// check for surplus in previous month for same period
+					for (size_t ir = 0; ir < m_month[m - 1].ec_energy_surplus.nrows(); ir++)
+					{
+						if (m_month[m - 1].ec_energy_surplus.at(ir, 0) > 0) // surplus - check period
+						{
+							int toup_source = m_month[m - 1].ec_periods[ir]; // number of rows of previous month - and period with surplus
+							// find source period in rollover map for previous month
+							std::vector<int>::iterator source_per_num = std::find(m_month[m-1].ec_rollover_periods.begin(), m_month[m-1].ec_rollover_periods.end(), toup_source);
+							if (source_per_num == m_month[m-1].ec_rollover_periods.end())
+							{
+								std::ostringstream ss;
+								ss << "year:" << year << " utilityrate5: Unable to determine period for energy charge rollover: Period " << toup_source << " does not exist for 12 am, 6 am, 12 pm or 6 pm in the previous month, which is Month " << util::schedule_int_to_month(m-1) << ".";
+								log(ss.str(), SSC_NOTICE);
+							}
+							else
+							{
+								// find corresponding target period for same time of day
+								ssc_number_t extra = 0;
+								int rollover_index = (int)(source_per_num - m_month[m-1].ec_rollover_periods.begin());
+								if (rollover_index < (int)m_month[m].ec_rollover_periods.size())
 								{
-									charge = 0;
-									d_lower = 0;
-									if (tou_demand_single_peak)
-									{
-										demand = m_month[m].dc_flat_peak;
-										if (m_month[m].dc_flat_peak_hour != m_month[m].dc_tou_peak_hour[period]) continue; // only one peak per month.
-									}
-									else
-										demand = m_month[m].dc_tou_peak[period];
-									// find tier corresponding to peak demand
-									found = false;
-									for (tier = 0; tier < (int)m_month[m].dc_tou_ub.ncols() && !found; tier++)
+									int toup_target = m_month[m].ec_rollover_periods[rollover_index];
+									std::vector<int>::iterator target_per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), toup_target);
+									if (target_per_num == m_month[m].ec_periods.end())
 									{
-										if (demand < m_month[m].dc_tou_ub.at(period, tier))
-										{
-											found = true;
-											charge += (demand - d_lower) *
-												m_month[m].dc_tou_ch.at(period, tier)* rate_esc;
-											m_month[m].dc_tou_charge.push_back(charge);
-										}
-										else
-										{
-											charge += (m_month[m].dc_tou_ub.at(period, tier) - d_lower) * m_month[m].dc_tou_ch.at(period, tier)* rate_esc;
-											d_lower = m_month[m].dc_tou_ub.at(period, tier);
-										}
+										std::ostringstream ss;
+										ss << "year:" << year << "utilityrate5: Unable to determine period for energy charge rollover: Period " << toup_target << " does not exist for 12 am, 6 am, 12 pm or 6 pm in the current month, which is " << util::schedule_int_to_month(m) << ".";
+										log(ss.str(), SSC_NOTICE);
 									}
-
-									dc_hourly_peak[peak_hour] = demand;
-									// add to payments
-									monthly_dc_tou[m] += charge;
-									payment[c] += charge; // apply to last hour of the month
-									demand_charge[c] += charge; // add TOU charge to hourly demand charge
-								}
-								// end of TOU demand charge
-							}
-
-						} // end of if end of month
-						c++;
-					} // end of steps per hour loop
-				}  // h loop
-			} // d loop
-
-			// Calculate monthly bill (before minimums and fixed charges) and excess kwhs and rollover
-//			monthly_bill[m] = payment[c - 1] - income[c - 1];
-			monthly_bill[m] = monthly_ec_charges[m] + monthly_dc_fixed[m] + monthly_dc_tou[m];
-
-			monthly_ec_charges_gross[m] = monthly_ec_charges[m];
-			excess_dollars_earned[m] = monthly_cumulative_excess_dollars[m];
-			ssc_number_t dollars_applied = 0;
-			if (enable_nm)
-			{
-				// apply previous month rollover kwhs
-				if (m > 0)
-				{
-//					monthly_bill[m] -= monthly_cumulative_excess_dollars[m - 1];
-					payment[c - 1] -= monthly_cumulative_excess_dollars[m-1];
-					monthly_ec_charges[m] -= monthly_cumulative_excess_dollars[m - 1];
-					dollars_applied += monthly_cumulative_excess_dollars[m - 1];
+									int target_row = (int)(target_per_num - m_month[m].ec_periods.begin());
+									for (size_t ic = 0; ic < m_month[m - 1].ec_energy_surplus.ncols(); ic++)
+										extra += m_month[m - 1].ec_energy_surplus.at(ir, ic);
+
+									m_month[m].ec_energy_use(target_row, 0) += extra;
+								}
+							}
+						}
+					}
 				}
-//				if (monthly_bill[m] < 0)
-				if (monthly_ec_charges[m] < 0)
+
+				// set surplus or use
+				for (size_t ir = 0; ir < m_month[m].ec_energy_use.nrows(); ir++)
 				{
-					if (excess_monthly_dollars)
+					if (m_month[m].ec_energy_use.at(ir, 0) > 0)
 					{
-						monthly_cumulative_excess_dollars[m] -= monthly_ec_charges[m];
-						//						monthly_cumulative_excess_dollars[m] -= monthly_bill[m];
+						m_month[m].ec_energy_surplus.at(ir, 0) = m_month[m].ec_energy_use.at(ir, 0);
+						m_month[m].ec_energy_use.at(ir, 0) = 0;
 					}
-					//					monthly_bill[m] = 0;
-					payment[c - 1] -= monthly_ec_charges[m];; // keep demand charges
-					monthly_ec_charges[m] = 0;
+					else
+						m_month[m].ec_energy_use.at(ir, 0) = -m_month[m].ec_energy_use.at(ir, 0);
 				}
-				else // apply current month rollover and adjust
+
+				// now ditribute across tier boundaries - upper bounds equally across periods
+				// 3/5/16 prorate based on total net per period / total net
+				// look at total net distributed among tiers
+
+				ssc_number_t num_per = (ssc_number_t)m_month[m].ec_energy_use.nrows();
+				ssc_number_t tot_energy = 0;
+				for (size_t ir = 0; ir < num_per; ir++)
+					tot_energy += m_month[m].ec_energy_use.at(ir, 0);
+				if (tot_energy > 0)
 				{
-//					monthly_bill[m] -= monthly_cumulative_excess_dollars[m];
-					monthly_ec_charges[m] -= monthly_cumulative_excess_dollars[m];
-					//					if (monthly_bill[m] < 0)
-					if (monthly_ec_charges[m] < 0)
+					for (size_t ir = 0; ir < num_per; ir++)
 					{
-						payment[c - 1] -= monthly_cumulative_excess_dollars[m] + monthly_ec_charges[m];
-						if (excess_monthly_dollars)
+						bool done = false;
+						ssc_number_t per_energy = m_month[m].ec_energy_use.at(ir, 0);
+						for (size_t ic = 0; ic < m_month[m].ec_tou_ub.ncols() && !done; ic++)
 						{
-//							monthly_cumulative_excess_dollars[m] = -monthly_bill[m];
-							dollars_applied += monthly_cumulative_excess_dollars[m] + monthly_ec_charges[m];
-							monthly_cumulative_excess_dollars[m] = -monthly_ec_charges[m];
+							ssc_number_t ub_tier = m_month[m].ec_tou_ub.at(ir, ic);
+							if (per_energy > 0)
+							{
+								if (tot_energy > ub_tier)
+								{
+									m_month[m].ec_energy_use.at(ir, ic) = (per_energy/tot_energy) * ub_tier;
+									if (ic > 0)
+										m_month[m].ec_energy_use.at(ir, ic) -= (per_energy / tot_energy) * m_month[m].ec_tou_ub.at(ir, ic - 1);
+								}
+								else
+								{
+									m_month[m].ec_energy_use.at(ir, ic) = (per_energy / tot_energy) * tot_energy;
+									if (ic > 0)
+										m_month[m].ec_energy_use.at(ir, ic) -= (per_energy / tot_energy)* m_month[m].ec_tou_ub.at(ir, ic - 1);
+									done=true;
+								}
+							}
 						}
-						//						monthly_bill[m] = 0;
-						monthly_ec_charges[m] = 0;
 					}
-					else
+				}
+
+				// repeat for surplus
+				tot_energy = 0;
+				for (size_t ir = 0; ir < num_per; ir++)
+					tot_energy += m_month[m].ec_energy_surplus.at(ir, 0);
+				if (tot_energy > 0)
+				{
+					for (size_t ir = 0; ir < num_per; ir++)
 					{
-						dollars_applied += monthly_cumulative_excess_dollars[m];
-						payment[c - 1] -= monthly_cumulative_excess_dollars[m];
-						monthly_cumulative_excess_dollars[m] = 0;
+						bool done = false;
+						ssc_number_t per_energy = m_month[m].ec_energy_surplus.at(ir, 0);
+						for (size_t ic = 0; ic < m_month[m].ec_tou_ub.ncols() && !done; ic++)
+						{
+							ssc_number_t ub_tier = m_month[m].ec_tou_ub.at(0, ic);
+							if (per_energy > 0)
+							{
+								if (tot_energy > ub_tier)
+								{
+									m_month[m].ec_energy_surplus.at(ir, ic) = (per_energy / tot_energy) * ub_tier;
+									if (ic > 0)
+										m_month[m].ec_energy_surplus.at(ir, ic) -= (per_energy / tot_energy) * m_month[m].ec_tou_ub.at(ir, ic - 1);
+								}
+								else
+								{
+									m_month[m].ec_energy_surplus.at(ir, ic) = (per_energy / tot_energy) * tot_energy;
+									if (ic > 0)
+										m_month[m].ec_energy_surplus.at(ir, ic) -= (per_energy / tot_energy)* m_month[m].ec_tou_ub.at(ir, ic - 1);
+									done = true;
+								}
+							}
+						}
 					}
 				}
-			}
-			if (monthly_ec_charges_gross[m] < dollars_applied) dollars_applied = monthly_ec_charges_gross[m];
-			excess_dollars_applied[m] = dollars_applied;
-			monthly_bill[m] = monthly_ec_charges[m] + monthly_dc_fixed[m] + monthly_dc_tou[m];
-
-		} // end of month m (m loop)
-
-		// TODO: check two meter excess
-
 
-		// Assumption that fixed and minimum charges independent of rollovers kWh or $
-		// process monthly fixed charges
-		// compute revenue ( = income - payment ) and monthly bill ( = payment - income) and apply fixed and minimum charges
-		c = 0;
-		ssc_number_t mon_bill = 0, ann_bill = 0;
-		ssc_number_t ann_min_charge = as_number("ur_annual_min_charge")*rate_esc;
-		ssc_number_t mon_min_charge = as_number("ur_monthly_min_charge")*rate_esc;
-		ssc_number_t mon_fixed = as_number("ur_monthly_fixed_charge")*rate_esc;
+			} // end month
+		}
 
-		// process one month at a time
-		for (m = 0; m < 12; m++)
+		// set peak per period - no tier accumulation
+		if (dc_enabled)
 		{
-			for (d = 0; d < util::nday[m]; d++)
+			c = 0;
+			for (m = 0; m < (int)m_month.size(); m++)
 			{
-				for (h = 0; h < 24; h++)
+				m_month[m].dc_tou_peak.clear();
+				m_month[m].dc_tou_peak_hour.clear();
+				for (i = 0; i < (int)m_month[m].dc_periods.size(); i++)
 				{
-					for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
+					m_month[m].dc_tou_peak.push_back(0);
+					m_month[m].dc_tou_peak_hour.push_back(0);
+				}
+				for (d = 0; d < util::nday[m]; d++)
+				{
+					for (h = 0; h < 24; h++)
 					{
-						if (d == util::nday[m] - 1 && h == 23 && s == (int)(steps_per_hour - 1))
+						for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
 						{
-							// apply fixed first
-							if (include_fixed)
-							{
-								payment[c] += mon_fixed;
-								monthly_fixed_charges[m] += mon_fixed;
-							}
-							mon_bill = payment[c] - income[c];
-							if (mon_bill < 0) mon_bill = 0; // for calculating min charge when monthly surplus.
-							// apply monthly minimum
-							if (include_min)
+							int row = m_dc_tou_row[c];
+							if (row < 0)
 							{
-								if (mon_bill < mon_min_charge)
-								{
-									monthly_minimum_charges[m] += mon_min_charge - mon_bill;
-									payment[c] += mon_min_charge - mon_bill;
-								}
+								std::ostringstream ss;
+								ss << "Demand rate Period " << m_dc_tou_sched[c] << " not found for Month " << m << ".";
+								throw exec_error("utilityrate5", ss.str());
 							}
-							ann_bill += mon_bill;
-							if (m == 11)
+							if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_tou_peak[row])
 							{
-								// apply annual minimum
-								if (include_min)
-								{
-									if (ann_bill < ann_min_charge)
-									{
-										monthly_minimum_charges[m] += ann_min_charge - ann_bill;
-										payment[c] += ann_min_charge - ann_bill;
-									}
-								}
-								// apply annual rollovers AFTER minimum calculations
-								if (enable_nm)
-								{
-									// monthly rollover with year end sell at reduced rate
-									if (!excess_monthly_dollars && (monthly_cumulative_excess_energy[11] > 0))
-									{
-										ssc_number_t year_end_dollars = monthly_cumulative_excess_energy[11] * as_number("ur_nm_yearend_sell_rate")*rate_esc;
-										income[8759] += year_end_dollars;
-										monthly_cumulative_excess_dollars[11] = year_end_dollars;
-										excess_dollars_earned[11] += year_end_dollars;
-										excess_dollars_applied[11] += year_end_dollars;
-									}
-									else if (excess_monthly_dollars && (monthly_cumulative_excess_dollars[11] > 0))
-									{
-										income[8759] += monthly_cumulative_excess_dollars[11];
-										// ? net metering energy?
-									}
-								}
+								m_month[m].dc_tou_peak[row] = -p_in[c];
+								m_month[m].dc_tou_peak_hour[row] = c;
 							}
-							revenue[c] = income[c] - payment[c];
-							monthly_bill[m] = -revenue[c];
+							c++;
 						}
-						c++;
 					}
 				}
 			}
 		}
-
 	}
 
 	// updated to timestep for net billing
@@ -2855,15 +2974,13 @@ public:
 					{
 						for (s = 0; s < (int)steps_per_hour && c < (int)m_num_rec_yearly; s++)
 						{
-							int todp = m_dc_tou_sched[c];
-							std::vector<int>::iterator per_num = std::find(m_month[m].dc_periods.begin(), m_month[m].dc_periods.end(), todp);
-							if (per_num == m_month[m].dc_periods.end())
+							int row = m_dc_tou_row[c];
+							if (row < 0)
 							{
 								std::ostringstream ss;
-								ss << "Demand charge Period " << todp << " not found for Month " << m << ".";
+								ss << "Demand charge Period " << m_dc_tou_sched[c] << " not found for Month " << m << ".";
 								throw exec_error("utilityrate5", ss.str());
 							}
-							int row = (int)(per_num - m_month[m].dc_periods.begin());
 							if (p_in[c] < 0 && p_in[c] < -m_month[m].dc_tou_peak[row])
 							{
 								m_month[m].dc_tou_peak[row] = -p_in[c];
@@ -2896,16 +3013,14 @@ public:
 						if (ec_enabled)
 						{
 							period = m_ec_tou_sched[c];
-							// find corresponding monthly period
-							// check for valid period
-							std::vector<int>::iterator per_num = std::find(m_month[m].ec_periods.begin(), m_month[m].ec_periods.end(), period);
-							if (per_num == m_month[m].ec_periods.end())
+							// corresponding monthly period resolved in setup
+							int row = m_ec_tou_row[c];
+							if (row < 0)
 							{
 								std::ostringstream ss;
 								ss << "Energy rate Period " << period << " not found for Month " << m << ".";
 								throw exec_error("utilityrate5", ss.str());
 							}
-							int row = (int)(per_num - m_month[m].ec_periods.begin());
 
 							if (e_in[c] >= 0.0)
 							{ // calculate income or credit
@@ -3321,3 +3436,218 @@ public:
 DEFINE_MODULE_ENTRY( utilityrate5, "Complex utility rate structure net revenue calculator OpenEI Version 4 with net billing", 1 );
 
 
+static var_info vtab_utility_rate5_batch[] = {
+
+/*   VARTYPE           DATATYPE         NAME                         LABEL                                           UNITS     META                      GROUP          REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT, SSC_MATRIX, "batch_load", "Electricity load for each customer", "kW", "one row per customer, 8760 x steps per hour columns", "", "*", "", "" },
+	{ SSC_INPUT, SSC_MATRIX, "batch_gen", "System power generated", "kW", "one row for all customers or one row per customer", "", "", "", "" },
+	{ SSC_INPUT, SSC_NUMBER, "batch_threads", "Number of threads", "", "0=one per processor", "", "?=0", "INTEGER,MIN=0", "" },
+
+	{ SSC_OUTPUT, SSC_MATRIX, "batch_monthly_bill", "Electricity bill", "$/mo", "one row per customer", "Monthly", "*", "", "" },
+	{ SSC_OUTPUT, SSC_MATRIX, "batch_monthly_ec_charge", "Energy charge", "$/mo", "one row per customer", "Monthly", "*", "", "" },
+	{ SSC_OUTPUT, SSC_MATRIX, "batch_monthly_dc_fixed", "Demand charge (flat)", "$/mo", "one row per customer", "Monthly", "*", "", "" },
+	{ SSC_OUTPUT, SSC_MATRIX, "batch_monthly_dc_tou", "Demand charge (TOU)", "$/mo", "one row per customer", "Monthly", "*", "", "" },
+	{ SSC_OUTPUT, SSC_MATRIX, "batch_monthly_fixed", "Fixed monthly charge", "$/mo", "one row per customer", "Monthly", "*", "", "" },
+	{ SSC_OUTPUT, SSC_MATRIX, "batch_monthly_minimum", "Minimum charge", "$/mo", "one row per customer", "Monthly", "*", "", "" },
+	{ SSC_OUTPUT, SSC_ARRAY, "batch_annual_bill", "Annual electricity bill", "$/yr", "one value per customer", "Annual", "*", "", "" },
+
+	var_info_invalid };
+
+struct ur_batch_bill
+{
+	ssc_number_t bill[12];
+	ssc_number_t ec_charge[12];
+	ssc_number_t dc_fixed[12];
+	ssc_number_t dc_tou[12];
+	ssc_number_t fixed[12];
+	ssc_number_t minimum[12];
+};
+
+// first year bills for one customer at a time, priced with a copy of a
+// tariff already parsed by setup() on another instance
+class ur_batch_worker : public cm_utilityrate5
+{
+public:
+	ur_batch_worker(const cm_utilityrate5 &tariff, const ssc_number_t *load, const ssc_number_t *gen, size_t gen_rows)
+		: cm_utilityrate5(0), m_load(load), m_gen(gen), m_gen_rows(gen_rows), m_customer(0), m_bill(0)
+	{
+		copy_tariff(tariff);
+	}
+
+	// bill one customer, returns an empty string on success
+	std::string run(var_table *inputs, size_t customer, ur_batch_bill &bill)
+	{
+		m_customer = customer;
+		m_bill = &bill;
+		clear_log();
+		silent_handler h(this);
+		return compute(&h, inputs) ? std::string() : h.last_error();
+	}
+
+	void exec() throw(general_error)
+	{
+		size_t nrec = m_num_rec_yearly;
+		ssc_number_t ts_hour = 1.0f / (nrec / 8760);
+
+		int metering_option = as_integer("ur_metering_option");
+		bool two_meter = (metering_option == 4);
+		bool timestep_reconciliation = (metering_option == 2 || metering_option == 3 || metering_option == 4);
+
+		std::vector<ssc_number_t>
+			e_sys(nrec), p_sys(nrec), e_load(nrec), p_load(nrec), e_grid(nrec), p_grid(nrec),
+			revenue(nrec), payment(nrec), income(nrec), demand_charge(nrec), energy_charge(nrec), dc_hourly_peak(nrec);
+		ssc_number_t monthly_fixed_charges[12], monthly_minimum_charges[12],
+			monthly_dc_fixed[12], monthly_dc_tou[12], monthly_ec_charges[12], monthly_ec_charges_gross[12],
+			monthly_excess_dollars_earned[12], monthly_excess_dollars_applied[12],
+			monthly_excess_kwhs_earned[12], monthly_excess_kwhs_applied[12],
+			monthly_cumulative_excess_energy[12], monthly_cumulative_excess_dollars[12], monthly_bill[12];
+
+		// same year one grid values as utilityrate5, load is positive on input
+		const ssc_number_t *load = m_load + m_customer * nrec;
+		const ssc_number_t *gen = m_gen ? m_gen + (m_gen_rows > 1 ? m_customer : 0) * nrec : 0;
+		for (size_t j = 0; j < nrec; j++)
+		{
+			p_load[j] = -load[j];
+			e_load[j] = p_load[j] * ts_hour;
+			p_sys[j] = gen ? gen[j] : 0;
+			e_sys[j] = p_sys[j] * ts_hour;
+			e_grid[j] = e_sys[j] + e_load[j];
+			p_grid[j] = p_sys[j] + p_load[j];
+		}
+
+		ur_batch_bill &b = *m_bill;
+		for (int pass = 0; pass < (two_meter ? 2 : 1); pass++)
+		{
+			// two meters bill the load and the system separately and add them
+			bool gen_only = (pass == 1);
+			ssc_number_t *e_in = two_meter ? (gen_only ? &e_sys[0] : &e_load[0]) : &e_grid[0];
+			ssc_number_t *p_in = two_meter ? (gen_only ? &p_sys[0] : &p_load[0]) : &p_grid[0];
+			if (timestep_reconciliation)
+				ur_calc_timestep(e_in, p_in,
+					&revenue[0], &payment[0], &income[0], &demand_charge[0], &energy_charge[0],
+					monthly_fixed_charges, monthly_minimum_charges,
+					monthly_dc_fixed, monthly_dc_tou,
+					monthly_ec_charges, monthly_ec_charges_gross,
+					monthly_excess_dollars_earned, monthly_excess_dollars_applied,
+					monthly_excess_kwhs_earned, monthly_excess_kwhs_applied,
+					&dc_hourly_peak[0], monthly_cumulative_excess_energy, monthly_cumulative_excess_dollars, monthly_bill,
+					1.0f, !gen_only, !gen_only, gen_only);
+			else
+				ur_calc(e_in, p_in,
+					&revenue[0], &payment[0], &income[0], &demand_charge[0], &energy_charge[0],
+					monthly_fixed_charges, monthly_minimum_charges,
+					monthly_dc_fixed, monthly_dc_tou,
+					monthly_ec_charges, monthly_ec_charges_gross,
+					monthly_excess_dollars_earned, monthly_excess_dollars_applied,
+					monthly_excess_kwhs_earned, monthly_excess_kwhs_applied,
+					&dc_hourly_peak[0], monthly_cumulative_excess_energy, monthly_cumulative_excess_dollars, monthly_bill,
+					1.0f, 1, !gen_only, !gen_only, gen_only);
+
+			for (int m = 0; m < 12; m++)
+			{
+				if (!gen_only)
+				{
+					b.bill[m] = b.ec_charge[m] = b.dc_fixed[m] = b.dc_tou[m] = b.fixed[m] = b.minimum[m] = 0;
+				}
+				b.bill[m] += monthly_bill[m];
+				b.ec_charge[m] += monthly_ec_charges[m];
+				b.dc_fixed[m] += monthly_dc_fixed[m];
+				b.dc_tou[m] += monthly_dc_tou[m];
+				b.fixed[m] += monthly_fixed_charges[m];
+				b.minimum[m] += monthly_minimum_charges[m];
+			}
+		}
+	}
+
+private:
+	const ssc_number_t *m_load;
+	const ssc_number_t *m_gen;
+	size_t m_gen_rows;
+	size_t m_customer;
+	ur_batch_bill *m_bill;
+};
+
+class cm_utilityrate5_batch : public cm_utilityrate5
+{
+public:
+	cm_utilityrate5_batch() : cm_utilityrate5(vtab_utility_rate5_batch)
+	{
+	}
+
+	void exec() throw(general_error)
+	{
+		size_t ncustomers, nrec;
+		ssc_number_t *load = as_matrix("batch_load", &ncustomers, &nrec);
+		size_t step_per_hour = nrec / 8760;
+		if (step_per_hour < 1 || step_per_hour > 60 || step_per_hour * 8760 != nrec)
+			throw exec_error("utilityrate5_batch", util::format("invalid number of load records (%d): must be an integer multiple of 8760", (int)nrec));
+
+		ssc_number_t *gen = 0;
+		size_t gen_rows = 0;
+		if (is_assigned("batch_gen"))
+		{
+			size_t gen_cols;
+			gen = as_matrix("batch_gen", &gen_rows, &gen_cols);
+			if (gen_cols != nrec || (gen_rows != 1 && gen_rows != ncustomers))
+				throw exec_error("utilityrate5_batch", util::format("gen matrix (%d x %d) must have one row or one row per customer and %d columns", (int)gen_rows, (int)gen_cols, (int)nrec));
+		}
+
+		// parse the tariff once, each worker takes a copy of the result
+		m_num_rec_yearly = nrec;
+		setup();
+
+		var_table tariff;
+		for (var_info *vi = vtab_utility_rate5_tariff; vi->name != 0; vi++)
+			if (is_assigned(vi->name))
+				tariff.assign(vi->name, *lookup(vi->name));
+
+		// one worker and copy of the tariff inputs per thread, reused for each customer the thread bills
+		size_t nthreads = (size_t)as_integer("batch_threads");
+		size_t nworkers = parallel_threads(ncustomers, nthreads);
+		std::vector<var_table> inputs(nworkers);
+		std::vector<std::unique_ptr<ur_batch_worker>> workers(nworkers);
+		for (size_t t = 0; t < nworkers; t++)
+		{
+			inputs[t] = tariff;
+			workers[t].reset(new ur_batch_worker(*this, load, gen, gen_rows));
+		}
+
+		std::vector<ur_batch_bill> bills(ncustomers);
+		std::vector<std::string> errors(ncustomers);
+		parallel_for(ncustomers, nthreads, [&](size_t i, size_t t)
+		{
+			errors[i] = workers[t]->run(&inputs[t], i, bills[i]);
+		});
+
+		for (size_t i = 0; i < ncustomers; i++)
+			if (!errors[i].empty())
+				throw exec_error("utilityrate5_batch", util::format("customer %d: ", (int)i) + errors[i]);
+
+		ssc_number_t *p_bill = allocate("batch_monthly_bill", ncustomers, 12);
+		ssc_number_t *p_ec = allocate("batch_monthly_ec_charge", ncustomers, 12);
+		ssc_number_t *p_dc_fixed = allocate("batch_monthly_dc_fixed", ncustomers, 12);
+		ssc_number_t *p_dc_tou = allocate("batch_monthly_dc_tou", ncustomers, 12);
+		ssc_number_t *p_fixed = allocate("batch_monthly_fixed", ncustomers, 12);
+		ssc_number_t *p_minimum = allocate("batch_monthly_minimum", ncustomers, 12);
+		ssc_number_t *p_annual = allocate("batch_annual_bill", ncustomers);
+		for (size_t i = 0; i < ncustomers; i++)
+		{
+			const ur_batch_bill &b = bills[i];
+			p_annual[i] = 0;
+			for (size_t m = 0; m < 12; m++)
+			{
+				p_bill[i * 12 + m] = b.bill[m];
+				p_ec[i * 12 + m] = b.ec_charge[m];
+				p_dc_fixed[i * 12 + m] = b.dc_fixed[m];
+				p_dc_tou[i * 12 + m] = b.dc_tou[m];
+				p_fixed[i * 12 + m] = b.fixed[m];
+				p_minimum[i * 12 + m] = b.minimum[m];
+				p_annual[i] += b.bill[m];
+			}
+		}
+	}
+};
+
+DEFINE_MODULE_ENTRY( utilityrate5_batch, "Year one utility bills for many customers on one utilityrate5 tariff", 1 );
+
+
@@ -51,6 +51,7 @@
 #include "core.h"
 #include <sstream>
 #include <sstream>
+#include <cmath>
 
 #ifndef WIN32
 #include <float.h>
@@ -258,6 +259,15 @@ enum {
 	CF_max_dispatch
 };
 
+// dispatch_bin_month_period, dispatch_bin_month_ts and compute_dispatch_output index these rows
+// as offsets (CF_TODJanEnergy + m, CF_TODJanRevenue + m, CF_TOD1Energy + p and
+// CF_TOD1JanEnergy + p*12 + m), so the month and period rows must stay contiguous and in order
+static_assert(CF_TODDecEnergy == CF_TODJanEnergy + 11, "monthly energy rows must be contiguous");
+static_assert(CF_TODDecRevenue == CF_TODJanRevenue + 11, "monthly revenue rows must be contiguous");
+static_assert(CF_TOD9Energy == CF_TOD1Energy + 8, "period energy rows must be contiguous");
+static_assert(CF_TOD2JanEnergy == CF_TOD1JanEnergy + 12, "period by month rows must be period major");
+static_assert(CF_TOD9DecEnergy == CF_TOD1JanEnergy + 9 * 12 - 1, "period by month rows must be contiguous");
+
 
 
 //var_info vtab_dispatch_periods[] = {
@@ -314,6 +324,20 @@ bool dispatch_calculations::init(compute_module *cm, std::vector<double>& degrad
 	return true;
 }
 
+bool dispatch_calculations::init(compute_module *cm, const dispatch_calculations &shared)
+{
+	if (!cm) return false;
+
+	*this = shared;
+	m_cm = cm;
+
+	// gen and the multipliers are only read while aggregating, and point into the
+	// var_table of the shared instance, which may already be released
+	m_gen = m_multipliers = 0;
+	m_ngen = m_nmultipliers = 0;
+	return true;
+}
+
 bool dispatch_calculations::compute_outputs_ts(std::vector<double>& ppa)
 {
 
@@ -1293,12 +1317,78 @@ int dispatch_calculations::operator()(size_t time)
 
 
 
+/* the dispatch rows are laid out so that a month, period or month and period bin is an
+   offset from the January / period 1 row, which lets the binning below index them directly
+   instead of switching on each month and period */
+static void dispatch_year1_by_degradation(util::matrix_t<double> &cf, int first_row, int nrows, const std::vector<double> &degradation, int nyears)
+{
+	for (int r = first_row; r < first_row + nrows; r++)
+	{
+		double year1 = cf.at(r, 1);
+		for (int y = 0; y <= nyears; y++)
+			cf.at(r, y) = year1 * degradation[y];
+	}
+}
+
+// one pass over a year of hourly energy bins it by month and by month and dispatch period
+static void dispatch_bin_month_period(util::matrix_t<double> &cf, int col, const double *hourly_energy, const std::vector<int> &periods)
+{
+	for (int m = 0; m < 12; m++)
+	{
+		cf.at(CF_TODJanEnergy + m, col) = 0;
+		for (int p = 0; p < 9; p++)
+			cf.at(CF_TOD1JanEnergy + p * 12 + m, col) = 0;
+	}
+
+	int i = 0;
+	for (int m = 0; m < 12; m++)
+	{
+		for (int d = 0; d < util::nday[m]; d++)
+		{
+			for (int h = 0; h < 24 && i < 8760; h++)
+			{
+				cf.at(CF_TODJanEnergy + m, col) += hourly_energy[i];
+				int period = periods[i];
+				if (period >= 1 && period <= 9)
+					cf.at(CF_TOD1JanEnergy + (period - 1) * 12 + m, col) += hourly_energy[i];
+				i++;
+			}
+		}
+	}
+}
+
+// one pass over a year of timestep gen bins energy and revenue by month
+static void dispatch_bin_month_ts(util::matrix_t<double> &cf, int col, const ssc_number_t *gen, const ssc_number_t *multipliers, size_t nrec_per_year, size_t step_per_hour, ssc_number_t ts_hour)
+{
+	for (int m = 0; m < 12; m++)
+	{
+		cf.at(CF_TODJanEnergy + m, col) = 0;
+		cf.at(CF_TODJanRevenue + m, col) = 0;
+	}
+
+	size_t i = 0;
+	for (int m = 0; m < 12; m++)
+	{
+		for (int d = 0; d < util::nday[m]; d++)
+		{
+			for (int h = 0; h < 24 && i < nrec_per_year; h++)
+			{
+				for (size_t k = 0; k < step_per_hour; k++)
+				{
+					ssc_number_t energy = gen[i] * ts_hour;
+					cf.at(CF_TODJanEnergy + m, col) += energy;
+					cf.at(CF_TODJanRevenue + m, col) += energy * multipliers[i];
+					i++;
+				}
+			}
+		}
+	}
+}
+
 bool dispatch_calculations::compute_dispatch_output()
 {
 	//Calculate energy dispatched in each dispatch period 
 
-
-	int h;
 	size_t count = m_hourly_energy.size();
 
 	// hourly energy
@@ -1311,86 +1401,25 @@ bool dispatch_calculations::compute_dispatch_output()
 		return false;
 	}
 
-
-	m_cf.at(CF_TOD1Energy, 1) = 0;
-	m_cf.at(CF_TOD2Energy, 1) = 0;
-	m_cf.at(CF_TOD3Energy, 1) = 0;
-	m_cf.at(CF_TOD4Energy, 1) = 0;
-	m_cf.at(CF_TOD5Energy, 1) = 0;
-	m_cf.at(CF_TOD6Energy, 1) = 0;
-	m_cf.at(CF_TOD7Energy, 1) = 0;
-	m_cf.at(CF_TOD8Energy, 1) = 0;
-	m_cf.at(CF_TOD9Energy, 1) = 0;
-
-
 	// hourly net energy include first year curtailment, availability and degradation
 	// unapply first year availability and degradation so that dispatch can be properly calculated and 
 	// so that availability and degradation is not applied multiple times
 	// Better would be to calculate dispatch energy in cmod_annual output; however, dispatch only
 	// applies to IPP and DHF markets.
 
+	for (int p = 0; p < 9; p++)
+		m_cf.at(CF_TOD1Energy + p, 1) = 0;
 
-
-	for (h = 0; h<8760; h++)
+	for (int h = 0; h < 8760; h++)
 	{
-		switch (m_periods[h])
-		{
-		case 1:
-			m_cf.at(CF_TOD1Energy, 1) += m_hourly_energy[h];
-			break;
-		case 2:
-			m_cf.at(CF_TOD2Energy, 1) += m_hourly_energy[h];
-			break;
-		case 3:
-			m_cf.at(CF_TOD3Energy, 1) += m_hourly_energy[h];
-			break;
-		case 4:
-			m_cf.at(CF_TOD4Energy, 1) += m_hourly_energy[h];
-			break;
-		case 5:
-			m_cf.at(CF_TOD5Energy, 1) += m_hourly_energy[h];
-			break;
-		case 6:
-			m_cf.at(CF_TOD6Energy, 1) += m_hourly_energy[h];
-			break;
-		case 7:
-			m_cf.at(CF_TOD7Energy, 1) += m_hourly_energy[h];
-			break;
-		case 8:
-			m_cf.at(CF_TOD8Energy, 1) += m_hourly_energy[h];
-			break;
-		case 9:
-			m_cf.at(CF_TOD9Energy, 1) += m_hourly_energy[h];
-			break;
-		}
+		int period = m_periods[h];
+		if (period >= 1 && period <= 9)
+			m_cf.at(CF_TOD1Energy + period - 1, 1) += m_hourly_energy[h];
 	}
+
 	// remove degradation and availability from year 1 values but keep curtailment so that
 	// availability and degradation yearly schedules from cmod_annualoutput can be properly applied.
-	double year1_TOD1Energy = m_cf.at(CF_TOD1Energy, 1);
-	double year1_TOD2Energy = m_cf.at(CF_TOD2Energy, 1);
-	double year1_TOD3Energy = m_cf.at(CF_TOD3Energy, 1);
-	double year1_TOD4Energy = m_cf.at(CF_TOD4Energy, 1);
-	double year1_TOD5Energy = m_cf.at(CF_TOD5Energy, 1);
-	double year1_TOD6Energy = m_cf.at(CF_TOD6Energy, 1);
-	double year1_TOD7Energy = m_cf.at(CF_TOD7Energy, 1);
-	double year1_TOD8Energy = m_cf.at(CF_TOD8Energy, 1);
-	double year1_TOD9Energy = m_cf.at(CF_TOD9Energy, 1);
-
-
-	for (int y = 0; y <= m_nyears; y++)
-	{
-		// compute energy dispatched
-		m_cf.at(CF_TOD1Energy, y) = year1_TOD1Energy * m_degradation[y]; 
-		m_cf.at(CF_TOD2Energy, y) = year1_TOD2Energy * m_degradation[y]; 
-		m_cf.at(CF_TOD3Energy, y) = year1_TOD3Energy * m_degradation[y]; 
-		m_cf.at(CF_TOD4Energy, y) = year1_TOD4Energy * m_degradation[y]; 
-		m_cf.at(CF_TOD5Energy, y) = year1_TOD5Energy * m_degradation[y]; 
-		m_cf.at(CF_TOD6Energy, y) = year1_TOD6Energy * m_degradation[y]; 
-		m_cf.at(CF_TOD7Energy, y) = year1_TOD7Energy * m_degradation[y]; 
-		m_cf.at(CF_TOD8Energy, y) = year1_TOD8Energy * m_degradation[y]; 
-		m_cf.at(CF_TOD9Energy, y) = year1_TOD9Energy * m_degradation[y]; 
-	}
-
+	dispatch_year1_by_degradation(m_cf, CF_TOD1Energy, 9, m_degradation, m_nyears);
 
 	return true;
 }
@@ -1410,821 +1439,17 @@ bool dispatch_calculations::process_dispatch_output()
 		return false;
 	}
 
+	dispatch_bin_month_period(m_cf, 1, &m_hourly_energy[0], m_periods);
 
+	dispatch_year1_by_degradation(m_cf, CF_TODJanEnergy, 12, m_degradation, m_nyears);
+	dispatch_year1_by_degradation(m_cf, CF_TOD1JanEnergy, 9 * 12, m_degradation, m_nyears);
 
-	m_cf.at(CF_TODJanEnergy, 1) = 0;
-	m_cf.at(CF_TODFebEnergy, 1) = 0;
-	m_cf.at(CF_TODMarEnergy, 1) = 0;
-	m_cf.at(CF_TODAprEnergy, 1) = 0;
-	m_cf.at(CF_TODMayEnergy, 1) = 0;
-	m_cf.at(CF_TODJunEnergy, 1) = 0;
-	m_cf.at(CF_TODJulEnergy, 1) = 0;
-	m_cf.at(CF_TODAugEnergy, 1) = 0;
-	m_cf.at(CF_TODSepEnergy, 1) = 0;
-	m_cf.at(CF_TODOctEnergy, 1) = 0;
-	m_cf.at(CF_TODNovEnergy, 1) = 0;
-	m_cf.at(CF_TODDecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD1JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD1FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD1MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD1AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD1MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD1JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD1JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD1AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD1SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD1OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD1NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD1DecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD2JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD2FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD2MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD2AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD2MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD2JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD2JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD2AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD2SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD2OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD2NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD2DecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD3JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD3FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD3MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD3AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD3MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD3JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD3JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD3AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD3SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD3OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD3NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD3DecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD4JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD4FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD4MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD4AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD4MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD4JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD4JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD4AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD4SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD4OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD4NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD4DecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD5JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD5FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD5MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD5AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD5MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD5JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD5JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD5AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD5SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD5OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD5NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD5DecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD6JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD6FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD6MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD6AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD6MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD6JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD6JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD6AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD6SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD6OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD6NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD6DecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD7JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD7FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD7MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD7AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD7MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD7JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD7JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD7AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD7SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD7OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD7NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD7DecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD8JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD8FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD8MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD8AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD8MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD8JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD8JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD8AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD8SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD8OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD8NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD8DecEnergy, 1) = 0;
-
-	m_cf.at(CF_TOD9JanEnergy, 1) = 0;
-	m_cf.at(CF_TOD9FebEnergy, 1) = 0;
-	m_cf.at(CF_TOD9MarEnergy, 1) = 0;
-	m_cf.at(CF_TOD9AprEnergy, 1) = 0;
-	m_cf.at(CF_TOD9MayEnergy, 1) = 0;
-	m_cf.at(CF_TOD9JunEnergy, 1) = 0;
-	m_cf.at(CF_TOD9JulEnergy, 1) = 0;
-	m_cf.at(CF_TOD9AugEnergy, 1) = 0;
-	m_cf.at(CF_TOD9SepEnergy, 1) = 0;
-	m_cf.at(CF_TOD9OctEnergy, 1) = 0;
-	m_cf.at(CF_TOD9NovEnergy, 1) = 0;
-	m_cf.at(CF_TOD9DecEnergy, 1) = 0;
-
-	int i = 0;
-	for (int m = 0; m<12; m++)
-	{
-		for (int d = 0; d<util::nday[m]; d++)
-		{
-			for (int h = 0; h<24 && i<8760 && m * 24 + h<288; h++)
-			{
-				switch (m)
-				{
-				case 0:
-					m_cf.at(CF_TODJanEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9JanEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 1:
-					m_cf.at(CF_TODFebEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9FebEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 2:
-					m_cf.at(CF_TODMarEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9MarEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 3:
-					m_cf.at(CF_TODAprEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9AprEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 4:
-					m_cf.at(CF_TODMayEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9MayEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 5:
-					m_cf.at(CF_TODJunEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9JunEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 6:
-					m_cf.at(CF_TODJulEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9JulEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 7:
-					m_cf.at(CF_TODAugEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9AugEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 8:
-					m_cf.at(CF_TODSepEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9SepEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 9:
-					m_cf.at(CF_TODOctEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9OctEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 10:
-					m_cf.at(CF_TODNovEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9NovEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				case 11:
-					m_cf.at(CF_TODDecEnergy, 1) += m_hourly_energy[i];
-					switch (m_periods[i])
-					{
-					case 1:
-						m_cf.at(CF_TOD1DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 2:
-						m_cf.at(CF_TOD2DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 3:
-						m_cf.at(CF_TOD3DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 4:
-						m_cf.at(CF_TOD4DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 5:
-						m_cf.at(CF_TOD5DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 6:
-						m_cf.at(CF_TOD6DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 7:
-						m_cf.at(CF_TOD7DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 8:
-						m_cf.at(CF_TOD8DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					case 9:
-						m_cf.at(CF_TOD9DecEnergy, 1) += m_hourly_energy[i];
-						break;
-					}
-					break;
-				}
-				i++;
-			}
-		}
-	}
-
-
-	double year1_TODJanEnergy = m_cf.at(CF_TODJanEnergy, 1);
-	double year1_TODFebEnergy = m_cf.at(CF_TODFebEnergy, 1);
-	double year1_TODMarEnergy = m_cf.at(CF_TODMarEnergy, 1);
-	double year1_TODAprEnergy = m_cf.at(CF_TODAprEnergy, 1);
-	double year1_TODMayEnergy = m_cf.at(CF_TODMayEnergy, 1);
-	double year1_TODJunEnergy = m_cf.at(CF_TODJunEnergy, 1);
-	double year1_TODJulEnergy = m_cf.at(CF_TODJulEnergy, 1);
-	double year1_TODAugEnergy = m_cf.at(CF_TODAugEnergy, 1);
-	double year1_TODSepEnergy = m_cf.at(CF_TODSepEnergy, 1);
-	double year1_TODOctEnergy = m_cf.at(CF_TODOctEnergy, 1);
-	double year1_TODNovEnergy = m_cf.at(CF_TODNovEnergy, 1);
-	double year1_TODDecEnergy = m_cf.at(CF_TODDecEnergy, 1);
-
-	double year1_TOD1JanEnergy = m_cf.at(CF_TOD1JanEnergy, 1);
-	double year1_TOD1FebEnergy = m_cf.at(CF_TOD1FebEnergy, 1);
-	double year1_TOD1MarEnergy = m_cf.at(CF_TOD1MarEnergy, 1);
-	double year1_TOD1AprEnergy = m_cf.at(CF_TOD1AprEnergy, 1);
-	double year1_TOD1MayEnergy = m_cf.at(CF_TOD1MayEnergy, 1);
-	double year1_TOD1JunEnergy = m_cf.at(CF_TOD1JunEnergy, 1);
-	double year1_TOD1JulEnergy = m_cf.at(CF_TOD1JulEnergy, 1);
-	double year1_TOD1AugEnergy = m_cf.at(CF_TOD1AugEnergy, 1);
-	double year1_TOD1SepEnergy = m_cf.at(CF_TOD1SepEnergy, 1);
-	double year1_TOD1OctEnergy = m_cf.at(CF_TOD1OctEnergy, 1);
-	double year1_TOD1NovEnergy = m_cf.at(CF_TOD1NovEnergy, 1);
-	double year1_TOD1DecEnergy = m_cf.at(CF_TOD1DecEnergy, 1);
-
-	double year1_TOD2JanEnergy = m_cf.at(CF_TOD2JanEnergy, 1);
-	double year1_TOD2FebEnergy = m_cf.at(CF_TOD2FebEnergy, 1);
-	double year1_TOD2MarEnergy = m_cf.at(CF_TOD2MarEnergy, 1);
-	double year1_TOD2AprEnergy = m_cf.at(CF_TOD2AprEnergy, 1);
-	double year1_TOD2MayEnergy = m_cf.at(CF_TOD2MayEnergy, 1);
-	double year1_TOD2JunEnergy = m_cf.at(CF_TOD2JunEnergy, 1);
-	double year1_TOD2JulEnergy = m_cf.at(CF_TOD2JulEnergy, 1);
-	double year1_TOD2AugEnergy = m_cf.at(CF_TOD2AugEnergy, 1);
-	double year1_TOD2SepEnergy = m_cf.at(CF_TOD2SepEnergy, 1);
-	double year1_TOD2OctEnergy = m_cf.at(CF_TOD2OctEnergy, 1);
-	double year1_TOD2NovEnergy = m_cf.at(CF_TOD2NovEnergy, 1);
-	double year1_TOD2DecEnergy = m_cf.at(CF_TOD2DecEnergy, 1);
-
-	double year1_TOD3JanEnergy = m_cf.at(CF_TOD3JanEnergy, 1);
-	double year1_TOD3FebEnergy = m_cf.at(CF_TOD3FebEnergy, 1);
-	double year1_TOD3MarEnergy = m_cf.at(CF_TOD3MarEnergy, 1);
-	double year1_TOD3AprEnergy = m_cf.at(CF_TOD3AprEnergy, 1);
-	double year1_TOD3MayEnergy = m_cf.at(CF_TOD3MayEnergy, 1);
-	double year1_TOD3JunEnergy = m_cf.at(CF_TOD3JunEnergy, 1);
-	double year1_TOD3JulEnergy = m_cf.at(CF_TOD3JulEnergy, 1);
-	double year1_TOD3AugEnergy = m_cf.at(CF_TOD3AugEnergy, 1);
-	double year1_TOD3SepEnergy = m_cf.at(CF_TOD3SepEnergy, 1);
-	double year1_TOD3OctEnergy = m_cf.at(CF_TOD3OctEnergy, 1);
-	double year1_TOD3NovEnergy = m_cf.at(CF_TOD3NovEnergy, 1);
-	double year1_TOD3DecEnergy = m_cf.at(CF_TOD3DecEnergy, 1);
-
-	double year1_TOD4JanEnergy = m_cf.at(CF_TOD4JanEnergy, 1);
-	double year1_TOD4FebEnergy = m_cf.at(CF_TOD4FebEnergy, 1);
-	double year1_TOD4MarEnergy = m_cf.at(CF_TOD4MarEnergy, 1);
-	double year1_TOD4AprEnergy = m_cf.at(CF_TOD4AprEnergy, 1);
-	double year1_TOD4MayEnergy = m_cf.at(CF_TOD4MayEnergy, 1);
-	double year1_TOD4JunEnergy = m_cf.at(CF_TOD4JunEnergy, 1);
-	double year1_TOD4JulEnergy = m_cf.at(CF_TOD4JulEnergy, 1);
-	double year1_TOD4AugEnergy = m_cf.at(CF_TOD4AugEnergy, 1);
-	double year1_TOD4SepEnergy = m_cf.at(CF_TOD4SepEnergy, 1);
-	double year1_TOD4OctEnergy = m_cf.at(CF_TOD4OctEnergy, 1);
-	double year1_TOD4NovEnergy = m_cf.at(CF_TOD4NovEnergy, 1);
-	double year1_TOD4DecEnergy = m_cf.at(CF_TOD4DecEnergy, 1);
-
-	double year1_TOD5JanEnergy = m_cf.at(CF_TOD5JanEnergy, 1);
-	double year1_TOD5FebEnergy = m_cf.at(CF_TOD5FebEnergy, 1);
-	double year1_TOD5MarEnergy = m_cf.at(CF_TOD5MarEnergy, 1);
-	double year1_TOD5AprEnergy = m_cf.at(CF_TOD5AprEnergy, 1);
-	double year1_TOD5MayEnergy = m_cf.at(CF_TOD5MayEnergy, 1);
-	double year1_TOD5JunEnergy = m_cf.at(CF_TOD5JunEnergy, 1);
-	double year1_TOD5JulEnergy = m_cf.at(CF_TOD5JulEnergy, 1);
-	double year1_TOD5AugEnergy = m_cf.at(CF_TOD5AugEnergy, 1);
-	double year1_TOD5SepEnergy = m_cf.at(CF_TOD5SepEnergy, 1);
-	double year1_TOD5OctEnergy = m_cf.at(CF_TOD5OctEnergy, 1);
-	double year1_TOD5NovEnergy = m_cf.at(CF_TOD5NovEnergy, 1);
-	double year1_TOD5DecEnergy = m_cf.at(CF_TOD5DecEnergy, 1);
-
-	double year1_TOD6JanEnergy = m_cf.at(CF_TOD6JanEnergy, 1);
-	double year1_TOD6FebEnergy = m_cf.at(CF_TOD6FebEnergy, 1);
-	double year1_TOD6MarEnergy = m_cf.at(CF_TOD6MarEnergy, 1);
-	double year1_TOD6AprEnergy = m_cf.at(CF_TOD6AprEnergy, 1);
-	double year1_TOD6MayEnergy = m_cf.at(CF_TOD6MayEnergy, 1);
-	double year1_TOD6JunEnergy = m_cf.at(CF_TOD6JunEnergy, 1);
-	double year1_TOD6JulEnergy = m_cf.at(CF_TOD6JulEnergy, 1);
-	double year1_TOD6AugEnergy = m_cf.at(CF_TOD6AugEnergy, 1);
-	double year1_TOD6SepEnergy = m_cf.at(CF_TOD6SepEnergy, 1);
-	double year1_TOD6OctEnergy = m_cf.at(CF_TOD6OctEnergy, 1);
-	double year1_TOD6NovEnergy = m_cf.at(CF_TOD6NovEnergy, 1);
-	double year1_TOD6DecEnergy = m_cf.at(CF_TOD6DecEnergy, 1);
-
-	double year1_TOD7JanEnergy = m_cf.at(CF_TOD7JanEnergy, 1);
-	double year1_TOD7FebEnergy = m_cf.at(CF_TOD7FebEnergy, 1);
-	double year1_TOD7MarEnergy = m_cf.at(CF_TOD7MarEnergy, 1);
-	double year1_TOD7AprEnergy = m_cf.at(CF_TOD7AprEnergy, 1);
-	double year1_TOD7MayEnergy = m_cf.at(CF_TOD7MayEnergy, 1);
-	double year1_TOD7JunEnergy = m_cf.at(CF_TOD7JunEnergy, 1);
-	double year1_TOD7JulEnergy = m_cf.at(CF_TOD7JulEnergy, 1);
-	double year1_TOD7AugEnergy = m_cf.at(CF_TOD7AugEnergy, 1);
-	double year1_TOD7SepEnergy = m_cf.at(CF_TOD7SepEnergy, 1);
-	double year1_TOD7OctEnergy = m_cf.at(CF_TOD7OctEnergy, 1);
-	double year1_TOD7NovEnergy = m_cf.at(CF_TOD7NovEnergy, 1);
-	double year1_TOD7DecEnergy = m_cf.at(CF_TOD7DecEnergy, 1);
-
-	double year1_TOD8JanEnergy = m_cf.at(CF_TOD8JanEnergy, 1);
-	double year1_TOD8FebEnergy = m_cf.at(CF_TOD8FebEnergy, 1);
-	double year1_TOD8MarEnergy = m_cf.at(CF_TOD8MarEnergy, 1);
-	double year1_TOD8AprEnergy = m_cf.at(CF_TOD8AprEnergy, 1);
-	double year1_TOD8MayEnergy = m_cf.at(CF_TOD8MayEnergy, 1);
-	double year1_TOD8JunEnergy = m_cf.at(CF_TOD8JunEnergy, 1);
-	double year1_TOD8JulEnergy = m_cf.at(CF_TOD8JulEnergy, 1);
-	double year1_TOD8AugEnergy = m_cf.at(CF_TOD8AugEnergy, 1);
-	double year1_TOD8SepEnergy = m_cf.at(CF_TOD8SepEnergy, 1);
-	double year1_TOD8OctEnergy = m_cf.at(CF_TOD8OctEnergy, 1);
-	double year1_TOD8NovEnergy = m_cf.at(CF_TOD8NovEnergy, 1);
-	double year1_TOD8DecEnergy = m_cf.at(CF_TOD8DecEnergy, 1);
-
-	double year1_TOD9JanEnergy = m_cf.at(CF_TOD9JanEnergy, 1);
-	double year1_TOD9FebEnergy = m_cf.at(CF_TOD9FebEnergy, 1);
-	double year1_TOD9MarEnergy = m_cf.at(CF_TOD9MarEnergy, 1);
-	double year1_TOD9AprEnergy = m_cf.at(CF_TOD9AprEnergy, 1);
-	double year1_TOD9MayEnergy = m_cf.at(CF_TOD9MayEnergy, 1);
-	double year1_TOD9JunEnergy = m_cf.at(CF_TOD9JunEnergy, 1);
-	double year1_TOD9JulEnergy = m_cf.at(CF_TOD9JulEnergy, 1);
-	double year1_TOD9AugEnergy = m_cf.at(CF_TOD9AugEnergy, 1);
-	double year1_TOD9SepEnergy = m_cf.at(CF_TOD9SepEnergy, 1);
-	double year1_TOD9OctEnergy = m_cf.at(CF_TOD9OctEnergy, 1);
-	double year1_TOD9NovEnergy = m_cf.at(CF_TOD9NovEnergy, 1);
-	double year1_TOD9DecEnergy = m_cf.at(CF_TOD9DecEnergy, 1);
-
-	for (int y = 0; y <= m_nyears; y++)
-	{
-		// compute energy dispatched
-		m_cf.at(CF_TODJanEnergy, y) = year1_TODJanEnergy * m_degradation[y];
-		m_cf.at(CF_TODFebEnergy, y) = year1_TODFebEnergy * m_degradation[y];
-		m_cf.at(CF_TODMarEnergy, y) = year1_TODMarEnergy * m_degradation[y];
-		m_cf.at(CF_TODAprEnergy, y) = year1_TODAprEnergy * m_degradation[y];
-		m_cf.at(CF_TODMayEnergy, y) = year1_TODMayEnergy * m_degradation[y];
-		m_cf.at(CF_TODJunEnergy, y) = year1_TODJunEnergy * m_degradation[y];
-		m_cf.at(CF_TODJulEnergy, y) = year1_TODJulEnergy * m_degradation[y];
-		m_cf.at(CF_TODAugEnergy, y) = year1_TODAugEnergy * m_degradation[y];
-		m_cf.at(CF_TODSepEnergy, y) = year1_TODSepEnergy * m_degradation[y];
-		m_cf.at(CF_TODOctEnergy, y) = year1_TODOctEnergy * m_degradation[y];
-		m_cf.at(CF_TODNovEnergy, y) = year1_TODNovEnergy * m_degradation[y];
-		m_cf.at(CF_TODDecEnergy, y) = year1_TODDecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD1JanEnergy, y) = year1_TOD1JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1FebEnergy, y) = year1_TOD1FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1MarEnergy, y) = year1_TOD1MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1AprEnergy, y) = year1_TOD1AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1MayEnergy, y) = year1_TOD1MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1JunEnergy, y) = year1_TOD1JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1JulEnergy, y) = year1_TOD1JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1AugEnergy, y) = year1_TOD1AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1SepEnergy, y) = year1_TOD1SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1OctEnergy, y) = year1_TOD1OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1NovEnergy, y) = year1_TOD1NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD1DecEnergy, y) = year1_TOD1DecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD2JanEnergy, y) = year1_TOD2JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2FebEnergy, y) = year1_TOD2FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2MarEnergy, y) = year1_TOD2MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2AprEnergy, y) = year1_TOD2AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2MayEnergy, y) = year1_TOD2MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2JunEnergy, y) = year1_TOD2JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2JulEnergy, y) = year1_TOD2JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2AugEnergy, y) = year1_TOD2AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2SepEnergy, y) = year1_TOD2SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2OctEnergy, y) = year1_TOD2OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2NovEnergy, y) = year1_TOD2NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD2DecEnergy, y) = year1_TOD2DecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD3JanEnergy, y) = year1_TOD3JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3FebEnergy, y) = year1_TOD3FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3MarEnergy, y) = year1_TOD3MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3AprEnergy, y) = year1_TOD3AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3MayEnergy, y) = year1_TOD3MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3JunEnergy, y) = year1_TOD3JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3JulEnergy, y) = year1_TOD3JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3AugEnergy, y) = year1_TOD3AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3SepEnergy, y) = year1_TOD3SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3OctEnergy, y) = year1_TOD3OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3NovEnergy, y) = year1_TOD3NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD3DecEnergy, y) = year1_TOD3DecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD4JanEnergy, y) = year1_TOD4JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4FebEnergy, y) = year1_TOD4FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4MarEnergy, y) = year1_TOD4MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4AprEnergy, y) = year1_TOD4AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4MayEnergy, y) = year1_TOD4MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4JunEnergy, y) = year1_TOD4JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4JulEnergy, y) = year1_TOD4JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4AugEnergy, y) = year1_TOD4AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4SepEnergy, y) = year1_TOD4SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4OctEnergy, y) = year1_TOD4OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4NovEnergy, y) = year1_TOD4NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD4DecEnergy, y) = year1_TOD4DecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD5JanEnergy, y) = year1_TOD5JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5FebEnergy, y) = year1_TOD5FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5MarEnergy, y) = year1_TOD5MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5AprEnergy, y) = year1_TOD5AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5MayEnergy, y) = year1_TOD5MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5JunEnergy, y) = year1_TOD5JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5JulEnergy, y) = year1_TOD5JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5AugEnergy, y) = year1_TOD5AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5SepEnergy, y) = year1_TOD5SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5OctEnergy, y) = year1_TOD5OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5NovEnergy, y) = year1_TOD5NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD5DecEnergy, y) = year1_TOD5DecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD6JanEnergy, y) = year1_TOD6JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6FebEnergy, y) = year1_TOD6FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6MarEnergy, y) = year1_TOD6MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6AprEnergy, y) = year1_TOD6AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6MayEnergy, y) = year1_TOD6MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6JunEnergy, y) = year1_TOD6JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6JulEnergy, y) = year1_TOD6JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6AugEnergy, y) = year1_TOD6AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6SepEnergy, y) = year1_TOD6SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6OctEnergy, y) = year1_TOD6OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6NovEnergy, y) = year1_TOD6NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD6DecEnergy, y) = year1_TOD6DecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD7JanEnergy, y) = year1_TOD7JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7FebEnergy, y) = year1_TOD7FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7MarEnergy, y) = year1_TOD7MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7AprEnergy, y) = year1_TOD7AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7MayEnergy, y) = year1_TOD7MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7JunEnergy, y) = year1_TOD7JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7JulEnergy, y) = year1_TOD7JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7AugEnergy, y) = year1_TOD7AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7SepEnergy, y) = year1_TOD7SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7OctEnergy, y) = year1_TOD7OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7NovEnergy, y) = year1_TOD7NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD7DecEnergy, y) = year1_TOD7DecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD8JanEnergy, y) = year1_TOD8JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8FebEnergy, y) = year1_TOD8FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8MarEnergy, y) = year1_TOD8MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8AprEnergy, y) = year1_TOD8AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8MayEnergy, y) = year1_TOD8MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8JunEnergy, y) = year1_TOD8JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8JulEnergy, y) = year1_TOD8JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8AugEnergy, y) = year1_TOD8AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8SepEnergy, y) = year1_TOD8SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8OctEnergy, y) = year1_TOD8OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8NovEnergy, y) = year1_TOD8NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD8DecEnergy, y) = year1_TOD8DecEnergy * m_degradation[y];
-
-		m_cf.at(CF_TOD9JanEnergy, y) = year1_TOD9JanEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9FebEnergy, y) = year1_TOD9FebEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9MarEnergy, y) = year1_TOD9MarEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9AprEnergy, y) = year1_TOD9AprEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9MayEnergy, y) = year1_TOD9MayEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9JunEnergy, y) = year1_TOD9JunEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9JulEnergy, y) = year1_TOD9JulEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9AugEnergy, y) = year1_TOD9AugEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9SepEnergy, y) = year1_TOD9SepEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9OctEnergy, y) = year1_TOD9OctEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9NovEnergy, y) = year1_TOD9NovEnergy * m_degradation[y];
-		m_cf.at(CF_TOD9DecEnergy, y) = year1_TOD9DecEnergy * m_degradation[y];
-	}
 	return true;
 }
 
-
 bool dispatch_calculations::compute_dispatch_output_ts()
 {
 	//Calculate energy dispatched in each month
-
 	size_t nrec_gen_per_year = m_ngen;
 //	if (m_cm->as_integer("system_use_lifetime_output") == 1)
 //		nrec_gen_per_year = m_ngen / m_nyears;
@@ -2243,154 +1468,12 @@ bool dispatch_calculations::compute_dispatch_output_ts()
 	}
 	ssc_number_t ts_hour_gen = 1.0f / step_per_hour_gen;
 
+	dispatch_bin_month_ts(m_cf, 1, m_gen, m_multipliers, nrec_gen_per_year, step_per_hour_gen, ts_hour_gen);
 
-	m_cf.at(CF_TODJanEnergy, 1) = 0;
-	m_cf.at(CF_TODFebEnergy, 1) = 0;
-	m_cf.at(CF_TODMarEnergy, 1) = 0;
-	m_cf.at(CF_TODAprEnergy, 1) = 0;
-	m_cf.at(CF_TODMayEnergy, 1) = 0;
-	m_cf.at(CF_TODJunEnergy, 1) = 0;
-	m_cf.at(CF_TODJulEnergy, 1) = 0;
-	m_cf.at(CF_TODAugEnergy, 1) = 0;
-	m_cf.at(CF_TODSepEnergy, 1) = 0;
-	m_cf.at(CF_TODOctEnergy, 1) = 0;
-	m_cf.at(CF_TODNovEnergy, 1) = 0;
-	m_cf.at(CF_TODDecEnergy, 1) = 0;
-
-	m_cf.at(CF_TODJanRevenue, 1) = 0;
-	m_cf.at(CF_TODFebRevenue, 1) = 0;
-	m_cf.at(CF_TODMarRevenue, 1) = 0;
-	m_cf.at(CF_TODAprRevenue, 1) = 0;
-	m_cf.at(CF_TODMayRevenue, 1) = 0;
-	m_cf.at(CF_TODJunRevenue, 1) = 0;
-	m_cf.at(CF_TODJulRevenue, 1) = 0;
-	m_cf.at(CF_TODAugRevenue, 1) = 0;
-	m_cf.at(CF_TODSepRevenue, 1) = 0;
-	m_cf.at(CF_TODOctRevenue, 1) = 0;
-	m_cf.at(CF_TODNovRevenue, 1) = 0;
-	m_cf.at(CF_TODDecRevenue, 1) = 0;
-
-	int i = 0;
-	for (int m = 0; m<12; m++)
-	{
-		for (int d = 0; d<util::nday[m]; d++)
-		{
-			for (int h = 0; h<24 && i<(int)nrec_gen_per_year; h++)
-			{
-				for (int k = 0; k < (int)step_per_hour_gen; k++)
-				{
-					switch (m)
-					{
-					case 0:
-						m_cf.at(CF_TODJanEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODJanRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 1:
-						m_cf.at(CF_TODFebEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODFebRevenue, 1) += m_gen[i] * ts_hour_gen* m_multipliers[i];
-						break;
-					case 2:
-						m_cf.at(CF_TODMarEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODMarRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 3:
-						m_cf.at(CF_TODAprEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODAprRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 4:
-						m_cf.at(CF_TODMayEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODMayRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 5:
-						m_cf.at(CF_TODJunEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODJunRevenue, 1) += m_gen[i] * ts_hour_gen* m_multipliers[i];
-						break;
-					case 6:
-						m_cf.at(CF_TODJulEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODJulRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 7:
-						m_cf.at(CF_TODAugEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODAugRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 8:
-						m_cf.at(CF_TODSepEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODSepRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 9:
-						m_cf.at(CF_TODOctEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODOctRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 10:
-						m_cf.at(CF_TODNovEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODNovRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					case 11:
-						m_cf.at(CF_TODDecEnergy, 1) += m_gen[i] * ts_hour_gen;
-						m_cf.at(CF_TODDecRevenue, 1) += m_gen[i] * ts_hour_gen * m_multipliers[i];
-						break;
-					}
-					i++;
-				}
-			}
-		}
-	}
+	// energy and energy value
+	dispatch_year1_by_degradation(m_cf, CF_TODJanEnergy, 12, m_degradation, m_nyears);
+	dispatch_year1_by_degradation(m_cf, CF_TODJanRevenue, 12, m_degradation, m_nyears);
 
-	double year1_TODJanEnergy = m_cf.at(CF_TODJanEnergy, 1);
-	double year1_TODFebEnergy = m_cf.at(CF_TODFebEnergy, 1);
-	double year1_TODMarEnergy = m_cf.at(CF_TODMarEnergy, 1);
-	double year1_TODAprEnergy = m_cf.at(CF_TODAprEnergy, 1);
-	double year1_TODMayEnergy = m_cf.at(CF_TODMayEnergy, 1);
-	double year1_TODJunEnergy = m_cf.at(CF_TODJunEnergy, 1);
-	double year1_TODJulEnergy = m_cf.at(CF_TODJulEnergy, 1);
-	double year1_TODAugEnergy = m_cf.at(CF_TODAugEnergy, 1);
-	double year1_TODSepEnergy = m_cf.at(CF_TODSepEnergy, 1);
-	double year1_TODOctEnergy = m_cf.at(CF_TODOctEnergy, 1);
-	double year1_TODNovEnergy = m_cf.at(CF_TODNovEnergy, 1);
-	double year1_TODDecEnergy = m_cf.at(CF_TODDecEnergy, 1);
-
-	double year1_TODJanRevenue = m_cf.at(CF_TODJanRevenue, 1);
-	double year1_TODFebRevenue = m_cf.at(CF_TODFebRevenue, 1);
-	double year1_TODMarRevenue = m_cf.at(CF_TODMarRevenue, 1);
-	double year1_TODAprRevenue = m_cf.at(CF_TODAprRevenue, 1);
-	double year1_TODMayRevenue = m_cf.at(CF_TODMayRevenue, 1);
-	double year1_TODJunRevenue = m_cf.at(CF_TODJunRevenue, 1);
-	double year1_TODJulRevenue = m_cf.at(CF_TODJulRevenue, 1);
-	double year1_TODAugRevenue = m_cf.at(CF_TODAugRevenue, 1);
-	double year1_TODSepRevenue = m_cf.at(CF_TODSepRevenue, 1);
-	double year1_TODOctRevenue = m_cf.at(CF_TODOctRevenue, 1);
-	double year1_TODNovRevenue = m_cf.at(CF_TODNovRevenue, 1);
-	double year1_TODDecRevenue = m_cf.at(CF_TODDecRevenue, 1);
-
-	for (int y = 0; y <= m_nyears; y++)
-	{
-		// compute energy dispatched
-		m_cf.at(CF_TODJanEnergy, y) = year1_TODJanEnergy * m_degradation[y];
-		m_cf.at(CF_TODFebEnergy, y) = year1_TODFebEnergy * m_degradation[y];
-		m_cf.at(CF_TODMarEnergy, y) = year1_TODMarEnergy * m_degradation[y];
-		m_cf.at(CF_TODAprEnergy, y) = year1_TODAprEnergy * m_degradation[y];
-		m_cf.at(CF_TODMayEnergy, y) = year1_TODMayEnergy * m_degradation[y];
-		m_cf.at(CF_TODJunEnergy, y) = year1_TODJunEnergy * m_degradation[y];
-		m_cf.at(CF_TODJulEnergy, y) = year1_TODJulEnergy * m_degradation[y];
-		m_cf.at(CF_TODAugEnergy, y) = year1_TODAugEnergy * m_degradation[y];
-		m_cf.at(CF_TODSepEnergy, y) = year1_TODSepEnergy * m_degradation[y];
-		m_cf.at(CF_TODOctEnergy, y) = year1_TODOctEnergy * m_degradation[y];
-		m_cf.at(CF_TODNovEnergy, y) = year1_TODNovEnergy * m_degradation[y];
-		m_cf.at(CF_TODDecEnergy, y) = year1_TODDecEnergy * m_degradation[y];
-		// compute energy value
-		m_cf.at(CF_TODJanRevenue, y) = year1_TODJanRevenue * m_degradation[y];
-		m_cf.at(CF_TODFebRevenue, y) = year1_TODFebRevenue * m_degradation[y];
-		m_cf.at(CF_TODMarRevenue, y) = year1_TODMarRevenue * m_degradation[y];
-		m_cf.at(CF_TODAprRevenue, y) = year1_TODAprRevenue * m_degradation[y];
-		m_cf.at(CF_TODMayRevenue, y) = year1_TODMayRevenue * m_degradation[y];
-		m_cf.at(CF_TODJunRevenue, y) = year1_TODJunRevenue * m_degradation[y];
-		m_cf.at(CF_TODJulRevenue, y) = year1_TODJulRevenue * m_degradation[y];
-		m_cf.at(CF_TODAugRevenue, y) = year1_TODAugRevenue * m_degradation[y];
-		m_cf.at(CF_TODSepRevenue, y) = year1_TODSepRevenue * m_degradation[y];
-		m_cf.at(CF_TODOctRevenue, y) = year1_TODOctRevenue * m_degradation[y];
-		m_cf.at(CF_TODNovRevenue, y) = year1_TODNovRevenue * m_degradation[y];
-		m_cf.at(CF_TODDecRevenue, y) = year1_TODDecRevenue * m_degradation[y];
-	}
 	return true;
 }
 
@@ -2417,110 +1500,15 @@ bool dispatch_calculations::compute_lifetime_dispatch_output_ts()
 	ssc_number_t ts_hour_gen = 1.0f / step_per_hour_gen;
 
 	for (int iyear = 0; iyear < m_nyears; iyear++)
-	{
-		m_cf.at(CF_TODJanEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODFebEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODMarEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODAprEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODMayEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODJunEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODJulEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODAugEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODSepEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODOctEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODNovEnergy, iyear + 1) = 0;
-		m_cf.at(CF_TODDecEnergy, iyear + 1) = 0;
-
-		m_cf.at(CF_TODJanRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODFebRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODMarRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODAprRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODMayRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODJunRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODJulRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODAugRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODSepRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODOctRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODNovRevenue, iyear + 1) = 0;
-		m_cf.at(CF_TODDecRevenue, iyear + 1) = 0;
-
-		int i = 0; // iterator for current year
-
-		for (int m = 0; m < 12; m++)
-		{
-			for (int d = 0; d < util::nday[m]; d++)
-			{
-				for (int h = 0; h < 24 && i < (int)nrec_gen_per_year; h++)
-				{
-					for (int k = 0; k < (int)step_per_hour_gen; k++)
-					{
-						switch (m)
-						{
-						case 0:
-							m_cf.at(CF_TODJanEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODJanRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 1:
-							m_cf.at(CF_TODFebEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODFebRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen* m_multipliers[i];
-							break;
-						case 2:
-							m_cf.at(CF_TODMarEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODMarRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 3:
-							m_cf.at(CF_TODAprEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODAprRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 4:
-							m_cf.at(CF_TODMayEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODMayRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 5:
-							m_cf.at(CF_TODJunEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODJunRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen* m_multipliers[i];
-							break;
-						case 6:
-							m_cf.at(CF_TODJulEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODJulRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 7:
-							m_cf.at(CF_TODAugEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODAugRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 8:
-							m_cf.at(CF_TODSepEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODSepRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 9:
-							m_cf.at(CF_TODOctEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODOctRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 10:
-							m_cf.at(CF_TODNovEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODNovRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						case 11:
-							m_cf.at(CF_TODDecEnergy, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen;
-							m_cf.at(CF_TODDecRevenue, iyear + 1) += m_gen[i + (iyear * nrec_gen_per_year)] * ts_hour_gen * m_multipliers[i];
-							break;
-						}
-						i++;
-					}  // steps per hour
-				} // hours per day
-			} // days per month
-		} // months per year
-	} // years per analysis period
+		dispatch_bin_month_ts(m_cf, iyear + 1, m_gen + iyear * nrec_gen_per_year, m_multipliers, nrec_gen_per_year, step_per_hour_gen, ts_hour_gen);
+
 	return true;
 }
 
-
 bool dispatch_calculations::compute_lifetime_dispatch_output()
 {
 	//Calculate energy dispatched in each dispatch period 
 
-
-	int h;
 	size_t count=m_hourly_energy.size();
 
 	// hourly energy includes all curtailment, availability
@@ -2532,59 +1520,20 @@ bool dispatch_calculations::compute_lifetime_dispatch_output()
 		return false;
 	}
 
-	//// hourly dispatch
-	//dispatch_calculations hourly_dispatch(this);
-	//if (!hourly_dispatch.setup())
-	//	throw exec_error("ippppa", "failed to setup dispatch periods: " + hourly_dispatch.error());
-
 	for (int y = 1; y <= m_nyears; y++)
 	{
-		m_cf.at(CF_TOD1Energy, y) = 0;
-		m_cf.at(CF_TOD2Energy, y) = 0;
-		m_cf.at(CF_TOD3Energy, y) = 0;
-		m_cf.at(CF_TOD4Energy, y) = 0;
-		m_cf.at(CF_TOD5Energy, y) = 0;
-		m_cf.at(CF_TOD6Energy, y) = 0;
-		m_cf.at(CF_TOD7Energy, y) = 0;
-		m_cf.at(CF_TOD8Energy, y) = 0;
-		m_cf.at(CF_TOD9Energy, y) = 0;
-
-		for (h = 0; h<8760; h++)
+		for (int p = 0; p < 9; p++)
+			m_cf.at(CF_TOD1Energy + p, y) = 0;
+
+		const double *hourly_energy = &m_hourly_energy[(y - 1) * 8760];
+		for (int h = 0; h < 8760; h++)
 		{
-			switch (m_periods[h])
-			{
-			case 1:
-				m_cf.at(CF_TOD1Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			case 2:
-				m_cf.at(CF_TOD2Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			case 3:
-				m_cf.at(CF_TOD3Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			case 4:
-				m_cf.at(CF_TOD4Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			case 5:
-				m_cf.at(CF_TOD5Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			case 6:
-				m_cf.at(CF_TOD6Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			case 7:
-				m_cf.at(CF_TOD7Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			case 8:
-				m_cf.at(CF_TOD8Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			case 9:
-				m_cf.at(CF_TOD9Energy, y) += m_hourly_energy[(y - 1) * 8760 + h];
-				break;
-			}
+			int period = m_periods[h];
+			if (period >= 1 && period <= 9)
+				m_cf.at(CF_TOD1Energy + period - 1, y) += hourly_energy[h];
 		}
 	}
 
-
 	return true;
 }
 
@@ -2603,558 +1552,75 @@ bool dispatch_calculations::process_lifetime_dispatch_output()
 		return false;
 	}
 
-	//// hourly dispatch
-	//dispatch_calculations hourly_dispatch(this);
-	//if (!hourly_dispatch.setup())
-	//	throw exec_error("ippppa", "failed to setup dispatch periods: " + hourly_dispatch.error());
+	for (int y = 1; y <= m_nyears; y++)
+		dispatch_bin_month_period(m_cf, y, &m_hourly_energy[(y - 1) * 8760], m_periods);
 
+	return true;
+}
 
-	for (int y = 1; y <= m_nyears; y++)
+ppa_solver::ppa_solver(double ppa_min, double ppa_max, double coarse_interval)
+	: m_x0(ppa_min), m_x1(ppa_max), m_f0(0), m_f1(0), m_x_last(0), m_f_last(0),
+	m_coarse_interval(coarse_interval), m_npass(0), m_side(0), m_bracketed(false)
+{
+}
+
+double ppa_solver::next(double ppa, double npv_at_target)
+{
+	double f = npv_at_target;
+	bool too_large = (f >= 0.0);
+	m_npass++;
+
+	if (!m_bracketed)
 	{
-		m_cf.at(CF_TODJanEnergy, y) = 0;
-		m_cf.at(CF_TODFebEnergy, y) = 0;
-		m_cf.at(CF_TODMarEnergy, y) = 0;
-		m_cf.at(CF_TODAprEnergy, y) = 0;
-		m_cf.at(CF_TODMayEnergy, y) = 0;
-		m_cf.at(CF_TODJunEnergy, y) = 0;
-		m_cf.at(CF_TODJulEnergy, y) = 0;
-		m_cf.at(CF_TODAugEnergy, y) = 0;
-		m_cf.at(CF_TODSepEnergy, y) = 0;
-		m_cf.at(CF_TODOctEnergy, y) = 0;
-		m_cf.at(CF_TODNovEnergy, y) = 0;
-		m_cf.at(CF_TODDecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD1JanEnergy, y) = 0;
-		m_cf.at(CF_TOD1FebEnergy, y) = 0;
-		m_cf.at(CF_TOD1MarEnergy, y) = 0;
-		m_cf.at(CF_TOD1AprEnergy, y) = 0;
-		m_cf.at(CF_TOD1MayEnergy, y) = 0;
-		m_cf.at(CF_TOD1JunEnergy, y) = 0;
-		m_cf.at(CF_TOD1JulEnergy, y) = 0;
-		m_cf.at(CF_TOD1AugEnergy, y) = 0;
-		m_cf.at(CF_TOD1SepEnergy, y) = 0;
-		m_cf.at(CF_TOD1OctEnergy, y) = 0;
-		m_cf.at(CF_TOD1NovEnergy, y) = 0;
-		m_cf.at(CF_TOD1DecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD2JanEnergy, y) = 0;
-		m_cf.at(CF_TOD2FebEnergy, y) = 0;
-		m_cf.at(CF_TOD2MarEnergy, y) = 0;
-		m_cf.at(CF_TOD2AprEnergy, y) = 0;
-		m_cf.at(CF_TOD2MayEnergy, y) = 0;
-		m_cf.at(CF_TOD2JunEnergy, y) = 0;
-		m_cf.at(CF_TOD2JulEnergy, y) = 0;
-		m_cf.at(CF_TOD2AugEnergy, y) = 0;
-		m_cf.at(CF_TOD2SepEnergy, y) = 0;
-		m_cf.at(CF_TOD2OctEnergy, y) = 0;
-		m_cf.at(CF_TOD2NovEnergy, y) = 0;
-		m_cf.at(CF_TOD2DecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD3JanEnergy, y) = 0;
-		m_cf.at(CF_TOD3FebEnergy, y) = 0;
-		m_cf.at(CF_TOD3MarEnergy, y) = 0;
-		m_cf.at(CF_TOD3AprEnergy, y) = 0;
-		m_cf.at(CF_TOD3MayEnergy, y) = 0;
-		m_cf.at(CF_TOD3JunEnergy, y) = 0;
-		m_cf.at(CF_TOD3JulEnergy, y) = 0;
-		m_cf.at(CF_TOD3AugEnergy, y) = 0;
-		m_cf.at(CF_TOD3SepEnergy, y) = 0;
-		m_cf.at(CF_TOD3OctEnergy, y) = 0;
-		m_cf.at(CF_TOD3NovEnergy, y) = 0;
-		m_cf.at(CF_TOD3DecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD4JanEnergy, y) = 0;
-		m_cf.at(CF_TOD4FebEnergy, y) = 0;
-		m_cf.at(CF_TOD4MarEnergy, y) = 0;
-		m_cf.at(CF_TOD4AprEnergy, y) = 0;
-		m_cf.at(CF_TOD4MayEnergy, y) = 0;
-		m_cf.at(CF_TOD4JunEnergy, y) = 0;
-		m_cf.at(CF_TOD4JulEnergy, y) = 0;
-		m_cf.at(CF_TOD4AugEnergy, y) = 0;
-		m_cf.at(CF_TOD4SepEnergy, y) = 0;
-		m_cf.at(CF_TOD4OctEnergy, y) = 0;
-		m_cf.at(CF_TOD4NovEnergy, y) = 0;
-		m_cf.at(CF_TOD4DecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD5JanEnergy, y) = 0;
-		m_cf.at(CF_TOD5FebEnergy, y) = 0;
-		m_cf.at(CF_TOD5MarEnergy, y) = 0;
-		m_cf.at(CF_TOD5AprEnergy, y) = 0;
-		m_cf.at(CF_TOD5MayEnergy, y) = 0;
-		m_cf.at(CF_TOD5JunEnergy, y) = 0;
-		m_cf.at(CF_TOD5JulEnergy, y) = 0;
-		m_cf.at(CF_TOD5AugEnergy, y) = 0;
-		m_cf.at(CF_TOD5SepEnergy, y) = 0;
-		m_cf.at(CF_TOD5OctEnergy, y) = 0;
-		m_cf.at(CF_TOD5NovEnergy, y) = 0;
-		m_cf.at(CF_TOD5DecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD6JanEnergy, y) = 0;
-		m_cf.at(CF_TOD6FebEnergy, y) = 0;
-		m_cf.at(CF_TOD6MarEnergy, y) = 0;
-		m_cf.at(CF_TOD6AprEnergy, y) = 0;
-		m_cf.at(CF_TOD6MayEnergy, y) = 0;
-		m_cf.at(CF_TOD6JunEnergy, y) = 0;
-		m_cf.at(CF_TOD6JulEnergy, y) = 0;
-		m_cf.at(CF_TOD6AugEnergy, y) = 0;
-		m_cf.at(CF_TOD6SepEnergy, y) = 0;
-		m_cf.at(CF_TOD6OctEnergy, y) = 0;
-		m_cf.at(CF_TOD6NovEnergy, y) = 0;
-		m_cf.at(CF_TOD6DecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD7JanEnergy, y) = 0;
-		m_cf.at(CF_TOD7FebEnergy, y) = 0;
-		m_cf.at(CF_TOD7MarEnergy, y) = 0;
-		m_cf.at(CF_TOD7AprEnergy, y) = 0;
-		m_cf.at(CF_TOD7MayEnergy, y) = 0;
-		m_cf.at(CF_TOD7JunEnergy, y) = 0;
-		m_cf.at(CF_TOD7JulEnergy, y) = 0;
-		m_cf.at(CF_TOD7AugEnergy, y) = 0;
-		m_cf.at(CF_TOD7SepEnergy, y) = 0;
-		m_cf.at(CF_TOD7OctEnergy, y) = 0;
-		m_cf.at(CF_TOD7NovEnergy, y) = 0;
-		m_cf.at(CF_TOD7DecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD8JanEnergy, y) = 0;
-		m_cf.at(CF_TOD8FebEnergy, y) = 0;
-		m_cf.at(CF_TOD8MarEnergy, y) = 0;
-		m_cf.at(CF_TOD8AprEnergy, y) = 0;
-		m_cf.at(CF_TOD8MayEnergy, y) = 0;
-		m_cf.at(CF_TOD8JunEnergy, y) = 0;
-		m_cf.at(CF_TOD8JulEnergy, y) = 0;
-		m_cf.at(CF_TOD8AugEnergy, y) = 0;
-		m_cf.at(CF_TOD8SepEnergy, y) = 0;
-		m_cf.at(CF_TOD8OctEnergy, y) = 0;
-		m_cf.at(CF_TOD8NovEnergy, y) = 0;
-		m_cf.at(CF_TOD8DecEnergy, y) = 0;
-
-		m_cf.at(CF_TOD9JanEnergy, y) = 0;
-		m_cf.at(CF_TOD9FebEnergy, y) = 0;
-		m_cf.at(CF_TOD9MarEnergy, y) = 0;
-		m_cf.at(CF_TOD9AprEnergy, y) = 0;
-		m_cf.at(CF_TOD9MayEnergy, y) = 0;
-		m_cf.at(CF_TOD9JunEnergy, y) = 0;
-		m_cf.at(CF_TOD9JulEnergy, y) = 0;
-		m_cf.at(CF_TOD9AugEnergy, y) = 0;
-		m_cf.at(CF_TOD9SepEnergy, y) = 0;
-		m_cf.at(CF_TOD9OctEnergy, y) = 0;
-		m_cf.at(CF_TOD9NovEnergy, y) = 0;
-		m_cf.at(CF_TOD9DecEnergy, y) = 0;
-
-		int i = 0;
-		for (int m = 0; m<12; m++)
+		if (m_npass > 1 && ((m_f_last >= 0.0) != too_large))
 		{
-			for (int d = 0; d<util::nday[m]; d++)
+			m_bracketed = true;
+			if (too_large)
 			{
-				for (int h = 0; h<24 && i<8760 && m * 24 + h<288; h++)
-				{
-					switch (m)
-					{
-					case 0:
-						m_cf.at(CF_TODJanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9JanEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 1:
-						m_cf.at(CF_TODFebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9FebEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 2:
-						m_cf.at(CF_TODMarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9MarEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 3:
-						m_cf.at(CF_TODAprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9AprEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 4:
-						m_cf.at(CF_TODMayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9MayEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 5:
-						m_cf.at(CF_TODJunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9JunEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 6:
-						m_cf.at(CF_TODJulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9JulEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 7:
-						m_cf.at(CF_TODAugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9AugEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 8:
-						m_cf.at(CF_TODSepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9SepEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 9:
-						m_cf.at(CF_TODOctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9OctEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 10:
-						m_cf.at(CF_TODNovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9NovEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					case 11:
-						m_cf.at(CF_TODDecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-						switch (m_periods[i])
-						{
-						case 1:
-							m_cf.at(CF_TOD1DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 2:
-							m_cf.at(CF_TOD2DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 3:
-							m_cf.at(CF_TOD3DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 4:
-							m_cf.at(CF_TOD4DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 5:
-							m_cf.at(CF_TOD5DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 6:
-							m_cf.at(CF_TOD6DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 7:
-							m_cf.at(CF_TOD7DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 8:
-							m_cf.at(CF_TOD8DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						case 9:
-							m_cf.at(CF_TOD9DecEnergy, y) += m_hourly_energy[(y - 1) * 8760 + i];
-							break;
-						}
-						break;
-					}
-					i++;
-				}
+				m_x0 = m_x_last; m_f0 = m_f_last;
+				m_x1 = ppa; m_f1 = f;
+			}
+			else
+			{
+				m_x0 = ppa; m_f0 = f;
+				m_x1 = m_x_last; m_f1 = m_f_last;
 			}
 		}
-
+		else
+		{
+			// secant through the last two passes, falling back to a coarse step
+			// when the slope is flat or points away from the root
+			double step = too_large ? -m_coarse_interval : m_coarse_interval;
+			if (m_npass > 1 && f != m_f_last)
+			{
+				double secant = -f * (ppa - m_x_last) / (f - m_f_last);
+				if (std::isfinite(secant) && (secant > 0.0) != too_large && fabs(secant) <= 10.0 * m_coarse_interval)
+					step = secant;
+			}
+			m_x_last = ppa;
+			m_f_last = f;
+			return ppa + step;
+		}
+	}
+	else
+	{
+		// Illinois false position: halve the weight of an endpoint retained twice in a row
+		if (too_large)
+		{
+			m_x1 = ppa; m_f1 = f;
+			if (m_side == 1) m_f0 *= 0.5;
+			m_side = 1;
+		}
+		else
+		{
+			m_x0 = ppa; m_f0 = f;
+			if (m_side == -1) m_f1 *= 0.5;
+			m_side = -1;
+		}
 	}
 
-	return true;
+	if (m_f1 == m_f0) return 0.5*(m_x0 + m_x1);
+	return (m_x0*m_f1 - m_x1*m_f0) / (m_f1 - m_f0);
 }
 
 /*   VARTYPE           DATATYPE         NAME                               LABEL                                       UNITS     META                                     GROUP                 REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
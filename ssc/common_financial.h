@@ -78,6 +78,8 @@ public:
 	dispatch_calculations() {};
 	dispatch_calculations(compute_module *cm, std::vector<double>& degradation, std::vector<double>& hourly_energy);
 	bool init(compute_module *cm, std::vector<double>& degradation, std::vector<double>& hourly_energy);
+	// reuse the energy aggregation of an instance initialized with the same gen, degradation and schedules
+	bool init(compute_module *cm, const dispatch_calculations &shared);
 	bool setup();
 	bool setup_ts();
 	bool compute_outputs(std::vector<double>& ppa);
@@ -114,6 +116,33 @@ public:
 };
 
 
+/*
+* PPA price search for the IRR target modes (ppa_soln_mode=0). Each cashflow pass
+* reports the NPV of the target return line discounted at the target IRR, which is
+* near linear in PPA price because revenue is. Until the root is bracketed the next
+* price is the secant through the last two passes, which is exact when the tax and
+* debt structure is linear; once bracketed, Illinois false position keeps a curved
+* residual from stalling on one endpoint.
+*/
+class ppa_solver
+{
+private:
+	double m_x0, m_x1;		// bracket endpoints, or ppa min and max until bracketed
+	double m_f0, m_f1;
+	double m_x_last, m_f_last;
+	double m_coarse_interval;
+	int m_npass;
+	int m_side;				// endpoint replaced on the previous bracketed step, -1 lower, 1 upper
+	bool m_bracketed;
+
+public:
+	ppa_solver(double ppa_min, double ppa_max, double coarse_interval = 10.0);
+	/// record the target NPV from a pass at price ppa and return the price for the next pass
+	double next(double ppa, double npv_at_target);
+	bool bracketed() { return m_bracketed; }
+	double lower() { return m_x0; }
+	double upper() { return m_x1; }
+};
 
 
 /*
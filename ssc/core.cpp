@@ -50,6 +50,8 @@
 #include <sstream>
 #include <fstream>
 #include <cstring>
+#include <atomic>
+#include <thread>
 
 #include "core.h"
 
@@ -363,6 +365,28 @@ ssc_number_t *compute_module::as_array( const std::string &name, size_t *count )
 	if (count) *count = x.num.length();
 	return x.num.data();
 }
+
+std::vector<double> compute_module::as_vector_expanded( const std::string &name, size_t count, const std::string &item ) throw( general_error )
+{
+	var_data &x = value(name);
+	if (x.type != SSC_NUMBER && x.type != SSC_ARRAY) throw cast_error("array", x, name);
+	std::vector<double> v;
+	if (!expand_values(x, count, v))
+		throw general_error(util::format("%s must have one value or one value per %s (%d)", name.c_str(), item.c_str(), (int)count));
+	return v;
+}
+
+// one value applies to every item, otherwise there must be exactly one value per item
+bool compute_module::expand_values( const var_data &x, size_t count, std::vector<double> &values )
+{
+	size_t n = x.num.ncells();
+	if ((x.type != SSC_NUMBER && x.type != SSC_ARRAY) || (n != 1 && n != count))
+		return false;
+	values.resize(count);
+	for (size_t k = 0; k < count; k++)
+		values[k] = (double)x.num[n == 1 ? 0 : k];
+	return true;
+}
 /** 
 The obvious improvement would be to made this a template, but ran into trouble with 
 "error: Access violation - no RTTI data!" 
@@ -1037,3 +1061,53 @@ ssc_number_t compute_module::accumulate_annual_for_year( const std::string &ts_v
 
 	return (ssc_number_t)( sum*scale );
 }
+
+std::string silent_handler::last_error()
+{
+	std::string text;
+	for (int i = 0; compute_module::log_item *li = module()->log(i); i++)
+		if (li->type == SSC_ERROR || text.empty())
+			text = li->text;
+	return text;
+}
+
+size_t parallel_threads( size_t n, size_t nthreads )
+{
+	if (nthreads == 0) nthreads = std::thread::hardware_concurrency();
+	if (nthreads > n) nthreads = n;
+	if (nthreads == 0) nthreads = 1;
+	return nthreads;
+}
+
+void parallel_for( size_t n, size_t nthreads, const std::function<void(size_t, size_t)> &fn )
+{
+	nthreads = parallel_threads(n, nthreads);
+
+	std::atomic<size_t> next(0);
+	std::vector<std::exception_ptr> errors(nthreads);
+	auto worker = [&](size_t thread)
+	{
+		try
+		{
+			size_t i;
+			while ((i = next++) < n)
+				fn(i, thread);
+		}
+		catch (...)
+		{
+			errors[thread] = std::current_exception();
+			next = n;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t t = 1; t < nthreads; t++)
+		threads.push_back(std::thread(worker, t));
+	worker(0);
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	for (size_t t = 0; t < nthreads; t++)
+		if (errors[t])
+			std::rethrow_exception(errors[t]);
+}
@@ -60,6 +60,7 @@
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <functional>
 
 /* Macros for C++11 support */
 template <typename T>
@@ -266,6 +267,8 @@ public:
 	double as_double( const std::string &name ) throw( general_error );
 	const char *as_string( const std::string &name ) throw( general_error );
 	ssc_number_t *as_array( const std::string &name, size_t *count ) throw( general_error );
+	std::vector<double> as_vector_expanded( const std::string &name, size_t count, const std::string &item ) throw( general_error );
+	static bool expand_values( const var_data &x, size_t count, std::vector<double> &values );
 	std::vector<int> as_vector_integer(const std::string &name) throw(general_error);
 	std::vector<ssc_number_t> as_vector_ssc_number_t(const std::string &name) throw(general_error);
 	std::vector<double> as_vector_double( const std::string &name ) throw( general_error );
@@ -329,6 +332,26 @@ public:
 		  if (!m_cm->on_extproc_output(text)) m_cm->log( "stdout(child): " + text, SSC_NOTICE ); }
 };
 
+/* for a compute module run from inside another module's exec: log messages and
+   progress updates are dropped, last_error() returns the message that stopped the run */
+class silent_handler : public handler_interface
+{
+public:
+	silent_handler( compute_module *cm ) : handler_interface(cm) {  }
+	virtual void on_log( const std::string &, int, float ) {  }
+	virtual bool on_update( const std::string &, float, float ) { return true; }
+	std::string last_error();
+};
+
+/* calls fn(i, thread) for i = 0..n-1 on up to nthreads threads (0=one per processor),
+   the calling thread is thread 0.  items are handed out one at a time so that threads
+   finishing early pick up the remaining work.  an exception thrown by fn is rethrown
+   on the calling thread once all threads have finished. */
+void parallel_for( size_t n, size_t nthreads, const std::function<void(size_t, size_t)> &fn );
+
+/* number of threads parallel_for uses for n items, for sizing per thread state */
+size_t parallel_threads( size_t n, size_t nthreads );
+
 
 
 #define DEFINE_MODULE_ENTRY( name, desc, ver ) \
@@ -52,6 +52,7 @@
 
 #include "core.h"
 #include "sscapi.h"
+#include "lib_pvwatts.h"
 
 SSCEXPORT int ssc_version()
 {
@@ -76,6 +77,7 @@ extern module_entry_info
 	cm_entry_iec61853par,
 	cm_entry_iec61853interp,
 	cm_entry_6parsolve,
+	cm_entry_6parsolve_batch,
 	cm_entry_pvsamv1,
 	cm_entry_pvwattsv0,
 	cm_entry_pvwattsv1,
@@ -83,6 +85,7 @@ extern module_entry_info
 	cm_entry_pvwattsv1_poa,
 	cm_entry_pvwattsv5,
 	cm_entry_pvwattsv5_1ts,
+	cm_entry_pvwattsv5_fleet,
 	cm_entry_pv6parmod,
 	cm_entry_pvsandiainv,
 	cm_entry_wfreader,
@@ -92,6 +95,7 @@ extern module_entry_info
 	cm_entry_utilityrate3,
 	cm_entry_utilityrate4,
 	cm_entry_utilityrate5,
+	cm_entry_utilityrate5_batch,
 	cm_entry_annualoutput,
 	cm_entry_cashloan,
 	cm_entry_thirdpartyownership,
@@ -101,6 +105,7 @@ extern module_entry_info
 	cm_entry_equpartflip,
 	cm_entry_saleleaseback,
 	cm_entry_singleowner,
+	cm_entry_singleowner_sweep,
 	cm_entry_host_developer,
 	cm_entry_swh,
 	cm_entry_geothermal,
@@ -146,6 +151,7 @@ extern module_entry_info
 	cm_entry_cb_empirical_hce_heat_loss,
 	cm_entry_iscc_design_point,
 	cm_entry_battery,
+	cm_entry_battery_sweep,
 	cm_entry_battwatts,
    	cm_entry_lcoefcr,
 	cm_entry_pv_get_shade_loss_mpp,
@@ -158,6 +164,7 @@ static module_entry_info *module_table[] = {
 	&cm_entry_iec61853par,
 	&cm_entry_iec61853interp,
 	&cm_entry_6parsolve,
+	&cm_entry_6parsolve_batch,
 	&cm_entry_pv6parmod,
 	&cm_entry_pvsamv1,
 	//&cm_entry_pvwattsv0,
@@ -166,6 +173,7 @@ static module_entry_info *module_table[] = {
 	&cm_entry_pvwattsv1_poa,
 	&cm_entry_pvwattsv5,
 	&cm_entry_pvwattsv5_1ts,
+	&cm_entry_pvwattsv5_fleet,
 	&cm_entry_pvsandiainv,
 	&cm_entry_wfreader,
 	&cm_entry_irradproc,
@@ -174,6 +182,7 @@ static module_entry_info *module_table[] = {
 	&cm_entry_utilityrate3,
 	&cm_entry_utilityrate4,
 	&cm_entry_utilityrate5,
+	&cm_entry_utilityrate5_batch,
 	&cm_entry_annualoutput,
 	&cm_entry_cashloan,
 	&cm_entry_thirdpartyownership,
@@ -183,6 +192,7 @@ static module_entry_info *module_table[] = {
 	&cm_entry_equpartflip,
 	&cm_entry_saleleaseback,
 	&cm_entry_singleowner,
+	&cm_entry_singleowner_sweep,
 	&cm_entry_host_developer,
 	&cm_entry_swh,
 	&cm_entry_geothermal,
@@ -228,6 +238,7 @@ static module_entry_info *module_table[] = {
 	&cm_entry_cb_empirical_hce_heat_loss,
 	&cm_entry_iscc_design_point,
 	&cm_entry_battery,
+	&cm_entry_battery_sweep,
 	&cm_entry_battwatts,
 	&cm_entry_lcoefcr,
 	&cm_entry_pv_get_shade_loss_mpp,
@@ -682,6 +693,167 @@ SSCEXPORT const char *ssc_module_log( ssc_module_t p_mod, int index, int *item_t
 	return l->text.c_str();
 }
 
+struct pvwatts_stream
+{
+	std::vector<pvwattsv5_site> sites;
+	std::string error;
+};
+
+// one value per site, a single value applies to every site
+static bool pvwatts_stream_input( var_table *vt, const char *name, size_t nsites, double default_value, std::vector<double> &values, std::string &error )
+{
+	values.assign( nsites, default_value );
+	var_data *vd = vt->lookup( name );
+	if ( !vd )
+	{
+		if ( default_value < -900 )
+		{
+			error = util::format("site data missing: %s", name);
+			return false;
+		}
+		return true;
+	}
+
+	if ( vd->type != SSC_NUMBER && vd->type != SSC_ARRAY )
+	{
+		error = util::format("%s must be a number or an array", name);
+		return false;
+	}
+
+	if ( !compute_module::expand_values( *vd, nsites, values ) )
+	{
+		error = util::format("%s must have one value or one value per site (%d)", name, (int)nsites);
+		return false;
+	}
+	return true;
+}
+
+SSCEXPORT ssc_pvwatts_stream_t ssc_pvwatts_stream_create( ssc_data_t p_sites, ssc_number_t time_step )
+{
+	var_table *vt = static_cast<var_table*>(p_sites);
+	if ( !vt ) return 0;
+
+	pvwatts_stream *ps = new pvwatts_stream;
+
+	var_data *vd = vt->lookup( "lat" );
+	size_t nsites = vd ? vd->num.ncells() : 0;
+	if ( nsites == 0 )
+	{
+		ps->error = "site data missing: lat";
+		return static_cast<ssc_pvwatts_stream_t>(ps);
+	}
+	if ( time_step <= 0 || time_step > 1 )
+	{
+		ps->error = "time step must be greater than zero and at most one hour";
+		return static_cast<ssc_pvwatts_stream_t>(ps);
+	}
+
+	const double required = -999;
+	std::vector<double> lat, lon, tz, capacity, losses, array_type, tilt, azimuth, module_type, dc_ac_ratio, inv_eff, gcr;
+	if ( !pvwatts_stream_input( vt, "lat", nsites, required, lat, ps->error )
+		|| !pvwatts_stream_input( vt, "lon", nsites, required, lon, ps->error )
+		|| !pvwatts_stream_input( vt, "tz", nsites, required, tz, ps->error )
+		|| !pvwatts_stream_input( vt, "system_capacity", nsites, required, capacity, ps->error )
+		|| !pvwatts_stream_input( vt, "losses", nsites, required, losses, ps->error )
+		|| !pvwatts_stream_input( vt, "array_type", nsites, required, array_type, ps->error )
+		|| !pvwatts_stream_input( vt, "tilt", nsites, required, tilt, ps->error )
+		|| !pvwatts_stream_input( vt, "azimuth", nsites, required, azimuth, ps->error )
+		|| !pvwatts_stream_input( vt, "module_type", nsites, 0, module_type, ps->error )
+		|| !pvwatts_stream_input( vt, "dc_ac_ratio", nsites, 1.1, dc_ac_ratio, ps->error )
+		|| !pvwatts_stream_input( vt, "inv_eff", nsites, 96, inv_eff, ps->error )
+		|| !pvwatts_stream_input( vt, "gcr", nsites, 0.4, gcr, ps->error ) )
+		return static_cast<ssc_pvwatts_stream_t>(ps);
+
+	ps->sites.reserve( nsites );
+	for ( size_t i = 0; i < nsites; i++ )
+	{
+		pvwattsv5_system sys;
+		std::string error;
+		if ( !sys.setup( capacity[i], (int)module_type[i], dc_ac_ratio[i], inv_eff[i], losses[i],
+				(int)array_type[i], tilt[i], azimuth[i], gcr[i], &error ) )
+		{
+			ps->sites.clear();
+			ps->error = util::format("site %d: ", (int)i) + error;
+			break;
+		}
+		if ( lat[i] < -90 || lat[i] > 90 || lon[i] < -180 || lon[i] > 180 || tz[i] < -15 || tz[i] > 15 )
+		{
+			ps->sites.clear();
+			ps->error = util::format("site %d: invalid location", (int)i);
+			break;
+		}
+		ps->sites.push_back( pvwattsv5_site( sys, lat[i], lon[i], tz[i], time_step ) );
+	}
+
+	return static_cast<ssc_pvwatts_stream_t>(ps);
+}
+
+SSCEXPORT int ssc_pvwatts_stream_nsites( ssc_pvwatts_stream_t p_stream )
+{
+	pvwatts_stream *ps = static_cast<pvwatts_stream*>(p_stream);
+	return ps ? (int)ps->sites.size() : 0;
+}
+
+SSCEXPORT ssc_bool_t ssc_pvwatts_stream_step( ssc_pvwatts_stream_t p_stream, int year, int month, int day, int hour, ssc_number_t minute,
+	const ssc_number_t *beam, const ssc_number_t *diffuse, const ssc_number_t *tamb, const ssc_number_t *wspd, const ssc_number_t *albedo,
+	ssc_number_t *dc, ssc_number_t *ac )
+{
+	pvwatts_stream *ps = static_cast<pvwatts_stream*>(p_stream);
+	if ( !ps || !beam || !diffuse || !tamb || !wspd || !dc || !ac ) return 0;
+
+	ps->error.clear();
+	bool ok = true;
+	size_t nsites = ps->sites.size();
+	for ( size_t i = 0; i < nsites; i++ )
+	{
+		double alb = 0.2;
+		if ( albedo && albedo[i] > 0 && albedo[i] < 1 )
+			alb = albedo[i];
+
+		double site_dc, site_ac;
+		int code = ps->sites[i].calc( year, month, day, hour, minute, IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET,
+			beam[i], diffuse[i], tamb[i], wspd[i], alb, site_dc, site_ac );
+		if ( code != 0 && code != -1 )
+		{
+			ps->error = util::format("site %d: failed to calculate plane of array irradiance (code: %d)", (int)i, code);
+			ok = false;
+		}
+		dc[i] = (ssc_number_t)site_dc;
+		ac[i] = (ssc_number_t)site_ac;
+	}
+	return ok ? 1 : 0;
+}
+
+SSCEXPORT ssc_bool_t ssc_pvwatts_stream_set_state( ssc_pvwatts_stream_t p_stream, int site, ssc_number_t tcell, ssc_number_t poa )
+{
+	pvwatts_stream *ps = static_cast<pvwatts_stream*>(p_stream);
+	if ( !ps || site < 0 || site >= (int)ps->sites.size() ) return 0;
+	ps->sites[site].set_last_values( tcell, poa );
+	return 1;
+}
+
+SSCEXPORT ssc_bool_t ssc_pvwatts_stream_get_state( ssc_pvwatts_stream_t p_stream, int site, ssc_number_t *tcell, ssc_number_t *poa )
+{
+	pvwatts_stream *ps = static_cast<pvwatts_stream*>(p_stream);
+	if ( !ps || site < 0 || site >= (int)ps->sites.size() ) return 0;
+	if ( tcell ) *tcell = (ssc_number_t)ps->sites[site].tcell();
+	if ( poa ) *poa = (ssc_number_t)ps->sites[site].poa();
+	return 1;
+}
+
+SSCEXPORT const char *ssc_pvwatts_stream_error( ssc_pvwatts_stream_t p_stream )
+{
+	pvwatts_stream *ps = static_cast<pvwatts_stream*>(p_stream);
+	if ( !ps || ps->error.empty() ) return 0;
+	return ps->error.c_str();
+}
+
+SSCEXPORT void ssc_pvwatts_stream_free( ssc_pvwatts_stream_t p_stream )
+{
+	pvwatts_stream *ps = static_cast<pvwatts_stream*>(p_stream);
+	if ( ps ) delete ps;
+}
+
 SSCEXPORT void __ssc_segfault()
 {
 	std::string *pstr = 0;
@@ -324,6 +324,39 @@ SSCEXPORT ssc_bool_t ssc_module_exec_with_handler(
 /** Retrive notices, warnings, and error messages from the simulation. Returns a NULL-terminated ASCII C string with the message text, or NULL if the index passed in was invalid. */
 SSCEXPORT const char *ssc_module_log( ssc_module_t p_mod, int index, int *item_type, float *time );
 
+/** @name Streaming PVWatts:
+  * A stateful PVWatts V5 engine for a fixed set of sites, for applications that step many systems forward one time step at a time, such as real-time forecasting.
+  * Site geometry is set up once at creation and each site keeps its own cell temperature state between steps, so no inputs are verified and no memory is allocated per step.
+  * The engine is not thread-safe, but separate engines may be used from separate threads.
+*/
+/**@{*/
+/** An opaque reference to a streaming PVWatts engine. */
+typedef void* ssc_pvwatts_stream_t;
+
+/** Creates a streaming PVWatts engine. p_sites holds arrays with one entry per site: lat, lon, tz, system_capacity (kW), losses (%), array_type, tilt, azimuth, and optionally module_type, dc_ac_ratio, inv_eff (%) and gcr.  An array with a single value applies to every site.  time_step is the time step between calls in hours.  Check ssc_pvwatts_stream_error after creating the engine. Returns NULL only if p_sites is NULL. */
+SSCEXPORT ssc_pvwatts_stream_t ssc_pvwatts_stream_create( ssc_data_t p_sites, ssc_number_t time_step );
+
+/** Returns the number of sites in the engine. */
+SSCEXPORT int ssc_pvwatts_stream_nsites( ssc_pvwatts_stream_t p_stream );
+
+/** Calculates one time step for every site. beam, diffuse, tamb and wspd are arrays with one value per site (W/m2, W/m2, C, m/s); albedo may be NULL to use 0.2. dc and ac receive the power in W for each site. Returns 0 if any site failed, see ssc_pvwatts_stream_error, which is cleared at the start of each step; other sites are still calculated. A failed site gets zero power, and its state as returned by ssc_pvwatts_stream_get_state is the ambient temperature and zero irradiance, as at night; the cell temperature model keeps the state of its last daytime step. The sun position is calculated at the given minute, without the sunrise and sunset interpolation (IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET). pvwattsv5 instead uses the middle of the time step, or of its sunup part in the sunrise and sunset hours, for hourly weather files without minutes, so pass minute 30 with hourly data to get the same sun position outside those hours. */
+SSCEXPORT ssc_bool_t ssc_pvwatts_stream_step( ssc_pvwatts_stream_t p_stream, int year, int month, int day, int hour, ssc_number_t minute,
+	const ssc_number_t *beam, const ssc_number_t *diffuse, const ssc_number_t *tamb, const ssc_number_t *wspd, const ssc_number_t *albedo,
+	ssc_number_t *dc, ssc_number_t *ac );
+
+/** Restores the module temperature (C) and plane of array irradiance (W/m2) from the previous time step for one site, for example when restarting a forecast. */
+SSCEXPORT ssc_bool_t ssc_pvwatts_stream_set_state( ssc_pvwatts_stream_t p_stream, int site, ssc_number_t tcell, ssc_number_t poa );
+
+/** Returns the module temperature (C) and plane of array irradiance (W/m2) for one site from the last time step. */
+SSCEXPORT ssc_bool_t ssc_pvwatts_stream_get_state( ssc_pvwatts_stream_t p_stream, int site, ssc_number_t *tcell, ssc_number_t *poa );
+
+/** Returns the last error message, or NULL if there was none. */
+SSCEXPORT const char *ssc_pvwatts_stream_error( ssc_pvwatts_stream_t p_stream );
+
+/** Frees a streaming PVWatts engine. */
+SSCEXPORT void ssc_pvwatts_stream_free( ssc_pvwatts_stream_t p_stream );
+/**@}*/
+
 /** DO NOT CALL THIS FUNCTION: immediately causes a segmentation fault within the library. This is only useful for testing crash handling from an external application that is dynamically linked to the SSC library */
 SSCEXPORT void __ssc_segfault();
 
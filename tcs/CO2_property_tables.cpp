@@ -0,0 +1,493 @@
+/*******************************************************************************************************
+*  Copyright 2017 Alliance for Sustainable Energy, LLC
+*
+*  NOTICE: This software was developed at least in part by Alliance for Sustainable Energy, LLC
+*  (Alliance) under Contract No. DE-AC36-08GO28308 with the U.S. Department of Energy and the U.S.
+*  The Government retains for itself and others acting on its behalf a nonexclusive, paid-up,
+*  irrevocable worldwide license in the software to reproduce, prepare derivative works, distribute
+*  copies to the public, perform publicly and display publicly, and to permit others to do so.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted
+*  provided that the following conditions are met:
+*
+*  1. Redistributions of source code must retain the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer.
+*
+*  2. Redistributions in binary form must reproduce the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer in the documentation and/or
+*  other materials provided with the distribution.
+*
+*  3. The entire corresponding source code of any redistribution, with or without modification, by a
+*  research entity, including but not limited to any contracting manager/operator of a United States
+*  National Laboratory, any institution of higher learning, and any non-profit organization, must be
+*  made publicly available under this license for as long as the redistribution is made available by
+*  the research entity.
+*
+*  4. Redistribution of this software, without modification, must refer to the software by the same
+*  designation. Redistribution of a modified version of this software (i) may not refer to the modified
+*  version by the same designation, or by any confusingly similar designation, and (ii) must refer to
+*  the underlying software originally provided by Alliance as System Advisor Model or SAM. Except
+*  to comply with the foregoing, the terms System Advisor Model, SAM, or any confusingly similar
+*  designation may not be used to refer to any modified version of this software or any modified
+*  version of the underlying software originally provided by Alliance without the prior written consent
+*  of Alliance.
+*
+*  5. The name of the copyright holder, contributors, the United States Government, the United States
+*  Department of Energy, or any of their employees may not be used to endorse or promote products
+*  derived from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+*  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER,
+*  CONTRIBUTORS, UNITED STATES GOVERNMENT OR UNITED STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR
+*  EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+*  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+*  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+*  THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************************************/
+
+#include "CO2_property_tables.h"
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <atomic>
+#include <mutex>
+
+// Saturation densities of the fit [kg/m3], defined in CO2_properties.cpp
+double CO2_sat_vap_dens(const double T);
+double CO2_sat_liq_dens(const double T);
+
+// Catmull-Rom weights of the nodes at -1, 0, 1 and 2 for a point at fraction t of the interval from 0 to 1
+static void catmull_rom_weights(double t, double * w)
+{
+	double t2 = t*t;
+	double t3 = t2*t;
+	w[0] = 0.5*(-t3 + 2.0*t2 - t);
+	w[1] = 0.5*(3.0*t3 - 5.0*t2 + 2.0);
+	w[2] = 0.5*(-3.0*t3 + 4.0*t2 + t);
+	w[3] = 0.5*(t3 - t2);
+}
+
+// Derivatives of the weights with respect to t
+static void catmull_rom_slope_weights(double t, double * w)
+{
+	double t2 = t*t;
+	w[0] = 0.5*(-3.0*t2 + 4.0*t - 1.0);
+	w[1] = 0.5*(9.0*t2 - 10.0*t);
+	w[2] = 0.5*(-9.0*t2 + 8.0*t + 1.0);
+	w[3] = 0.5*(3.0*t2 - 2.0*t);
+}
+
+// Phase of a single-phase state with respect to the saturation dome: -1 liquid, 1 vapor or gas, 0 above the critical pressure
+static int co2_phase(const CO2_state & state)
+{
+	if( state.qual < 0.0 )
+		return -1;
+	if( state.qual > 1.0 && state.qual != 999.0 )
+		return 1;
+	return 0;
+}
+
+C_CO2_property_table::C_CO2_property_table()
+{
+	m_vars = E_PH;
+	m_x_min = m_y_min = m_dx = m_dy = m_inv_dx = m_inv_dy = 0.0;
+	m_n_x = m_n_y = 0;
+	m_max_error = m_max_error_derived = m_tabulated_fraction = 0.0;
+}
+
+C_CO2_property_table::S_table_par C_CO2_property_table::default_par(int vars)
+{
+	S_table_par par;
+	par.m_vars = vars;
+
+	switch( vars )
+	{
+	case E_PH:
+		par.m_x_min = 2000.0;	par.m_x_max = 40000.0;	par.m_n_x = 381;	//[kPa]
+		par.m_y_min = 150.0;	par.m_y_max = 1600.0;	par.m_n_y = 581;	//[kJ/kg]
+		break;
+	case E_PS:
+		par.m_x_min = 2000.0;	par.m_x_max = 40000.0;	par.m_n_x = 381;	//[kPa]
+		par.m_y_min = 0.75;		par.m_y_max = 3.6;		par.m_n_y = 571;	//[kJ/kg-K]
+		break;
+	default:
+		par.m_vars = E_TP;
+		par.m_x_min = 275.0;	par.m_x_max = 1200.0;	par.m_n_x = 741;	//[K]
+		par.m_y_min = 2000.0;	par.m_y_max = 40000.0;	par.m_n_y = 381;	//[kPa]
+		break;
+	}
+
+	return par;
+}
+
+int C_CO2_property_table::exact_state(double x, double y, CO2_state * state) const
+{
+	switch( m_vars )
+	{
+	case E_PH:
+		return CO2_PH(x, y, state);
+	case E_PS:
+		return CO2_PS(x, y, state);
+	default:
+		return CO2_TP(x, y, state);
+	}
+}
+
+bool C_CO2_property_table::init(const S_table_par & par)
+{
+	m_n_x = m_n_y = 0;
+	if( par.m_vars < 0 || par.m_vars >= E_n_vars || par.m_n_x < 4 || par.m_n_y < 4 ||
+		!(par.m_x_max > par.m_x_min) || !(par.m_y_max > par.m_y_min) )
+		return false;
+
+	m_vars = par.m_vars;
+	m_x_min = par.m_x_min;
+	m_y_min = par.m_y_min;
+	m_dx = (par.m_x_max - par.m_x_min) / double(par.m_n_x - 1);
+	m_dy = (par.m_y_max - par.m_y_min) / double(par.m_n_y - 1);
+	m_inv_dx = 1.0 / m_dx;
+	m_inv_dy = 1.0 / m_dy;
+	int n_x = par.m_n_x;
+	int n_y = par.m_n_y;
+
+	// Nodes: exact states, and the phase of the single-phase ones
+	const int phase_invalid = 2;
+	m_values.assign(n_x*n_y*C_n_cols, std::numeric_limits<double>::quiet_NaN());
+	std::vector<int> phase(n_x*n_y, phase_invalid);
+	CO2_state co2_props;
+	for( int i = 0; i < n_x; i++ )
+	{
+		for( int j = 0; j < n_y; j++ )
+		{
+			if( exact_state(m_x_min + i*m_dx, m_y_min + j*m_dy, &co2_props) != 0 ||
+				(co2_props.qual >= 0.0 && co2_props.qual <= 1.0) )
+				continue;
+
+			double *v = &m_values[(i*n_y + j)*C_n_cols];
+			v[C_T] = co2_props.temp;
+			v[C_D] = co2_props.dens;
+			v[C_H] = co2_props.enth;
+			v[C_S] = co2_props.entr;
+			v[C_CV] = co2_props.cv;
+			v[C_CP] = co2_props.cp;
+			v[C_SSND] = co2_props.ssnd;
+			phase[i*n_y + j] = co2_phase(co2_props);
+		}
+	}
+
+	// Cells: interior cells whose 4x4 nodes are valid and on one side of the dome, and whose check points meet the tolerances
+	m_n_x = n_x;
+	m_n_y = n_y;
+	m_is_cell_tabulated.assign((n_x - 1)*(n_y - 1), 0);
+	m_max_error = m_max_error_derived = 0.0;
+	int n_tabulated = 0;
+
+	const int n_check_points = 7;
+	const double check_points[n_check_points][2] = { {0.5, 0.5}, {0.5, 0.0}, {0.0, 0.5},
+		{0.25, 0.25}, {0.75, 0.25}, {0.25, 0.75}, {0.75, 0.75} };
+	for( int i = 1; i < n_x - 2; i++ )
+	{
+		for( int j = 1; j < n_y - 2; j++ )
+		{
+			bool is_liquid = false;
+			bool is_vapor = false;
+			bool is_valid = true;
+			for( int a = i - 1; a <= i + 2 && is_valid; a++ )
+			{
+				for( int b = j - 1; b <= j + 2; b++ )
+				{
+					int p = phase[a*n_y + b];
+					if( p == phase_invalid )
+					{
+						is_valid = false;
+						break;
+					}
+					is_liquid = is_liquid || p < 0;
+					is_vapor = is_vapor || p > 0;
+				}
+			}
+			if( !is_valid || (is_liquid && is_vapor) )
+				continue;
+
+			double error = 0.0;
+			double error_derived = 0.0;
+			for( int k = 0; k < n_check_points && is_valid; k++ )
+			{
+				double x = m_x_min + (i + check_points[k][0])*m_dx;
+				double y = m_y_min + (j + check_points[k][1])*m_dy;
+				if( exact_state(x, y, &co2_props) != 0 || (co2_props.qual >= 0.0 && co2_props.qual <= 1.0) )
+				{
+					is_valid = false;
+					break;
+				}
+
+				double v[C_n_cols];
+				interpolate(i, j, check_points[k][0], check_points[k][1], v);
+				double exact[C_n_cols] = { co2_props.temp, co2_props.dens, co2_props.enth, co2_props.entr,
+											co2_props.cv, co2_props.cp, co2_props.ssnd };
+				for( int c = 0; c < C_n_cols; c++ )
+				{
+					double rel_error = std::abs(v[c] - exact[c]) / std::abs(exact[c]);
+					if( !(rel_error < 1.E99) )
+						rel_error = 1.E99;
+					if( c < C_CV )
+						error = std::max(error, rel_error);
+					else
+						error_derived = std::max(error_derived, rel_error);
+				}
+			}
+
+			if( !is_valid || error > par.m_tol || error_derived > par.m_tol_derived )
+				continue;
+
+			m_is_cell_tabulated[i*(n_y - 1) + j] = 1;
+			m_max_error = std::max(m_max_error, error);
+			m_max_error_derived = std::max(m_max_error_derived, error_derived);
+			n_tabulated++;
+		}
+	}
+
+	m_tabulated_fraction = n_tabulated / double((n_x - 1)*(n_y - 1));
+
+	return true;
+}
+
+bool C_CO2_property_table::find_cell(double x, double y, int & i, int & j, double & fx, double & fy) const
+{
+	double sx = (x - m_x_min)*m_inv_dx;
+	double sy = (y - m_y_min)*m_inv_dy;
+	if( !(sx >= 1.0 && sx < m_n_x - 2 && sy >= 1.0 && sy < m_n_y - 2) )
+		return false;
+
+	i = (int)sx;
+	j = (int)sy;
+	fx = sx - i;
+	fy = sy - j;
+
+	return m_is_cell_tabulated[i*(m_n_y - 1) + j] != 0;
+}
+
+void C_CO2_property_table::interpolate(int i, int j, double fx, double fy, double * v) const
+{
+	double wx[4], wy[4];
+	catmull_rom_weights(fx, wx);
+	catmull_rom_weights(fy, wy);
+
+	// Interpolate along y in each of the 4 rows of nodes, then along x
+	double sum[C_n_cols] = { 0.0 };
+	for( int a = 0; a < 4; a++ )
+	{
+		const double *node = &m_values[((i - 1 + a)*m_n_y + j - 1)*C_n_cols];
+		double row[C_n_cols];
+		for( int c = 0; c < C_n_cols; c++ )
+			row[c] = wy[0]*node[c] + wy[1]*node[C_n_cols + c] + wy[2]*node[2*C_n_cols + c] + wy[3]*node[3*C_n_cols + c];
+		for( int c = 0; c < C_n_cols; c++ )
+			sum[c] += wx[a]*row[c];
+	}
+
+	for( int c = 0; c < C_n_cols; c++ )
+		v[c] = sum[c];
+}
+
+void C_CO2_property_table::set_state(double x, double y, const double * v, CO2_state * state) const
+{
+	double T = v[C_T];
+	double P = std::numeric_limits<double>::quiet_NaN();
+	double H = v[C_H];
+	double S = v[C_S];
+	switch( m_vars )
+	{
+	case E_PH:
+		P = x;
+		H = y;
+		break;
+	case E_PS:
+		P = x;
+		S = y;
+		break;
+	default:
+		T = x;
+		P = y;
+		break;
+	}
+	double D = v[C_D];
+
+	// Quality as reported by the exact routines for single-phase states
+	double D_vap = 0.0;
+	double D_liq = 0.0;
+	double Q = 999.0;
+	if( T < N_co2_props::T_crit )
+	{
+		D_vap = CO2_sat_vap_dens(T);
+		D_liq = CO2_sat_liq_dens(T);
+		Q = (D_vap * (D_liq - D)) / (D * (D_liq - D_vap));
+	}
+	else if( P < N_co2_props::P_crit )
+	{
+		Q = 998.0;
+	}
+
+	state->temp = T;
+	state->pres = P;
+	state->dens = D;
+	state->qual = Q;
+	state->inte = H - P / D;
+	state->enth = H;
+	state->entr = S;
+	state->cv = v[C_CV];
+	state->cp = v[C_CP];
+	state->ssnd = v[C_SSND];
+	state->sat_vap_dens = D_vap;
+	state->sat_liq_dens = D_liq;
+}
+
+int C_CO2_property_table::get_state(double x, double y, CO2_state * state) const
+{
+	int i, j;
+	double fx, fy;
+	if( !find_cell(x, y, i, j, fx, fy) )
+		return exact_state(x, y, state);
+
+	double v[C_n_cols];
+	interpolate(i, j, fx, fy, v);
+	set_state(x, y, v, state);
+
+	return 0;
+}
+
+int C_CO2_property_table::get_derivatives(double x, double y, double & dT_dx, double & dT_dy, double & dD_dx, double & dD_dy) const
+{
+	int i, j;
+	double fx, fy;
+	if( find_cell(x, y, i, j, fx, fy) )
+	{
+		double wx[4], wy[4], dwx[4], dwy[4];
+		catmull_rom_weights(fx, wx);
+		catmull_rom_weights(fy, wy);
+		catmull_rom_slope_weights(fx, dwx);
+		catmull_rom_slope_weights(fy, dwy);
+
+		dT_dx = dT_dy = dD_dx = dD_dy = 0.0;
+		for( int a = 0; a < 4; a++ )
+		{
+			const double *node = &m_values[((i - 1 + a)*m_n_y + j - 1)*C_n_cols];
+			for( int b = 0; b < 4; b++, node += C_n_cols )
+			{
+				dT_dx += dwx[a]*wy[b]*node[C_T];
+				dT_dy += wx[a]*dwy[b]*node[C_T];
+				dD_dx += dwx[a]*wy[b]*node[C_D];
+				dD_dy += wx[a]*dwy[b]*node[C_D];
+			}
+		}
+		dT_dx *= m_inv_dx;
+		dD_dx *= m_inv_dx;
+		dT_dy *= m_inv_dy;
+		dD_dy *= m_inv_dy;
+
+		return 0;
+	}
+
+	CO2_state co2_props;
+	int prop_error_code = exact_state(x, y, &co2_props);
+	if( prop_error_code != 0 )
+		return prop_error_code;
+
+	// Invert the Jacobian of (x, y) with respect to (T, D) from the fit
+	double dPdD_T, dhdD_T, dsdD_T, dPdT_D, dhdT_D, dsdT_D, dDdP_T, dDdT_P, pres, enth, entr;
+	N_co2_props::get_prop_derivatives(co2_props.temp, co2_props.dens, &dPdD_T, &dhdD_T, &dsdD_T,
+		&dPdT_D, &dhdT_D, &dsdT_D, &dDdP_T, &dDdT_P, &pres, &enth, &entr);
+
+	double dx_dT, dx_dD, dy_dT, dy_dD;
+	switch( m_vars )
+	{
+	case E_PH:
+		dx_dT = dPdT_D;	dx_dD = dPdD_T;
+		dy_dT = dhdT_D;	dy_dD = dhdD_T;
+		break;
+	case E_PS:
+		dx_dT = dPdT_D;	dx_dD = dPdD_T;
+		dy_dT = dsdT_D;	dy_dD = dsdD_T;
+		break;
+	default:
+		dx_dT = 1.0;	dx_dD = 0.0;
+		dy_dT = dPdT_D;	dy_dD = dPdD_T;
+		break;
+	}
+
+	double det = dx_dT*dy_dD - dx_dD*dy_dT;
+	dT_dx = dy_dD / det;
+	dT_dy = -dx_dD / det;
+	dD_dx = -dy_dT / det;
+	dD_dy = dx_dT / det;
+
+	return 0;
+}
+
+namespace N_co2_property_tables
+{
+	static std::atomic<int> s_use_tables(-1);		// -1 until set or read from the environment
+	static std::once_flag s_is_built[C_CO2_property_table::E_n_vars];
+	static C_CO2_property_table s_tables[C_CO2_property_table::E_n_vars];
+
+	void set_use_tables(bool use_tables)
+	{
+		s_use_tables = use_tables ? 1 : 0;
+	}
+
+	bool use_tables()
+	{
+		int use = s_use_tables.load();
+		if( use < 0 )
+		{
+			const char *env = getenv("SSC_CO2_PROPERTY_TABLES");
+			use = (env != 0 && atoi(env) != 0) ? 1 : 0;
+			s_use_tables = use;
+		}
+		return use == 1;
+	}
+
+	const C_CO2_property_table & get_table(int vars)
+	{
+		if( vars < 0 || vars >= C_CO2_property_table::E_n_vars )
+			vars = C_CO2_property_table::E_TP;
+
+		std::call_once(s_is_built[vars], [vars]()
+		{
+			s_tables[vars].init(C_CO2_property_table::default_par(vars));
+		});
+
+		return s_tables[vars];
+	}
+
+	void build_tables()
+	{
+		for( int vars = 0; vars < C_CO2_property_table::E_n_vars; vars++ )
+			get_table(vars);
+	}
+};
+
+int CO2_PH_table(double P, double H, CO2_state * state)
+{
+	if( !N_co2_property_tables::use_tables() )
+		return CO2_PH(P, H, state);
+
+	return N_co2_property_tables::get_table(C_CO2_property_table::E_PH).get_state(P, H, state);
+}
+
+int CO2_PS_table(double P, double S, CO2_state * state)
+{
+	if( !N_co2_property_tables::use_tables() )
+		return CO2_PS(P, S, state);
+
+	return N_co2_property_tables::get_table(C_CO2_property_table::E_PS).get_state(P, S, state);
+}
+
+int CO2_TP_table(double T, double P, CO2_state * state)
+{
+	if( !N_co2_property_tables::use_tables() )
+		return CO2_TP(T, P, state);
+
+	return N_co2_property_tables::get_table(C_CO2_property_table::E_TP).get_state(T, P, state);
+}
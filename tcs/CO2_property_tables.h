@@ -0,0 +1,163 @@
+/*******************************************************************************************************
+*  Copyright 2017 Alliance for Sustainable Energy, LLC
+*
+*  NOTICE: This software was developed at least in part by Alliance for Sustainable Energy, LLC
+*  (Alliance) under Contract No. DE-AC36-08GO28308 with the U.S. Department of Energy and the U.S.
+*  The Government retains for itself and others acting on its behalf a nonexclusive, paid-up,
+*  irrevocable worldwide license in the software to reproduce, prepare derivative works, distribute
+*  copies to the public, perform publicly and display publicly, and to permit others to do so.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted
+*  provided that the following conditions are met:
+*
+*  1. Redistributions of source code must retain the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer.
+*
+*  2. Redistributions in binary form must reproduce the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer in the documentation and/or
+*  other materials provided with the distribution.
+*
+*  3. The entire corresponding source code of any redistribution, with or without modification, by a
+*  research entity, including but not limited to any contracting manager/operator of a United States
+*  National Laboratory, any institution of higher learning, and any non-profit organization, must be
+*  made publicly available under this license for as long as the redistribution is made available by
+*  the research entity.
+*
+*  4. Redistribution of this software, without modification, must refer to the software by the same
+*  designation. Redistribution of a modified version of this software (i) may not refer to the modified
+*  version by the same designation, or by any confusingly similar designation, and (ii) must refer to
+*  the underlying software originally provided by Alliance as System Advisor Model or SAM. Except
+*  to comply with the foregoing, the terms System Advisor Model, SAM, or any confusingly similar
+*  designation may not be used to refer to any modified version of this software or any modified
+*  version of the underlying software originally provided by Alliance without the prior written consent
+*  of Alliance.
+*
+*  5. The name of the copyright holder, contributors, the United States Government, the United States
+*  Department of Energy, or any of their employees may not be used to endorse or promote products
+*  derived from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+*  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER,
+*  CONTRIBUTORS, UNITED STATES GOVERNMENT OR UNITED STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR
+*  EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+*  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+*  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+*  THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************************************/
+
+#ifndef __CO2_PROPERTY_TABLES_
+#define __CO2_PROPERTY_TABLES_
+
+#include "CO2_properties.h"
+#include <vector>
+
+// Tabulated CO2 properties for the property calls that the CO2 fit can only evaluate by iteration (see note 1 in CO2_properties.h).
+// A table stores T, D, h, s, cv, cp and ssnd at the nodes of a uniform grid in two independent variables and interpolates them
+// with a bicubic (Catmull-Rom) surface, so a lookup is index arithmetic and a weighted sum over the surrounding 4x4 nodes.
+// When the table is built, the surface is compared with the exact routines at the center and edge midpoints of every cell.
+// Cells that miss the tolerances, or whose nodes are two-phase, on both sides of the saturation dome, or outside the fit,
+// are flagged, and calls in those cells or outside the grid use the exact routines. This is what bounds the error near the
+// critical point: the cells there that cannot meet the tolerances are not interpolated.
+// A table is not modified after 'init', so one table can be used by any number of threads
+class C_CO2_property_table
+{
+public:
+	enum E_independent_vars
+	{
+		E_PH = 0,	// x = pressure [kPa], y = enthalpy [kJ/kg]
+		E_PS,		// x = pressure [kPa], y = entropy [kJ/kg-K]
+		E_TP,		// x = temperature [K], y = pressure [kPa]
+		E_n_vars
+	};
+
+	struct S_table_par
+	{
+		int m_vars;				//[-] E_independent_vars
+		double m_x_min;			// Grid limits, units of the independent variables
+		double m_x_max;
+		int m_n_x;				//[-] Number of nodes
+		double m_y_min;
+		double m_y_max;
+		int m_n_y;
+		double m_tol;			//[-] Relative error allowed in T, D, h and s
+		double m_tol_derived;	//[-] Relative error allowed in cv, cp and ssnd
+
+		S_table_par()
+		{
+			m_vars = E_PH;
+			m_x_min = m_x_max = m_y_min = m_y_max = 0.0;
+			m_n_x = m_n_y = 0;
+			m_tol = 1.E-5;
+			m_tol_derived = 1.E-3;
+		}
+	};
+
+	C_CO2_property_table();
+
+	// Grid covering the sCO2 cycle models: 2 - 40 MPa, and 275 - 1200 K or the matching enthalpies and entropies
+	static S_table_par default_par(int vars);
+
+	// Returns false if the grid is invalid
+	bool init(const S_table_par & par);
+
+	// Same error codes and state as CO2_PH, CO2_PS and CO2_TP, with (x, y) in the order of the table's E_independent_vars
+	int get_state(double x, double y, CO2_state * state) const;
+
+	// Partial derivatives of temperature [K] and density [kg/m3] with respect to x and y, consistent with 'get_state':
+	//   derivatives of the interpolating surface in tabulated cells, otherwise of the fit at the exact state
+	int get_derivatives(double x, double y, double & dT_dx, double & dT_dy, double & dD_dx, double & dD_dy) const;
+
+	bool is_init() const { return m_n_x > 3 && m_n_y > 3; }
+	double get_max_error() const { return m_max_error; }					//[-] Largest relative error in T, D, h or s at the check points of tabulated cells
+	double get_max_error_derived() const { return m_max_error_derived; }	//[-] Same for cv, cp and ssnd
+	double get_tabulated_fraction() const { return m_tabulated_fraction; }	//[-] Fraction of cells that are interpolated
+
+private:
+	enum { C_T, C_D, C_H, C_S, C_CV, C_CP, C_SSND, C_n_cols };
+
+	int m_vars;
+	double m_x_min;
+	double m_y_min;
+	double m_dx;
+	double m_dy;
+	double m_inv_dx;
+	double m_inv_dy;
+	int m_n_x;
+	int m_n_y;
+
+	std::vector<double> m_values;			// C_n_cols values per node, nodes in x-major order
+	std::vector<unsigned char> m_is_cell_tabulated;	// (n_x - 1)*(n_y - 1) cells, x-major
+
+	double m_max_error;
+	double m_max_error_derived;
+	double m_tabulated_fraction;
+
+	int exact_state(double x, double y, CO2_state * state) const;
+	bool find_cell(double x, double y, int & i, int & j, double & fx, double & fy) const;
+	void interpolate(int i, int j, double fx, double fy, double * v) const;
+	void set_state(double x, double y, const double * v, CO2_state * state) const;
+};
+
+// Shared tables used by CO2_PH_table, CO2_PS_table and CO2_TP_table. These functions call the exact routines unless the
+// tables are enabled with 'set_use_tables' or by setting the environment variable SSC_CO2_PROPERTY_TABLES to 1.
+// Each table is built with the default grid on its first use, once per process even if several threads ask for it at the
+// same time; the other threads wait for the build. Building runs the exact routines at every node and check point, up to about
+// a second per table, so callers that care about the latency of the first call should call 'build_tables' up front
+namespace N_co2_property_tables
+{
+	void set_use_tables(bool use_tables);
+	bool use_tables();
+
+	// Builds any of the tables that are not built yet
+	void build_tables();
+
+	const C_CO2_property_table & get_table(int vars);
+};
+
+int CO2_PH_table( double P, double H, CO2_state * state );
+int CO2_PS_table( double P, double S, CO2_state * state );
+int CO2_TP_table( double T, double P, CO2_state * state );
+
+#endif
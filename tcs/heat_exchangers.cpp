@@ -48,6 +48,7 @@
 *******************************************************************************************************/
 
 #include "heat_exchangers.h"
+#include "CO2_property_tables.h"
 #include "csp_solver_util.h"
 #include "sam_csp_util.h"
 #include <algorithm>
@@ -65,7 +66,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_PH(P_h_in, h_h_in, &ms_co2_props);
+		prop_error_code = CO2_PH_table(P_h_in, h_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -93,7 +94,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_PH(P_c_in, h_c_in, &ms_co2_props);
+		prop_error_code = CO2_PH_table(P_c_in, h_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -123,7 +124,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_h_in, P_c_out, &ms_co2_props);
+		prop_error_code = CO2_TP_table(T_h_in, P_c_out, &ms_co2_props);
 		if (prop_error_code == 205)
 		{
 			prop_error_code = CO2_TQ(T_h_in, 0.0, &ms_co2_props);
@@ -163,7 +164,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_c_in, P_h_out, &ms_co2_props);
+		prop_error_code = CO2_TP_table(T_c_in, P_h_out, &ms_co2_props);
 		if (prop_error_code == 205)
 		{
 			prop_error_code = CO2_TQ(T_c_in, 1.0, &ms_co2_props);
@@ -213,7 +214,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot(int hot_fl_code /*-*/, HTFPropertie
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_c_in, P_c_in, &ms_co2_props);
+		prop_error_code = CO2_TP_table(T_c_in, P_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::calc_max_q_dot",
@@ -241,7 +242,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot(int hot_fl_code /*-*/, HTFPropertie
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_h_in, P_h_in, &ms_co2_props);
+		prop_error_code = CO2_TP_table(T_h_in, P_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::calc_max_q_dot",
@@ -331,7 +332,7 @@ void NS_HX_counterflow_eqs::calc_req_UA(int hot_fl_code /*-*/, HTFProperties & h
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_c_in, P_c_in, &ms_co2_props);
+		prop_error_code = CO2_TP_table(T_c_in, P_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -358,7 +359,7 @@ void NS_HX_counterflow_eqs::calc_req_UA(int hot_fl_code /*-*/, HTFProperties & h
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_h_in, P_h_in, &ms_co2_props);
+		prop_error_code = CO2_TP_table(T_h_in, P_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -465,7 +466,7 @@ void NS_HX_counterflow_eqs::calc_req_UA_enth(int hot_fl_code /*-*/, HTFPropertie
 		double T_h = std::numeric_limits<double>::quiet_NaN();
 		if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 		{
-			prop_error_code = CO2_PH(P_h, h_h, &ms_co2_props);
+			prop_error_code = CO2_PH_table(P_h, h_h, &ms_co2_props);
 			if (prop_error_code != 0)
 			{
 				throw(C_csp_exception("C_HX_counterflow::design",
@@ -491,7 +492,7 @@ void NS_HX_counterflow_eqs::calc_req_UA_enth(int hot_fl_code /*-*/, HTFPropertie
 		double T_c = std::numeric_limits<double>::quiet_NaN();
 		if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 		{
-			prop_error_code = CO2_PH(P_c, h_c, &ms_co2_props);
+			prop_error_code = CO2_PH_table(P_c, h_c, &ms_co2_props);
 			if (prop_error_code != 0)
 			{
 				throw(C_csp_exception("C_HX_counterflow::design",
@@ -814,7 +815,7 @@ void NS_HX_counterflow_eqs::solve_q_dot_for_fixed_UA(int hot_fl_code /*-*/, HTFP
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_c_in, P_c_in, &ms_co2_props);
+		prop_error_code = CO2_TP_table(T_c_in, P_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -841,7 +842,7 @@ void NS_HX_counterflow_eqs::solve_q_dot_for_fixed_UA(int hot_fl_code /*-*/, HTFP
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_h_in, P_h_in, &ms_co2_props);
+		prop_error_code = CO2_TP_table(T_h_in, P_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -1386,9 +1387,9 @@ bool C_CO2_to_air_cooler::design_hx(S_des_par_ind des_par_ind, S_des_par_cycle_d
 		mu_air, v_air, cp_air, k_air, Pr_air);
 
 	// Calculate the required heat rejection
-	CO2_TP(ms_des_par_cycle_dep.m_T_hot_in_des, P_hot_ave, &mc_co2_props);
+	CO2_TP_table(ms_des_par_cycle_dep.m_T_hot_in_des, P_hot_ave, &mc_co2_props);
 	double h_in_des = mc_co2_props.enth*1000.0;					//[J/kg]
-	CO2_TP(ms_des_par_cycle_dep.m_T_hot_out_des, P_hot_ave, &mc_co2_props);
+	CO2_TP_table(ms_des_par_cycle_dep.m_T_hot_out_des, P_hot_ave, &mc_co2_props);
 	double h_out_des = mc_co2_props.enth*1000.0;				//[J/kg]
 
 	if (ms_des_par_cycle_dep.m_m_dot_total > 0.0)
@@ -1417,7 +1418,7 @@ bool C_CO2_to_air_cooler::design_hx(S_des_par_ind des_par_ind, S_des_par_cycle_d
 	// ** Try to get better guess by estimating length required to hit pressure drop **
 	// ********************************************************************************
 	double T_co2_deltaP_eval = 0.75*ms_des_par_cycle_dep.m_T_hot_in_des + 0.25*ms_des_par_cycle_dep.m_T_hot_out_des;
-	CO2_TP(T_co2_deltaP_eval, ms_des_par_cycle_dep.m_P_hot_in_des, &mc_co2_props);
+	CO2_TP_table(T_co2_deltaP_eval, ms_des_par_cycle_dep.m_P_hot_in_des, &mc_co2_props);
 	double visc_dyn_co2_g = CO2_visc(mc_co2_props.dens, mc_co2_props.temp)*1.E-6;
 
 	// Just try hitting a "reasonable" Reynolds number?
@@ -1530,7 +1531,7 @@ int C_CO2_to_air_cooler::C_MEQ_node_energy_balance__T_co2_out::operator()(double
 
 	double T_co2_ave = 0.5*(T_co2_hot_in + m_T_co2_cold_out);		//[K]
 
-	int co2_prop_error = CO2_TP(T_co2_ave, m_P_co2_ave, mpc_co2_props);
+	int co2_prop_error = CO2_TP_table(T_co2_ave, m_P_co2_ave, mpc_co2_props);
 	if (co2_prop_error != 0)
 	{
 		return -2;
@@ -1856,7 +1857,7 @@ int C_CO2_to_air_cooler::C_MEQ_target_T_hot__width_parallel::operator()(double W
 	// ********************************************************************************
 	// ** Try to estimate length required to hit pressure drop **
 	// ********************************************************************************
-	CO2_TP(m_T_co2_deltaP_eval, m_P_hot_ave, &mpc_ac->mc_co2_props);
+	CO2_TP_table(m_T_co2_deltaP_eval, m_P_hot_ave, &mpc_ac->mc_co2_props);
 	double visc_dyn_co2_g = CO2_visc(mpc_ac->mc_co2_props.dens, mpc_ac->mc_co2_props.temp)*1.E-6;
 	double Re_co2_g = m_dot_tube*mpc_ac->ms_hx_des_sol.m_d_in / (mpc_ac->m_A_cs*visc_dyn_co2_g);
 
@@ -2230,9 +2231,9 @@ void C_CO2_to_air_cooler::off_design_hx(double T_amb_K, double P_amb_Pa, double
 
 	// Calculate the required heat rejection
 	CO2_state co2_props;
-	CO2_TP(T_hot_in, P_hot_in, &co2_props);			// Assumes no pressure drop...
+	CO2_TP_table(T_hot_in, P_hot_in, &co2_props);			// Assumes no pressure drop...
 	double h_in = co2_props.enth*1000.0;					//[J/kg]
-	CO2_TP(T_hot_out, P_hot_in, &co2_props);
+	CO2_TP_table(T_hot_out, P_hot_in, &co2_props);
 	double h_out = co2_props.enth*1000.0;					//[J/kg]
 	double Q_dot = m_dot_hot*(h_in - h_out);				//[W]
 	//double deltaT_hot = T_hot_in - T_hot_out;				//[K,C] Hot side temperature difference
@@ -2432,7 +2433,7 @@ void C_CO2_to_air_cooler::off_design_hx(double T_amb_K, double P_amb_Pa, double
 					double T_out_ave = 0.5*(T_out_guess + T_co2((size_t)in, j));
 
 					// Check this error?
-					int co2_prop_error = CO2_TP(T_out_ave, P_hot_in, &co2_props);
+					int co2_prop_error = CO2_TP_table(T_out_ave, P_hot_in, &co2_props);
 					double cp_co2_ave = co2_props.cp*1000.0;
 
 					// Capacitance rates
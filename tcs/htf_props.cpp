@@ -57,6 +57,10 @@ HTFProperties::HTFProperties()
 	uf_err_msg = "The user-defined htf property table is invalid (rows=%d cols=%d)";
 
 	m_is_temp_enth_avail = false;
+
+	m_is_fast_avail = m_is_fast_dens = m_is_fast_temp = m_is_fast_cubic = false;
+	m_n_fast_points = 0;
+	m_T_fast_low = m_T_fast_high = m_H_fast_low = m_H_fast_high = std::numeric_limits<double>::quiet_NaN();
 }
 
 bool HTFProperties::SetUserDefinedFluid(const util::matrix_t<double> &table, bool calc_temp_enth_table)
@@ -97,6 +101,11 @@ bool HTFProperties::SetUserDefinedFluid( const util::matrix_t<double> &table )
 		set_temp_enth_lookup();
 	}
 
+	if( m_is_fast_avail )
+	{
+		set_fast_lookup();
+	}
+
 	return true;
 }
 
@@ -108,53 +117,41 @@ void HTFProperties::set_temp_enth_lookup()
 	double delta_T_target = 1.0;
 
 	int n_rows = (int)(ceil((T_high - T_low)/delta_T_target) + 1.0);
-	double delta_T = (T_high - T_low)/double(n_rows-1);
 
-	util::matrix_t<double> table(n_rows, 2);
+	// Temperatures are uniformly spaced, so both lookups find their interval without a search
+	mc_temp_enth_lookup.Set_Uniform_Grid(T_low, T_high, n_rows, 1);
+
+	// Integrate the correlations, not the optional fast lookup tables
+	bool is_fast_avail = m_is_fast_avail;
+	m_is_fast_avail = false;
 
 	double T, T_next, cp, h, h_next;
 	T_next = T_low;
 	h_next = 0.0;	// specific heat[kJ / kg - K]
-	table(0, 0) = T_next;		//[K]
-	table(0, 1) = h_next;		//[kJ/kg-K]
+	mc_temp_enth_lookup.set_value(0, 0, h_next);		//[kJ/kg-K]
 	for(int i = 0; i<n_rows-1; i++)
 	{
 		h = h_next;
 		T = T_next;
 
-		T_next = T + delta_T;
+		T_next = mc_temp_enth_lookup.get_x_value(i+1);
 	
 		cp = Cp(0.5*(T+T_next));	// specific heat[kJ / kg - K]
 
-		h_next = h + cp*delta_T;
-
-		table(i+1,0) = T_next;		//[K]
-		table(i+1,1) = h_next;		//[kJ/kg-K]
-	}
+		h_next = h + cp*(T_next - T);
 
-	// Specific which columns are used as the independent variable; these must be monotonically increasing
-	int ind_var_index[2] = {0, 1};
-	int n_ind_var = 2;
-	int error_index = -99;
-	if( !mc_temp_enth_lookup.Set_1D_Lookup_Table(table,ind_var_index,n_ind_var,error_index) )
-	{
-		if(error_index == -1)
-		{
-			throw(C_csp_exception("Interpolation table must have at least 3 rows (rows=%d cols=%d)", 
-				"HTFProperties::set_temp_enth_lookup"));
-		}
-		if(error_index == 0)
-		{
-			throw(C_csp_exception("Temperature must monotonically increase (rows=%d cols=%d)",
-				"HTFProperties::set_temp_enth_lookup"));
-		}
-		if(error_index == 1)
+		// Check that the enthalpy (the independent variable in 'temp_lookup') is monotonically increasing
+		if( h_next < h )
 		{
+			m_is_fast_avail = is_fast_avail;
 			throw(C_csp_exception("Enthalpy must monotonically increase (rows=%d cols=%d)",
 				"HTFProperties::set_temp_enth_lookup"));
 		}
+
+		mc_temp_enth_lookup.set_value(i+1, 0, h_next);		//[kJ/kg-K]
 	}
 
+	m_is_fast_avail = is_fast_avail;
 }
 
 double HTFProperties::temp_lookup( double enth /*kJ/kg*/)
@@ -166,7 +163,7 @@ double HTFProperties::temp_lookup( double enth /*kJ/kg*/)
 		throw(C_csp_exception("The enth-temp-lookup method is only available if fluid is set with optional Boolean to enable it"));
 	}
 
-	return mc_temp_enth_lookup.linear_1D_interp(1, 0, enth);	//[K]
+	return mc_temp_enth_lookup.inverse_linear_interp(0, enth);	//[K]
 }
 
 double HTFProperties::enth_lookup( double temp /*K*/)
@@ -178,7 +175,7 @@ double HTFProperties::enth_lookup( double temp /*K*/)
 		throw(C_csp_exception("This enth-temp-lookup method is only available if fluid is set with optional Boolean to enable it"));
 	}
 
-	return mc_temp_enth_lookup.linear_1D_interp(0, 1, temp);	//[kJ/kg]
+	return mc_temp_enth_lookup.linear_interp(0, temp);	//[kJ/kg]
 }
 
 bool HTFProperties::SetFluid( int fluid, bool calc_temp_enth_table)
@@ -198,6 +195,11 @@ bool HTFProperties::SetFluid( int fluid )
 		set_temp_enth_lookup();
 	}
 
+	if( m_is_fast_avail )
+	{
+		set_fast_lookup();
+	}
+
 	return true;
 }
 
@@ -211,6 +213,67 @@ bool HTFProperties::equals(HTFProperties *comp_class)
 	return m_userTable.equals(	(*comp_class->get_prop_table()) );
 }
 
+bool HTFProperties::SetFastLookup(double T_low_K, double T_high_K, int n_points, bool is_cubic)
+{
+	if( !(T_low_K > 0.0 && T_high_K > T_low_K) || n_points < 4 )
+	{
+		ClearFastLookup();
+		return false;
+	}
+
+	m_T_fast_low = T_low_K;
+	m_T_fast_high = T_high_K;
+	m_n_fast_points = n_points;
+	m_is_fast_cubic = is_cubic;
+
+	set_fast_lookup();
+
+	return true;
+}
+
+void HTFProperties::ClearFastLookup()
+{
+	m_is_fast_avail = m_is_fast_dens = m_is_fast_temp = false;
+}
+
+void HTFProperties::set_fast_lookup()
+{
+	// Evaluate the correlations, not a previous table
+	m_is_fast_avail = false;
+
+	mc_fast_props.Set_Uniform_Grid(m_T_fast_low, m_T_fast_high, m_n_fast_points, C_fast_n_cols);
+	for( int i = 0; i < m_n_fast_points; i++ )
+	{
+		double T_K = mc_fast_props.get_x_value(i);
+		mc_fast_props.set_value(i, C_fast_cp, Cp(T_K));
+		mc_fast_props.set_value(i, C_fast_dens, dens(T_K, 1.E5));
+		mc_fast_props.set_value(i, C_fast_visc, visc(T_K));
+		mc_fast_props.set_value(i, C_fast_cond, cond(T_K));
+		mc_fast_props.set_value(i, C_fast_enth, enth(T_K));
+	}
+
+	// Gas densities are functions of pressure
+	m_is_fast_dens = !(m_fluid == Air || m_fluid == Argon_ideal || m_fluid == Hydrogen_ideal);
+
+	// Temperature is tabulated over the enthalpy range of the temperature grid, if the fluid has one
+	m_H_fast_low = enth(m_T_fast_low);
+	m_H_fast_high = enth(m_T_fast_high);
+	m_is_fast_temp = m_H_fast_high > m_H_fast_low && std::isfinite(m_H_fast_high) && std::isfinite(m_H_fast_low);
+	if( m_is_fast_temp )
+	{
+		mc_fast_temp.Set_Uniform_Grid(m_H_fast_low, m_H_fast_high, m_n_fast_points, 1);
+		for( int i = 0; i < m_n_fast_points; i++ )
+			mc_fast_temp.set_value(i, 0, temp(mc_fast_temp.get_x_value(i)));
+	}
+
+	m_is_fast_avail = true;
+}
+
+double HTFProperties::fast_lookup(const Uniform_Grid_Interp &grid, int col, double x)
+{
+	return m_is_fast_cubic ? grid.cubic_interp(col, x) : grid.linear_interp(col, x);
+}
+
 double HTFProperties::Cp_ave(double T_cold_K, double T_hot_K, int n_points)
 {
 	// Check that temperatures are at least positive values
@@ -253,6 +316,9 @@ double HTFProperties::Cp( double T_K )
 
 	double T_C = T_K - 273.15;		// Also provide temperature in C
 
+	if( m_is_fast_avail && T_K >= m_T_fast_low && T_K <= m_T_fast_high )
+		return fast_lookup(mc_fast_props, C_fast_cp, T_K);
+
 	switch(m_fluid)
 	{
 	case Air: 
@@ -332,6 +398,9 @@ double HTFProperties::dens(double T_K, double P)
 
 	double T_C = T_K - 273.15;		// This function accepts as inputs temperature[K]. Convert to [C] for correlations
 
+	if( m_is_fast_dens && m_is_fast_avail && T_K >= m_T_fast_low && T_K <= m_T_fast_high )
+		return fast_lookup(mc_fast_props, C_fast_dens, T_K);
+
 	switch(m_fluid)
 	{
 		case Air:
@@ -410,6 +479,9 @@ double HTFProperties::visc(double T_K)
 
 	double T_C = T_K - 273.15;		// This function accepts as inputs temperature[K]. Convert to [C] for correlations
 
+	if( m_is_fast_avail && T_K >= m_T_fast_low && T_K <= m_T_fast_high )
+		return fast_lookup(mc_fast_props, C_fast_visc, T_K);
+
 	switch(m_fluid)
 	{
 	case Air:
@@ -497,6 +569,9 @@ double HTFProperties::cond(double T_K)
 
 	double T_C = T_K - 273.15;
 
+	if( m_is_fast_avail && T_K >= m_T_fast_low && T_K <= m_T_fast_high )
+		return fast_lookup(mc_fast_props, C_fast_cond, T_K);
+
 	switch(m_fluid)
 	{
 	case Air:
@@ -573,6 +648,9 @@ double HTFProperties::temp(double H)
 
 	double H_kJ;
 
+	if( m_is_fast_temp && m_is_fast_avail && H >= m_H_fast_low && H <= m_H_fast_high )
+		return fast_lookup(mc_fast_temp, 0, H);
+
 	switch(m_fluid)
 	{
 	case Nitrate_Salt:
@@ -615,6 +693,9 @@ double HTFProperties::enth(double T_K)
 
 	double T_C = T_K - 273.15;
 
+	if( m_is_fast_avail && T_K >= m_T_fast_low && T_K <= m_T_fast_high )
+		return fast_lookup(mc_fast_props, C_fast_enth, T_K);
+
 	switch(m_fluid)
 	{
 	case Nitrate_Salt:
@@ -131,6 +131,14 @@ public:
 	//               rather than at the range's midpoint
 	double Cp_ave(double T_cold_K, double T_hot_K, int n_points);
 
+	// Optional tables of Cp, dens, visc, cond and enth on a uniform temperature grid from T_low_K to T_high_K,
+	//   and of temp on a uniform enthalpy grid over the same range. Inside the range the properties are interpolated
+	//   (linear, or cubic if 'is_cubic') instead of evaluated from the correlations or the user table.
+	//   Density is only tabulated for fluids where it does not depend on pressure. The tables follow later calls to SetFluid
+	bool SetFastLookup(double T_low_K, double T_high_K, int n_points, bool is_cubic);
+	void ClearFastLookup();
+	bool IsFastLookup() { return m_is_fast_avail; }
+
 	const util::matrix_t<double> *get_prop_table();
 	//bool equals(const util::matrix_t<double> *comp_table);
 	bool equals(HTFProperties *comp_class);
@@ -140,10 +148,25 @@ private:
 
 	Linear_Interp User_Defined_Props;		// Define interpolation class in case user defined propeties are required
 
-	Linear_Interp mc_temp_enth_lookup;		// Enthalpy-temperature relationship, populated by pre-processor: 'set_temp_enth_lookup' 
+	Uniform_Grid_Interp mc_temp_enth_lookup;		// Enthalpy-temperature relationship, populated by pre-processor: 'set_temp_enth_lookup' 
 	void set_temp_enth_lookup();
 	bool m_is_temp_enth_avail;
 
+	enum { C_fast_cp, C_fast_dens, C_fast_visc, C_fast_cond, C_fast_enth, C_fast_n_cols };
+	Uniform_Grid_Interp mc_fast_props;		// Properties vs. temperature [K], populated by 'set_fast_lookup'
+	Uniform_Grid_Interp mc_fast_temp;		// Temperature [K] vs. enthalpy [J/kg]
+	void set_fast_lookup();
+	double fast_lookup(const Uniform_Grid_Interp &grid, int col, double x);
+	bool m_is_fast_avail;
+	bool m_is_fast_dens;
+	bool m_is_fast_temp;
+	bool m_is_fast_cubic;
+	int m_n_fast_points;
+	double m_T_fast_low;		//[K]
+	double m_T_fast_high;		//[K]
+	double m_H_fast_low;		//[J/kg]
+	double m_H_fast_high;		//[J/kg]
+
 	int m_fluid;	// Store fluid number as member integer
 	util::matrix_t<double> m_userTable;	// User table of properties
 
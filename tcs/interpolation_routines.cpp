@@ -329,6 +329,109 @@ double Bilinear_Interp::bilinear_2D_interp( double x, double y )
 	
 }
 
+Uniform_Grid_Interp::Uniform_Grid_Interp()
+{
+	m_x_min = m_x_max = m_dx = m_inv_dx = 0.0;
+	m_nx = m_ny = 0;
+}
+
+bool Uniform_Grid_Interp::Set_Uniform_Grid( double x_min, double x_max, int nx, int ny )
+{
+	if( nx < 2 || ny < 1 || !(x_max > x_min) )
+	{
+		m_nx = 0;
+		return false;
+	}
+
+	m_x_min = x_min;
+	m_x_max = x_max;
+	m_nx = nx;
+	m_ny = ny;
+	m_dx = (x_max - x_min) / double(nx - 1);
+	m_inv_dx = 1.0 / m_dx;
+	m_values.assign(nx*ny, 0.0);
+
+	return true;
+}
+
+int Uniform_Grid_Interp::interval( double x, double & frac ) const
+{
+	// Row at the start of the interval containing x, clamped to the end intervals
+	double s = (x - m_x_min)*m_inv_dx;
+	int j;
+	if( !(s > 0.0) )
+		j = 0;
+	else if( s >= double(m_nx - 2) )
+		j = m_nx - 2;
+	else
+		j = (int)s;
+
+	frac = s - j;
+	return j;
+}
+
+double Uniform_Grid_Interp::linear_interp( int y_col, double x ) const
+{
+	double frac;
+	int j = interval( x, frac );
+	const double *y = &m_values[j*m_ny + y_col];
+
+	return y[0] + frac*(y[m_ny] - y[0]);
+}
+
+double Uniform_Grid_Interp::cubic_interp( int y_col, double x ) const
+{
+	double frac;
+	int j = interval( x, frac );
+	if( m_nx < 4 || !(frac >= 0.0 && frac <= 1.0) )
+		return linear_interp( y_col, x );
+
+	const double *y = &m_values[j*m_ny + y_col];
+	if( j == 0 || j == m_nx - 2 )
+	{
+		// Quadratic through the three rows at the end of the grid
+		if( j == m_nx - 2 )
+		{
+			y -= m_ny;
+			frac += 1.0;
+		}
+		return y[0] + frac*(y[m_ny] - y[0]) + 0.5*frac*(frac - 1.0)*(y[2*m_ny] - 2.0*y[m_ny] + y[0]);
+	}
+
+	double p0 = y[-m_ny];
+	double p1 = y[0];
+	double p2 = y[m_ny];
+	double p3 = y[2*m_ny];
+
+	return p1 + 0.5*frac*(p2 - p0 + frac*(2.0*p0 - 5.0*p1 + 4.0*p2 - p3 + frac*(3.0*(p1 - p2) + p3 - p0)));
+}
+
+double Uniform_Grid_Interp::inverse_linear_interp( int y_col, double y ) const
+{
+	// Start from the row given by the end-to-end slope and walk to the bracketing interval,
+	// which for a nearly linear column is the starting row or its neighbour
+	double y_first = m_values[y_col];
+	double y_last = m_values[(m_nx - 1)*m_ny + y_col];
+	double s = (y - y_first) / (y_last - y_first)*(m_nx - 1);
+	int j;
+	if( !(s > 0.0) )
+		j = 0;
+	else if( s >= double(m_nx - 2) )
+		j = m_nx - 2;
+	else
+		j = (int)s;
+
+	while( j > 0 && y < m_values[j*m_ny + y_col] )
+		j--;
+	while( j < m_nx - 2 && y >= m_values[(j + 1)*m_ny + y_col] )
+		j++;
+
+	double y_j = m_values[j*m_ny + y_col];
+	double y_j1 = m_values[(j + 1)*m_ny + y_col];
+
+	return get_x_value(j) + (y - y_j) / (y_j1 - y_j)*m_dx;
+}
+
 bool Bilinear_Interp::Set_2D_Lookup_Table( const util::matrix_t<double> &table )
 {
 	// Initialize class member data
@@ -95,6 +95,41 @@ private:
 
 };
 
+class Uniform_Grid_Interp
+{
+// Columns of values tabulated at nx uniformly spaced x values from x_min to x_max. The bracketing
+// row is found by index arithmetic instead of a search, and lookups do not change the object.
+// Outside the grid, values are extrapolated linearly from the end intervals as in Linear_Interp
+public:
+	Uniform_Grid_Interp();
+
+	bool Set_Uniform_Grid( double x_min, double x_max, int nx, int ny );
+	void set_value( int i_x, int y_col, double y ){ m_values[i_x*m_ny + y_col] = y; };
+	double get_x_value( int i_x ) const { return m_x_min + i_x*m_dx; };
+
+	double linear_interp( int y_col, double x ) const;
+	// Catmull-Rom cubic through the two rows on either side of x, quadratic in the end intervals
+	double cubic_interp( int y_col, double x ) const;
+	// x at which a monotonically increasing column reaches y, linear between rows
+	double inverse_linear_interp( int y_col, double y ) const;
+
+	bool is_set() const { return m_nx > 1; };
+	double get_min_x() const { return m_x_min; };
+	double get_max_x() const { return m_x_max; };
+	int get_number_of_rows() const { return m_nx; };
+
+private:
+	int interval( double x, double & frac ) const;
+
+	double m_x_min;
+	double m_x_max;
+	double m_dx;
+	double m_inv_dx;
+	int m_nx;
+	int m_ny;
+	std::vector<double> m_values;	// nx rows by ny columns, row major
+};
+
 class Bilinear_Interp
 {
 // 3 columns by X rows
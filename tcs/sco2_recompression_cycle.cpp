@@ -53,6 +53,7 @@
 #include "sco2_cycle_components.h"
 
 #include "CO2_properties.h"
+#include "CO2_property_tables.h"
 #include <limits>
 #include <algorithm>
 
@@ -2060,7 +2061,7 @@ void C_RecompCycle::design_core_standard(int & error_code)
 
 	// State 5 can now be fully defined
 	m_enth_last[HTR_HP_OUT] = m_enth_last[MIXER_OUT] + Q_dot_HT / m_dot_t;						// Energy balance on cold stream of high-temp recuperator
-	int prop_error_code = CO2_PH(m_pres_last[HTR_HP_OUT], m_enth_last[HTR_HP_OUT], &co2_props);
+	int prop_error_code = CO2_PH_table(m_pres_last[HTR_HP_OUT], m_enth_last[HTR_HP_OUT], &co2_props);
 	if( prop_error_code != 0 )
 	{
 		error_code = prop_error_code;
@@ -2145,7 +2146,7 @@ int C_RecompCycle::C_mono_eq_LTR_des::operator()(double T_LTR_LP_out /*K*/, doub
 	else
 	{
 		m_w_rc = 0.0;		// no recompressor
-		int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_last[LTR_LP_OUT], mpc_rc_cycle->m_pres_last[LTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
+		int prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_last[LTR_LP_OUT], mpc_rc_cycle->m_pres_last[LTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
 		if( prop_error_code != 0 )
 		{
 			*diff_T_LTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -2197,7 +2198,7 @@ int C_RecompCycle::C_mono_eq_HTR_des::operator()(double T_HTR_LP_out /*K*/, doub
 
 	mpc_rc_cycle->m_temp_last[HTR_LP_OUT] = T_HTR_LP_out;		//[K]	
 
-	int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_last[HTR_LP_OUT], mpc_rc_cycle->m_pres_last[HTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
+	int prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_last[HTR_LP_OUT], mpc_rc_cycle->m_pres_last[HTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -2244,7 +2245,7 @@ int C_RecompCycle::C_mono_eq_HTR_des::operator()(double T_HTR_LP_out /*K*/, doub
 	// Know LTR performance so we can calculate the HP outlet
 		// Energy balance on LTR HP stream
 	mpc_rc_cycle->m_enth_last[LTR_HP_OUT] = mpc_rc_cycle->m_enth_last[MC_OUT] + m_Q_dot_LT/ m_m_dot_mc;		//[kJ/kg]
-	prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_last[LTR_HP_OUT], mpc_rc_cycle->m_enth_last[LTR_HP_OUT], &mpc_rc_cycle->mc_co2_props);
+	prop_error_code = CO2_PH_table(mpc_rc_cycle->m_pres_last[LTR_HP_OUT], mpc_rc_cycle->m_enth_last[LTR_HP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -2258,7 +2259,7 @@ int C_RecompCycle::C_mono_eq_HTR_des::operator()(double T_HTR_LP_out /*K*/, doub
 	if( mpc_rc_cycle->ms_des_par.m_recomp_frac >= 1.E-12 )
 	{
 		mpc_rc_cycle->m_enth_last[MIXER_OUT] = (1.0 - mpc_rc_cycle->ms_des_par.m_recomp_frac)*mpc_rc_cycle->m_enth_last[LTR_HP_OUT] + mpc_rc_cycle->ms_des_par.m_recomp_frac*mpc_rc_cycle->m_enth_last[RC_OUT];	//[kJ/kg]
-		prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_last[MIXER_OUT], mpc_rc_cycle->m_enth_last[MIXER_OUT], &mpc_rc_cycle->mc_co2_props);
+		prop_error_code = CO2_PH_table(mpc_rc_cycle->m_pres_last[MIXER_OUT], mpc_rc_cycle->m_enth_last[MIXER_OUT], &mpc_rc_cycle->mc_co2_props);
 		if( prop_error_code != 0 )
 		{
 			*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3604,7 +3605,7 @@ int C_RecompCycle::C_mono_eq_LTR_od::operator()(double T_LTR_LP_out_guess /*K*/,
 
 	mpc_rc_cycle->m_temp_od[LTR_LP_OUT] = T_LTR_LP_out_guess;		//[K]
 
-	int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[LTR_LP_OUT], mpc_rc_cycle->m_pres_od[LTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
+	int prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_od[LTR_LP_OUT], mpc_rc_cycle->m_pres_od[LTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_LTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3627,7 +3628,7 @@ int C_RecompCycle::C_mono_eq_LTR_od::operator()(double T_LTR_LP_out_guess /*K*/,
 		}
 
 		// Fully define state 10
-		prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[RC_OUT], mpc_rc_cycle->m_pres_od[RC_OUT], &mpc_rc_cycle->mc_co2_props);
+		prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_od[RC_OUT], mpc_rc_cycle->m_pres_od[RC_OUT], &mpc_rc_cycle->mc_co2_props);
 		if( prop_error_code != 0 )
 		{
 			*diff_T_LTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3672,7 +3673,7 @@ int C_RecompCycle::C_mono_eq_HTR_od::operator()(double T_HTR_LP_out_guess /*K*/,
 
 	mpc_rc_cycle->m_temp_od[HTR_LP_OUT] = T_HTR_LP_out_guess;	//[K]
 
-	int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[HTR_LP_OUT],mpc_rc_cycle->m_pres_od[HTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
+	int prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_od[HTR_LP_OUT],mpc_rc_cycle->m_pres_od[HTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3720,7 +3721,7 @@ int C_RecompCycle::C_mono_eq_HTR_od::operator()(double T_HTR_LP_out_guess /*K*/,
 
 	// Now, calculate State 3
 	mpc_rc_cycle->m_enth_od[LTR_HP_OUT] = mpc_rc_cycle->m_enth_od[MC_OUT] + m_Q_dot_LTR / m_m_dot_mc;		//[kJ/kg] Energy balance on HP stream of LTR
-	prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_od[LTR_HP_OUT], mpc_rc_cycle->m_enth_od[LTR_HP_OUT], &mpc_rc_cycle->mc_co2_props);
+	prop_error_code = CO2_PH_table(mpc_rc_cycle->m_pres_od[LTR_HP_OUT], mpc_rc_cycle->m_enth_od[LTR_HP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3736,7 +3737,7 @@ int C_RecompCycle::C_mono_eq_HTR_od::operator()(double T_HTR_LP_out_guess /*K*/,
 		// Conservation of energy
 		mpc_rc_cycle->m_enth_od[MIXER_OUT] = (1.0 - mpc_rc_cycle->ms_od_phi_par.m_recomp_frac)*mpc_rc_cycle->m_enth_od[LTR_HP_OUT] +
 												mpc_rc_cycle->ms_od_phi_par.m_recomp_frac*mpc_rc_cycle->m_enth_od[RC_OUT];
-		prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_od[MIXER_OUT], mpc_rc_cycle->m_enth_od[MIXER_OUT], &mpc_rc_cycle->mc_co2_props);
+		prop_error_code = CO2_PH_table(mpc_rc_cycle->m_pres_od[MIXER_OUT], mpc_rc_cycle->m_enth_od[MIXER_OUT], &mpc_rc_cycle->mc_co2_props);
 		if( prop_error_code != 0 )
 		{
 			*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3887,7 +3888,7 @@ int C_RecompCycle::C_mono_eq_turbo_N_fixed_m_dot::operator()(double m_dot_t_in /
 	mpc_rc_cycle->m_temp_od[C_RecompCycle::MC_OUT] = T_mc_out;	//[K]
 
 	// Calculate main compressor power
-	int prop_err_code = CO2_TP(T_mc_out, P_mc_out, &mc_co2_props);
+	int prop_err_code = CO2_TP_table(T_mc_out, P_mc_out, &mc_co2_props);
 
 	// Calculate scaled pressure drops through heat exchangers
 		// LTR
@@ -4009,7 +4010,7 @@ int C_RecompCycle::C_mono_eq_x_f_recomp_y_N_rc::operator()(double f_recomp /*-*/
 	m_m_dot_mc = m_m_dot_t - m_m_dot_rc;
 
 	// Fully define known states
-	int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[MC_IN], mpc_rc_cycle->m_pres_od[MC_IN], &mc_co2_props);
+	int prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_od[MC_IN], mpc_rc_cycle->m_pres_od[MC_IN], &mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		return prop_error_code;
@@ -4018,7 +4019,7 @@ int C_RecompCycle::C_mono_eq_x_f_recomp_y_N_rc::operator()(double f_recomp /*-*/
 	mpc_rc_cycle->m_entr_od[MC_IN] = mc_co2_props.entr;
 	mpc_rc_cycle->m_dens_od[MC_IN] = mc_co2_props.dens;
 
-	prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[MC_OUT], mpc_rc_cycle->m_pres_od[MC_OUT], &mc_co2_props);
+	prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_od[MC_OUT], mpc_rc_cycle->m_pres_od[MC_OUT], &mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		return prop_error_code;
@@ -4027,7 +4028,7 @@ int C_RecompCycle::C_mono_eq_x_f_recomp_y_N_rc::operator()(double f_recomp /*-*/
 	mpc_rc_cycle->m_entr_od[MC_OUT] = mc_co2_props.entr;
 	mpc_rc_cycle->m_dens_od[MC_OUT] = mc_co2_props.dens;
 
-	prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[TURB_IN], mpc_rc_cycle->m_pres_od[TURB_IN], &mc_co2_props);
+	prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_od[TURB_IN], mpc_rc_cycle->m_pres_od[TURB_IN], &mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		return prop_error_code;
@@ -4036,7 +4037,7 @@ int C_RecompCycle::C_mono_eq_x_f_recomp_y_N_rc::operator()(double f_recomp /*-*/
 	mpc_rc_cycle->m_entr_od[TURB_IN] = mc_co2_props.entr;
 	mpc_rc_cycle->m_dens_od[TURB_IN] = mc_co2_props.dens;
 
-	prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[TURB_OUT], mpc_rc_cycle->m_pres_od[TURB_OUT], &mc_co2_props);
+	prop_error_code = CO2_TP_table(mpc_rc_cycle->m_temp_od[TURB_OUT], mpc_rc_cycle->m_pres_od[TURB_OUT], &mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		return prop_error_code;
@@ -4081,7 +4082,7 @@ int C_RecompCycle::C_mono_eq_x_f_recomp_y_N_rc::operator()(double f_recomp /*-*/
 
 	// State 5 can now be fully defined
 	mpc_rc_cycle->m_enth_od[HTR_HP_OUT] = mpc_rc_cycle->m_enth_od[MIXER_OUT] + Q_dot_HTR / m_m_dot_t;		//[kJ/kg] Energy balance on cold stream of high-temp recuperator
-	prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_od[HTR_HP_OUT], mpc_rc_cycle->m_enth_od[HTR_HP_OUT], &mc_co2_props);
+	prop_error_code = CO2_PH_table(mpc_rc_cycle->m_pres_od[HTR_HP_OUT], mpc_rc_cycle->m_enth_od[HTR_HP_OUT], &mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		return prop_error_code;
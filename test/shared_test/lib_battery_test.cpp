@@ -1,5 +1,8 @@
+#include <chrono>
+#include <cmath>
 #include <gtest/gtest.h>
 #include <lib_battery.h>
+#include <lib_battery_dispatch.h>
 
 class BatteryProperties : public ::testing::Test
 {
@@ -165,4 +168,130 @@ TEST_F(LeadAcidBattery, LeadAcidCapacityUnitTest_lib_battery)
 	*/
 	
 
-}
\ No newline at end of file
+}
+
+
+/// Rainflow count on a stack of unmatched reversals, checked with the three-point rule after each new reversal
+static void rainflow_reference(std::vector<double> &peaks, double DOD, std::vector<double> &ranges)
+{
+	peaks.push_back(DOD);
+	while (peaks.size() >= 3)
+	{
+		size_t j = peaks.size() - 1;
+		double Y = fabs(peaks[j - 1] - peaks[j - 2]);
+		double X = fabs(peaks[j] - peaks[j - 1]);
+		if (X < Y)
+			break;
+		ranges.push_back(Y);
+		double save = peaks[j];
+		peaks.pop_back();
+		peaks.pop_back();
+		peaks.pop_back();
+		peaks.push_back(save);
+	}
+}
+
+/// Exposes the rainflow state of the cycle model
+class lifetime_cycle_probe : public lifetime_cycle_t
+{
+public:
+	lifetime_cycle_probe(const util::matrix_t<double> &cycles_vs_DOD) : lifetime_cycle_t(cycles_vs_DOD) {}
+	const std::vector<double> &peaks() { return _Peaks; }
+	double average_range() { return _average_range; }
+};
+
+TEST(LifetimeCycle, StreamingRainflowBenchmark_lib_battery)
+{
+	std::vector<double> table = { 20, 0, 100, 20, 5000, 80, 20, 10000, 60, 80, 0, 100, 80, 1000, 80, 80, 2000, 60 };
+	util::matrix_t<double> batt_lifetime_matrix(6, 3, &table);
+
+	// 25 years of 5-minute DOD: one daily cycle of varying depth with small dispatch reversals
+	size_t steps_per_day = 288;
+	size_t n = 25 * 365 * steps_per_day;
+	std::vector<double> DOD(n);
+	unsigned int seed = 12345;
+	double depth = 60;
+	for (size_t i = 0; i < n; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		double noise = ((seed >> 16) & 0x7fff) / 32768.0 - 0.5;
+		if (i % steps_per_day == 0)
+			depth = 40 + 50 * ((seed >> 8) & 0xff) / 255.0;
+		double phase = 2 * M_PI * (i % steps_per_day) / steps_per_day;
+		DOD[i] = fmax(0, fmin(100, 0.5 * depth * (1 - cos(phase)) + 2 * noise));
+	}
+
+	// reversals, passed to the cycle model as the battery does on a change of direction
+	std::vector<double> reversals;
+	reversals.push_back(DOD[0]);
+	for (size_t i = 1; i + 1 < n; i++)
+	{
+		if ((DOD[i] - DOD[i - 1]) * (DOD[i + 1] - DOD[i]) < 0)
+			reversals.push_back(DOD[i]);
+	}
+	ASSERT_EQ(reversals.size(), 1360556u);
+
+	// capacity after each fifth of the reversals until it reaches zero, from the cycle model before the streaming count
+	const double q_expected[3] = { 72.497529378911295, 44.409701492849415, 16.175639177202243 };
+	size_t fifth = reversals.size() / 5;
+
+	lifetime_cycle_t cycle_model(batt_lifetime_matrix);
+	std::vector<double> q;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < reversals.size(); i++)
+	{
+		double q_i = cycle_model.runCycleLifetime(reversals[i]);
+		if ((i + 1) % fifth == 0)
+			q.push_back(q_i);
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+	printf("rainflow: %d reversals, %d cycles in %.1f ms\n", (int)reversals.size(), cycle_model.cycles_elapsed(), elapsed_ms);
+
+	EXPECT_EQ(cycle_model.cycles_elapsed(), 680277);
+	for (size_t k = 0; k < 3; k++)
+		EXPECT_DOUBLE_EQ(q[k], q_expected[k]) << "after " << (k + 1) * fifth << " reversals";
+
+	// every range counted in a step, in order, through the running average range and the residue
+	lifetime_cycle_probe probe(batt_lifetime_matrix);
+	std::vector<double> peaks, ranges;
+	double average_range = 0;
+	size_t n_mismatch = 0;
+	for (size_t i = 0; i < reversals.size(); i++)
+	{
+		size_t n_counted = ranges.size();
+		rainflow_reference(peaks, reversals[i], ranges);
+		probe.runCycleLifetime(reversals[i]);
+		for (size_t k = n_counted; k < ranges.size(); k++)
+			average_range = (average_range * k + ranges[k]) / (k + 1);
+
+		bool match = (size_t)probe.cycles_elapsed() == ranges.size() && probe.average_range() == average_range
+			&& probe.peaks() == peaks && (ranges.size() == n_counted || probe.cycle_range() == ranges.back());
+		if (!match)
+			n_mismatch++;
+	}
+	EXPECT_EQ(n_mismatch, 0u);
+	EXPECT_EQ(ranges.size(), 680277u);
+	EXPECT_LT(peaks.size(), 64u);
+}
+
+TEST(DispatchLP, PriceArbitrage_lib_battery_dispatch)
+{
+	// four hourly steps, buy low and sell high with a 10 kWh, 5 kW lossless battery starting empty
+	dispatch_lp_t lp(4, 1.0, 5, 5, 1, 1, 1);
+	double P_pv[4] = { 0, 0, 0, 0 };
+	double P_headroom[4] = { 100, 100, 100, 100 };
+	double price[4] = { 0.05, 0.05, 0.2, 0.2 };
+	double P_battery[4];
+
+	EXPECT_TRUE(lp.solve(P_pv, P_pv, P_headroom, price, price, 0., true, true, true, 10, 0, P_battery));
+	EXPECT_NEAR(P_battery[0], -5, 1e-6);
+	EXPECT_NEAR(P_battery[1], -5, 1e-6);
+	EXPECT_NEAR(P_battery[2], 5, 1e-6);
+	EXPECT_NEAR(P_battery[3], 5, 1e-6);
+
+	// without grid charging there is nothing to sell
+	EXPECT_TRUE(lp.solve(P_pv, P_pv, P_headroom, price, price, 0., true, true, false, 10, 0, P_battery));
+	for (size_t t = 0; t != 4; t++)
+		EXPECT_NEAR(P_battery[t], 0, 1e-6);
+}
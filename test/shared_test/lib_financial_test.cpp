@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <lib_financial.h>
+
+TEST(libFinancialTests, testCashflowNpv)
+{
+	// year 0 is excluded and payments are end of period
+	double line[4] = { -1000, 100, 100, 1100 };
+	double expected = 100 / 1.1 + 100 / (1.1*1.1) + 1100 / (1.1*1.1*1.1);
+	EXPECT_NEAR(libfin::cashflow_npv(line, 3, 0.1), expected, 1e-9);
+	EXPECT_NEAR(libfin::cashflow_npv(line, 3, 0.1) + line[0], 0, 1e-9);
+}
+
+TEST(libFinancialTests, testCashflowIrr)
+{
+	// bond at par returns its coupon
+	double bond[11] = { -1000, 80, 80, 80, 80, 80, 80, 80, 80, 80, 1080 };
+	EXPECT_NEAR(libfin::cashflow_irr(bond, 10), 0.08, 1e-6);
+
+	// irr through an intermediate year only sees the first count years
+	double line[3] = { -100, 110, -50 };
+	EXPECT_NEAR(libfin::cashflow_irr(line, 1), 0.10, 1e-6);
+
+	// no sign change, no irr
+	double positive[3] = { 100, 10, 10 };
+	EXPECT_TRUE(std::isnan(libfin::cashflow_irr(positive, 2)));
+}
+
+TEST(libFinancialTests, testCashflowIrrStatus)
+{
+	int status = -1;
+
+	// high return far from the estimate from the first years
+	double fast[4] = { -100, 150, 10, 10 };
+	double r = libfin::cashflow_irr(fast, 3, -2, 1e-6, 100, &status);
+	EXPECT_EQ(status, libfin::IRR_SOLVED);
+	EXPECT_NEAR(libfin::cashflow_npv(fast, 3, r) + fast[0], 0, 1e-4);
+
+	// leading zero years do not change the irr
+	double deferred[4] = { 0, -1000, 0, 1210 };
+	EXPECT_NEAR(libfin::cashflow_irr(deferred, 3, -2, 1e-6, 100, &status), 0.10, 1e-6);
+	EXPECT_EQ(status, libfin::IRR_SOLVED);
+
+	double income[3] = { 0, 10, 10 };
+	EXPECT_TRUE(std::isnan(libfin::cashflow_irr(income, 2, -2, 1e-6, 100, &status)));
+	EXPECT_EQ(status, libfin::IRR_NO_INVESTMENT);
+
+	double loss[3] = { -100, 10, -10 };
+	EXPECT_TRUE(std::isnan(libfin::cashflow_irr(loss, 2, -2, 1e-6, 100, &status)));
+	EXPECT_EQ(status, libfin::IRR_NO_SOLUTION);
+}
+
+TEST(libFinancialTests, testIrrVector)
+{
+	std::vector<double> bond = { -1000, 80, 80, 80, 80, 80, 80, 80, 80, 80, 1080 };
+	EXPECT_NEAR(libfin::irr(1e-6, 100, bond, (int)bond.size()), 0.08, 1e-6);
+}
+
+TEST(libFinancialTests, testCashflowMinValue)
+{
+	// zeros are skipped and year 0 is ignored
+	double line[5] = { -5, 2, 0, 1.5, 3 };
+	EXPECT_DOUBLE_EQ(libfin::cashflow_min_value(line, 4), 1.5);
+
+	double nans[3] = { 0, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN() };
+	EXPECT_TRUE(std::isnan(libfin::cashflow_min_value(nans, 2)));
+}
@@ -332,3 +332,26 @@ TEST_F(sharedInverterTest, tempDerateTest3Curves_lib_shared_inverter) {
 	EXPECT_NEAR(eff, 0, e) << "curve 3 used with negative efficiency";
 	EXPECT_NEAR(loss, 100, e) << "curve 3 used with negative efficiency";
 }
+
+TEST_F(sharedInverterTest, batchMatchesSingleStep_lib_shared_inverter) {
+	plinv.Paco = 4000.;
+	plinv.Pdco = 4200.;
+	plinv.Vdco = 300.;
+	plinv.Pntare = 1.;
+	plinv.Partload = { 0., 10., 50., 100. };
+	plinv.Efficiency = { 0., 90., 96., 95. };
+	SharedInverter plShared(SharedInverter::PARTLOAD_INVERTER, 2, &sinv, &plinv);
+	plShared.setTempDerateCurves(c1, c2);
+
+	double Pdc[5] = { 0., 500., 3000., 8000., 9000. };
+	double Vdc[5] = { 0., 220., 280., 300., 320. };
+	double T[5] = { 10., 35., 45., 55., 60. };
+	double Pac[5], clip[5];
+	plShared.calculateACPower(Pdc, Vdc, T, 5, Pac, clip);
+
+	for (size_t i = 0; i < 5; i++) {
+		plShared.calculateACPower(Pdc[i], Vdc[i], T[i]);
+		EXPECT_NEAR(Pac[i], plShared.powerAC_kW, 1e-9) << "batch ac power " << i;
+		EXPECT_NEAR(clip[i], plShared.powerClipLoss_kW, 1e-9) << "batch clipping loss " << i;
+	}
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <lib_utility_rate.h>
+#include <core.h>
+
+#include "../input_cases/pvsamv1_common_data.h"
+
+class UtilityRateIncrementalTest : public ::testing::Test
+{
+protected:
+	UtilityRate * rate;
+	util::matrix_t<size_t> weekday, weekend;
+	util::matrix_t<double> ecRates, dcRates, dcFlat;
+
+	void SetUp()
+	{
+		// period 1 weekday afternoons, period 2 otherwise
+		weekday.resize_fill(12, 24, 2);
+		weekend.resize_fill(12, 24, 2);
+		for (size_t m = 0; m < 12; m++)
+			for (size_t h = 12; h < 18; h++)
+				weekday(m, h) = 1;
+
+		// period, tier, max usage, units, buy, sell
+		double ec[24] = { 1, 1, 100, 0, 0.30, 0.05,
+			1, 2, 1e38, 0, 0.40, 0.05,
+			2, 1, 100, 0, 0.10, 0.02,
+			2, 2, 1e38, 0, 0.12, 0.02 };
+		ecRates.assign(ec, 4, 6);
+
+		// period, tier, max kW, charge
+		double dc[16] = { 1, 1, 5, 10,
+			1, 2, 1e38, 12,
+			2, 1, 5, 2,
+			2, 2, 1e38, 3 };
+		dcRates.assign(dc, 4, 4);
+		dcFlat.resize(12, 4);
+		for (size_t m = 0; m < 12; m++)
+		{
+			dcFlat(m, 0) = (double)m;
+			dcFlat(m, 1) = 1;
+			dcFlat(m, 2) = 1e38;
+			dcFlat(m, 3) = 5;
+		}
+		rate = new UtilityRate(weekday, weekend, ecRates, weekday, weekend, dcRates, dcFlat);
+	}
+	void TearDown()
+	{
+		delete rate;
+	}
+};
+
+TEST_F(UtilityRateIncrementalTest, SingleStep)
+{
+	UtilityRateIncremental bill(rate, 1);
+	bill.setPower(12, 10);
+
+	// 10 kWh at 0.30, 10 kW TOU peak at 10 and 12 above 5 kW, 10 kW monthly peak at 5
+	EXPECT_NEAR(bill.getEnergyCharge(0), 3., 1e-9);
+	EXPECT_NEAR(bill.getDemandCharge(0), 160., 1e-9);
+	EXPECT_NEAR(bill.getBill(), 163., 1e-9);
+
+	// next tier above 100 kWh, export credited at the sell rate
+	bill.setPower(13, 100);
+	EXPECT_NEAR(bill.getEnergyCharge(0), 100 * 0.30 + 10 * 0.40, 1e-9);
+	bill.setPower(12, 0);
+	bill.setPower(13, 0);
+	bill.setPower(0, -4);
+	EXPECT_NEAR(bill.getBill(), -4 * 0.02, 1e-9);
+}
+
+TEST_F(UtilityRateIncrementalTest, MarginalCostsMatchRecalculation)
+{
+	UtilityRateIncremental bill(rate, 2);
+	std::vector<double> power(8760 * 2);
+	for (size_t i = 0; i < power.size(); i++)
+	{
+		power[i] = 3 + 2 * std::sin(i * 0.13) + std::cos(i * 0.0007);
+		bill.setPower(i, power[i]);
+	}
+	double base = bill.getBill();
+
+	size_t steps[4] = { 25, 5000, 5011, 17000 };
+	for (size_t k = 0; k < 4; k++)
+	{
+		size_t from = steps[k], to = steps[(k + 1) % 4];
+
+		double marginal = bill.marginalCost(from, 1.5);
+		double shift = bill.shiftCost(from, to, 2.);
+		EXPECT_NEAR(bill.getBill(), base, 1e-9) << "state restored";
+
+		UtilityRateIncremental check(rate, 2);
+		for (size_t i = 0; i < power.size(); i++)
+			check.setPower(i, power[i] + (i == from ? 1.5 : 0));
+		EXPECT_NEAR(marginal, check.getBill() - base, 1e-6);
+
+		check.setPower(from, power[from] - 4.);
+		check.setPower(to, power[to] + 4.);
+		EXPECT_NEAR(shift, check.getBill() - base, 1e-6);
+	}
+}
+
+TEST_F(UtilityRateIncrementalTest, BillMatchesUtilityRate5)
+{
+	// utilityrate5 translates weekend schedules from the second week on as weekdays, so both use the weekday schedule
+	UtilityRate weekdays(weekday, weekday, ecRates, weekday, weekday, dcRates, dcFlat);
+	std::vector<ssc_number_t> load(8760), gen(8760, 0);
+	UtilityRateIncremental bill(&weekdays, 1);
+	for (size_t i = 0; i < 8760; i++)
+	{
+		load[i] = (ssc_number_t)(3 + 2 * std::sin(i * 0.13) + std::cos(i * 0.0007));
+		bill.setPower(i, load[i]);
+	}
+
+	// the same tiered TOU energy rates with TOU and flat demand charges, no generation
+	std::vector<ssc_number_t> sched(288);
+	for (size_t m = 0; m < 12; m++)
+		for (size_t h = 0; h < 24; h++)
+			sched[m * 24 + h] = (ssc_number_t)weekday(m, h);
+	std::vector<ssc_number_t> ec_mat(ecRates.data(), ecRates.data() + ecRates.ncells());
+	std::vector<ssc_number_t> dc_mat(dcRates.data(), dcRates.data() + dcRates.ncells());
+	std::vector<ssc_number_t> dc_flat(dcFlat.data(), dcFlat.data() + dcFlat.ncells());
+
+	ssc_data_t data = ssc_data_create();
+	utility_rate5_default(data);
+	ssc_data_set_number(data, "analysis_period", 1);
+	ssc_data_set_number(data, "system_use_lifetime_output", 0);
+	ssc_data_set_array(data, "load", &load[0], 8760);
+	ssc_data_set_array(data, "gen", &gen[0], 8760);
+	ssc_data_set_matrix(data, "ur_ec_sched_weekday", &sched[0], 12, 24);
+	ssc_data_set_matrix(data, "ur_ec_sched_weekend", &sched[0], 12, 24);
+	ssc_data_set_matrix(data, "ur_ec_tou_mat", &ec_mat[0], (int)ecRates.nrows(), (int)ecRates.ncols());
+	ssc_data_set_number(data, "ur_dc_enable", 1);
+	ssc_data_set_matrix(data, "ur_dc_sched_weekday", &sched[0], 12, 24);
+	ssc_data_set_matrix(data, "ur_dc_sched_weekend", &sched[0], 12, 24);
+	ssc_data_set_matrix(data, "ur_dc_tou_mat", &dc_mat[0], (int)dcRates.nrows(), (int)dcRates.ncols());
+	ssc_data_set_matrix(data, "ur_dc_flat_mat", &dc_flat[0], (int)dcFlat.nrows(), (int)dcFlat.ncols());
+	ASSERT_EQ(run_module(data, "utilityrate5"), 0);
+
+	int n;
+	ssc_number_t *ec = ssc_data_get_array(data, "year1_monthly_ec_charge_with_system", &n);
+	ASSERT_EQ(n, 12);
+	ssc_number_t *dc_fixed = ssc_data_get_array(data, "year1_monthly_dc_fixed_with_system", &n);
+	ssc_number_t *dc_tou = ssc_data_get_array(data, "year1_monthly_dc_tou_with_system", &n);
+	double annual = 0;
+	for (size_t m = 0; m < 12; m++)
+	{
+		EXPECT_NEAR(bill.getEnergyCharge(m), ec[m], 1e-3 * ec[m]) << "month " << m;
+		EXPECT_NEAR(bill.getDemandCharge(m), dc_fixed[m] + dc_tou[m], 1e-3 * (dc_fixed[m] + dc_tou[m])) << "month " << m;
+		annual += ec[m] + dc_fixed[m] + dc_tou[m];
+	}
+	EXPECT_NEAR(bill.getBill(), annual, 1e-3 * annual);
+	ssc_data_free(data);
+}
+
+TEST_F(UtilityRateIncrementalTest, MissingPeriodThrows)
+{
+	// period 3 in January afternoons has no rows in the energy table
+	util::matrix_t<size_t> bad(weekday);
+	bad(0, 14) = 3;
+	UtilityRate missing(bad, bad, ecRates, weekday, weekend, dcRates, dcFlat);
+	EXPECT_THROW(UtilityRateIncremental bill(&missing, 1), compute_module::general_error);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "sscapi.h"
+
+/// Datasheet values of a few CEC modules and one module with an impossible fill factor
+struct module_datasheet
+{
+	const char *celltype;
+	int tech;
+	ssc_number_t Vmp, Imp, Voc, Isc, alpha_isc, beta_voc, gamma_pmp, Nser;
+};
+
+static const module_datasheet modules[] = {
+	{ "monoSi",  0, 54.7f, 5.98f, 64.9f, 6.46f, 0.0026f, -0.1766f, -0.38f, 96 },
+	{ "multiSi", 1, 30.0f, 8.33f, 37.0f, 8.84f, 0.0052f, -0.123f,  -0.43f, 60 },
+	{ "monoSi",  0, 37.5f, 8.80f, 45.6f, 9.30f, 0.0047f, -0.140f,  -0.41f, 72 },
+	{ "monoSi",  0, 45.0f, 9.20f, 45.2f, 9.25f, 0.0047f, -0.140f,  -0.41f, 72 },
+};
+static const int nmod = sizeof(modules) / sizeof(modules[0]);
+static const int unsolvable = 3;
+
+/// Solve one module with the single module solver, returns false if it fails
+static bool solve_single(const module_datasheet &m, ssc_number_t coefs[6])
+{
+	ssc_data_t data = ssc_data_create();
+	ssc_data_set_string(data, "celltype", m.celltype);
+	ssc_data_set_number(data, "Vmp", m.Vmp);
+	ssc_data_set_number(data, "Imp", m.Imp);
+	ssc_data_set_number(data, "Voc", m.Voc);
+	ssc_data_set_number(data, "Isc", m.Isc);
+	ssc_data_set_number(data, "alpha_isc", m.alpha_isc);
+	ssc_data_set_number(data, "beta_voc", m.beta_voc);
+	ssc_data_set_number(data, "gamma_pmp", m.gamma_pmp);
+	ssc_data_set_number(data, "Nser", m.Nser);
+	ssc_data_set_number(data, "Tref", 25);
+
+	ssc_module_t mod = ssc_module_create("6parsolve");
+	bool ok = ssc_module_exec(mod, data) != 0;
+	ssc_module_free(mod);
+
+	const char *names[6] = { "a", "Il", "Io", "Rs", "Rsh", "Adj" };
+	for (int k = 0; ok && k < 6; k++)
+		ssc_data_get_number(data, names[k], &coefs[k]);
+	ssc_data_free(data);
+	return ok;
+}
+
+TEST(CM6parsolveBatch, MatchesSingleModuleSolves)
+{
+	ssc_number_t tech[nmod], Vmp[nmod], Imp[nmod], Voc[nmod], Isc[nmod], aIsc[nmod], bVoc[nmod], gPmp[nmod], Nser[nmod];
+	for (int i = 0; i < nmod; i++)
+	{
+		tech[i] = (ssc_number_t)modules[i].tech;
+		Vmp[i] = modules[i].Vmp;
+		Imp[i] = modules[i].Imp;
+		Voc[i] = modules[i].Voc;
+		Isc[i] = modules[i].Isc;
+		aIsc[i] = modules[i].alpha_isc;
+		bVoc[i] = modules[i].beta_voc;
+		gPmp[i] = modules[i].gamma_pmp;
+		Nser[i] = modules[i].Nser;
+	}
+	ssc_number_t Tref = 25;
+
+	ssc_data_t data = ssc_data_create();
+	ssc_data_set_array(data, "tech", tech, nmod);
+	ssc_data_set_array(data, "Vmp", Vmp, nmod);
+	ssc_data_set_array(data, "Imp", Imp, nmod);
+	ssc_data_set_array(data, "Voc", Voc, nmod);
+	ssc_data_set_array(data, "Isc", Isc, nmod);
+	ssc_data_set_array(data, "alpha_isc", aIsc, nmod);
+	ssc_data_set_array(data, "beta_voc", bVoc, nmod);
+	ssc_data_set_array(data, "gamma_pmp", gPmp, nmod);
+	ssc_data_set_array(data, "Nser", Nser, nmod);
+	ssc_data_set_array(data, "Tref", &Tref, 1);
+	ssc_data_set_number(data, "batch_threads", 2);
+
+	// a module that does not solve is reported in its row, the rest of the batch still runs
+	ssc_module_t mod = ssc_module_create("6parsolve_batch");
+	ASSERT_TRUE(ssc_module_exec(mod, data) != 0);
+	ssc_module_free(mod);
+
+	int nrows, ncols, nstatus;
+	ssc_number_t *coefs = ssc_data_get_matrix(data, "coefficients", &nrows, &ncols);
+	ssc_number_t *status = ssc_data_get_array(data, "status", &nstatus);
+	ASSERT_EQ(nrows, nmod);
+	ASSERT_EQ(ncols, 6);
+	ASSERT_EQ(nstatus, nmod);
+
+	for (int i = 0; i < nmod; i++)
+	{
+		ssc_number_t single[6];
+		bool solved = solve_single(modules[i], single);
+		if (i == unsolvable)
+		{
+			EXPECT_FALSE(solved);
+			EXPECT_LT(status[i], 0);
+			for (int k = 0; k < 6; k++)
+				EXPECT_TRUE(std::isnan(coefs[i * 6 + k])) << "module " << i << " coefficient " << k;
+			continue;
+		}
+
+		ASSERT_TRUE(solved) << "module " << i;
+		EXPECT_EQ(status[i], 0) << "module " << i;
+		for (int k = 0; k < 6; k++)
+			EXPECT_NEAR(coefs[i * 6 + k], single[k], 1e-4 * std::abs(single[k]) + 1e-12) << "module " << i << " coefficient " << k;
+	}
+	ssc_data_free(data);
+}
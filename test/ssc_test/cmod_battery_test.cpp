@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "../input_cases/pvsamv1_common_data.h"
+
+/// Residential battery inputs moved in front of the meter with manual dispatch and a clear sky like generation profile
+static void battery_sweep_default(ssc_data_t &data)
+{
+	pvsamv1_with_residential_default(data);
+	ssc_data_set_number(data, "en_batt", 1);
+	ssc_data_set_number(data, "batt_initial_SOC", 50);
+	ssc_data_set_number(data, "batt_dispatch_auto_can_gridcharge", 0);
+	ssc_data_set_number(data, "batt_dispatch_auto_can_charge", 1);
+	ssc_data_set_number(data, "batt_dispatch_auto_can_clipcharge", 1);
+	ssc_data_set_number(data, "batt_replacement_cost", 500);
+	ssc_data_set_number(data, "batt_meter_position", 1);
+	ssc_data_set_number(data, "batt_dispatch_choice", 4);
+	ssc_data_set_number(data, "batt_cycle_cost_choice", 0);
+	ssc_data_set_number(data, "batt_cycle_cost", 0);
+
+	std::vector<ssc_number_t> gen(8760, 0), forecast(8760, 0), tod_sched(288, 1);
+	for (size_t h = 0; h < 8760; h++)
+		gen[h] = (ssc_number_t)std::max(0., 4. * sin(((h % 24) - 6) / 12. * M_PI));
+	ssc_data_set_array(data, "gen", &gen[0], 8760);
+	ssc_data_set_array(data, "batt_pv_clipping_forecast", &forecast[0], 8760);
+	ssc_data_set_array(data, "batt_pv_dc_forecast", &forecast[0], 8760);
+
+	ssc_number_t tod_factors[9] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+	ssc_data_set_number(data, "ppa_price_input", 0.1);
+	ssc_data_set_array(data, "dispatch_tod_factors", tod_factors, 9);
+	ssc_data_set_matrix(data, "dispatch_sched_weekday", &tod_sched[0], 12, 24);
+	ssc_data_set_matrix(data, "dispatch_sched_weekend", &tod_sched[0], 12, 24);
+}
+
+TEST(CMBatterySweep, PointMatchesStandaloneBattery)
+{
+	ssc_data_t data = ssc_data_create();
+	battery_sweep_default(data);
+
+	ssc_number_t kwh, kw, dispatch;
+	ssc_data_get_number(data, "batt_computed_bank_capacity", &kwh);
+	ssc_data_get_number(data, "batt_power_discharge_max", &kw);
+	ssc_data_get_number(data, "batt_dispatch_choice", &dispatch);
+
+	// the first point has the size and dispatch of the standalone battery
+	ssc_number_t sweep_kwh[2] = { kwh, kwh / 2 };
+	ssc_number_t sweep_kw[2] = { kw, kw / 2 };
+	ssc_data_set_array(data, "sweep_batt_kwh", sweep_kwh, 2);
+	ssc_data_set_array(data, "sweep_batt_kw", sweep_kw, 2);
+	ssc_data_set_array(data, "sweep_batt_dispatch_choice", &dispatch, 1);
+	ssc_data_set_number(data, "sweep_threads", 2);
+	ASSERT_EQ(run_module(data, "battery_sweep"), 0);
+
+	int n, nrows, ncols;
+	ssc_number_t *capacity = ssc_data_get_array(data, "sweep_bank_capacity", &n);
+	ASSERT_EQ(n, 2);
+	EXPECT_NEAR(capacity[0], kwh, 1e-4);
+	EXPECT_NEAR(capacity[1], kwh / 2, 1e-4);
+	ssc_number_t cycles = ssc_data_get_array(data, "sweep_cycles", &n)[0];
+	ssc_number_t capacity_percent = ssc_data_get_array(data, "sweep_capacity_percent", &n)[0];
+	ssc_number_t efficiency = ssc_data_get_array(data, "sweep_roundtrip_efficiency", &n)[0];
+	ssc_number_t *discharge = ssc_data_get_matrix(data, "sweep_annual_discharge_energy", &nrows, &ncols);
+	ASSERT_EQ(nrows, 2);
+	ASSERT_EQ(ncols, 1);
+	ssc_number_t discharge0 = discharge[0];
+	EXPECT_GT(discharge0, 0);
+	ssc_data_free(data);
+
+	data = ssc_data_create();
+	battery_sweep_default(data);
+	ASSERT_EQ(run_module(data, "battery"), 0);
+
+	ssc_number_t *batt_cycles = ssc_data_get_array(data, "batt_cycles", &n);
+	ASSERT_EQ(n, 8760);
+	EXPECT_NEAR(cycles, batt_cycles[n - 1], 1e-6);
+	EXPECT_NEAR(capacity_percent, ssc_data_get_array(data, "batt_capacity_percent", &n)[n - 1], 1e-6);
+	ssc_number_t batt_efficiency;
+	ssc_data_get_number(data, "average_battery_roundtrip_efficiency", &batt_efficiency);
+	EXPECT_NEAR(efficiency, batt_efficiency, 1e-6);
+	EXPECT_NEAR(discharge0, ssc_data_get_array(data, "batt_annual_discharge_energy", &n)[0], 1e-3);
+	ssc_data_free(data);
+}
+
+/// Energy charges for the year from a utilityrate5 run with the given generation
+static double utilityrate5_energy_charges(ssc_data_t sweep_data, ssc_number_t *gen)
+{
+	ssc_data_t data = ssc_data_create();
+	utility_rate5_default(data);
+	int n, nrows, ncols;
+	ssc_number_t *load = ssc_data_get_array(sweep_data, "load", &n);
+	ssc_data_set_array(data, "load", load, n);
+	ssc_data_set_array(data, "gen", gen, 8760);
+	ssc_number_t *sched = ssc_data_get_matrix(sweep_data, "ur_ec_sched_weekday", &nrows, &ncols);
+	ssc_data_set_matrix(data, "ur_ec_sched_weekday", sched, nrows, ncols);
+	ssc_data_set_matrix(data, "ur_ec_sched_weekend", sched, nrows, ncols);
+	ssc_data_set_number(data, "ur_metering_option", 2);
+	ssc_data_set_number(data, "analysis_period", 1);
+	ssc_data_set_number(data, "system_use_lifetime_output", 0);
+	EXPECT_EQ(run_module(data, "utilityrate5"), 0);
+
+	double charges = 0;
+	ssc_number_t *ec = ssc_data_get_array(data, "year1_monthly_ec_charge_with_system", &n);
+	for (int m = 0; m < n; m++)
+		charges += ec[m];
+	ssc_data_free(data);
+	return charges;
+}
+
+TEST(CMBatterySweep, BehindTheMeterSavingsMatchUtilityRate5)
+{
+	// behind the meter peak shaving with the residential tariff, where the buy and sell rates are equal
+	// utilityrate5 translates weekend schedules from the second week on as weekdays, so both use the weekday schedule
+	ssc_data_t data = ssc_data_create();
+	battery_sweep_default(data);
+	utility_rate5_default(data);
+	int nrows, ncols;
+	ssc_number_t *sched = ssc_data_get_matrix(data, "ur_ec_sched_weekday", &nrows, &ncols);
+	ssc_data_set_matrix(data, "ur_ec_sched_weekend", sched, nrows, ncols);
+	set_array(data, "load", load_profile_path, 8760);
+	ssc_data_set_number(data, "batt_meter_position", 0);
+	ssc_data_set_number(data, "batt_dispatch_choice", 0);
+
+	ssc_number_t kwh, kw;
+	ssc_data_get_number(data, "batt_computed_bank_capacity", &kwh);
+	ssc_data_get_number(data, "batt_power_discharge_max", &kw);
+	ssc_data_set_array(data, "sweep_batt_kwh", &kwh, 1);
+	ssc_data_set_array(data, "sweep_batt_kw", &kw, 1);
+	ASSERT_EQ(run_module(data, "battery_sweep"), 0);
+	ssc_number_t *savings = ssc_data_get_matrix(data, "sweep_annual_savings", &nrows, &ncols);
+	ASSERT_EQ(nrows, 1);
+	ASSERT_EQ(ncols, 1);
+	double sweep_savings = savings[0];
+
+	int n;
+	std::vector<ssc_number_t> gen(8760);
+	ssc_number_t *p = ssc_data_get_array(data, "gen", &n);
+	ASSERT_EQ(n, 8760);
+	gen.assign(p, p + n);
+	ASSERT_EQ(run_module(data, "battery"), 0);
+	ssc_number_t *batt_gen = ssc_data_get_array(data, "gen", &n);
+	ASSERT_EQ(n, 8760);
+
+	double bill_savings = utilityrate5_energy_charges(data, &gen[0]) - utilityrate5_energy_charges(data, batt_gen);
+	EXPECT_GT(bill_savings, 0);
+	EXPECT_NEAR(sweep_savings, bill_savings, 1e-3 * std::abs(bill_savings) + 0.01);
+	ssc_data_free(data);
+}
@@ -282,7 +282,7 @@ TEST_F(CMPvsamv1PowerIntegration, NoFinancialModelSystemDesign)
 	std::vector<double> subarray2_track_mode = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 	std::vector<double> subarray3_track_mode = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 0, 0, 0, 0, 0 };
 	std::vector<double> subarray4_track_mode = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4 };
-	annual_energy_expected = { 167392, 176331, 183243, 166251, 175833, 183243, 171952, 178321, 183243, 171952, 178321, 183243, 183243, 183227, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 177310, 182927, 162456, 176883, 182902, 160961, 179014, 183024, 168431, 179014, 183024, 168431, 183243, 183243, 183243, 183243, 183243, 198796, 205187, 192695, 186088, 183243, 201501, 206750, 193370, 186290, 183243, 195419, 198925, 189995, 185277, 183243, 195419, 198925, 189995, 185277 };
+	annual_energy_expected = { 167392, 176331, 183243, 166251, 175833, 183243, 171952, 178321, 183243, 171952, 178321, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 183243, 177310, 182927, 162456, 176883, 182902, 160961, 179014, 183024, 168431, 179014, 183024, 168431, 183243, 183243, 183243, 183243, 183243, 198796, 205187, 192695, 186088, 183243, 201501, 206750, 193370, 186290, 183243, 195419, 198925, 189995, 185277, 183243, 195419, 198925, 189995, 185277 };
 
 	for (int i = 0; i != annual_energy_expected.size(); i++)
 	{
@@ -467,4 +467,58 @@ TEST_F(CMPvsamv1PowerIntegration, InvTempDerate) {
 
 	monthly_energy = ssc_data_get_array(data, "monthly_energy", nullptr)[11];
 	EXPECT_NEAR(monthly_energy, 740, 10) << "Month energy of December not reduced";
-}
\ No newline at end of file
+}
+
+/// Test PVSAMv1 lifetime simulation reusing year-one DC power with degradation applied
+TEST_F(CMPvsamv1PowerIntegration, LifetimeDCReuse) {
+	std::map<std::string, double> pairs;
+	pairs["system_use_lifetime_output"] = 1;
+	pairs["analysis_period"] = 3;
+
+	ssc_number_t dc_degradation[1] = { 0.5 };
+	ssc_data_set_array(data, "dc_degradation", dc_degradation, 1);
+
+	int pvsam_errors = modify_ssc_data_and_run_module(data, "pvsamv1", pairs);
+	EXPECT_FALSE(pvsam_errors);
+	if (!pvsam_errors) {
+		SetCalculated("annual_energy");
+		EXPECT_NEAR(calculated_value, 8714, m_error_tolerance_hi);
+
+		int n_dc = 0;
+		ssc_number_t * dc_net = ssc_data_get_array(data, "dc_net", &n_dc);
+		ASSERT_EQ(n_dc, 3 * 8760);
+		ssc_number_t * degrade_factor = ssc_data_get_array(data, "dc_degrade_factor", nullptr);
+		for (size_t i = 0; i < 8760; i += 73) {
+			EXPECT_NEAR(dc_net[8760 + i], dc_net[i] * degrade_factor[2], 1e-3) << "Year 2 DC power at " << i;
+			EXPECT_NEAR(dc_net[2 * 8760 + i], dc_net[i] * degrade_factor[3], 1e-3) << "Year 3 DC power at " << i;
+		}
+	}
+}
+
+/// Interpolated self-shading geometry for a one-axis tracker stays close to the exact calculation
+TEST_F(CMPvsamv1PowerIntegration, SelfShadingTrackerTiltStep) {
+	std::map<std::string, double> pairs;
+	pairs["subarray1_track_mode"] = 1;
+	pairs["subarray1_backtrack"] = 0;
+	pairs["subarray1_shade_mode"] = 1;
+	pairs["subarray1_mod_orient"] = 1;
+	pairs["subarray1_nmody"] = 1;
+	pairs["subarray1_nmodx"] = 6;
+	pairs["selfshading_tilt_step"] = 0;
+
+	int pvsam_errors = modify_ssc_data_and_run_module(data, "pvsamv1", pairs);
+	EXPECT_FALSE(pvsam_errors);
+	double annual_energy_exact = 0;
+	if (!pvsam_errors) {
+		SetCalculated("annual_energy");
+		annual_energy_exact = calculated_value;
+	}
+
+	pairs["selfshading_tilt_step"] = 1;
+	pvsam_errors = modify_ssc_data_and_run_module(data, "pvsamv1", pairs);
+	EXPECT_FALSE(pvsam_errors);
+	if (!pvsam_errors) {
+		SetCalculated("annual_energy");
+		EXPECT_NEAR(calculated_value, annual_energy_exact, m_error_tolerance_hi);
+	}
+}
@@ -37,4 +37,171 @@ TEST_F(CMPvwattsV5Integration, DefaultNoFinancialModel){
 	ssc_data_get_number(data, "capacity_factor", &capacity_factor);
 	EXPECT_NEAR(capacity_factor, 19.7197, error_tolerance) << "Capacity factor";
 
-}
\ No newline at end of file
+}
+
+/// Fleet simulation of several array types matches running pvwattsv5 for each system
+TEST_F(CMPvwattsV5Integration, FleetMatchesSingleSystems){
+	const size_t nsys = 5;
+	std::vector<double> annual_energy_single;
+	for (size_t i = 0; i < nsys; i++)
+	{
+		ssc_data_set_number(data, "array_type", (ssc_number_t)i);
+		compute();
+		ssc_number_t annual_energy;
+		ssc_data_get_number(data, "annual_energy", &annual_energy);
+		annual_energy_single.push_back(annual_energy);
+	}
+
+	ssc_data_t fleet = ssc_data_create();
+	ssc_data_set_string(fleet, "solar_resource_file", ssc_data_get_string(data, "solar_resource_file"));
+	ssc_number_t capacity[nsys] = { 4, 4, 4, 4, 4 };
+	ssc_number_t array_type[nsys] = { 0, 1, 2, 3, 4 };
+	ssc_number_t dc_ac_ratio = 1.2000000476837158;
+	ssc_number_t losses = 14.075660705566406;
+	ssc_number_t tilt = 20;
+	ssc_number_t azimuth = 180;
+	ssc_number_t gcr = 0.40000000596046448;
+	ssc_data_set_array(fleet, "system_capacity", capacity, nsys);
+	ssc_data_set_array(fleet, "array_type", array_type, nsys);
+	ssc_data_set_array(fleet, "dc_ac_ratio", &dc_ac_ratio, 1);
+	ssc_data_set_array(fleet, "losses", &losses, 1);
+	ssc_data_set_array(fleet, "tilt", &tilt, 1);
+	ssc_data_set_array(fleet, "azimuth", &azimuth, 1);
+	ssc_data_set_array(fleet, "gcr", &gcr, 1);
+	ssc_data_set_number(fleet, "fleet_threads", 2);
+
+	int errors = run_module(fleet, "pvwattsv5_fleet");
+	EXPECT_FALSE(errors);
+	if (!errors)
+	{
+		int nrows, ncols, n_annual;
+		ssc_data_get_matrix(fleet, "fleet_gen", &nrows, &ncols);
+		EXPECT_EQ(nrows, (int)nsys);
+		EXPECT_EQ(ncols, 8760);
+		ssc_number_t *annual_energy = ssc_data_get_array(fleet, "fleet_annual_energy", &n_annual);
+		for (size_t i = 0; i < nsys; i++)
+			EXPECT_NEAR(annual_energy[i], annual_energy_single[i], error_tolerance) << "Annual energy of system " << i;
+		ssc_data_free(fleet);
+	}
+}
+
+
+/// Streaming engine carries cell temperature between steps the same way as chaining pvwattsv5_1ts calls
+TEST(PvwattsStream, MatchesSingleTimestepModule){
+	const int nsites = 2;
+	ssc_number_t lat[nsites] = { 33.45f, 39.74f };
+	ssc_number_t lon[nsites] = { -111.98f, -105.18f };
+	ssc_number_t tz = -7;
+	ssc_number_t capacity = 4;
+	ssc_number_t losses = 14;
+	ssc_number_t array_type[nsites] = { 0, 2 };
+	ssc_number_t tilt = 20;
+	ssc_number_t azimuth = 180;
+
+	ssc_data_t sites = ssc_data_create();
+	ssc_data_set_array(sites, "lat", lat, nsites);
+	ssc_data_set_array(sites, "lon", lon, nsites);
+	ssc_data_set_array(sites, "tz", &tz, 1);
+	ssc_data_set_array(sites, "system_capacity", &capacity, 1);
+	ssc_data_set_array(sites, "losses", &losses, 1);
+	ssc_data_set_array(sites, "array_type", array_type, nsites);
+	ssc_data_set_array(sites, "tilt", &tilt, 1);
+	ssc_data_set_array(sites, "azimuth", &azimuth, 1);
+	ssc_pvwatts_stream_t stream = ssc_pvwatts_stream_create(sites, 1);
+	ssc_data_free(sites);
+	ASSERT_TRUE(stream != NULL);
+	EXPECT_TRUE(ssc_pvwatts_stream_error(stream) == NULL);
+	ASSERT_EQ(ssc_pvwatts_stream_nsites(stream), nsites);
+
+	ssc_number_t tcell_last[nsites] = { 20, 20 };
+	ssc_number_t poa_last[nsites] = { 0, 0 };
+	for (int i = 0; i < nsites; i++)
+		ssc_pvwatts_stream_set_state(stream, i, tcell_last[i], poa_last[i]);
+
+	ssc_number_t beam[] = { 100, 500, 800, 900, 850 };
+	ssc_number_t diffuse[] = { 50, 100, 120, 110, 115 };
+	for (int h = 0; h < 5; h++)
+	{
+		ssc_number_t b[nsites] = { beam[h], beam[h] };
+		ssc_number_t d[nsites] = { diffuse[h], diffuse[h] };
+		ssc_number_t tamb[nsites] = { 25, 25 };
+		ssc_number_t wspd[nsites] = { 2, 2 };
+		ssc_number_t dc[nsites], ac[nsites];
+		EXPECT_TRUE(ssc_pvwatts_stream_step(stream, 2017, 6, 21, 8 + h, 30, b, d, tamb, wspd, NULL, dc, ac) != 0);
+
+		for (int i = 0; i < nsites; i++)
+		{
+			ssc_data_t data = ssc_data_create();
+			ssc_data_set_number(data, "year", 2017);
+			ssc_data_set_number(data, "month", 6);
+			ssc_data_set_number(data, "day", 21);
+			ssc_data_set_number(data, "hour", (ssc_number_t)(8 + h));
+			ssc_data_set_number(data, "minute", 30);
+			ssc_data_set_number(data, "lat", lat[i]);
+			ssc_data_set_number(data, "lon", lon[i]);
+			ssc_data_set_number(data, "tz", tz);
+			ssc_data_set_number(data, "beam", beam[h]);
+			ssc_data_set_number(data, "diffuse", diffuse[h]);
+			ssc_data_set_number(data, "tamb", 25);
+			ssc_data_set_number(data, "wspd", 2);
+			ssc_data_set_number(data, "system_capacity", capacity);
+			ssc_data_set_number(data, "losses", losses);
+			ssc_data_set_number(data, "array_type", array_type[i]);
+			ssc_data_set_number(data, "tilt", tilt);
+			ssc_data_set_number(data, "azimuth", azimuth);
+			ssc_data_set_number(data, "tcell", tcell_last[i]);
+			ssc_data_set_number(data, "poa", poa_last[i]);
+			ASSERT_EQ(run_module(data, "pvwattsv5_1ts"), 0);
+
+			ssc_number_t ac_1ts;
+			ssc_data_get_number(data, "ac", &ac_1ts);
+			EXPECT_NEAR(ac[i], ac_1ts, 0.01) << "Site " << i << " hour " << h;
+			ssc_data_get_number(data, "tcell", &tcell_last[i]);
+			ssc_data_get_number(data, "poa", &poa_last[i]);
+			ssc_data_free(data);
+		}
+	}
+	ssc_pvwatts_stream_free(stream);
+}
+
+/// A failed site reports an error for that step only, and its state reads as ambient temperature with no irradiance
+TEST(PvwattsStream, ErrorClearedOnNextStep){
+	const int nsites = 2;
+	ssc_number_t lat = 33.45f, lon = -111.98f, tz = -7, capacity = 4, losses = 14, array_type = 0, tilt = 20, azimuth = 180;
+	ssc_data_t sites = ssc_data_create();
+	ssc_number_t lats[nsites] = { lat, lat };
+	ssc_data_set_array(sites, "lat", lats, nsites);
+	ssc_data_set_array(sites, "lon", &lon, 1);
+	ssc_data_set_array(sites, "tz", &tz, 1);
+	ssc_data_set_array(sites, "system_capacity", &capacity, 1);
+	ssc_data_set_array(sites, "losses", &losses, 1);
+	ssc_data_set_array(sites, "array_type", &array_type, 1);
+	ssc_data_set_array(sites, "tilt", &tilt, 1);
+	ssc_data_set_array(sites, "azimuth", &azimuth, 1);
+	ssc_pvwatts_stream_t stream = ssc_pvwatts_stream_create(sites, 1);
+	ssc_data_free(sites);
+	ASSERT_TRUE(stream != NULL);
+	ASSERT_TRUE(ssc_pvwatts_stream_error(stream) == NULL);
+
+	ssc_number_t diffuse[nsites] = { 100, 100 };
+	ssc_number_t tamb[nsites] = { 25, 25 };
+	ssc_number_t wspd[nsites] = { 2, 2 };
+	ssc_number_t dc[nsites], ac[nsites], tcell, poa;
+
+	// beam above the irradiance limit fails the second site only
+	ssc_number_t bad_beam[nsites] = { 800, 2000 };
+	EXPECT_EQ(ssc_pvwatts_stream_step(stream, 2017, 6, 21, 12, 30, bad_beam, diffuse, tamb, wspd, NULL, dc, ac), 0);
+	EXPECT_TRUE(ssc_pvwatts_stream_error(stream) != NULL);
+	EXPECT_GT(ac[0], 0);
+	EXPECT_EQ(dc[1], 0);
+	EXPECT_EQ(ac[1], 0);
+	ASSERT_TRUE(ssc_pvwatts_stream_get_state(stream, 1, &tcell, &poa) != 0);
+	EXPECT_EQ(tcell, tamb[1]);
+	EXPECT_EQ(poa, 0);
+
+	ssc_number_t beam[nsites] = { 800, 800 };
+	EXPECT_TRUE(ssc_pvwatts_stream_step(stream, 2017, 6, 21, 13, 30, beam, diffuse, tamb, wspd, NULL, dc, ac) != 0);
+	EXPECT_TRUE(ssc_pvwatts_stream_error(stream) == NULL);
+	EXPECT_GT(ac[1], 0);
+	ssc_pvwatts_stream_free(stream);
+}
@@ -0,0 +1,330 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <set>
+#include <sstream>
+
+#include "sscapi.h"
+#include "simulation_test_info.h"
+#include "../input_cases/code_generator_utilities.h"
+
+/// Single owner inputs of the physical trough default case
+extern TestInfo physTroughPPASingleDefaultInfo[];
+static const int physTroughPPASingleDefaultCount = 383;
+
+/// Assign the TestInfo values and a day-shaped generation profile in place of the trough output.
+/// The table predates the array form of the tax rates, so numbers go in as arrays where singleowner expects one.
+static void singleowner_default(ssc_data_t data)
+{
+	std::set<std::string> arrays;
+	ssc_module_t mod = ssc_module_create("singleowner");
+	for (int i = 0; ssc_info_t info = ssc_module_var_info(mod, i); i++)
+		if (ssc_info_data_type(info) == SSC_ARRAY)
+			arrays.insert(ssc_info_name(info));
+	ssc_module_free(mod);
+
+	for (int i = 0; i < physTroughPPASingleDefaultCount; i++)
+	{
+		const TestInfo &info = physTroughPPASingleDefaultInfo[i];
+		if (info.dataType == STR)
+			ssc_data_set_string(data, info.sscVarName.c_str(), info.values.c_str());
+		else if (info.dataType == NUM && arrays.count(info.sscVarName) == 0)
+			ssc_data_set_number(data, info.sscVarName.c_str(), (ssc_number_t)atof(info.values.c_str()));
+		else
+		{
+			std::vector<ssc_number_t> val(info.length * info.width, 0);
+			std::stringstream ss(info.values);
+			std::string substr;
+			for (size_t j = 0; j < val.size() && getline(ss, substr, ','); j++)
+				val[j] = (ssc_number_t)atof(substr.c_str());
+			if (info.dataType == MAT)
+				ssc_data_set_matrix(data, info.sscVarName.c_str(), &val[0], (int)info.length, (int)info.width);
+			else
+				ssc_data_set_array(data, info.sscVarName.c_str(), &val[0], (int)val.size());
+		}
+	}
+
+	std::vector<ssc_number_t> gen(8760);
+	for (size_t h = 0; h < 8760; h++)
+		gen[h] = (ssc_number_t)std::max(0., 100000. * sin(((h % 24) - 6) / 12. * M_PI));
+	ssc_data_set_array(data, "gen", &gen[0], 8760);
+	ssc_data_set_number(data, "system_capacity", 100000);
+}
+
+TEST(CMSingleOwnerSweep, ListsSingleOwnerInputs)
+{
+	// the sweep lists every singleowner input besides its own sweep_ inputs, and none of the outputs
+	std::set<std::string> sweep_inputs, singleowner_inputs;
+	ssc_module_t mod = ssc_module_create("singleowner_sweep");
+	for (int i = 0; ssc_info_t info = ssc_module_var_info(mod, i); i++)
+		if (ssc_info_var_type(info) != SSC_OUTPUT && std::string(ssc_info_name(info)).find("sweep_") != 0)
+			sweep_inputs.insert(ssc_info_name(info));
+	ssc_module_free(mod);
+
+	mod = ssc_module_create("singleowner");
+	for (int i = 0; ssc_info_t info = ssc_module_var_info(mod, i); i++)
+		if (ssc_info_var_type(info) != SSC_OUTPUT)
+			singleowner_inputs.insert(ssc_info_name(info));
+	ssc_module_free(mod);
+	EXPECT_TRUE(sweep_inputs == singleowner_inputs);
+
+	// a missing required input is reported before any point runs
+	ssc_data_t data = ssc_data_create();
+	singleowner_default(data);
+	ssc_data_unassign(data, "federal_tax_rate");
+	ssc_number_t cost = 3.0e8f;
+	ssc_data_set_array(data, "sweep_total_installed_cost", &cost, 1);
+	mod = ssc_module_create("singleowner_sweep");
+	EXPECT_EQ(ssc_module_exec(mod, data), 0);
+	ssc_module_free(mod);
+	ssc_data_free(data);
+}
+
+TEST(CMSingleOwnerSweep, PointsMatchSingleOwner)
+{
+	const int npoints = 3;
+	ssc_number_t installed_cost[npoints] = { 3.0e8f, 4.0e8f, 5.0e8f };
+	ssc_number_t itc_fed[npoints] = { 0, 30, 30 };
+
+	ssc_data_t data = ssc_data_create();
+	singleowner_default(data);
+	ssc_data_set_array(data, "sweep_total_installed_cost", installed_cost, npoints);
+	ssc_data_set_array(data, "sweep_itc_fed_percent", itc_fed, npoints);
+	ssc_data_set_number(data, "sweep_threads", 2);
+	ASSERT_EQ(run_module(data, "singleowner_sweep"), 0);
+
+	int n;
+	std::vector<ssc_number_t> ppa, npv, irr;
+	ssc_number_t *p = ssc_data_get_array(data, "sweep_ppa", &n);
+	ASSERT_EQ(n, npoints);
+	ppa.assign(p, p + n);
+	p = ssc_data_get_array(data, "sweep_project_return_aftertax_npv", &n);
+	npv.assign(p, p + n);
+	p = ssc_data_get_array(data, "sweep_project_return_aftertax_irr", &n);
+	irr.assign(p, p + n);
+	ssc_data_free(data);
+
+	for (int i = 0; i < npoints; i++)
+	{
+		data = ssc_data_create();
+		singleowner_default(data);
+		ssc_data_set_number(data, "total_installed_cost", installed_cost[i]);
+		ssc_data_set_number(data, "itc_fed_percent", itc_fed[i]);
+		ASSERT_EQ(run_module(data, "singleowner"), 0);
+
+		ssc_number_t value;
+		ssc_data_get_number(data, "ppa", &value);
+		EXPECT_NEAR(ppa[i], value, 1e-6 * std::abs(value)) << "point " << i;
+		ssc_data_get_number(data, "project_return_aftertax_npv", &value);
+		EXPECT_NEAR(npv[i], value, 1e-6 * std::abs(value) + 1e-3) << "point " << i;
+		ssc_data_get_number(data, "project_return_aftertax_irr", &value);
+		EXPECT_NEAR(irr[i], value, 1e-6 * std::abs(value)) << "point " << i;
+		ssc_data_free(data);
+	}
+
+	// each swept value changes the result
+	EXPECT_NE(ppa[0], ppa[1]);
+	EXPECT_NE(ppa[1], ppa[2]);
+}
+
+TEST(CMSingleOwner, PretaxIrrByYear)
+{
+	ssc_data_t data = ssc_data_create();
+	singleowner_default(data);
+	ASSERT_EQ(run_module(data, "singleowner"), 0);
+
+	int n, ncash;
+	ssc_number_t *irr = ssc_data_get_array(data, "cf_project_return_pretax_irr", &n);
+	ssc_number_t *cash = ssc_data_get_array(data, "cf_project_return_pretax", &ncash);
+	ASSERT_EQ(n, ncash);
+	ASSERT_GT(n, 11);
+
+	// years the chord solver used to leave as NaN, each a root of the cash flow through that year
+	double expected[9] = { -63.82521057, -50.69182587, -40.80962372, -33.32814789, -27.5668869,
+		-23.04685783, -19.43774223, -16.50995255, -14.10126877 };
+	for (int y = 3; y <= 11; y++)
+	{
+		EXPECT_NEAR(irr[y], expected[y - 3], 1e-4) << "year " << y;
+
+		double rate = irr[y] / 100.0, npv = 0, scale = 0;
+		for (int j = y; j >= 0; j--)
+		{
+			npv = npv / (1 + rate) + cash[j];
+			scale += std::abs(cash[j]);
+		}
+		EXPECT_NEAR(npv, 0, 1e-5 * scale) << "year " << y;
+	}
+	ssc_data_free(data);
+}
+
+static const char *dispatch_months[12] = { "jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec" };
+
+/// Use the same schedule on weekdays and weekends so that every period falls in every month
+static std::vector<int> dispatch_all_periods(ssc_data_t data)
+{
+	std::vector<ssc_number_t> sched(12 * 24);
+	for (int m = 0; m < 12; m++)
+		for (int h = 0; h < 24; h++)
+			sched[m * 24 + h] = (ssc_number_t)((m + h) % 9 + 1);
+	ssc_data_set_matrix(data, "dispatch_sched_weekday", &sched[0], 12, 24);
+	ssc_data_set_matrix(data, "dispatch_sched_weekend", &sched[0], 12, 24);
+
+	int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	std::vector<int> periods;
+	for (int m = 0; m < 12; m++)
+		for (int d = 0; d < days[m]; d++)
+			for (int h = 0; h < 24; h++)
+				periods.push_back((int)sched[m * 24 + h]);
+	return periods;
+}
+
+/// Bin each year of record energy by month and, when periods are given, by TOD period, and compare
+/// against the cash flow outputs. Revenue is energy times the record factor at the cash flow PPA price.
+static void expect_dispatch_bins(ssc_data_t data, const std::vector<std::vector<double>> &energy, const std::vector<int> &periods, const std::vector<double> &factor)
+{
+	int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	int n;
+	ssc_number_t *ppa = ssc_data_get_array(data, "cf_ppa_price", &n);
+	ASSERT_EQ(n, (int)energy.size() + 1);
+	std::vector<ssc_number_t> ppa_cf(ppa, ppa + n);
+
+	for (size_t y = 1; y <= energy.size(); y++)
+	{
+		const std::vector<double> &e = energy[y - 1];
+		size_t step_per_hour = e.size() / 8760;
+		double month_energy[12] = { 0 }, month_revenue[12] = { 0 }, period_energy[9] = { 0 };
+		size_t r = 0;
+		for (int m = 0; m < 12; m++)
+		{
+			for (size_t k = 0; k < (size_t)days[m] * 24 * step_per_hour; k++, r++)
+			{
+				month_energy[m] += e[r];
+				month_revenue[m] += e[r] * factor[r] * ppa_cf[y] / 100.0;
+				if (!periods.empty())
+					period_energy[periods[r / step_per_hour] - 1] += e[r];
+			}
+		}
+
+		for (int m = 0; m < 12; m++)
+		{
+			ssc_number_t *cf = ssc_data_get_array(data, (std::string("cf_energy_net_") + dispatch_months[m]).c_str(), &n);
+			ASSERT_TRUE(cf != 0);
+			EXPECT_NEAR(cf[y], month_energy[m], 1e-5 * month_energy[m]) << dispatch_months[m] << " year " << y;
+			cf = ssc_data_get_array(data, (std::string("cf_revenue_") + dispatch_months[m]).c_str(), &n);
+			ASSERT_TRUE(cf != 0);
+			EXPECT_NEAR(cf[y], month_revenue[m], 1e-5 * month_revenue[m]) << dispatch_months[m] << " year " << y;
+		}
+		for (int p = 0; p < 9 && !periods.empty(); p++)
+		{
+			ssc_number_t *cf = ssc_data_get_array(data, ("cf_energy_net_dispatch" + std::to_string(p + 1)).c_str(), &n);
+			ASSERT_TRUE(cf != 0);
+			EXPECT_NEAR(cf[y], period_energy[p], 1e-5 * period_energy[p]) << "period " << p + 1 << " year " << y;
+		}
+	}
+}
+
+TEST(CMSingleOwner, DispatchBinsHourly)
+{
+	ssc_data_t data = ssc_data_create();
+	singleowner_default(data);
+	std::vector<int> periods = dispatch_all_periods(data);
+	ssc_number_t degradation = 0.5;
+	ssc_data_set_array(data, "degradation", &degradation, 1);
+	ASSERT_EQ(run_module(data, "singleowner"), 0);
+
+	int n;
+	ssc_number_t *gen = ssc_data_get_array(data, "gen", &n);
+	std::vector<double> factor(8760);
+	for (size_t h = 0; h < 8760; h++)
+	{
+		ssc_number_t value;
+		ssc_data_get_number(data, ("dispatch_factor" + std::to_string(periods[h])).c_str(), &value);
+		factor[h] = value;
+	}
+	std::vector<std::vector<double>> energy(25, std::vector<double>(gen, gen + 8760));
+	for (size_t y = 0; y < energy.size(); y++)
+		for (size_t h = 0; h < 8760; h++)
+			energy[y][h] *= pow(1 - 0.005, (double)y);
+	expect_dispatch_bins(data, energy, periods, factor);
+
+	// values from the per month and per period binning before the single pass
+	ssc_number_t *cf = ssc_data_get_array(data, "cf_energy_net_jan", &n);
+	EXPECT_NEAR(cf[1], 36290324, 1e-6 * 36290324);
+	cf = ssc_data_get_array(data, "cf_revenue_jan", &n);
+	EXPECT_NEAR(cf[1], 4859452.5, 1e-6 * 4859452.5);
+	cf = ssc_data_get_array(data, "cf_energy_net_dispatch9", &n);
+	EXPECT_NEAR(cf[25], 37612420, 1e-6 * 37612420);
+	ssc_data_free(data);
+}
+
+TEST(CMSingleOwner, DispatchBinsTimestep)
+{
+	ssc_data_t data = ssc_data_create();
+	singleowner_default(data);
+	ssc_number_t degradation = 0.5;
+	ssc_data_set_array(data, "degradation", &degradation, 1);
+	ssc_data_set_number(data, "ppa_multiplier_model", 1);
+
+	// half hour gen and multipliers that change every record
+	std::vector<ssc_number_t> gen(17520), multipliers(17520);
+	for (size_t i = 0; i < gen.size(); i++)
+	{
+		gen[i] = (ssc_number_t)std::max(0., 100000. * sin(((i % 48) - 12) / 24. * M_PI));
+		multipliers[i] = (ssc_number_t)(0.5 + (i % 7) * 0.25);
+	}
+	ssc_data_set_array(data, "gen", &gen[0], (int)gen.size());
+	ssc_data_set_array(data, "dispatch_factors_ts", &multipliers[0], (int)multipliers.size());
+	ASSERT_EQ(run_module(data, "singleowner"), 0);
+
+	std::vector<std::vector<double>> energy(25, std::vector<double>(gen.size()));
+	for (size_t y = 0; y < energy.size(); y++)
+		for (size_t i = 0; i < gen.size(); i++)
+			energy[y][i] = gen[i] * 0.5 * pow(1 - 0.005, (double)y);
+	expect_dispatch_bins(data, energy, std::vector<int>(), std::vector<double>(multipliers.begin(), multipliers.end()));
+
+	// values from the per month binning before the single pass
+	int n;
+	ssc_number_t *cf = ssc_data_get_array(data, "cf_energy_net_jan", &n);
+	EXPECT_NEAR(cf[1], 40939516, 1e-6 * 40939516);
+	cf = ssc_data_get_array(data, "cf_revenue_dec", &n);
+	EXPECT_NEAR(cf[25], 5427375, 1e-6 * 5427375);
+	ssc_data_free(data);
+}
+
+TEST(CMSingleOwner, DispatchBinsLifetime)
+{
+	ssc_data_t data = ssc_data_create();
+	singleowner_default(data);
+	std::vector<int> periods = dispatch_all_periods(data);
+	ssc_data_set_number(data, "system_use_lifetime_output", 1);
+
+	// lifetime gen that falls off each year
+	int n;
+	ssc_number_t *gen1 = ssc_data_get_array(data, "gen", &n);
+	std::vector<ssc_number_t> gen(25 * 8760);
+	for (size_t y = 0; y < 25; y++)
+		for (size_t h = 0; h < 8760; h++)
+			gen[y * 8760 + h] = (ssc_number_t)(gen1[h] * (1 - 0.01 * y));
+	ssc_data_set_array(data, "gen", &gen[0], (int)gen.size());
+	ASSERT_EQ(run_module(data, "singleowner"), 0);
+
+	std::vector<double> factor(8760);
+	for (size_t h = 0; h < 8760; h++)
+	{
+		ssc_number_t value;
+		ssc_data_get_number(data, ("dispatch_factor" + std::to_string(periods[h])).c_str(), &value);
+		factor[h] = value;
+	}
+	std::vector<std::vector<double>> energy(25);
+	for (size_t y = 0; y < energy.size(); y++)
+		energy[y].assign(gen.begin() + y * 8760, gen.begin() + (y + 1) * 8760);
+	expect_dispatch_bins(data, energy, periods, factor);
+
+	// values from the per month and per period binning before the single pass
+	ssc_number_t *cf = ssc_data_get_array(data, "cf_energy_net_jul", &n);
+	EXPECT_NEAR(cf[25], 27580648, 1e-6 * 27580648);
+	cf = ssc_data_get_array(data, "cf_revenue_jul", &n);
+	EXPECT_NEAR(cf[25], 5126468, 1e-6 * 5126468);
+	cf = ssc_data_get_array(data, "cf_energy_net_dispatch1", &n);
+	EXPECT_NEAR(cf[1], 44616488, 1e-6 * 44616488);
+	ssc_data_free(data);
+}
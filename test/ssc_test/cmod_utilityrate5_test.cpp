@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "../input_cases/pvsamv1_common_data.h"
+
+/// Residential tariff with one of the customers and the shared generation profile
+static void utilityrate5_customer(ssc_data_t &data, const ssc_number_t *load, const ssc_number_t *gen)
+{
+	utility_rate5_default(data);
+	ssc_data_set_number(data, "analysis_period", 25);
+	ssc_data_set_number(data, "system_use_lifetime_output", 0);
+	ssc_data_set_array(data, "load", const_cast<ssc_number_t*>(load), 8760);
+	ssc_data_set_array(data, "gen", const_cast<ssc_number_t*>(gen), 8760);
+}
+
+TEST(CMUtilityRate5Batch, BillsMatchUtilityRate5)
+{
+	const int ncustomers = 3;
+	const double scale[ncustomers] = { 1., 2.5, 0.4 };
+
+	ssc_data_t profile = ssc_data_create();
+	set_array(profile, "load", load_profile_path, 8760);
+	int n;
+	ssc_number_t *residential = ssc_data_get_array(profile, "load", &n);
+	ASSERT_EQ(n, 8760);
+
+	std::vector<ssc_number_t> load(ncustomers * 8760), gen(8760);
+	for (int i = 0; i < ncustomers; i++)
+		for (int h = 0; h < 8760; h++)
+			load[i * 8760 + h] = (ssc_number_t)(scale[i] * residential[h]);
+	for (int h = 0; h < 8760; h++)
+		gen[h] = (ssc_number_t)std::max(0., 3. * sin(((h % 24) - 6) / 12. * M_PI));
+	ssc_data_free(profile);
+
+	// one batch with the shared generation profile and one without a system
+	ssc_data_t with_sys = ssc_data_create();
+	utility_rate5_default(with_sys);
+	ssc_data_set_matrix(with_sys, "batch_load", &load[0], ncustomers, 8760);
+	ssc_data_set_matrix(with_sys, "batch_gen", &gen[0], 1, 8760);
+	ssc_data_set_number(with_sys, "batch_threads", 2);
+	ASSERT_EQ(run_module(with_sys, "utilityrate5_batch"), 0);
+
+	ssc_data_t wo_sys = ssc_data_create();
+	utility_rate5_default(wo_sys);
+	ssc_data_set_matrix(wo_sys, "batch_load", &load[0], ncustomers, 8760);
+	ssc_data_set_number(wo_sys, "batch_threads", 2);
+	ASSERT_EQ(run_module(wo_sys, "utilityrate5_batch"), 0);
+
+	int nrows, ncols;
+	ssc_number_t *bill_w_sys = ssc_data_get_matrix(with_sys, "batch_monthly_bill", &nrows, &ncols);
+	ASSERT_EQ(nrows, ncustomers);
+	ASSERT_EQ(ncols, 12);
+	ssc_number_t *bill_wo_sys = ssc_data_get_matrix(wo_sys, "batch_monthly_bill", &nrows, &ncols);
+	ASSERT_EQ(nrows, ncustomers);
+	ASSERT_EQ(ncols, 12);
+
+	for (int i = 0; i < ncustomers; i++)
+	{
+		ssc_data_t data = ssc_data_create();
+		utilityrate5_customer(data, &load[i * 8760], &gen[0]);
+		ASSERT_EQ(run_module(data, "utilityrate5"), 0);
+
+		ssc_number_t *w_sys = ssc_data_get_array(data, "year1_monthly_utility_bill_w_sys", &n);
+		ASSERT_EQ(n, 12);
+		ssc_number_t *wo = ssc_data_get_array(data, "year1_monthly_utility_bill_wo_sys", &n);
+		ASSERT_EQ(n, 12);
+		for (int m = 0; m < 12; m++)
+		{
+			EXPECT_NEAR(bill_w_sys[i * 12 + m], w_sys[m], 0.01) << "customer " << i << " month " << m;
+			EXPECT_NEAR(bill_wo_sys[i * 12 + m], wo[m], 0.01) << "customer " << i << " month " << m;
+		}
+		ssc_data_free(data);
+	}
+	ssc_data_free(with_sys);
+	ssc_data_free(wo_sys);
+}
@@ -0,0 +1,200 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "CO2_property_tables.h"
+
+static int co2_exact(int vars, double x, double y, CO2_state *state)
+{
+	switch (vars)
+	{
+	case C_CO2_property_table::E_PH: return CO2_PH(x, y, state);
+	case C_CO2_property_table::E_PS: return CO2_PS(x, y, state);
+	default: return CO2_TP(x, y, state);
+	}
+}
+
+/// Largest relative differences from the exact routines on a lattice that is not aligned with the table grid
+static void max_table_error(const C_CO2_property_table &table, int vars, double x_min, double x_max, double y_min, double y_max,
+	double &error, double &error_derived)
+{
+	error = error_derived = 0.0;
+	const int n = 150;
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			double x = x_min + (x_max - x_min) * (i + 0.37) / n;
+			double y = y_min + (y_max - y_min) * (j + 0.61) / n;
+			CO2_state tab, exact;
+			int err_tab = table.get_state(x, y, &tab);
+			int err_exact = co2_exact(vars, x, y, &exact);
+			ASSERT_EQ(err_tab, err_exact);
+			if (err_exact != 0)
+				continue;
+
+			double v_tab[7] = { tab.temp, tab.dens, tab.enth, tab.entr, tab.cv, tab.cp, tab.ssnd };
+			double v_exact[7] = { exact.temp, exact.dens, exact.enth, exact.entr, exact.cv, exact.cp, exact.ssnd };
+			for (int c = 0; c < 7; c++)
+			{
+				double rel = std::abs(v_tab[c] - v_exact[c]) / std::abs(v_exact[c]);
+				if (c < 4) error = std::max(error, rel);
+				else error_derived = std::max(error_derived, rel);
+			}
+		}
+	}
+}
+
+// Runs first: the shared tables are built once per process, and the threads below must be the first users of one
+TEST(CO2PropertyTablesTest, SwitchAndThreads)
+{
+	CO2_state tab, exact;
+
+	// Threads that start before the (T,P) table exists all wait for the one build and get the states of the built table
+	N_co2_property_tables::set_use_tables(true);
+	const int n_threads = 4;
+	const int n_points = 2000;
+	std::atomic<bool> go(false);
+	std::vector<std::vector<double>> dens(n_threads, std::vector<double>(n_points));
+	std::vector<std::thread> threads;
+	for (int t = 0; t < n_threads; t++)
+	{
+		threads.push_back(std::thread([t, &go, &dens]()
+		{
+			while (!go)
+				std::this_thread::yield();
+			CO2_state state;
+			for (int i = 0; i < n_points; i++)
+			{
+				CO2_TP_table(320. + 0.25 * i, 7500. + 10. * i, &state);
+				dens[t][i] = state.dens;
+			}
+		}));
+	}
+	go = true;
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	const C_CO2_property_table &tp = N_co2_property_tables::get_table(C_CO2_property_table::E_TP);
+	ASSERT_TRUE(tp.is_init());
+	for (int t = 0; t < n_threads; t++)
+	{
+		int n_mismatch = 0;
+		for (int i = 0; i < n_points; i++)
+		{
+			tp.get_state(320. + 0.25 * i, 7500. + 10. * i, &tab);
+			if (tab.dens != dens[t][i])
+				n_mismatch++;
+		}
+		EXPECT_EQ(n_mismatch, 0) << "thread " << t;
+	}
+
+	// Error codes of the exact routines are returned outside the grids
+	EXPECT_EQ(CO2_PH_table(70000., 600., &tab), CO2_PH(70000., 600., &exact));
+	EXPECT_NE(CO2_PH_table(70000., 600., &tab), 0);
+
+	// With the tables off, the drop-in functions are the exact routines
+	N_co2_property_tables::set_use_tables(false);
+	ASSERT_EQ(CO2_PH_table(9000., 600., &tab), CO2_PH(9000., 600., &exact));
+	EXPECT_EQ(tab.temp, exact.temp);
+	EXPECT_EQ(tab.dens, exact.dens);
+	ASSERT_EQ(CO2_TP_table(500., 25000., &tab), CO2_TP(500., 25000., &exact));
+	EXPECT_EQ(tab.enth, exact.enth);
+}
+
+TEST(CO2PropertyTablesTest, ErrorNearCriticalPoint)
+{
+	C_CO2_property_table::S_table_par par = C_CO2_property_table::default_par(C_CO2_property_table::E_PH);
+	const C_CO2_property_table &ph = N_co2_property_tables::get_table(C_CO2_property_table::E_PH);
+	EXPECT_GT(ph.get_tabulated_fraction(), 0.9);
+	EXPECT_LE(ph.get_max_error(), par.m_tol);
+	EXPECT_LE(ph.get_max_error_derived(), par.m_tol_derived);
+
+	// Between the check points, including cells around the critical point, the error stays close to the tolerances
+	double error, error_derived;
+	max_table_error(ph, C_CO2_property_table::E_PH, 7000., 8500., 250., 450., error, error_derived);
+	EXPECT_LT(error, 1.5 * par.m_tol);
+	EXPECT_LT(error_derived, 1.5 * par.m_tol_derived);
+	max_table_error(ph, C_CO2_property_table::E_PH, 7500., 30000., 300., 1200., error, error_derived);
+	EXPECT_LT(error, 1.5 * par.m_tol);
+	EXPECT_LT(error_derived, 1.5 * par.m_tol_derived);
+
+	// Smaller (T,P) table around the critical point with a tighter tolerance
+	par = C_CO2_property_table::default_par(C_CO2_property_table::E_TP);
+	par.m_x_min = 295.;		par.m_x_max = 330.;		par.m_n_x = 141;
+	par.m_y_min = 6500.;	par.m_y_max = 9500.;	par.m_n_y = 121;
+	par.m_tol = 1.e-6;
+	C_CO2_property_table tp;
+	ASSERT_TRUE(tp.init(par));
+	EXPECT_LE(tp.get_max_error(), par.m_tol);
+	max_table_error(tp, C_CO2_property_table::E_TP, 296., 329., 6600., 9400., error, error_derived);
+	EXPECT_LT(error, 1.5 * par.m_tol);
+	EXPECT_LT(error_derived, 1.5 * par.m_tol_derived);
+}
+
+TEST(CO2PropertyTablesTest, Derivatives)
+{
+	const C_CO2_property_table &ps = N_co2_property_tables::get_table(C_CO2_property_table::E_PS);
+
+	// Derivatives match finite differences of the returned states in tabulated cells and where the exact routines are used
+	double points[3][2] = { { 20000., 2.2 }, { 7800., 1.45 }, { 5000., 1.3 } };
+	for (int k = 0; k < 3; k++)
+	{
+		double P = points[k][0];
+		double S = points[k][1];
+		double dT_dP, dT_dS, dD_dP, dD_dS;
+		ASSERT_EQ(ps.get_derivatives(P, S, dT_dP, dT_dS, dD_dP, dD_dS), 0);
+
+		double dP = 1.e-3;
+		double dS = 1.e-7;
+		CO2_state lo, hi;
+		ps.get_state(P - dP, S, &lo);
+		ps.get_state(P + dP, S, &hi);
+		EXPECT_NEAR(dT_dP, (hi.temp - lo.temp) / (2. * dP), 1.e-4 * std::abs(dT_dP) + 1.e-9) << "point " << k;
+		EXPECT_NEAR(dD_dP, (hi.dens - lo.dens) / (2. * dP), 1.e-4 * std::abs(dD_dP) + 1.e-9) << "point " << k;
+		ps.get_state(P, S - dS, &lo);
+		ps.get_state(P, S + dS, &hi);
+		EXPECT_NEAR(dT_dS, (hi.temp - lo.temp) / (2. * dS), 1.e-4 * std::abs(dT_dS)) << "point " << k;
+		EXPECT_NEAR(dD_dS, (hi.dens - lo.dens) / (2. * dS), 1.e-4 * std::abs(dD_dS)) << "point " << k;
+	}
+}
+
+TEST(CO2PropertyTablesTest, Timing)
+{
+	const int n_calls = 200000;
+	N_co2_property_tables::build_tables();
+	for (int vars = 0; vars < C_CO2_property_table::E_n_vars; vars++)
+	{
+		const C_CO2_property_table &table = N_co2_property_tables::get_table(vars);
+		double x_lo = vars == C_CO2_property_table::E_TP ? 320. : 7500.;
+		double x_hi = vars == C_CO2_property_table::E_TP ? 900. : 27500.;
+		double y_lo = vars == C_CO2_property_table::E_TP ? 7500. : (vars == C_CO2_property_table::E_PH ? 300. : 1.2);
+		double y_hi = vars == C_CO2_property_table::E_TP ? 27500. : (vars == C_CO2_property_table::E_PH ? 1000. : 2.7);
+
+		double sum = 0.0;
+		CO2_state state;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < n_calls; i++)
+		{
+			table.get_state(x_lo + (x_hi - x_lo) * (i % 1000) / 1000., y_lo + (y_hi - y_lo) * (i % 997) / 997., &state);
+			sum += state.dens;
+		}
+		auto mid = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < n_calls; i++)
+		{
+			co2_exact(vars, x_lo + (x_hi - x_lo) * (i % 1000) / 1000., y_lo + (y_hi - y_lo) * (i % 997) / 997., &state);
+			sum += state.dens;
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+
+		const char *names[3] = { "PH", "PS", "TP" };
+		printf("CO2 %s: table %.0f ns, exact %.0f ns per call\n", names[vars],
+			std::chrono::duration<double, std::nano>(mid - start).count() / n_calls,
+			std::chrono::duration<double, std::nano>(end - mid).count() / n_calls);
+		EXPECT_TRUE(std::isfinite(sum));
+	}
+}
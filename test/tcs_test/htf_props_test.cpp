@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "htf_props.h"
+
+static double rel_diff(double a, double b)
+{
+	return std::abs(a - b) / std::max(std::abs(b), 1.e-12);
+}
+
+/// Largest relative difference between the tabulated and correlation properties at temperatures between grid points
+static double max_fast_lookup_error(int fluid, double T_low_K, double T_high_K, int n_points, bool is_cubic)
+{
+	HTFProperties corr, fast;
+	corr.SetFluid(fluid);
+	fast.SetFluid(fluid);
+	EXPECT_TRUE(fast.SetFastLookup(T_low_K, T_high_K, n_points, is_cubic));
+
+	double err = 0.0;
+	for (double T_K = T_low_K + 0.123; T_K < T_high_K; T_K += 0.371)
+	{
+		err = std::max(err, rel_diff(fast.Cp(T_K), corr.Cp(T_K)));
+		err = std::max(err, rel_diff(fast.dens(T_K, 1.e5), corr.dens(T_K, 1.e5)));
+		err = std::max(err, rel_diff(fast.visc(T_K), corr.visc(T_K)));
+		err = std::max(err, rel_diff(fast.cond(T_K), corr.cond(T_K)));
+		err = std::max(err, rel_diff(fast.enth(T_K), corr.enth(T_K)));
+		double H = corr.enth(T_K);
+		err = std::max(err, rel_diff(fast.temp(H), corr.temp(H)));
+	}
+	return err;
+}
+
+TEST(HtfPropsTest, FastLookupAccuracy)
+{
+	double T_low = 290. + 273.15;
+	double T_high = 565. + 273.15;
+
+	int fluids[3] = { HTFProperties::Nitrate_Salt, HTFProperties::Therminol_VP1, HTFProperties::Hitec_XL };
+	for (int i = 0; i < 3; i++)
+	{
+		EXPECT_LT(max_fast_lookup_error(fluids[i], T_low, T_high, 501, false), 1.e-5) << "fluid " << fluids[i];
+		EXPECT_LT(max_fast_lookup_error(fluids[i], T_low, T_high, 501, true), 1.e-7) << "fluid " << fluids[i];
+	}
+
+	// Outside the table range, and for pressure dependent densities, the correlations are used
+	HTFProperties corr, fast;
+	corr.SetFluid(HTFProperties::Air);
+	fast.SetFluid(HTFProperties::Air);
+	fast.SetFastLookup(T_low, T_high, 101, false);
+	EXPECT_EQ(fast.dens(700., 2.e5), corr.dens(700., 2.e5));
+	EXPECT_EQ(fast.Cp(T_high + 10.), corr.Cp(T_high + 10.));
+
+	// Tables follow a change of fluid
+	fast.SetFluid(HTFProperties::Nitrate_Salt);
+	corr.SetFluid(HTFProperties::Nitrate_Salt);
+	EXPECT_NEAR(fast.Cp(700.), corr.Cp(700.), 1.e-6);
+
+	fast.ClearFastLookup();
+	EXPECT_FALSE(fast.IsFastLookup());
+	EXPECT_EQ(fast.visc(700.), corr.visc(700.));
+}
+
+/// Smooth user-defined fluid table starting at 250 C with n_rows rows dT apart
+static util::matrix_t<double> user_defined_table(size_t n_rows, double dT)
+{
+	util::matrix_t<double> table(n_rows, 7);
+	for (size_t r = 0; r < n_rows; r++)
+	{
+		double T_C = 250. + dT * r;
+		table(r, 0) = T_C;
+		table(r, 1) = 1.5 + 1.e-6 * T_C * T_C;
+		table(r, 2) = 2000. - 0.6 * T_C;
+		table(r, 3) = 0.01 * exp(-T_C / 120.);
+		table(r, 4) = table(r, 3) / table(r, 2);
+		table(r, 5) = 0.5 + 1.e-4 * T_C;
+		table(r, 6) = 1500. * T_C + 0.1 * T_C * T_C;
+	}
+	return table;
+}
+
+TEST(HtfPropsTest, FastLookupUserDefined)
+{
+	// Piecewise linear table with breakpoints on the fast lookup grid is reproduced exactly
+	util::matrix_t<double> table = user_defined_table(12, 25.);
+
+	HTFProperties corr, fast;
+	ASSERT_TRUE(corr.SetUserDefinedFluid(table));
+	ASSERT_TRUE(fast.SetUserDefinedFluid(table));
+	fast.SetFastLookup(250. + 273.15, 525. + 273.15, 276, false);
+
+	for (double T_C = 250.3; T_C < 525.; T_C += 1.7)
+	{
+		double T_K = T_C + 273.15;
+		EXPECT_NEAR(fast.Cp(T_K), corr.Cp(T_K), 1.e-9 * corr.Cp(T_K));
+		EXPECT_NEAR(fast.visc(T_K), corr.visc(T_K), 1.e-9 * corr.visc(T_K));
+		EXPECT_NEAR(fast.enth(T_K), corr.enth(T_K), 1.e-9 * corr.enth(T_K));
+	}
+}
+
+TEST(HtfPropsTest, TempEnthLookup)
+{
+	HTFProperties htf;
+	htf.SetFluid(HTFProperties::Salt_60_NaNO3_40_KNO3, true);
+
+	// Enthalpy is relative to 270 C and integrates Cp
+	double T_low = 270. + 273.15;
+	EXPECT_EQ(htf.enth_lookup(T_low), 0.0);
+	EXPECT_NEAR(htf.enth_lookup(T_low + 100.), htf.Cp_ave(T_low, T_low + 100., 101) * 100., 1.e-3);
+
+	for (double T_K = 500.; T_K < 900.; T_K += 3.7)
+	{
+		EXPECT_NEAR(htf.temp_lookup(htf.enth_lookup(T_K)), T_K, 1.e-9);
+	}
+}
+
+TEST(HtfPropsTest, FastLookupTiming)
+{
+	util::matrix_t<double> table = user_defined_table(30, 12.);
+
+	HTFProperties htfs[3];
+	htfs[0].SetFluid(HTFProperties::Nitrate_Salt);
+	htfs[1].SetFluid(HTFProperties::Therminol_VP1);
+	htfs[2].SetUserDefinedFluid(table);
+	const char *names[3] = { "Nitrate_Salt", "Therminol_VP1", "User_defined" };
+
+	const int n_calls = 1000000;
+	for (int f = 0; f < 3; f++)
+	{
+		for (int is_fast = 0; is_fast < 2; is_fast++)
+		{
+			HTFProperties &htf = htfs[f];
+			if (is_fast)
+				htf.SetFastLookup(260. + 273.15, 590. + 273.15, 1001, false);
+
+			double sum = 0.0;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < n_calls; i++)
+			{
+				double T_K = 543.15 + 300. * (i % 997) / 997.;
+				sum += htf.Cp(T_K) + htf.visc(T_K) + htf.dens(T_K, 1.e5) + htf.enth(T_K);
+			}
+			auto end = std::chrono::high_resolution_clock::now();
+			double ns_per_call = std::chrono::duration<double, std::nano>(end - start).count() / (4. * n_calls);
+			printf("htf props %s, %s: %.1f ns per call\n", names[f], is_fast ? "tabulated" : "correlation", ns_per_call);
+			EXPECT_TRUE(std::isfinite(sum));
+		}
+	}
+}